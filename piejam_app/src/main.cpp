@@ -176,20 +176,25 @@ main(int argc, char* argv[]) -> int
                     thread::configuration{
                             .affinity = 2,
                             .realtime_priority = realtime_priority,
-                            .name = "audio_main"},
+                            .name = "audio_main",
+                            .wait_policy = {}},
                     std::array{
                             thread::configuration{
                                     .affinity = 3,
                                     .realtime_priority = realtime_priority,
-                                    .name = "audio_worker_0"},
+                                    .name = "audio_worker_0",
+                                    .wait_policy =
+                                            thread::wait_policy::low_latency()},
                             thread::configuration{
                                     .affinity = 0,
                                     .realtime_priority = realtime_priority,
-                                    .name = "audio_worker_1"},
+                                    .name = "audio_worker_1",
+                                    .wait_policy = {}},
                             thread::configuration{
                                     .affinity = 1,
                                     .realtime_priority = realtime_priority,
-                                    .name = "audio_worker_2"}},
+                                    .name = "audio_worker_2",
+                                    .wait_policy = {}}},
                     *audio_device_manager,
                     ladspa_manager,
                     runtime::make_midi_input_controller(*midi_device_manager)));
@@ -0,0 +1,197 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <benchmark/benchmark.h>
+
+#include <piejam/audio/engine/event_input_buffers.h>
+#include <piejam/audio/engine/event_output_buffers.h>
+#include <piejam/audio/engine/input_processor.h>
+#include <piejam/audio/engine/process_context.h>
+#include <piejam/audio/engine/slice.h>
+#include <piejam/audio/pcm_convert.h>
+#include <piejam/audio/pcm_convert_interleaved.h>
+#include <piejam/range/strided_span.h>
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+using namespace piejam::audio;
+
+constexpr auto period_size = 256;
+constexpr auto min_num_channels = 2;
+constexpr auto max_num_channels = 32;
+
+//! Hands the channels to the engine, as its input processors do in a
+//! period. The benchmarks measure the read of a period including this.
+static void
+hand_off(
+        std::span<engine::input_processor> const procs,
+        std::span<std::span<float> const> const outputs,
+        std::span<engine::audio_slice> const results)
+{
+    for (std::size_t channel = 0; channel < procs.size(); ++channel)
+    {
+        procs[channel].process(
+                {{},
+                 outputs.subspan(channel, 1),
+                 results.subspan(channel, 1),
+                 {},
+                 {},
+                 period_size});
+    }
+}
+
+//! Each channel is converted into the engine buffer by its converter.
+template <pcm_format F>
+static void
+BM_from_interleaved_per_channel(benchmark::State& state)
+{
+    auto const num_channels = static_cast<std::size_t>(state.range(0));
+
+    std::vector<pcm_sample_t<F>> interleaved(num_channels * period_size);
+    std::vector<mipp::vector<float>> engine_buffers(
+            num_channels,
+            mipp::vector<float>(period_size));
+    std::vector<std::span<float>> outputs(
+            engine_buffers.begin(),
+            engine_buffers.end());
+    std::vector<engine::audio_slice> results(num_channels);
+    std::vector<engine::input_processor> procs(num_channels);
+
+    for (std::size_t channel = 0; channel < num_channels; ++channel)
+    {
+        procs[channel].set_input(
+                [&interleaved, channel, num_channels](
+                        std::span<float> const buffer) {
+                    piejam::range::strided_span<pcm_sample_t<F> const> in{
+                            interleaved.data() + channel,
+                            period_size,
+                            static_cast<std::ptrdiff_t>(num_channels)};
+                    std::ranges::transform(
+                            in,
+                            buffer.begin(),
+                            &pcm_convert::from<F>);
+                    return std::span<float const>{buffer};
+                });
+    }
+
+    for (auto _ : state)
+    {
+        hand_off(procs, outputs, results);
+        benchmark::ClobberMemory();
+    }
+}
+
+//! All channels are converted at once, the converters hand out the
+//! converted channels.
+template <pcm_format F>
+static void
+BM_from_interleaved(benchmark::State& state)
+{
+    auto const num_channels = static_cast<std::size_t>(state.range(0));
+
+    std::vector<pcm_sample_t<F>> interleaved(num_channels * period_size);
+    std::vector<mipp::vector<float>> buffers(
+            num_channels,
+            mipp::vector<float>(period_size));
+    std::vector<std::span<float>> channels(buffers.begin(), buffers.end());
+    std::vector<mipp::vector<float>> engine_buffers(
+            num_channels,
+            mipp::vector<float>(period_size));
+    std::vector<std::span<float>> outputs(
+            engine_buffers.begin(),
+            engine_buffers.end());
+    std::vector<engine::audio_slice> results(num_channels);
+    std::vector<engine::input_processor> procs(num_channels);
+
+    for (std::size_t channel = 0; channel < num_channels; ++channel)
+    {
+        procs[channel].set_input([&channels, channel](std::span<float>) {
+            return std::span<float const>{channels[channel]};
+        });
+    }
+
+    for (auto _ : state)
+    {
+        pcm_convert::from_interleaved<F>(interleaved, channels);
+        hand_off(procs, outputs, results);
+        benchmark::ClobberMemory();
+    }
+}
+
+template <pcm_format F>
+static void
+BM_to_interleaved_per_channel(benchmark::State& state)
+{
+    auto const num_channels = static_cast<std::size_t>(state.range(0));
+
+    std::vector<mipp::vector<float>> channels(
+            num_channels,
+            mipp::vector<float>(period_size, 0.5f));
+    std::vector<pcm_sample_t<F>> interleaved(num_channels * period_size);
+
+    for (auto _ : state)
+    {
+        for (std::size_t channel = 0; channel < num_channels; ++channel)
+        {
+            piejam::range::strided_span<pcm_sample_t<F>> out{
+                    interleaved.data() + channel,
+                    period_size,
+                    static_cast<std::ptrdiff_t>(num_channels)};
+            std::ranges::transform(
+                    channels[channel],
+                    out.begin(),
+                    &pcm_convert::to<F>);
+        }
+
+        benchmark::ClobberMemory();
+    }
+}
+
+template <pcm_format F>
+static void
+BM_to_interleaved(benchmark::State& state)
+{
+    auto const num_channels = static_cast<std::size_t>(state.range(0));
+
+    std::vector<mipp::vector<float>> buffers(
+            num_channels,
+            mipp::vector<float>(period_size, 0.5f));
+    std::vector<pcm_output_source_buffer_t> channels;
+    for (auto const& buffer : buffers)
+    {
+        channels.emplace_back(std::span<float const>(buffer));
+    }
+    std::vector<pcm_sample_t<F>> interleaved(num_channels * period_size);
+
+    for (auto _ : state)
+    {
+        pcm_convert::to_interleaved<F>(channels, interleaved);
+        benchmark::ClobberMemory();
+    }
+}
+
+#define M_PIEJAM_PCM_CONVERT_BENCHMARKS(Format)                                \
+    BENCHMARK_TEMPLATE(BM_from_interleaved_per_channel, Format)                \
+            ->RangeMultiplier(2)                                               \
+            ->Range(min_num_channels, max_num_channels);                       \
+    BENCHMARK_TEMPLATE(BM_from_interleaved, Format)                            \
+            ->RangeMultiplier(2)                                               \
+            ->Range(min_num_channels, max_num_channels);                       \
+    BENCHMARK_TEMPLATE(BM_to_interleaved_per_channel, Format)                  \
+            ->RangeMultiplier(2)                                               \
+            ->Range(min_num_channels, max_num_channels);                       \
+    BENCHMARK_TEMPLATE(BM_to_interleaved, Format)                              \
+            ->RangeMultiplier(2)                                               \
+            ->Range(min_num_channels, max_num_channels)
+
+M_PIEJAM_PCM_CONVERT_BENCHMARKS(pcm_format::s16_le);
+M_PIEJAM_PCM_CONVERT_BENCHMARKS(pcm_format::s16_be);
+M_PIEJAM_PCM_CONVERT_BENCHMARKS(pcm_format::s24_3le);
+M_PIEJAM_PCM_CONVERT_BENCHMARKS(pcm_format::s24_3be);
+M_PIEJAM_PCM_CONVERT_BENCHMARKS(pcm_format::s32_le);
+M_PIEJAM_PCM_CONVERT_BENCHMARKS(pcm_format::s32_be);
+
+#undef M_PIEJAM_PCM_CONVERT_BENCHMARKS
@@ -0,0 +1,97 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/audio/dsp/adaptive_resampler.h>
+#include <piejam/audio/sample_rate.h>
+#include <piejam/thread/cache_line_size.h>
+#include <piejam/thread/spsc_slot.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace piejam::audio
+{
+
+//! Carries interleaved frames between two devices running on independent
+//! clocks of the same nominal sample rate. The producer pushes at its clock,
+//! the consumer pulls at its clock through an adaptive resampler. A PI
+//! controller steers the resampling ratio, to keep the fill level of the
+//! ring at its target. The fill level is evaluated at the times, at which
+//! the hw pointers of both sides crossed their period boundaries. These are
+//! derived from the hw timestamp and the hw pointer of the same status, so
+//! the scheduling jitter of the threads doesn't reach the controller.
+//!
+//! push is called from the producer thread only, pull from the consumer
+//! thread only. Neither allocates nor blocks.
+class clock_bridge
+{
+public:
+    using timestamp = std::chrono::nanoseconds;
+
+    clock_bridge(
+            std::size_t num_channels,
+            sample_rate,
+            std::size_t producer_period_size,
+            std::size_t consumer_period_size);
+
+    [[nodiscard]] auto num_channels() const noexcept -> std::size_t
+    {
+        return m_num_channels;
+    }
+
+    //! Frames, which don't fit into the ring anymore, are dropped.
+    void push(std::span<float const> frames, timestamp) noexcept;
+
+    //! Silence is pulled, until the ring is filled up to the target.
+    void pull(std::span<float> frames, timestamp) noexcept;
+
+    //! Consumer thread only.
+    [[nodiscard]] auto ratio() const noexcept -> double
+    {
+        return m_ratio;
+    }
+
+    //! Number of times the consumer had to resynchronize, because the ring
+    //! ran empty or overfilled.
+    [[nodiscard]] auto resyncs() const noexcept -> std::size_t
+    {
+        return m_resyncs.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct producer_position
+    {
+        std::uint64_t frames{};
+        timestamp time{};
+    };
+
+    void read(std::span<float> frames) noexcept;
+    void resync() noexcept;
+
+    std::size_t const m_num_channels;
+    double const m_sample_rate;
+    double const m_consumer_period;
+    std::size_t const m_target_fill;
+    std::size_t const m_capacity;
+    std::vector<float> m_ring;
+
+    alignas(thread::cache_line_size) std::atomic<std::uint64_t> m_written{};
+    alignas(thread::cache_line_size) std::atomic<std::uint64_t> m_read{};
+    thread::spsc_slot<producer_position> m_producer_position;
+    alignas(thread::cache_line_size) std::atomic_size_t m_resyncs{};
+
+    // consumer state
+    producer_position m_last_producer_position;
+    dsp::adaptive_resampler<float> m_resampler;
+    bool m_running{};
+    double m_integral{};
+    double m_ratio{1.};
+};
+
+} // namespace piejam::audio
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <piejam/audio/fwd.h>
 #include <piejam/audio/process_function.h>
 #include <piejam/thread/fwd.h>
 
@@ -30,8 +31,21 @@ public:
 
     virtual void stop() = 0;
 
+    //! Whether the periods are processed at the pace of the hardware.
+    [[nodiscard]] virtual auto is_realtime() const noexcept -> bool
+    {
+        return true;
+    }
+
     [[nodiscard]] virtual auto cpu_load() const noexcept -> float = 0;
     [[nodiscard]] virtual auto xruns() const noexcept -> std::size_t = 0;
+
+    //! Timings of the periods around xruns, if the device keeps them.
+    [[nodiscard]] virtual auto period_history() noexcept
+            -> audio::period_history*
+    {
+        return nullptr;
+    }
 };
 
 auto make_dummy_device() -> std::unique_ptr<device>;
@@ -0,0 +1,137 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <span>
+#include <vector>
+
+namespace piejam::audio::dsp
+{
+
+//! Resampler for interleaved frames with a ratio, that may change with every
+//! call. The ratio is the number of input frames consumed per output frame.
+//! Interpolates with a 4-point Catmull-Rom spline.
+template <std::floating_point T>
+class adaptive_resampler
+{
+public:
+    adaptive_resampler(
+            std::size_t const num_channels,
+            std::size_t const max_output_frames,
+            T const max_ratio)
+        : m_num_channels(num_channels)
+        , m_input(
+                  (history +
+                   static_cast<std::size_t>(std::ceil(
+                           static_cast<T>(max_output_frames) * max_ratio)) +
+                   1) *
+                  num_channels)
+    {
+        BOOST_ASSERT(num_channels > 0);
+    }
+
+    [[nodiscard]] auto num_channels() const noexcept -> std::size_t
+    {
+        return m_num_channels;
+    }
+
+    //! Number of input frames, that are consumed to produce the output
+    //! frames with the given ratio.
+    [[nodiscard]] auto input_frames(
+            std::size_t const output_frames,
+            T const ratio) const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(
+                m_position + static_cast<T>(output_frames) * ratio);
+    }
+
+    //! Where the input frames have to be written before calling process.
+    [[nodiscard]] auto input_buffer(std::size_t const frames) noexcept
+            -> std::span<T>
+    {
+        BOOST_ASSERT((history + frames) * m_num_channels <= m_input.size());
+        return std::span<T>{m_input}.subspan(
+                history * m_num_channels,
+                frames * m_num_channels);
+    }
+
+    void process(
+            std::size_t const input_frames,
+            T const ratio,
+            std::span<T> const output) noexcept
+    {
+        BOOST_ASSERT(output.size() % m_num_channels == 0);
+        std::size_t const output_frames = output.size() / m_num_channels;
+        BOOST_ASSERT(input_frames == this->input_frames(output_frames, ratio));
+
+        T position = m_position;
+        for (std::size_t frame = 0; frame < output_frames; ++frame)
+        {
+            auto const index = static_cast<std::size_t>(position);
+            T const t = position - static_cast<T>(index);
+
+            T const* const x = m_input.data() + index * m_num_channels;
+            T* const out = output.data() + frame * m_num_channels;
+            for (std::size_t ch = 0; ch < m_num_channels; ++ch)
+            {
+                out[ch] = interpolate(
+                        x[ch],
+                        x[m_num_channels + ch],
+                        x[2 * m_num_channels + ch],
+                        x[3 * m_num_channels + ch],
+                        t);
+            }
+
+            position += ratio;
+        }
+
+        m_position =
+                m_position + static_cast<T>(output_frames) * ratio -
+                static_cast<T>(input_frames);
+        BOOST_ASSERT(m_position >= 0 && m_position < 1);
+
+        std::copy_n(
+                m_input.begin() +
+                        static_cast<std::ptrdiff_t>(
+                                input_frames * m_num_channels),
+                history * m_num_channels,
+                m_input.begin());
+    }
+
+    void reset() noexcept
+    {
+        std::ranges::fill(m_input, T{});
+        m_position = T{};
+    }
+
+private:
+    // one frame more than the interpolation needs, a ratio below one would
+    // otherwise read past the input at the end of a block
+    static constexpr std::size_t history = 4;
+
+    static constexpr auto
+    interpolate(T const x0, T const x1, T const x2, T const x3, T const t)
+            -> T
+    {
+        T const c1 = T{0.5} * (x2 - x0);
+        T const c2 = x0 - T{2.5} * x1 + T{2} * x2 - T{0.5} * x3;
+        T const c3 = T{0.5} * (x3 - x0) + T{1.5} * (x1 - x2);
+        return ((c3 * t + c2) * t + c1) * t + x1;
+    }
+
+    std::size_t m_num_channels;
+    std::vector<T> m_input;
+
+    //! Position of the next output frame, relative to the second frame of
+    //! the input buffer.
+    T m_position{};
+};
+
+} // namespace piejam::audio::dsp
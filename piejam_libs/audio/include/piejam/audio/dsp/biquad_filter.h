@@ -8,6 +8,8 @@
 #include <piejam/math.h>
 
 #include <cmath>
+#include <cstddef>
+#include <limits>
 #include <numbers>
 
 namespace piejam::audio::dsp::biquad_filter
@@ -144,4 +146,34 @@ make_br_coefficients(T const cutoff, T const res, T const inv_sr) noexcept
     return coefficients<T>{.b2 = b2, .b1 = b1, .a0 = a0, .a1 = b1, .a2 = a0};
 }
 
+//! Number of samples until the impulse response has decayed by the
+//! attenuation, estimated from the pole radius.
+template <std::floating_point T>
+auto
+decay_length(coefficients<T> const& c, T const attenuation = T{1e-6}) noexcept
+        -> std::size_t
+{
+    // the poles are the roots of z^2 + b1 * z + b2
+    T const d = c.b1 * c.b1 - T{4} * c.b2;
+    T const r = d < T{0} ? std::sqrt(c.b2)
+                         : (std::abs(c.b1) + std::sqrt(d)) / T{2};
+
+    if (r >= T{1})
+    {
+        return std::numeric_limits<std::size_t>::max();
+    }
+
+    // delay line of the transposed canonical form
+    constexpr std::size_t order = 2;
+
+    if (r <= T{0})
+    {
+        return order;
+    }
+
+    return static_cast<std::size_t>(
+                   std::ceil(std::log(attenuation) / std::log(r))) +
+           order;
+}
+
 } // namespace piejam::audio::dsp::biquad_filter
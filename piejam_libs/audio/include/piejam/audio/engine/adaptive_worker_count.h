@@ -0,0 +1,39 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+
+namespace piejam::audio::engine
+{
+
+//! Adapts the number of worker threads to the cpu load of the audio
+//! processing. One worker is added, if the load exceeds the upper threshold.
+//! One worker is removed, if the load, extrapolated to one thread less, would
+//! stay below the lower threshold.
+class adaptive_worker_count
+{
+public:
+    explicit adaptive_worker_count(
+            std::size_t max_workers,
+            float shrink_below = 0.5f,
+            float grow_above = 0.7f) noexcept;
+
+    [[nodiscard]] auto value() const noexcept -> std::size_t
+    {
+        return m_value;
+    }
+
+    //! cpu_load is the fraction of the period used for processing.
+    auto update(float cpu_load) noexcept -> std::size_t;
+
+private:
+    std::size_t m_max_workers;
+    float m_shrink_below;
+    float m_grow_above;
+    std::size_t m_value;
+};
+
+} // namespace piejam::audio::engine
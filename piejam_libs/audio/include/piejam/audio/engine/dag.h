@@ -4,10 +4,11 @@
 
 #pragma once
 
+#include <piejam/audio/engine/dag_task.h>
 #include <piejam/audio/engine/fwd.h>
 #include <piejam/thread/fwd.h>
 
-#include <functional>
+#include <chrono>
 #include <memory>
 #include <span>
 #include <unordered_map>
@@ -21,9 +22,24 @@ class dag
 {
 public:
     using task_id_t = std::size_t;
-    using task_t = std::function<void(thread_context const&)>;
+    using task_t = dag_task;
     using tasks_t = std::vector<std::pair<task_id_t, task_t>>;
     using graph_t = std::unordered_map<task_id_t, std::vector<task_id_t>>;
+    using cost_t = std::chrono::nanoseconds;
+    using costs_t = std::unordered_map<task_id_t, cost_t>;
+
+    //! Scheduling strategy used, when running on multiple threads.
+    enum class scheduling
+    {
+        //! All workers share one lock-free job stack.
+        shared_queue,
+        //! Every worker has its own deque, idle workers steal from others.
+        work_stealing,
+        //! Tasks are assigned to threads in advance, according to their
+        //! costs and the critical path. Each thread runs its precomputed
+        //! sequence, waiting only for parents assigned to other threads.
+        static_schedule,
+    };
 
     dag();
     dag(dag const&) = delete;
@@ -41,15 +57,27 @@ public:
     auto add_child_task(task_id_t parent, task_t) -> task_id_t;
     void add_child(task_id_t parent, task_id_t child);
 
+    //! Estimated execution time of a task, used for static scheduling.
+    void set_cost(task_id_t, cost_t);
+
+    //! Number of tasks, which can run in parallel at most. Estimated by the
+    //! largest number of tasks with the same depth.
+    [[nodiscard]] auto max_parallelism() const -> std::size_t;
+
+    //! Wakes at most max_parallelism() - 1 of the passed workers, since the
+    //! calling thread is participating. The optional tracer needs a ring for
+    //! the calling thread and each of the workers.
     auto make_runnable(
             std::span<thread::worker> = {},
-            std::size_t event_memory_size = (1u << 16))
-            -> std::unique_ptr<dag_executor>;
+            std::size_t event_memory_size = (1u << 16),
+            scheduling = scheduling::work_stealing,
+            tracer const* = nullptr) -> std::unique_ptr<dag_executor>;
 
 private:
     std::size_t m_free_id{};
     graph_t m_graph;
     tasks_t m_tasks;
+    costs_t m_costs;
 };
 
 } // namespace piejam::audio::engine
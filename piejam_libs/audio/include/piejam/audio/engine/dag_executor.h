@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 
 namespace piejam::audio::engine
@@ -15,6 +16,21 @@ public:
     virtual ~dag_executor() = default;
 
     virtual void operator()(std::size_t buffer_size) = 0;
+
+    //! Limits the number of worker threads woken up by the following runs.
+    //! Called from the processing thread. Executors with a fixed assignment
+    //! of tasks to threads ignore it.
+    virtual void set_num_workers(std::size_t) noexcept
+    {
+    }
+
+    //! Time the threads spent waiting for work or for each other, summed up
+    //! since the previous call. Called from the processing thread.
+    [[nodiscard]] virtual auto take_idle_time() noexcept
+            -> std::chrono::nanoseconds
+    {
+        return {};
+    }
 };
 
 } // namespace piejam::audio::engine
@@ -0,0 +1,62 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/audio/engine/fwd.h>
+
+#include <concepts>
+#include <memory>
+#include <type_traits>
+
+namespace piejam::audio::engine
+{
+
+//! Type-erased dag task, stored as a plain function pointer plus context.
+//! Copies share the same callable.
+class dag_task
+{
+public:
+    using function_t = void (*)(void*, thread_context const&);
+
+    dag_task() noexcept = default;
+
+    template <class F>
+        requires(
+                !std::same_as<std::decay_t<F>, dag_task> &&
+                std::invocable<std::decay_t<F>&, thread_context const&>)
+    dag_task(F&& f)
+        : m_context(std::make_shared<std::decay_t<F>>(std::forward<F>(f)))
+        , m_function([](void* const ctx, thread_context const& thread_ctx) {
+            (*static_cast<std::decay_t<F>*>(ctx))(thread_ctx);
+        })
+    {
+    }
+
+    [[nodiscard]] auto function() const noexcept -> function_t
+    {
+        return m_function;
+    }
+
+    [[nodiscard]] auto context() const noexcept -> void*
+    {
+        return m_context.get();
+    }
+
+    void operator()(thread_context const& thread_ctx) const
+    {
+        m_function(m_context.get(), thread_ctx);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_function != nullptr;
+    }
+
+private:
+    std::shared_ptr<void> m_context;
+    function_t m_function{};
+};
+
+} // namespace piejam::audio::engine
@@ -23,6 +23,8 @@ public:
 
     [[nodiscard]] virtual auto type() const -> std::type_index const& = 0;
 
+    [[nodiscard]] virtual auto empty() const noexcept -> bool = 0;
+
     virtual void clear() = 0;
 };
 
@@ -56,7 +58,7 @@ public:
         return s_type;
     }
 
-    [[nodiscard]] auto empty() const noexcept -> bool
+    [[nodiscard]] auto empty() const noexcept -> bool override
     {
         return m_event_container.empty();
     }
@@ -16,6 +16,7 @@ class event_buffer_memory;
 class event_input_buffers;
 class event_output_buffers;
 class event_port;
+struct gain_ramp;
 template <class T>
 class slice;
 using audio_slice = slice<float>;
@@ -36,6 +37,9 @@ struct graph_endpoint;
 class process;
 struct process_context;
 class processor_job;
+class processor_timings;
 class thread_context;
+class trace_ring;
+class tracer;
 
 } // namespace piejam::audio::engine
@@ -0,0 +1,25 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+namespace piejam::audio::engine
+{
+
+//! Gain, linearly ramped over a period.
+struct gain_ramp
+{
+    float from{1.f};
+    float to{1.f};
+
+    [[nodiscard]] constexpr auto is_unity() const noexcept -> bool
+    {
+        return from == 1.f && to == 1.f;
+    }
+
+    constexpr auto operator==(gain_ramp const&) const noexcept
+            -> bool = default;
+};
+
+} // namespace piejam::audio::engine
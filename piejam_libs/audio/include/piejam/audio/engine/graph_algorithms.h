@@ -5,9 +5,13 @@
 #pragma once
 
 #include <piejam/audio/engine/fwd.h>
+#include <piejam/audio/engine/graph_endpoint.h>
 
+#include <map>
 #include <memory>
 #include <optional>
+#include <set>
+#include <span>
 #include <vector>
 
 namespace piejam::audio::engine
@@ -28,11 +32,21 @@ auto has_event_wire(
         graph_endpoint const& src,
         graph_endpoint const& dst) -> bool;
 
+//! Processors fed by the sources over audio wires, directly or through
+//! other processors.
+auto downstream_processors(graph const&, std::span<graph_endpoint const> srcs)
+        -> std::set<processor const*>;
+
 void remove_event_identity_processors(graph&);
 void remove_identity_processors(graph&);
 
-using mix_processors = std::vector<std::unique_ptr<processor>>;
+//! Mixers inserted by finalize_graph, by the input they are feeding.
+using mix_processors = std::map<graph_endpoint, std::shared_ptr<processor>>;
 
-auto finalize_graph(graph const&) -> std::tuple<graph, mix_processors>;
+//! Removes the identities and inserts mixers into inputs with several
+//! sources. The mixers of the previous result are reused for the same inputs,
+//! so the graph stays the same where its sources are unchanged.
+auto finalize_graph(graph const&, mix_processors const& previous = {})
+        -> std::tuple<graph, mix_processors>;
 
 } // namespace piejam::audio::engine
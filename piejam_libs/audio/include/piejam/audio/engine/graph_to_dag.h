@@ -7,10 +7,42 @@
 #include <piejam/audio/engine/fwd.h>
 
 #include <cstddef>
+#include <memory>
 
 namespace piejam::audio::engine
 {
 
-auto graph_to_dag(graph const&) -> dag;
+//! Jobs of the dag made last from a graph. Processors with the same inputs
+//! and output buffers keep their jobs, and with them the fused chains, in the
+//! next dag. New jobs of the other processors take over the results of their
+//! previous ones, so the jobs of their consumers stay connected. Copies share
+//! the jobs, a copy keeps the previous ones, in case the new dag is dropped.
+class job_cache
+{
+private:
+    friend auto graph_to_dag(
+            graph const&,
+            processor_timings*,
+            std::size_t tile_size,
+            job_cache*) -> dag;
+
+    struct entries;
+    std::shared_ptr<entries const> m_entries;
+};
+
+//! If timings are passed, the execution time of each processor is measured
+//! and the current estimates are set as costs of the dag tasks.
+//! A tile size other than zero processes runs of block splittable processors
+//! in linear chains in tiles of that size. It must be a multiple of the simd
+//! vector size.
+//! If a cache is passed, the jobs, output buffers and fused chains of the
+//! unchanged part of the graph are reused from it, and it's updated with the
+//! jobs of the new dag. The processors of the cached jobs must still be
+//! alive, so no other processor can have the address of one of them.
+auto graph_to_dag(
+        graph const&,
+        processor_timings* = nullptr,
+        std::size_t tile_size = 0,
+        job_cache* = nullptr) -> dag;
 
 } // namespace piejam::audio::engine
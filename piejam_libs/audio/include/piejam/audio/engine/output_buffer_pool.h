@@ -0,0 +1,76 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/audio/engine/fwd.h>
+#include <piejam/audio/engine/graph_endpoint.h>
+#include <piejam/audio/period_size.h>
+
+#include <mipp.h>
+
+#include <array>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <span>
+
+namespace piejam::audio::engine
+{
+
+//! Output buffers of the processors of a graph, stored in a shared and
+//! aligned arena. Outputs share a slot, if their lifetimes can't overlap in
+//! any execution order of the graph. The lifetime of an output ends, when
+//! all processors which might see it have run. Results of a processor might
+//! refer to its inputs, so it also lasts through its consumers. Processors
+//! capable of it, write their output into the slot of an input, if that input
+//! has no other consumer.
+class output_buffer_pool
+{
+public:
+    using buffer_t = std::array<float, max_period_size.get()>;
+
+    //! The buffers don't move, when the arena grows.
+    using buffers_t = std::deque<buffer_t, mipp::allocator<buffer_t>>;
+
+    explicit output_buffer_pool(graph const&);
+
+    //! Shares the arena with the previous pool. Outputs keep their slot from
+    //! it, as long as their lifetime doesn't overlap with the other outputs
+    //! in it. New outputs don't take slots, which are still to be kept.
+    output_buffer_pool(graph const&, output_buffer_pool const& previous);
+
+    [[nodiscard]] auto num_slots() const noexcept -> std::size_t
+    {
+        return m_buffers->size();
+    }
+
+    //! Slot assigned to the output of a processor of the graph.
+    [[nodiscard]] auto slot(graph_endpoint const& src) const -> std::size_t;
+
+    [[nodiscard]] auto buffer(graph_endpoint const& src) -> std::span<float>;
+
+    //! True, if the output has the same buffer as in the previous pool.
+    [[nodiscard]] auto kept(graph_endpoint const& src) const -> bool;
+
+    //! Keeps the buffers alive, for the jobs referring to them.
+    [[nodiscard]] auto buffers() const noexcept
+            -> std::shared_ptr<buffers_t const>
+    {
+        return m_buffers;
+    }
+
+private:
+    output_buffer_pool(
+            graph const&,
+            std::shared_ptr<buffers_t>,
+            output_buffer_pool const* previous);
+
+    std::map<graph_endpoint, std::size_t> m_slots;
+    std::set<graph_endpoint> m_kept;
+    std::shared_ptr<buffers_t> m_buffers;
+};
+
+} // namespace piejam::audio::engine
@@ -4,9 +4,12 @@
 
 #pragma once
 
+#include <piejam/audio/engine/gain_ramp.h>
 #include <piejam/audio/engine/named_processor.h>
 #include <piejam/audio/pcm_buffer_converter.h>
+#include <piejam/audio/period_size.h>
 
+#include <array>
 #include <span>
 #include <vector>
 
@@ -23,6 +26,14 @@ public:
         m_engine_output = engine_output;
     }
 
+    //! The gain is applied to the input, before it is written to the
+    //! engine output. It is read in each period, so it can be changed
+    //! between periods by the processing thread.
+    void set_gain(gain_ramp const& gain) noexcept
+    {
+        m_gain = &gain;
+    }
+
     [[nodiscard]] auto type_name() const noexcept -> std::string_view override
     {
         return "output";
@@ -52,6 +63,8 @@ public:
 
 private:
     pcm_output_buffer_converter m_engine_output;
+    gain_ramp const* m_gain{};
+    std::array<float, max_period_size.get()> m_gain_buffer{};
 };
 
 } // namespace piejam::audio::engine
@@ -4,11 +4,19 @@
 
 #pragma once
 
+#include <piejam/audio/engine/gain_ramp.h>
 #include <piejam/audio/engine/graph.h>
 
+#include <boost/assert.hpp>
+
 #include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <future>
+#include <limits>
 #include <memory>
+#include <span>
+#include <vector>
 
 namespace piejam::audio::engine
 {
@@ -16,17 +24,60 @@ namespace piejam::audio::engine
 class process
 {
 public:
-    process();
+    explicit process(std::size_t num_outputs = 0);
     ~process();
 
-    [[nodiscard]] bool swap_executor(std::unique_ptr<dag_executor>);
+    //! Swaps to the next executor at a period boundary. With fade periods,
+    //! the current executor is faded out over them before the swap, and the
+    //! next one is faded in over them after it. The fade is applied to the
+    //! gain of the faded outputs.
+    [[nodiscard]] bool swap_executor(
+            std::unique_ptr<dag_executor>,
+            std::size_t fade_periods = 0,
+            std::span<std::size_t const> faded_outputs = {});
+
+    //! Limits the number of worker threads the executor wakes up.
+    void set_num_workers(std::size_t) noexcept;
 
+    //! With a buffer size of zero, a pending executor is swapped in right
+    //! away, without fading and without running it.
     void operator()(std::size_t buffer_size) noexcept;
 
+    //! Time the threads of the executor spent waiting, since the previous
+    //! call. Called from the processing thread.
+    [[nodiscard]] auto take_idle_time() noexcept -> std::chrono::nanoseconds;
+
+    //! Gain of the fade in the current period.
+    [[nodiscard]] auto output_gain() const noexcept -> gain_ramp const&
+    {
+        return m_output_gain;
+    }
+
+    //! Gain of an output in the current period, to be applied by its output
+    //! processor. Unity, unless the output is faded.
+    [[nodiscard]] auto output_gain(std::size_t output) const noexcept
+            -> gain_ramp const&
+    {
+        BOOST_ASSERT(output < m_output_gains.size());
+        return m_output_gains[output];
+    }
+
 private:
+    void swap_in_next_executor() noexcept;
+
     std::unique_ptr<dag_executor> m_executor;
 
+    // only accessed from the processing thread
+    std::size_t m_faded_periods{};
+    gain_ramp m_output_gain{};
+    std::vector<bool> m_faded_outputs;
+    std::vector<gain_ramp> m_output_gains;
+
+    std::atomic_size_t m_num_workers{std::numeric_limits<std::size_t>::max()};
+
     std::atomic<dag_executor*> m_next_executor{};
+    std::atomic_size_t m_fade_periods{};
+    std::vector<std::atomic_bool> m_next_faded_outputs;
     std::promise<std::unique_ptr<dag_executor>> m_prev_executor{};
 };
 
@@ -6,6 +6,7 @@
 
 #include <piejam/audio/engine/fwd.h>
 
+#include <optional>
 #include <span>
 #include <string_view>
 
@@ -30,6 +31,40 @@ public:
     [[nodiscard]] virtual auto event_outputs() const noexcept
             -> event_ports = 0;
 
+    //! Whether results might refer to the inputs, instead of the outputs or
+    //! constants. Determines how long output buffers are in use.
+    [[nodiscard]] virtual auto results_may_alias_inputs() const noexcept
+            -> bool
+    {
+        return num_inputs() != 0;
+    }
+
+    //! Input, whose buffer the output may be written to. The processor must
+    //! cope with the input and the output referring to the same memory.
+    [[nodiscard]] virtual auto in_place_input(std::size_t /*output*/)
+            const noexcept -> std::optional<std::size_t>
+    {
+        return std::nullopt;
+    }
+
+    //! Number of frames until the outputs become silent, after the inputs
+    //! became silent. Once the inputs have been silent longer than that, the
+    //! processor isn't called anymore and its outputs are silent, until
+    //! there is input or an event again. Without a tail length the processor
+    //! is always called.
+    [[nodiscard]] virtual auto tail_length() const noexcept
+            -> std::optional<std::size_t>
+    {
+        return std::nullopt;
+    }
+
+    //! Whether processing consecutive parts of a period gives the same
+    //! result as processing the whole period at once.
+    [[nodiscard]] virtual auto block_splittable() const noexcept -> bool
+    {
+        return false;
+    }
+
     virtual void process(process_context const&) = 0;
 };
 
@@ -8,27 +8,31 @@
 #include <piejam/audio/engine/event_input_buffers.h>
 #include <piejam/audio/engine/event_output_buffers.h>
 #include <piejam/audio/engine/process_context.h>
-#include <piejam/audio/period_size.h>
 
-#include <mipp.h>
-
-#include <array>
 #include <functional>
+#include <memory>
 #include <span>
 #include <vector>
 
 namespace piejam::audio::engine
 {
 
+class output_buffer_pool;
 class processor;
 class thread_context;
 
 class processor_job final
 {
 public:
-    using output_buffer_t = std::array<float, max_period_size.get()>;
+    processor_job(processor& proc, output_buffer_pool& output_buffers);
 
-    processor_job(processor& proc);
+    //! Takes over the results and event outputs of the previous job of the
+    //! processor, so the jobs connected to them stay connected. The previous
+    //! job must not run anymore, when this one runs.
+    processor_job(
+            processor& proc,
+            output_buffer_pool& output_buffers,
+            processor_job const& previous);
 
     auto result_ref(std::size_t index) const -> audio_slice const&;
     void connect_result(std::size_t index, audio_slice const& res);
@@ -42,18 +46,66 @@ public:
 
     void operator()(thread_context const&);
 
+    //! Block splittable processors without event ports can be processed in
+    //! parts of the period.
+    [[nodiscard]] auto splittable() const noexcept -> bool;
+
+    //! Processes [offset, offset + size) of the period. The results refer to
+    //! the whole period, so consumers can process the same part afterwards.
+    void process_tile(
+            thread_context const&,
+            std::size_t offset,
+            std::size_t size);
+
 private:
+    struct results
+    {
+        explicit results(processor const&);
+
+        std::vector<audio_slice> audio;
+        event_output_buffers events;
+    };
+
+    processor_job(
+            processor& proc,
+            output_buffer_pool& output_buffers,
+            std::shared_ptr<results>);
+
+    [[nodiscard]] auto silent_inputs() const noexcept -> bool;
+
+    //! Returns true, if the processor is bypassed for this period.
+    auto bypass_on_silence(std::size_t buffer_size) -> bool;
+
+    //! Records the execution, if the thread is tracing.
+    void process_traced(thread_context const&, process_context const&);
+
+    void merge_tile_result(
+            std::size_t index,
+            std::span<float> period_output,
+            std::size_t offset);
+
     processor& m_proc;
-    mipp::vector<output_buffer_t> m_output_buffers;
+
+    //! Shared with the next job of the processor.
+    std::shared_ptr<results> m_shared_results;
 
     std::vector<std::reference_wrapper<audio_slice const>> m_inputs;
     std::vector<std::span<float>> m_outputs;
-    std::vector<audio_slice> m_results;
+    std::span<audio_slice> m_results;
 
     event_input_buffers m_event_inputs;
-    event_output_buffers m_event_outputs;
+    event_output_buffers& m_event_outputs;
 
     process_context m_process_context;
+
+    //! Frames the inputs have been silent, before the current period.
+    std::size_t m_silent_frames{};
+
+    std::vector<audio_slice> m_tile_input_slices;
+    std::vector<std::reference_wrapper<audio_slice const>> m_tile_inputs;
+    std::vector<std::span<float>> m_tile_outputs;
+    std::vector<audio_slice> m_tile_results;
+    process_context m_tile_context;
 };
 
 } // namespace piejam::audio::engine
@@ -0,0 +1,82 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/audio/engine/fwd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+
+namespace piejam::audio::engine
+{
+
+//! Measured execution times of processors. They outlive the dags and serve
+//! as cost estimates, when scheduling the next dag, and as statistics about
+//! the processing costs.
+class processor_timings
+{
+public:
+    using duration = std::chrono::nanoseconds;
+
+    //! Execution times since the statistics were taken the last time. The
+    //! p99 is the upper bound of its histogram bucket, precise to 1/4 of an
+    //! octave.
+    struct statistics
+    {
+        duration mean{};
+        duration p99{};
+        duration max{};
+        std::size_t count{};
+    };
+
+    //! Running average and histogram of the execution time of a single
+    //! processor. Updated from the audio threads.
+    class timing
+    {
+    public:
+        void update(duration d) noexcept;
+
+        [[nodiscard]] auto estimate() const noexcept -> duration
+        {
+            return duration{m_estimate.load(std::memory_order_relaxed)};
+        }
+
+        //! Takes the statistics and starts a new window. Called from a non
+        //! audio thread.
+        auto take_statistics() noexcept -> statistics;
+
+    private:
+        static constexpr std::size_t num_buckets = 128;
+
+        std::atomic<duration::rep> m_estimate{};
+        std::atomic<duration::rep> m_sum{};
+        std::atomic<duration::rep> m_max{};
+        std::array<std::atomic_uint32_t, num_buckets> m_histogram{};
+
+        static_assert(std::atomic<duration::rep>::is_always_lock_free);
+        static_assert(std::atomic_uint32_t::is_always_lock_free);
+    };
+
+    //! Returns the timing of the processor, creates it if necessary. The
+    //! reference stays valid until the timing is removed by `retain`.
+    auto operator[](processor const&) -> timing&;
+
+    [[nodiscard]] auto estimate(processor const&) const -> duration;
+
+    //! Statistics of the processor, empty if it has no timing.
+    auto take_statistics(processor const&) -> statistics;
+
+    //! Removes the timings of processors, which are not part of the graph.
+    //! Must not be called, while a dag using those timings is running.
+    void retain(graph const&);
+
+private:
+    std::map<processor const*, std::unique_ptr<timing>> m_timings;
+};
+
+} // namespace piejam::audio::engine
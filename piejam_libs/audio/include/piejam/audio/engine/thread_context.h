@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <piejam/audio/engine/fwd.h>
+
 #include <memory_resource>
 
 namespace piejam::audio::engine
@@ -13,6 +15,9 @@ struct thread_context
 {
     std::pmr::memory_resource* event_memory{std::pmr::get_default_resource()};
     std::size_t buffer_size{};
+
+    //! Set while tracing, processors record their execution into it.
+    trace_ring* trace{};
 };
 
 } // namespace piejam::audio::engine
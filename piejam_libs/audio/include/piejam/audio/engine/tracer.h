@@ -0,0 +1,122 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/audio/engine/fwd.h>
+#include <piejam/thread/cache_line_size.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace piejam::audio::engine
+{
+
+struct trace_event
+{
+    using clock_t = std::chrono::steady_clock;
+
+    static constexpr std::size_t max_name_length = 31;
+
+    //! Null-terminated, longer names are truncated.
+    std::array<char, max_name_length + 1> name{};
+    clock_t::time_point begin;
+    clock_t::time_point end;
+};
+
+//! Lock-free single producer, single consumer ring of trace events. The
+//! events are preallocated, recording doesn't allocate. When full, new
+//! events are dropped.
+class trace_ring
+{
+    static_assert(std::atomic_size_t::is_always_lock_free);
+
+public:
+    explicit trace_ring(std::size_t capacity);
+
+    //! Called from the producing (audio) thread.
+    auto record(
+            std::string_view name,
+            trace_event::clock_t::time_point begin,
+            trace_event::clock_t::time_point end) noexcept -> bool;
+
+    //! Called from the consuming thread.
+    template <std::invocable<trace_event const&> F>
+    void consume(F&& f)
+    {
+        std::size_t read = m_read.load(std::memory_order_relaxed);
+        std::size_t const write = m_write.load(std::memory_order_acquire);
+
+        for (; read != write; ++read)
+        {
+            std::invoke(f, m_events[read % m_events.size()]);
+        }
+
+        m_read.store(read, std::memory_order_release);
+    }
+
+    //! Number of events dropped, since the ring was full.
+    [[nodiscard]] auto dropped() const noexcept -> std::size_t
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::vector<trace_event> m_events;
+    alignas(thread::cache_line_size) std::atomic_size_t m_write{};
+    alignas(thread::cache_line_size) std::atomic_size_t m_read{};
+    std::atomic_size_t m_dropped{};
+};
+
+//! Opt-in tracing of the processor execution. Each thread taking part in
+//! processing a dag records into its own ring. Index 0 is the thread calling
+//! the dag executor, the following ones are the worker threads. While
+//! tracing, the rings have to be drained periodically into growable
+//! buffers, otherwise they run full and new events are dropped.
+class tracer
+{
+public:
+    explicit tracer(std::size_t num_threads, std::size_t ring_capacity = 8192);
+    ~tracer();
+
+    [[nodiscard]] auto enabled() const noexcept -> bool
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    void set_enabled(bool) noexcept;
+
+    //! Ring to record into, nullptr while tracing is disabled.
+    [[nodiscard]] auto active_ring(std::size_t thread_index) const noexcept
+            -> trace_ring*;
+
+    //! Moves the recorded events out of the rings. Must not be called from
+    //! an audio thread.
+    void drain();
+
+    //! Drains the rings and writes the events, which were drained since the
+    //! last write, in the Chrome trace event format. It can also be loaded
+    //! into Perfetto. The number of events dropped in the meantime is
+    //! written as well. Must not be called from an audio thread.
+    void write_chrome_trace(std::ostream&);
+
+private:
+    void drain_locked();
+
+    std::vector<std::unique_ptr<trace_ring>> m_rings;
+    std::vector<std::vector<trace_event>> m_drained;
+    std::size_t m_reported_dropped{};
+    std::atomic_bool m_enabled{};
+    std::mutex m_drain_mutex;
+};
+
+} // namespace piejam::audio::engine
@@ -14,6 +14,7 @@ enum class pcm_format : unsigned;
 
 class device;
 class device_manager;
+class period_history;
 class process_thread;
 
 struct pcm_descriptor;
@@ -22,6 +23,7 @@ struct pcm_hw_params;
 struct pcm_io_descriptors;
 struct pcm_process_config;
 struct pcm_io_config;
+struct pcm_secondary_config;
 
 template <class T>
 struct pair;
@@ -8,7 +8,11 @@
 
 #include <boost/circular_buffer.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <functional>
+#include <iterator>
+#include <numeric>
 
 namespace piejam::audio
 {
@@ -42,6 +46,45 @@ public:
         m_squared_history.push_back(sq);
     }
 
+    //! Same as pushing back count times x, without the per sample loop.
+    void append(float const x, std::size_t const count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        auto const abs_x = std::abs(x);
+        m_peak_level = abs_x >= m_peak_level
+                               ? abs_x
+                               : abs_x + std::pow(
+                                                 m_g_release,
+                                                 static_cast<float>(count)) *
+                                                 (m_peak_level - abs_x);
+
+        double const xl = x;
+        double const sq = xl * xl;
+        if (count >= m_squared_history.size())
+        {
+            std::ranges::fill(m_squared_history, sq);
+            m_squared_sum =
+                    static_cast<double>(m_squared_history.size()) * sq;
+        }
+        else
+        {
+            m_squared_sum = std::accumulate(
+                    m_squared_history.begin(),
+                    std::next(
+                            m_squared_history.begin(),
+                            static_cast<std::ptrdiff_t>(count)),
+                    m_squared_sum,
+                    std::minus<>{});
+            m_squared_sum += static_cast<double>(count) * sq;
+            m_squared_history.erase_begin(count);
+            m_squared_history.insert(m_squared_history.end(), count, sq);
+        }
+    }
+
     [[nodiscard]] auto peak_level() const noexcept -> float
     {
         return m_peak_level;
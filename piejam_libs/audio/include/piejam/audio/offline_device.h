@@ -0,0 +1,115 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/audio/device.h>
+#include <piejam/audio/pcm_buffer_converter.h>
+#include <piejam/audio/pcm_io_config.h>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace piejam::audio
+{
+
+//! Fills the input channels with the next frames.
+using offline_source = std::function<void(std::span<std::span<float> const>)>;
+
+//! Receives the next frames of the output channels.
+using offline_sink =
+        std::function<void(std::span<std::span<float const> const>)>;
+
+//! Device without hardware, which is driven by calls to render. The process
+//! function runs on the calling thread, as fast as it can, without any
+//! pacing. Suited for bouncing sessions, rendering test fixtures and
+//! benchmarking the engine without a sound card.
+//!
+//! While started and not rendering, the process function is called with a
+//! buffer size of zero on an own thread. This way the engine keeps picking
+//! up rebuilt graphs, without processing anything between renders, so the
+//! rendered output doesn't depend on the time between the renders.
+//!
+//! The channels of secondary devices are simply offline channels as well.
+class offline_device final : public device
+{
+public:
+    offline_device(pcm_io_config const&, offline_source, offline_sink);
+
+    [[nodiscard]] auto is_open() const noexcept -> bool override
+    {
+        return m_open;
+    }
+
+    void close() override;
+
+    [[nodiscard]] auto is_running() const noexcept -> bool override
+    {
+        return static_cast<bool>(m_process_function);
+    }
+
+    //! The thread configuration isn't applied.
+    void
+    start(thread::configuration const&,
+          init_process_function const&,
+          process_function) override;
+
+    void stop() override;
+
+    [[nodiscard]] auto is_realtime() const noexcept -> bool override
+    {
+        return false;
+    }
+
+    //! Ratio of the processing time to the duration of the rendered frames,
+    //! values below one are faster than real time.
+    [[nodiscard]] auto cpu_load() const noexcept -> float override
+    {
+        return m_cpu_load.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] auto xruns() const noexcept -> std::size_t override
+    {
+        return 0;
+    }
+
+    //! Renders the frames in periods. The last period is passed partially
+    //! to the sink, if the frames are not a multiple of the period size.
+    void render(std::size_t num_frames);
+
+    [[nodiscard]] auto rendered_frames() const noexcept -> std::size_t
+    {
+        return m_rendered_frames;
+    }
+
+private:
+    void process_period();
+
+    pcm_process_config m_process_config;
+    offline_source m_source;
+    offline_sink m_sink;
+
+    std::vector<float> m_input;
+    std::vector<std::span<float>> m_input_channels;
+    std::vector<pcm_input_buffer_converter> m_input_converter;
+
+    std::vector<float> m_output;
+    std::vector<std::span<float const>> m_output_channels;
+    std::vector<pcm_output_source_buffer_t> m_output_sources;
+    std::vector<pcm_output_buffer_converter> m_output_converter;
+
+    process_function m_process_function;
+    bool m_open{true};
+    std::size_t m_rendered_frames{};
+    std::atomic<float> m_cpu_load{};
+
+    std::mutex m_mutex;
+    std::jthread m_handover_thread;
+};
+
+} // namespace piejam::audio
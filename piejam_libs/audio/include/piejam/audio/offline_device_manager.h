@@ -0,0 +1,55 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/audio/device_manager.h>
+#include <piejam/audio/offline_device.h>
+#include <piejam/audio/period_size.h>
+#include <piejam/audio/sample_rate.h>
+
+namespace piejam::audio
+{
+
+//! Offers one offline input and one offline output device, to run the
+//! runtime without any sound card.
+class offline_device_manager final : public device_manager
+{
+public:
+    offline_device_manager(
+            unsigned num_input_channels,
+            unsigned num_output_channels,
+            sample_rate,
+            period_size,
+            offline_source,
+            offline_sink);
+
+    auto io_descriptors() -> pcm_io_descriptors override;
+
+    auto
+    hw_params(pcm_descriptor const&, sample_rate const*, period_size const*)
+            -> pcm_hw_params override;
+
+    auto make_device(
+            pcm_descriptor const& in,
+            pcm_descriptor const& out,
+            pcm_io_config const&) -> std::unique_ptr<device> override;
+
+    //! The device made last, it is owned by the caller of make_device.
+    [[nodiscard]] auto last_device() const noexcept -> offline_device*
+    {
+        return m_device;
+    }
+
+private:
+    unsigned m_num_input_channels;
+    unsigned m_num_output_channels;
+    sample_rate m_sample_rate;
+    period_size m_period_size;
+    offline_source m_source;
+    offline_sink m_sink;
+    offline_device* m_device{};
+};
+
+} // namespace piejam::audio
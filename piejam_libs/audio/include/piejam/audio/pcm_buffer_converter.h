@@ -11,8 +11,10 @@
 namespace piejam::audio
 {
 
-// from pcm to target
-using pcm_input_buffer_converter = std::function<void(std::span<float>)>;
+// from pcm to target, returns the converted samples, which are either in
+// the target or in a buffer of the pcm, valid until its next transfer
+using pcm_input_buffer_converter =
+        std::function<std::span<float const>(std::span<float>)>;
 
 // from source to pcm
 using pcm_output_source_buffer_t = std::variant<float, std::span<float const>>;
@@ -0,0 +1,228 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/audio/pcm_buffer_converter.h>
+#include <piejam/audio/pcm_convert.h>
+#include <piejam/audio/pcm_sample_type.h>
+#include <piejam/audio/simd.h>
+
+#include <mipp.h>
+
+#include <boost/assert.hpp>
+#include <boost/hof/match.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <variant>
+
+namespace piejam::audio::pcm_convert
+{
+
+namespace detail
+{
+
+//! Samples converted per pass, the scratch buffers stay in the L1 cache.
+inline constexpr std::size_t interleaved_chunk_size = 256;
+
+template <class T>
+using interleaved_chunk_t = std::array<T, interleaved_chunk_size>;
+
+//! Converts a contiguous run of samples into floats. The samples are widened
+//! to native int32 first, which the compiler can vectorize for the byte
+//! aligned formats. The int to float conversion and scaling is done with
+//! SIMD, the remainder falls back to the scalar conversion.
+template <pcm_format F>
+void
+to_float(std::span<pcm_sample_t<F> const> const in, float* const out)
+{
+    using desc_t = pcm_sample_descriptor_t<F>;
+    using signed_t = typename desc_t::signed_value_type;
+
+    BOOST_ASSERT(in.size() <= interleaved_chunk_size);
+    BOOST_ASSERT(simd::is_aligned(out));
+
+    alignas(mipp::RequiredAlignment) interleaved_chunk_t<std::int32_t> ints;
+    std::ranges::transform(in, ints.begin(), [](pcm_sample_t<F> const x) {
+        return static_cast<std::int32_t>(
+                numeric::intops::sign_map<signed_t>(endian_to_native<F>(x)));
+    });
+
+    // fscale is a power of two, multiplying with its reciprocal is exact
+    constexpr auto step = mipp::N<float>();
+    static_assert(mipp::N<std::int32_t>() == step);
+    std::size_t const simd_size = in.size() - in.size() % step;
+    mipp::Reg<float> const scale(static_cast<float>(1. / desc_t::fscale));
+
+    for (std::size_t i = 0; i < simd_size; i += step)
+    {
+        mipp::Reg<float> const reg_out =
+                mipp::cvt<std::int32_t, float>(
+                        mipp::Reg<std::int32_t>(ints.data() + i)) *
+                scale;
+        reg_out.store(out + i);
+    }
+
+    std::transform(
+            in.begin() + simd_size,
+            in.end(),
+            out + simd_size,
+            &from<F>);
+}
+
+//! Converts a contiguous run of floats into samples. Formats converted
+//! through single precision are clamped, scaled and truncated with SIMD,
+//! the 32 bit formats need double precision and use the scalar conversion.
+template <pcm_format F>
+void
+from_float(float const* const in, std::span<pcm_sample_t<F>> const out)
+{
+    using desc_t = pcm_sample_descriptor_t<F>;
+    using signed_t = typename desc_t::signed_value_type;
+
+    BOOST_ASSERT(out.size() <= interleaved_chunk_size);
+    BOOST_ASSERT(simd::is_aligned(in));
+
+    std::size_t simd_size{};
+
+    if constexpr (std::is_same_v<typename desc_t::float_t, float>)
+    {
+        constexpr auto step = mipp::N<float>();
+        simd_size = out.size() - out.size() % step;
+
+        mipp::Reg<float> const lo(desc_t::fmin);
+        mipp::Reg<float> const hi(desc_t::fmax);
+        mipp::Reg<float> const scale(desc_t::fscale);
+
+        alignas(mipp::RequiredAlignment) interleaved_chunk_t<std::int32_t> ints;
+
+        for (std::size_t i = 0; i < simd_size; i += step)
+        {
+            mipp::Reg<std::int32_t> const reg_out =
+                    mipp::cvt<float, std::int32_t>(mipp::trunc(
+                            simd::clamp(mipp::Reg<float>(in + i), lo, hi) *
+                            scale));
+            reg_out.store(ints.data() + i);
+        }
+
+        std::transform(
+                ints.begin(),
+                ints.begin() + simd_size,
+                out.begin(),
+                [](std::int32_t const x) {
+                    return endian_to_format<F>(
+                            numeric::intops::sign_map<pcm_sample_t<F>>(
+                                    static_cast<signed_t>(x)));
+                });
+    }
+
+    std::transform(
+            in + simd_size,
+            in + out.size(),
+            out.begin() + simd_size,
+            &to<F>);
+}
+
+} // namespace detail
+
+//! Converts all channels of an interleaved period in a single pass over it.
+template <pcm_format F>
+void
+from_interleaved(
+        std::span<pcm_sample_t<F> const> const interleaved,
+        std::span<std::span<float> const> const channels)
+{
+    std::size_t const num_channels = channels.size();
+    BOOST_ASSERT(num_channels > 0);
+    BOOST_ASSERT(num_channels <= detail::interleaved_chunk_size);
+    BOOST_ASSERT(interleaved.size() % num_channels == 0);
+
+    std::size_t const num_frames = interleaved.size() / num_channels;
+    std::size_t const chunk_frames =
+            detail::interleaved_chunk_size / num_channels;
+
+    alignas(mipp::RequiredAlignment) detail::interleaved_chunk_t<float> chunk;
+
+    for (std::size_t frame = 0; frame < num_frames; frame += chunk_frames)
+    {
+        std::size_t const frames = std::min(chunk_frames, num_frames - frame);
+
+        detail::to_float<F>(
+                interleaved.subspan(
+                        frame * num_channels,
+                        frames * num_channels),
+                chunk.data());
+
+        for (std::size_t channel = 0; channel < num_channels; ++channel)
+        {
+            BOOST_ASSERT(channels[channel].size() == num_frames);
+
+            float* const out = channels[channel].data() + frame;
+            for (std::size_t i = 0; i < frames; ++i)
+            {
+                out[i] = chunk[i * num_channels + channel];
+            }
+        }
+    }
+}
+
+//! Converts all channels into an interleaved period in a single pass over it.
+template <pcm_format F>
+void
+to_interleaved(
+        std::span<pcm_output_source_buffer_t const> const channels,
+        std::span<pcm_sample_t<F>> const interleaved)
+{
+    std::size_t const num_channels = channels.size();
+    BOOST_ASSERT(num_channels > 0);
+    BOOST_ASSERT(num_channels <= detail::interleaved_chunk_size);
+    BOOST_ASSERT(interleaved.size() % num_channels == 0);
+
+    std::size_t const num_frames = interleaved.size() / num_channels;
+    std::size_t const chunk_frames =
+            detail::interleaved_chunk_size / num_channels;
+
+    alignas(mipp::RequiredAlignment) detail::interleaved_chunk_t<float> chunk;
+
+    for (std::size_t frame = 0; frame < num_frames; frame += chunk_frames)
+    {
+        std::size_t const frames = std::min(chunk_frames, num_frames - frame);
+
+        for (std::size_t channel = 0; channel < num_channels; ++channel)
+        {
+            float* const out = chunk.data() + channel;
+
+            std::visit(
+                    boost::hof::match(
+                            [&](float const constant) {
+                                for (std::size_t i = 0; i < frames; ++i)
+                                {
+                                    out[i * num_channels] = constant;
+                                }
+                            },
+                            [&](std::span<float const> const buffer) {
+                                BOOST_ASSERT(buffer.size() == num_frames);
+
+                                float const* const in = buffer.data() + frame;
+                                for (std::size_t i = 0; i < frames; ++i)
+                                {
+                                    out[i * num_channels] = in[i];
+                                }
+                            }),
+                    channels[channel]);
+        }
+
+        detail::from_float<F>(
+                chunk.data(),
+                interleaved.subspan(
+                        frame * num_channels,
+                        frames * num_channels));
+    }
+}
+
+} // namespace piejam::audio::pcm_convert
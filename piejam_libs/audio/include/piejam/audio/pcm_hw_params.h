@@ -16,6 +16,7 @@ enum class pcm_format : unsigned;
 struct pcm_hw_params
 {
     bool interleaved{};
+    bool mmap{};
     pcm_format format{};
     unsigned num_channels{};
     sample_rates_t sample_rates;
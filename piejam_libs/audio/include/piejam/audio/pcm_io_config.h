@@ -4,10 +4,15 @@
 
 #pragma once
 
+#include <piejam/audio/pcm_descriptor.h>
 #include <piejam/audio/period_count.h>
 #include <piejam/audio/period_size.h>
 #include <piejam/audio/sample_rate.h>
 
+#include <numeric>
+#include <span>
+#include <vector>
+
 namespace piejam::audio
 {
 
@@ -16,6 +21,7 @@ enum class pcm_format : unsigned;
 struct pcm_device_config
 {
     bool interleaved{};
+    bool mmap{};
     pcm_format format{};
     unsigned num_channels{};
 };
@@ -27,11 +33,52 @@ struct pcm_process_config
     audio::period_count period_count{};
 };
 
+//! Device running on an own clock, aggregated into the io of the main
+//! devices. Its channels are appended to the ones of the main device, the
+//! clock drift is compensated by adaptive resampling.
+struct pcm_secondary_config
+{
+    pcm_descriptor descriptor;
+    pcm_device_config device_config;
+};
+
+//! Channels of a main device and the secondaries aggregated into it.
+[[nodiscard]] inline auto
+aggregate_num_channels(
+        unsigned const main_num_channels,
+        std::span<pcm_secondary_config const> const secondaries) noexcept
+        -> unsigned
+{
+    return std::accumulate(
+            secondaries.begin(),
+            secondaries.end(),
+            main_num_channels,
+            [](unsigned const num_channels,
+               pcm_secondary_config const& secondary) {
+                return num_channels + secondary.device_config.num_channels;
+            });
+}
+
 struct pcm_io_config
 {
     pcm_device_config in_config;
     pcm_device_config out_config;
     pcm_process_config process_config;
+    std::vector<pcm_secondary_config> in_secondaries{};
+    std::vector<pcm_secondary_config> out_secondaries{};
+
+    //! The aggregate is processed like a single device with these channels.
+    [[nodiscard]] auto num_input_channels() const noexcept -> unsigned
+    {
+        return aggregate_num_channels(in_config.num_channels, in_secondaries);
+    }
+
+    [[nodiscard]] auto num_output_channels() const noexcept -> unsigned
+    {
+        return aggregate_num_channels(
+                out_config.num_channels,
+                out_secondaries);
+    }
 };
 
 } // namespace piejam::audio
@@ -0,0 +1,86 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace piejam::audio
+{
+
+//! Timings of a single period of the process thread.
+struct period_record
+{
+    using duration = std::chrono::nanoseconds;
+
+    //! Sequence number of the period.
+    std::size_t period{};
+
+    //! From the hw pointer crossing the end of the period, to the process
+    //! thread having acquired the period. Zero, if the device has no hw
+    //! timestamps.
+    duration wakeup_latency{};
+
+    //! Reading the period, including the time blocked waiting for it. Close
+    //! to zero, if the thread was already behind.
+    duration read{};
+
+    duration process{};
+    duration write{};
+
+    //! Summed over all threads taking part in processing the period.
+    duration worker_idle{};
+
+    bool xrun{};
+};
+
+//! Keeps the records of the last periods. When an xrun happens, the periods
+//! around it are captured, to tell scheduling latency apart from processing
+//! overload. Recording is done on the process thread and neither allocates
+//! nor blocks, the captures are taken from a non-realtime thread.
+class period_history
+{
+public:
+    explicit period_history(
+            std::size_t periods_before = 32,
+            std::size_t periods_after = 4);
+
+    //! Called from the process thread, while processing a period.
+    void add_worker_idle(period_record::duration) noexcept;
+
+    //! Called from the process thread, at the end of each period. The
+    //! sequence number and the worker idle time are assigned here.
+    void record(period_record) noexcept;
+
+    //! Periods around the last captured xrun, empty if there was none since
+    //! the last call. Called from a non-realtime thread.
+    [[nodiscard]] auto take_capture() -> std::vector<period_record>;
+
+    //! Xruns, which couldn't be captured, since the previous capture wasn't
+    //! taken yet.
+    [[nodiscard]] auto missed_captures() const noexcept -> std::size_t
+    {
+        return m_missed_captures.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::size_t m_periods_after;
+
+    // process thread only
+    std::vector<period_record> m_ring;
+    std::size_t m_next_period{};
+    period_record::duration m_worker_idle{};
+    std::optional<std::size_t> m_capture_end;
+
+    std::vector<period_record> m_capture;
+    std::size_t m_capture_size{};
+    std::atomic_bool m_capture_ready{};
+    std::atomic_size_t m_missed_captures{};
+};
+
+} // namespace piejam::audio
@@ -16,6 +16,8 @@ using init_process_function = std::function<void(
         std::span<pcm_input_buffer_converter const>,
         std::span<pcm_output_buffer_converter const>)>;
 
+//! Processes a period of the given size. Called with a size of zero, only
+//! pending changes of the processing are picked up.
 using process_function = std::function<void(std::size_t /*buffer_size*/)>;
 
 } // namespace piejam::audio
@@ -243,19 +243,35 @@ get_hw_params(
         throw std::system_error(err);
     }
 
-    result.interleaved =
-            test_mask_bit(
-                    hw_params,
-                    SNDRV_PCM_HW_PARAM_ACCESS,
-                    SNDRV_PCM_ACCESS_RW_NONINTERLEAVED)
-                    ? false
-            : test_mask_bit(
-                      hw_params,
-                      SNDRV_PCM_HW_PARAM_ACCESS,
-                      SNDRV_PCM_ACCESS_RW_INTERLEAVED)
-                    ? true
-                    : throw std::runtime_error(
-                              "rw access not supported, only mmap?");
+    // mmap saves a copy per period, prefer it
+    auto const access = [&hw_params](unsigned const bit) {
+        return test_mask_bit(hw_params, SNDRV_PCM_HW_PARAM_ACCESS, bit);
+    };
+
+    if (access(SNDRV_PCM_ACCESS_MMAP_INTERLEAVED))
+    {
+        result.interleaved = true;
+        result.mmap = true;
+    }
+    else if (access(SNDRV_PCM_ACCESS_RW_NONINTERLEAVED))
+    {
+        result.interleaved = false;
+        result.mmap = false;
+    }
+    else if (access(SNDRV_PCM_ACCESS_RW_INTERLEAVED))
+    {
+        result.interleaved = true;
+        result.mmap = false;
+    }
+    else if (access(SNDRV_PCM_ACCESS_MMAP_NONINTERLEAVED))
+    {
+        result.interleaved = false;
+        result.mmap = true;
+    }
+    else
+    {
+        throw std::runtime_error("no supported access type");
+    }
 
     static constexpr std::array preferred_formats{
             SNDRV_PCM_FORMAT_S32_LE,
@@ -339,10 +355,15 @@ set_hw_params(
 
     hw_params.cmask = 0;
 
-    unsigned const interleaved_bit =
-            device_config.interleaved ? SNDRV_PCM_ACCESS_RW_INTERLEAVED
-                                      : SNDRV_PCM_ACCESS_RW_NONINTERLEAVED;
-    set_mask_bit(hw_params, SNDRV_PCM_HW_PARAM_ACCESS, interleaved_bit);
+    unsigned const access_bit =
+            device_config.mmap
+                    ? (device_config.interleaved
+                               ? SNDRV_PCM_ACCESS_MMAP_INTERLEAVED
+                               : SNDRV_PCM_ACCESS_MMAP_NONINTERLEAVED)
+                    : (device_config.interleaved
+                               ? SNDRV_PCM_ACCESS_RW_INTERLEAVED
+                               : SNDRV_PCM_ACCESS_RW_NONINTERLEAVED);
+    set_mask_bit(hw_params, SNDRV_PCM_HW_PARAM_ACCESS, access_bit);
     set_mask_bit(
             hw_params,
             SNDRV_PCM_HW_PARAM_FORMAT,
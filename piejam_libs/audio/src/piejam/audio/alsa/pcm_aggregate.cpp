@@ -0,0 +1,756 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pcm_aggregate.h"
+
+#include "pcm_reader.h"
+#include "pcm_writer.h"
+
+#include <piejam/audio/process_thread.h>
+#include <piejam/thread/configuration.h>
+
+#include <mipp.h>
+#include <spdlog/spdlog.h>
+
+#include <sound/asound.h>
+#include <sys/ioctl.h>
+
+#include <boost/assert.hpp>
+#include <boost/core/ignore_unused.hpp>
+#include <boost/hof/match.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <variant>
+#include <vector>
+
+namespace piejam::audio::alsa
+{
+
+namespace
+{
+
+void
+interleave(
+        std::span<float const> const channels,
+        std::size_t const num_channels,
+        std::span<float> const frames) noexcept
+{
+    BOOST_ASSERT(channels.size() == frames.size());
+    std::size_t const num_frames = frames.size() / num_channels;
+
+    for (std::size_t ch = 0; ch < num_channels; ++ch)
+    {
+        float const* const in = channels.data() + ch * num_frames;
+        for (std::size_t frame = 0; frame < num_frames; ++frame)
+        {
+            frames[frame * num_channels + ch] = in[frame];
+        }
+    }
+}
+
+void
+deinterleave(
+        std::span<float const> const frames,
+        std::size_t const num_channels,
+        std::span<float> const channels) noexcept
+{
+    BOOST_ASSERT(channels.size() == frames.size());
+    std::size_t const num_frames = frames.size() / num_channels;
+
+    for (std::size_t ch = 0; ch < num_channels; ++ch)
+    {
+        float* const out = channels.data() + ch * num_frames;
+        for (std::size_t frame = 0; frame < num_frames; ++frame)
+        {
+            out[frame] = frames[frame * num_channels + ch];
+        }
+    }
+}
+
+//! Position of a device, relative to the period boundary its hw pointer
+//! crossed last. The periods are aligned to the start of the stream.
+auto
+clock_hw_position(
+        system::device& clock_fd,
+        std::size_t const period_size,
+        pcm_hw_position& position) noexcept -> std::error_code
+{
+    snd_pcm_status status{};
+
+    if (auto err = clock_fd.ioctl(SNDRV_PCM_IOCTL_STATUS, status))
+    {
+        return err;
+    }
+
+    position = make_pcm_hw_position(
+            status.tstamp,
+            status.hw_ptr % period_size,
+            0);
+    return {};
+}
+
+//! The bridges are driven by the times, at which the periods were crossed
+//! by the hw pointer. They are taken from the hw position of the device, if
+//! it has one, otherwise from the clock device.
+auto
+bridge_time(
+        system::device& clock_fd,
+        std::optional<pcm_hw_position> position,
+        pcm_process_config const& process_config,
+        clock_bridge::timestamp& time) noexcept -> std::error_code
+{
+    if (!position)
+    {
+        if (auto err = clock_hw_position(
+                    clock_fd,
+                    process_config.period_size.get(),
+                    position.emplace()))
+        {
+            return err;
+        }
+    }
+
+    time = period_time(*position, process_config.sample_rate);
+    return {};
+}
+
+//! Reads the periods of a secondary capture device into its bridge.
+class capture_step
+{
+public:
+    capture_step(
+            system::device& fd,
+            pcm_device_config const& device_config,
+            pcm_process_config const& process_config,
+            clock_bridge& bridge,
+            std::atomic_size_t& xruns)
+        : m_fd(fd)
+        , m_bridge(bridge)
+        , m_xruns(xruns)
+        , m_process_config(process_config)
+        , m_num_channels(device_config.num_channels)
+        , m_period_size(process_config.period_size.get())
+        , m_reader(make_reader(
+                  fd,
+                  device_config,
+                  process_config.period_size,
+                  process_config.period_count))
+        , m_channels(m_num_channels * m_period_size)
+        , m_frames(m_num_channels * m_period_size)
+    {
+    }
+
+    auto operator()() -> std::error_condition
+    {
+        if (m_starting)
+        {
+            if (auto err = m_fd.get().ioctl(SNDRV_PCM_IOCTL_PREPARE))
+            {
+                return err.default_error_condition();
+            }
+
+            if (auto err = m_fd.get().ioctl(SNDRV_PCM_IOCTL_START))
+            {
+                return err.default_error_condition();
+            }
+
+            m_reader->clear();
+            m_starting = false;
+        }
+
+        auto err = m_reader->transfer();
+
+        if (!err)
+        {
+            auto const converter = m_reader->converter();
+            for (std::size_t ch = 0; ch < m_num_channels; ++ch)
+            {
+                converter[ch](std::span<float>{m_channels}.subspan(
+                        ch * m_period_size,
+                        m_period_size));
+            }
+
+            err = m_reader->release();
+        }
+
+        clock_bridge::timestamp time{};
+
+        if (!err)
+        {
+            err = bridge_time(
+                    m_fd,
+                    m_reader->hw_position(),
+                    m_process_config,
+                    time);
+        }
+
+        if (!err)
+        {
+            interleave(m_channels, m_num_channels, m_frames);
+            m_bridge.get().push(m_frames, time);
+        }
+
+        if (err)
+        {
+            if (err == std::make_error_code(std::errc::broken_pipe))
+            {
+                m_starting = true;
+                ++m_xruns.get();
+            }
+            else
+            {
+                return err.default_error_condition();
+            }
+        }
+
+        return {};
+    }
+
+private:
+    std::reference_wrapper<system::device> m_fd;
+    std::reference_wrapper<clock_bridge> m_bridge;
+    std::reference_wrapper<std::atomic_size_t> m_xruns;
+    pcm_process_config m_process_config;
+    std::size_t m_num_channels;
+    std::size_t m_period_size;
+    std::unique_ptr<pcm_reader> m_reader;
+    std::vector<float> m_channels;
+    std::vector<float> m_frames;
+    bool m_starting{true};
+};
+
+//! Writes the periods of a secondary playback device from its bridge.
+class playback_step
+{
+public:
+    playback_step(
+            system::device& fd,
+            pcm_device_config const& device_config,
+            pcm_process_config const& process_config,
+            clock_bridge& bridge,
+            std::atomic_size_t& xruns)
+        : m_fd(fd)
+        , m_bridge(bridge)
+        , m_xruns(xruns)
+        , m_process_config(process_config)
+        , m_num_channels(device_config.num_channels)
+        , m_period_size(process_config.period_size.get())
+        , m_period_count(process_config.period_count.get())
+        , m_writer(make_writer(
+                  fd,
+                  device_config,
+                  process_config.period_size,
+                  process_config.period_count))
+        , m_channels(m_num_channels * m_period_size)
+        , m_frames(m_num_channels * m_period_size)
+    {
+    }
+
+    auto operator()() -> std::error_condition
+    {
+        if (m_starting)
+        {
+            if (auto err = m_fd.get().ioctl(SNDRV_PCM_IOCTL_PREPARE))
+            {
+                return err.default_error_condition();
+            }
+
+            // the device starts, as soon as its buffer is full
+            for (std::size_t i = 0; i < m_period_count; ++i)
+            {
+                if (auto err = m_writer->acquire())
+                {
+                    return err.default_error_condition();
+                }
+
+                m_writer->clear();
+
+                if (auto err = m_writer->transfer())
+                {
+                    return err.default_error_condition();
+                }
+            }
+
+            m_starting = false;
+        }
+
+        auto err = m_writer->acquire();
+
+        clock_bridge::timestamp time{};
+
+        if (!err)
+        {
+            err = bridge_time(
+                    m_fd,
+                    m_writer->hw_position(),
+                    m_process_config,
+                    time);
+        }
+
+        if (!err)
+        {
+            m_bridge.get().pull(m_frames, time);
+            deinterleave(m_frames, m_num_channels, m_channels);
+
+            auto const converter = m_writer->converter();
+            for (std::size_t ch = 0; ch < m_num_channels; ++ch)
+            {
+                converter[ch](std::span<float const>{m_channels}.subspan(
+                        ch * m_period_size,
+                        m_period_size));
+            }
+
+            err = m_writer->transfer();
+        }
+
+        if (err)
+        {
+            if (err == std::make_error_code(std::errc::broken_pipe))
+            {
+                m_starting = true;
+                ++m_xruns.get();
+            }
+            else
+            {
+                return err.default_error_condition();
+            }
+        }
+
+        return {};
+    }
+
+private:
+    std::reference_wrapper<system::device> m_fd;
+    std::reference_wrapper<clock_bridge> m_bridge;
+    std::reference_wrapper<std::atomic_size_t> m_xruns;
+    pcm_process_config m_process_config;
+    std::size_t m_num_channels;
+    std::size_t m_period_size;
+    std::size_t m_period_count;
+    std::unique_ptr<pcm_writer> m_writer;
+    std::vector<float> m_channels;
+    std::vector<float> m_frames;
+    bool m_starting{true};
+};
+
+class aggregate_reader final : public pcm_reader
+{
+public:
+    aggregate_reader(
+            system::device& clock_fd,
+            std::unique_ptr<pcm_reader> main,
+            std::vector<clock_bridge*> bridges,
+            pcm_process_config const& process_config)
+        : m_clock_fd(clock_fd)
+        , m_main(std::move(main))
+        , m_bridges(std::move(bridges))
+        , m_process_config(process_config)
+        , m_period_size(process_config.period_size.get())
+        , m_converter(m_main->converter().begin(), m_main->converter().end())
+    {
+        std::size_t num_channels{};
+        std::size_t max_bridge_channels{};
+        for (clock_bridge const* const bridge : m_bridges)
+        {
+            num_channels += bridge->num_channels();
+            max_bridge_channels =
+                    std::max(max_bridge_channels, bridge->num_channels());
+        }
+
+        m_channels.resize(num_channels * m_period_size);
+        m_frames.resize(max_bridge_channels * m_period_size);
+
+        for (std::size_t ch = 0; ch < num_channels; ++ch)
+        {
+            m_converter.emplace_back([this, ch](std::span<float> const out) {
+                BOOST_ASSERT(out.size() == m_period_size);
+                boost::ignore_unused(out);
+                return std::span<float const>{m_channels}.subspan(
+                        ch * m_period_size,
+                        m_period_size);
+            });
+        }
+    }
+
+    auto converter() const noexcept -> std::span<converter_f const> override
+    {
+        return m_converter;
+    }
+
+    auto transfer() noexcept -> std::error_code override
+    {
+        auto err = m_main->transfer();
+
+        clock_bridge::timestamp time{};
+
+        if (!err)
+        {
+            err = bridge_time(
+                    m_clock_fd,
+                    m_main->hw_position(),
+                    m_process_config,
+                    time);
+        }
+
+        if (!err)
+        {
+            std::span<float> channels{m_channels};
+
+            for (clock_bridge* const bridge : m_bridges)
+            {
+                std::size_t const size = bridge->num_channels() * m_period_size;
+                std::span<float> const frames =
+                        std::span<float>{m_frames}.first(size);
+
+                bridge->pull(frames, time);
+                deinterleave(
+                        frames,
+                        bridge->num_channels(),
+                        channels.first(size));
+
+                channels = channels.subspan(size);
+            }
+        }
+
+        return err;
+    }
+
+    auto release() noexcept -> std::error_code override
+    {
+        return m_main->release();
+    }
+
+    auto hw_position() noexcept -> std::optional<pcm_hw_position> override
+    {
+        return m_main->hw_position();
+    }
+
+    void clear() noexcept override
+    {
+        m_main->clear();
+        std::ranges::fill(m_channels, 0.f);
+    }
+
+private:
+    system::device& m_clock_fd;
+    std::unique_ptr<pcm_reader> m_main;
+    std::vector<clock_bridge*> m_bridges;
+    pcm_process_config m_process_config;
+    std::size_t m_period_size;
+    mipp::vector<float> m_channels;
+    std::vector<float> m_frames;
+    std::vector<converter_f> m_converter;
+};
+
+class aggregate_writer final : public pcm_writer
+{
+public:
+    aggregate_writer(
+            system::device& clock_fd,
+            std::unique_ptr<pcm_writer> main,
+            std::vector<clock_bridge*> bridges,
+            pcm_process_config const& process_config)
+        : m_clock_fd(clock_fd)
+        , m_main(std::move(main))
+        , m_bridges(std::move(bridges))
+        , m_process_config(process_config)
+        , m_period_size(process_config.period_size.get())
+        , m_converter(m_main->converter().begin(), m_main->converter().end())
+    {
+        std::size_t num_channels{};
+        std::size_t max_bridge_channels{};
+        for (clock_bridge const* const bridge : m_bridges)
+        {
+            num_channels += bridge->num_channels();
+            max_bridge_channels =
+                    std::max(max_bridge_channels, bridge->num_channels());
+        }
+
+        m_sources.resize(num_channels, 0.f);
+        m_frames.resize(max_bridge_channels * m_period_size);
+
+        for (std::size_t ch = 0; ch < num_channels; ++ch)
+        {
+            m_converter.emplace_back(
+                    [this, ch](pcm_output_source_buffer_t const& source) {
+                        m_sources[ch] = source;
+                    });
+        }
+    }
+
+    auto converter() const noexcept -> std::span<converter_f const> override
+    {
+        return m_converter;
+    }
+
+    auto acquire() noexcept -> std::error_code override
+    {
+        auto err = m_main->acquire();
+
+        if (!err)
+        {
+            err = bridge_time(
+                    m_clock_fd,
+                    m_main->hw_position(),
+                    m_process_config,
+                    m_time);
+        }
+
+        return err;
+    }
+
+    auto transfer() noexcept -> std::error_code override
+    {
+        auto err = m_main->transfer();
+
+        // periods written before the start don't come from the engine
+        bool const push = !std::exchange(m_cleared, false);
+
+        if (!err && push)
+        {
+            std::span<pcm_output_source_buffer_t const> sources{m_sources};
+
+            for (clock_bridge* const bridge : m_bridges)
+            {
+                std::size_t const num_channels = bridge->num_channels();
+                std::span<float> const frames =
+                        std::span<float>{m_frames}.first(
+                                num_channels * m_period_size);
+
+                for (std::size_t ch = 0; ch < num_channels; ++ch)
+                {
+                    std::visit(
+                            boost::hof::match(
+                                    [&](float const constant) {
+                                        for (std::size_t frame = 0;
+                                             frame < m_period_size;
+                                             ++frame)
+                                        {
+                                            frames[frame * num_channels + ch] =
+                                                    constant;
+                                        }
+                                    },
+                                    [&](std::span<float const> const buffer) {
+                                        BOOST_ASSERT(
+                                                buffer.size() == m_period_size);
+                                        for (std::size_t frame = 0;
+                                             frame < m_period_size;
+                                             ++frame)
+                                        {
+                                            frames[frame * num_channels + ch] =
+                                                    buffer[frame];
+                                        }
+                                    }),
+                            sources[ch]);
+                }
+
+                bridge->push(frames, m_time);
+                sources = sources.subspan(num_channels);
+            }
+        }
+
+        std::ranges::fill(m_sources, pcm_output_source_buffer_t{0.f});
+
+        return err;
+    }
+
+    auto hw_position() noexcept -> std::optional<pcm_hw_position> override
+    {
+        return m_main->hw_position();
+    }
+
+    void clear() noexcept override
+    {
+        m_main->clear();
+        m_cleared = true;
+    }
+
+private:
+    system::device& m_clock_fd;
+    std::unique_ptr<pcm_writer> m_main;
+    std::vector<clock_bridge*> m_bridges;
+    pcm_process_config m_process_config;
+    std::size_t m_period_size;
+    std::vector<pcm_output_source_buffer_t> m_sources;
+    std::vector<float> m_frames;
+    std::vector<converter_f> m_converter;
+    clock_bridge::timestamp m_time{};
+    bool m_cleared{};
+};
+
+auto
+bridges(std::span<std::unique_ptr<pcm_secondary> const> const secondaries,
+        pcm_stream const stream) -> std::vector<clock_bridge*>
+{
+    std::vector<clock_bridge*> result;
+
+    for (auto const& secondary : secondaries)
+    {
+        if (secondary->stream() == stream)
+        {
+            result.push_back(&secondary->bridge());
+        }
+    }
+
+    return result;
+}
+
+} // namespace
+
+pcm_secondary::pcm_secondary(
+        system::device fd,
+        pcm_stream const stream,
+        pcm_device_config const& device_config,
+        pcm_process_config const& process_config)
+    : m_fd(std::move(fd))
+    , m_stream(stream)
+    , m_device_config(device_config)
+    , m_process_config(process_config)
+    , m_bridge(
+              device_config.num_channels,
+              process_config.sample_rate,
+              process_config.period_size.get(),
+              process_config.period_size.get())
+{
+    BOOST_ASSERT(m_fd);
+}
+
+pcm_secondary::~pcm_secondary()
+{
+    if (m_process_thread)
+    {
+        stop();
+    }
+}
+
+void
+pcm_secondary::start(thread::configuration const& thread_config)
+{
+    BOOST_ASSERT(!m_process_thread);
+
+    m_xruns.store(0, std::memory_order_relaxed);
+
+    m_process_thread = std::make_unique<process_thread>();
+
+    if (m_stream == pcm_stream::capture)
+    {
+        m_process_thread->start(
+                thread_config,
+                capture_step(
+                        m_fd,
+                        m_device_config,
+                        m_process_config,
+                        m_bridge,
+                        m_xruns));
+    }
+    else
+    {
+        m_process_thread->start(
+                thread_config,
+                playback_step(
+                        m_fd,
+                        m_device_config,
+                        m_process_config,
+                        m_bridge,
+                        m_xruns));
+    }
+}
+
+void
+pcm_secondary::stop()
+{
+    BOOST_ASSERT(m_process_thread);
+
+    if (m_process_thread->is_running())
+    {
+        m_process_thread->stop();
+    }
+    else if (auto err = m_process_thread->error())
+    {
+        auto const message = err.message();
+        spdlog::error("Secondary process thread stopped with: {}", message);
+    }
+
+    m_process_thread.reset();
+
+    if (auto err = m_fd.ioctl(SNDRV_PCM_IOCTL_DROP))
+    {
+        auto const message = err.message();
+        spdlog::error("pcm_secondary::stop: {}", message);
+    }
+}
+
+auto
+make_aggregate_reader(
+        system::device& clock_fd,
+        std::unique_ptr<pcm_reader> main,
+        std::vector<clock_bridge*> bridges,
+        pcm_process_config const& process_config)
+        -> std::unique_ptr<pcm_reader>
+{
+    if (bridges.empty())
+    {
+        return main;
+    }
+
+    return std::make_unique<aggregate_reader>(
+            clock_fd,
+            std::move(main),
+            std::move(bridges),
+            process_config);
+}
+
+auto
+make_aggregate_reader(
+        system::device& clock_fd,
+        std::unique_ptr<pcm_reader> main,
+        std::span<std::unique_ptr<pcm_secondary> const> const secondaries,
+        pcm_process_config const& process_config)
+        -> std::unique_ptr<pcm_reader>
+{
+    return make_aggregate_reader(
+            clock_fd,
+            std::move(main),
+            bridges(secondaries, pcm_stream::capture),
+            process_config);
+}
+
+auto
+make_aggregate_writer(
+        system::device& clock_fd,
+        std::unique_ptr<pcm_writer> main,
+        std::vector<clock_bridge*> bridges,
+        pcm_process_config const& process_config)
+        -> std::unique_ptr<pcm_writer>
+{
+    if (bridges.empty())
+    {
+        return main;
+    }
+
+    return std::make_unique<aggregate_writer>(
+            clock_fd,
+            std::move(main),
+            std::move(bridges),
+            process_config);
+}
+
+auto
+make_aggregate_writer(
+        system::device& clock_fd,
+        std::unique_ptr<pcm_writer> main,
+        std::span<std::unique_ptr<pcm_secondary> const> const secondaries,
+        pcm_process_config const& process_config)
+        -> std::unique_ptr<pcm_writer>
+{
+    return make_aggregate_writer(
+            clock_fd,
+            std::move(main),
+            bridges(secondaries, pcm_stream::playback),
+            process_config);
+}
+
+} // namespace piejam::audio::alsa
@@ -0,0 +1,101 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "pcm_mmap.h"
+
+#include <piejam/audio/clock_bridge.h>
+#include <piejam/audio/fwd.h>
+#include <piejam/audio/pcm_io_config.h>
+#include <piejam/system/device.h>
+#include <piejam/thread/fwd.h>
+
+#include <atomic>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <vector>
+
+namespace piejam::audio::alsa
+{
+
+class pcm_reader;
+class pcm_writer;
+
+//! Secondary device of an aggregate, run by an own thread. Its audio is
+//! passed to and from the main device through a clock_bridge.
+class pcm_secondary
+{
+public:
+    pcm_secondary(
+            system::device fd,
+            pcm_stream,
+            pcm_device_config const&,
+            pcm_process_config const&);
+    ~pcm_secondary();
+
+    [[nodiscard]] auto stream() const noexcept -> pcm_stream
+    {
+        return m_stream;
+    }
+
+    [[nodiscard]] auto bridge() noexcept -> clock_bridge&
+    {
+        return m_bridge;
+    }
+
+    [[nodiscard]] auto xruns() const noexcept -> std::size_t
+    {
+        return m_xruns.load(std::memory_order_relaxed) + m_bridge.resyncs();
+    }
+
+    void start(thread::configuration const&);
+    void stop();
+
+private:
+    system::device m_fd;
+    pcm_stream m_stream;
+    pcm_device_config m_device_config;
+    pcm_process_config m_process_config;
+    clock_bridge m_bridge;
+    std::atomic_size_t m_xruns{};
+    std::unique_ptr<process_thread> m_process_thread;
+};
+
+//! Appends the channels of the bridges to the ones of the main reader. The
+//! bridges are pulled at the period times of the main reader, if it has a
+//! hw position, otherwise at the ones of the clock device.
+auto make_aggregate_reader(
+        system::device& clock_fd,
+        std::unique_ptr<pcm_reader>,
+        std::vector<clock_bridge*>,
+        pcm_process_config const&) -> std::unique_ptr<pcm_reader>;
+
+//! Appends the channels of the secondary capture devices to the ones of the
+//! main reader.
+auto make_aggregate_reader(
+        system::device& clock_fd,
+        std::unique_ptr<pcm_reader>,
+        std::span<std::unique_ptr<pcm_secondary> const>,
+        pcm_process_config const&) -> std::unique_ptr<pcm_reader>;
+
+//! Appends the channels of the bridges to the ones of the main writer. The
+//! bridges are pushed at the period times of the main writer, if it has a
+//! hw position, otherwise at the ones of the clock device.
+auto make_aggregate_writer(
+        system::device& clock_fd,
+        std::unique_ptr<pcm_writer>,
+        std::vector<clock_bridge*>,
+        pcm_process_config const&) -> std::unique_ptr<pcm_writer>;
+
+//! Appends the channels of the secondary playback devices to the ones of the
+//! main writer.
+auto make_aggregate_writer(
+        system::device& clock_fd,
+        std::unique_ptr<pcm_writer>,
+        std::span<std::unique_ptr<pcm_secondary> const>,
+        pcm_process_config const&) -> std::unique_ptr<pcm_writer>;
+
+} // namespace piejam::audio::alsa
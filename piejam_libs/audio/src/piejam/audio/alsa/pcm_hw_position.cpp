@@ -0,0 +1,59 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pcm_hw_position.h"
+
+#include <piejam/system/device.h>
+
+#include <sys/ioctl.h>
+
+namespace piejam::audio::alsa
+{
+
+auto
+make_pcm_hw_position(
+        timespec const& tstamp,
+        std::size_t const avail,
+        std::size_t const pending) noexcept -> pcm_hw_position
+{
+    return {.time = std::chrono::seconds{tstamp.tv_sec} +
+                    std::chrono::nanoseconds{tstamp.tv_nsec},
+            .late_frames = avail > pending ? avail - pending : 0};
+}
+
+auto
+make_pcm_hw_position(
+        snd_pcm_status const& status,
+        std::size_t const pending) noexcept -> pcm_hw_position
+{
+    return make_pcm_hw_position(status.tstamp, status.avail, pending);
+}
+
+auto
+pcm_status_hw_position(
+        system::device& fd,
+        std::size_t const pending,
+        pcm_hw_position& position) noexcept -> std::error_code
+{
+    snd_pcm_status status{};
+
+    if (auto err = fd.ioctl(SNDRV_PCM_IOCTL_STATUS, status))
+    {
+        return err;
+    }
+
+    position = make_pcm_hw_position(status, pending);
+    return {};
+}
+
+auto
+period_time(pcm_hw_position const& position, sample_rate const sample_rate)
+        noexcept -> std::chrono::nanoseconds
+{
+    return position.time -
+           std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   sample_rate.to_nanoseconds<double>(position.late_frames));
+}
+
+} // namespace piejam::audio::alsa
@@ -0,0 +1,53 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/audio/sample_rate.h>
+#include <piejam/system/fwd.h>
+
+#include <sound/asound.h>
+
+#include <chrono>
+#include <cstddef>
+#include <system_error>
+
+namespace piejam::audio::alsa
+{
+
+//! Position of the hw pointer, relative to the period being transferred.
+struct pcm_hw_position
+{
+    //! Time of the hw pointer update, in the clock set in the sw params.
+    std::chrono::nanoseconds time{};
+
+    //! Frames the hw pointer was already past the end of the period, at the
+    //! time of the update.
+    std::size_t late_frames{};
+};
+
+//! Position from a timestamp and the available frames at that time, of
+//! which the pending ones are still to be transferred for the period.
+[[nodiscard]] auto make_pcm_hw_position(
+        timespec const& tstamp,
+        std::size_t avail,
+        std::size_t pending) noexcept -> pcm_hw_position;
+
+[[nodiscard]] auto
+make_pcm_hw_position(snd_pcm_status const&, std::size_t pending) noexcept
+        -> pcm_hw_position;
+
+//! Reads the position with SNDRV_PCM_IOCTL_STATUS, which updates the hw
+//! pointer and its timestamp.
+[[nodiscard]] auto pcm_status_hw_position(
+        system::device&,
+        std::size_t pending,
+        pcm_hw_position&) noexcept -> std::error_code;
+
+//! Time at which the hw pointer crossed the end of the period.
+[[nodiscard]] auto
+period_time(pcm_hw_position const&, sample_rate) noexcept
+        -> std::chrono::nanoseconds;
+
+} // namespace piejam::audio::alsa
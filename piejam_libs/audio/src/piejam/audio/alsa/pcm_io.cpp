@@ -5,11 +5,14 @@
 #include "pcm_io.h"
 
 #include "get_set_hw_params.h"
+#include "pcm_aggregate.h"
+#include "pcm_mmap.h"
 #include "process_step.h"
 
 #include <piejam/audio/pcm_descriptor.h>
 #include <piejam/audio/pcm_hw_params.h>
 #include <piejam/audio/process_thread.h>
+#include <piejam/thread/configuration.h>
 
 #include <spdlog/spdlog.h>
 
@@ -30,7 +33,11 @@ open_pcm(
 {
     if (!path.empty())
     {
-        system::device fd(path);
+        // writing into the mmapped buffer needs write access
+        system::device fd(
+                path,
+                device_config.mmap ? system::open_mode::read_write
+                                   : system::open_mode::read_only);
 
         set_hw_params(fd, device_config, process_config);
 
@@ -47,13 +54,7 @@ open_pcm(
         sw_params.start_threshold = buffer_size;
         sw_params.stop_threshold = buffer_size;
         sw_params.silence_threshold = 0;
-        sw_params.boundary = buffer_size;
-        while (sw_params.boundary * 2 <=
-               static_cast<long unsigned>(
-                       std::numeric_limits<long>::max() - buffer_size))
-        {
-            sw_params.boundary *= 2;
-        }
+        sw_params.boundary = pcm_boundary(buffer_size);
         sw_params.silence_size = sw_params.boundary;
 
         if (auto err = fd.ioctl(SNDRV_PCM_IOCTL_SW_PARAMS, sw_params))
@@ -90,6 +91,26 @@ pcm_io::pcm_io(
             throw std::system_error(err);
         }
     }
+
+    auto open_secondaries = [this](
+                                    std::vector<pcm_secondary_config> const&
+                                            secondaries,
+                                    pcm_stream const stream) {
+        for (pcm_secondary_config const& secondary : secondaries)
+        {
+            m_secondaries.push_back(std::make_unique<pcm_secondary>(
+                    open_pcm(
+                            secondary.descriptor.path,
+                            secondary.device_config,
+                            m_io_config.process_config),
+                    stream,
+                    secondary.device_config,
+                    m_io_config.process_config));
+        }
+    };
+
+    open_secondaries(io_config.in_secondaries, pcm_stream::capture);
+    open_secondaries(io_config.out_secondaries, pcm_stream::playback);
 }
 
 pcm_io::~pcm_io()
@@ -111,11 +132,26 @@ pcm_io::is_open() const noexcept -> bool
     return m_input_fd || m_output_fd;
 }
 
+auto
+pcm_io::xruns() const noexcept -> std::size_t
+{
+    std::size_t result = m_xruns.load(std::memory_order_relaxed);
+
+    for (auto const& secondary : m_secondaries)
+    {
+        result += secondary->xruns();
+    }
+
+    return result;
+}
+
 void
 pcm_io::close()
 {
     BOOST_ASSERT(!is_running());
 
+    m_secondaries.clear();
+
     auto input_fd = std::move(m_input_fd);
     auto output_fd = std::move(m_output_fd);
 
@@ -146,6 +182,16 @@ pcm_io::start(
 
     m_xruns.store(0, std::memory_order_relaxed);
 
+    // the secondaries run next to the main device, not on its core
+    thread::configuration secondary_thread_config = thread_config;
+    secondary_thread_config.affinity.reset();
+    secondary_thread_config.name = "secondary_io";
+
+    for (auto const& secondary : m_secondaries)
+    {
+        secondary->start(secondary_thread_config);
+    }
+
     m_process_thread = std::make_unique<process_thread>();
     m_process_thread->start(
             thread_config,
@@ -153,8 +199,10 @@ pcm_io::start(
                     m_input_fd,
                     m_output_fd,
                     m_io_config,
+                    m_secondaries,
                     m_cpu_load,
                     m_xruns,
+                    m_period_history,
                     init_process_function,
                     std::move(process_function)));
 }
@@ -177,6 +225,11 @@ pcm_io::stop()
 
     m_process_thread.reset();
 
+    for (auto const& secondary : m_secondaries)
+    {
+        secondary->stop();
+    }
+
     system::device& fd = m_input_fd ? m_input_fd : m_output_fd;
     if (auto err = fd.ioctl(SNDRV_PCM_IOCTL_DROP))
     {
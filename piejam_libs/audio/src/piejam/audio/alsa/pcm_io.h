@@ -7,14 +7,18 @@
 #include <piejam/audio/device.h>
 #include <piejam/audio/fwd.h>
 #include <piejam/audio/pcm_io_config.h>
+#include <piejam/audio/period_history.h>
 #include <piejam/system/device.h>
 
 #include <atomic>
 #include <memory>
+#include <vector>
 
 namespace piejam::audio::alsa
 {
 
+class pcm_secondary;
+
 class pcm_io final : public piejam::audio::device
 {
 public:
@@ -41,18 +45,23 @@ public:
         return m_cpu_load.load(std::memory_order_relaxed);
     }
 
-    [[nodiscard]] auto xruns() const noexcept -> std::size_t override
+    [[nodiscard]] auto xruns() const noexcept -> std::size_t override;
+
+    [[nodiscard]] auto period_history() noexcept
+            -> audio::period_history* override
     {
-        return m_xruns.load(std::memory_order_relaxed);
+        return &m_period_history;
     }
 
 private:
     system::device m_input_fd;
     system::device m_output_fd;
     pcm_io_config m_io_config;
+    std::vector<std::unique_ptr<pcm_secondary>> m_secondaries;
 
     std::atomic<float> m_cpu_load{};
     std::atomic_size_t m_xruns{};
+    audio::period_history m_period_history;
 
     std::unique_ptr<process_thread> m_process_thread;
 };
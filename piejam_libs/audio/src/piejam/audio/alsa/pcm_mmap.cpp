@@ -0,0 +1,250 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pcm_mmap.h"
+
+#include <piejam/system/device.h>
+
+#include <boost/assert.hpp>
+
+#include <poll.h>
+#include <sys/ioctl.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <limits>
+
+namespace piejam::audio::alsa
+{
+
+namespace
+{
+
+// same as the kernel, when blocking in read or write
+constexpr std::chrono::seconds transfer_timeout{10};
+
+auto
+state_error(snd_pcm_state_t const state) noexcept -> std::error_code
+{
+    switch (state)
+    {
+        case SNDRV_PCM_STATE_XRUN:
+            return std::make_error_code(std::errc::broken_pipe);
+
+        case SNDRV_PCM_STATE_SUSPENDED:
+            return std::error_code(ESTRPIPE, std::generic_category());
+
+        case SNDRV_PCM_STATE_DISCONNECTED:
+            return std::make_error_code(std::errc::no_such_device);
+
+        default:
+            return {};
+    }
+}
+
+//! The layout of the channels is defined by the driver, it might pad the
+//! areas of the non-interleaved channels.
+auto
+channel_areas(system::device& fd, std::size_t const num_channels)
+        -> std::vector<pcm_channel_area>
+{
+    std::vector<pcm_channel_area> result;
+    result.reserve(num_channels);
+
+    for (std::size_t channel = 0; channel < num_channels; ++channel)
+    {
+        snd_pcm_channel_info info{};
+        info.channel = static_cast<unsigned>(channel);
+
+        if (auto err = fd.ioctl(SNDRV_PCM_IOCTL_CHANNEL_INFO, info))
+        {
+            throw std::system_error(err);
+        }
+
+        BOOST_ASSERT(info.offset == SNDRV_PCM_MMAP_OFFSET_DATA);
+        BOOST_ASSERT(info.first % 8 == 0 && info.step % 8 == 0);
+
+        result.push_back({.first = info.first / 8, .step = info.step / 8});
+    }
+
+    return result;
+}
+
+auto
+mapped_size(
+        std::span<pcm_channel_area const> const areas,
+        std::size_t const sample_bytes,
+        std::size_t const buffer_size) noexcept -> std::size_t
+{
+    std::size_t result{};
+
+    for (pcm_channel_area const& area : areas)
+    {
+        result = std::max(
+                result,
+                area.first + (buffer_size - 1) * area.step + sample_bytes);
+    }
+
+    return result;
+}
+
+} // namespace
+
+auto
+pcm_boundary(std::size_t const buffer_size) noexcept -> std::size_t
+{
+    std::size_t boundary = buffer_size;
+    while (boundary * 2 <=
+           static_cast<std::size_t>(
+                   std::numeric_limits<long>::max() - buffer_size))
+    {
+        boundary *= 2;
+    }
+    return boundary;
+}
+
+pcm_mmap::pcm_mmap(
+        system::device& fd,
+        pcm_stream const stream,
+        std::size_t const num_channels,
+        std::size_t const sample_bytes,
+        period_size const period_size,
+        period_count const period_count)
+    : m_fd(fd)
+    , m_stream(stream)
+    , m_sample_bytes(sample_bytes)
+    , m_frame_bytes(num_channels * sample_bytes)
+    , m_period_size(period_size.get())
+    , m_buffer_size(period_size.get() * period_count.get())
+    , m_boundary(pcm_boundary(m_buffer_size))
+    , m_areas(channel_areas(fd, num_channels))
+    , m_data(
+              fd,
+              mapped_size(m_areas, sample_bytes, m_buffer_size),
+              SNDRV_PCM_MMAP_OFFSET_DATA,
+              stream == pcm_stream::playback)
+{
+}
+
+auto
+pcm_mmap::sync_ptr(unsigned const flags) noexcept -> std::error_code
+{
+    m_sync_ptr.flags = flags;
+    return m_fd.ioctl(SNDRV_PCM_IOCTL_SYNC_PTR, m_sync_ptr);
+}
+
+auto
+pcm_mmap::avail() const noexcept -> std::size_t
+{
+    auto const hw_ptr = static_cast<std::ptrdiff_t>(m_sync_ptr.s.status.hw_ptr);
+    auto const appl_ptr =
+            static_cast<std::ptrdiff_t>(m_sync_ptr.c.control.appl_ptr);
+    auto const boundary = static_cast<std::ptrdiff_t>(m_boundary);
+
+    std::ptrdiff_t avail =
+            m_stream == pcm_stream::capture
+                    ? hw_ptr - appl_ptr
+                    : hw_ptr + static_cast<std::ptrdiff_t>(m_buffer_size) -
+                              appl_ptr;
+
+    if (avail < 0)
+    {
+        avail += boundary;
+    }
+    else if (avail >= boundary)
+    {
+        avail -= boundary;
+    }
+
+    return static_cast<std::size_t>(avail);
+}
+
+auto
+pcm_mmap::acquire() noexcept -> std::error_code
+{
+    for (;;)
+    {
+        if (auto err = sync_ptr(
+                    SNDRV_PCM_SYNC_PTR_HWSYNC | SNDRV_PCM_SYNC_PTR_APPL |
+                    SNDRV_PCM_SYNC_PTR_AVAIL_MIN))
+        {
+            return err;
+        }
+
+        if (auto err = state_error(m_sync_ptr.s.status.state))
+        {
+            return err;
+        }
+
+        if (std::size_t const avail = this->avail(); avail >= m_period_size)
+        {
+            BOOST_ASSERT(
+                    m_sync_ptr.c.control.appl_ptr % m_period_size == 0);
+            m_hw_position = make_pcm_hw_position(
+                    m_sync_ptr.s.status.tstamp,
+                    avail,
+                    m_period_size);
+            return {};
+        }
+
+        if (auto err = m_fd.poll(
+                    m_stream == pcm_stream::capture ? POLLIN : POLLOUT,
+                    transfer_timeout))
+        {
+            return err == std::errc::timed_out
+                           ? std::make_error_code(std::errc::io_error)
+                           : err;
+        }
+    }
+}
+
+auto
+pcm_mmap::period() const noexcept -> std::span<std::byte>
+{
+    BOOST_ASSERT(m_areas.front().first == 0);
+    BOOST_ASSERT(m_areas.front().step == m_frame_bytes);
+
+    std::size_t const offset = m_sync_ptr.c.control.appl_ptr % m_buffer_size;
+    return m_data.data().subspan(
+            offset * m_frame_bytes,
+            m_period_size * m_frame_bytes);
+}
+
+auto
+pcm_mmap::channel_period(std::size_t const channel) const noexcept
+        -> std::span<std::byte>
+{
+    BOOST_ASSERT(channel < m_areas.size());
+    BOOST_ASSERT(m_areas[channel].step == m_sample_bytes);
+
+    std::size_t const offset = m_sync_ptr.c.control.appl_ptr % m_buffer_size;
+    return m_data.data().subspan(
+            m_areas[channel].first + offset * m_sample_bytes,
+            m_period_size * m_sample_bytes);
+}
+
+auto
+pcm_mmap::commit() noexcept -> std::error_code
+{
+    m_sync_ptr.c.control.appl_ptr =
+            (m_sync_ptr.c.control.appl_ptr + m_period_size) % m_boundary;
+
+    // without the appl flag, the kernel takes over our appl_ptr
+    if (auto err = sync_ptr(SNDRV_PCM_SYNC_PTR_AVAIL_MIN))
+    {
+        return err;
+    }
+
+    if (m_stream == pcm_stream::playback &&
+        m_sync_ptr.s.status.state == SNDRV_PCM_STATE_PREPARED &&
+        avail() == 0)
+    {
+        return m_fd.ioctl(SNDRV_PCM_IOCTL_START);
+    }
+
+    return state_error(m_sync_ptr.s.status.state);
+}
+
+} // namespace piejam::audio::alsa
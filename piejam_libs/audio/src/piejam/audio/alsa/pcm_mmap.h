@@ -0,0 +1,91 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "pcm_hw_position.h"
+
+#include <piejam/audio/period_count.h>
+#include <piejam/audio/period_size.h>
+#include <piejam/system/fwd.h>
+#include <piejam/system/memory_map.h>
+
+#include <sound/asound.h>
+
+#include <cstddef>
+#include <span>
+#include <system_error>
+#include <vector>
+
+namespace piejam::audio::alsa
+{
+
+//! Wrap around point of the hw and appl pointers, as set in the sw params.
+auto pcm_boundary(std::size_t buffer_size) noexcept -> std::size_t;
+
+//! Location of a channel in the mapped buffer, in bytes.
+struct pcm_channel_area
+{
+    std::size_t first{};
+    std::size_t step{};
+};
+
+enum class pcm_stream : bool
+{
+    capture,
+    playback,
+};
+
+//! Transfers periods directly through the DMA ring buffer of a pcm device.
+//! The hw and appl pointers are synchronized with SNDRV_PCM_IOCTL_SYNC_PTR.
+class pcm_mmap
+{
+public:
+    pcm_mmap(
+            system::device&,
+            pcm_stream,
+            std::size_t num_channels,
+            std::size_t sample_bytes,
+            period_size,
+            period_count);
+
+    //! Waits until the next period can be read or written.
+    [[nodiscard]] auto acquire() noexcept -> std::error_code;
+
+    //! Memory of the acquired period, for the interleaved layout.
+    [[nodiscard]] auto period() const noexcept -> std::span<std::byte>;
+
+    //! Memory of the acquired period of a single channel, for the
+    //! non-interleaved layout.
+    [[nodiscard]] auto channel_period(std::size_t channel) const noexcept
+            -> std::span<std::byte>;
+
+    //! Passes the acquired period on to the device. Playback is started, as
+    //! soon as the buffer is full.
+    [[nodiscard]] auto commit() noexcept -> std::error_code;
+
+    //! Position of the hw pointer, as synchronized by the last acquire.
+    [[nodiscard]] auto hw_position() const noexcept -> pcm_hw_position
+    {
+        return m_hw_position;
+    }
+
+private:
+    [[nodiscard]] auto sync_ptr(unsigned flags) noexcept -> std::error_code;
+    [[nodiscard]] auto avail() const noexcept -> std::size_t;
+
+    system::device& m_fd;
+    pcm_stream m_stream;
+    std::size_t m_sample_bytes;
+    std::size_t m_frame_bytes;
+    std::size_t m_period_size;
+    std::size_t m_buffer_size;
+    std::size_t m_boundary;
+    std::vector<pcm_channel_area> m_areas;
+    system::memory_map m_data;
+    snd_pcm_sync_ptr m_sync_ptr{};
+    pcm_hw_position m_hw_position;
+};
+
+} // namespace piejam::audio::alsa
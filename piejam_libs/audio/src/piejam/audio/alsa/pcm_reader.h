@@ -4,8 +4,14 @@
 
 #pragma once
 
+#include "pcm_hw_position.h"
+
+#include <piejam/audio/fwd.h>
 #include <piejam/audio/pcm_buffer_converter.h>
+#include <piejam/system/fwd.h>
 
+#include <memory>
+#include <optional>
 #include <span>
 #include <system_error>
 
@@ -22,9 +28,29 @@ public:
     [[nodiscard]] virtual auto converter() const noexcept
             -> std::span<converter_f const> = 0;
 
+    //! Reads the next period.
     [[nodiscard]] virtual auto transfer() noexcept -> std::error_code = 0;
 
+    //! Hands the period back to the device, after it was converted.
+    [[nodiscard]] virtual auto release() noexcept -> std::error_code = 0;
+
+    //! Position of the hw pointer, relative to the period of the last
+    //! transfer. With mmap access, it is taken from the transfer, otherwise
+    //! it is read from the device.
+    [[nodiscard]] virtual auto hw_position() noexcept
+            -> std::optional<pcm_hw_position>
+    {
+        return std::nullopt;
+    }
+
     virtual void clear() noexcept = 0;
 };
 
+//! Creates the reader for the access type and format of the device.
+auto make_reader(
+        system::device&,
+        pcm_device_config const&,
+        period_size,
+        period_count) -> std::unique_ptr<pcm_reader>;
+
 } // namespace piejam::audio::alsa
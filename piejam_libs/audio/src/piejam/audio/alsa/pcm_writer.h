@@ -4,8 +4,14 @@
 
 #pragma once
 
+#include "pcm_hw_position.h"
+
+#include <piejam/audio/fwd.h>
 #include <piejam/audio/pcm_buffer_converter.h>
+#include <piejam/system/fwd.h>
 
+#include <memory>
+#include <optional>
 #include <span>
 #include <system_error>
 
@@ -22,9 +28,29 @@ public:
     [[nodiscard]] virtual auto converter() const noexcept
             -> std::span<converter_f const> = 0;
 
+    //! Gets the next period ready to be converted into.
+    [[nodiscard]] virtual auto acquire() noexcept -> std::error_code = 0;
+
+    //! Writes the converted period.
     [[nodiscard]] virtual auto transfer() noexcept -> std::error_code = 0;
 
+    //! Position of the hw pointer, relative to the period of the last
+    //! acquire. With mmap access, it is taken from the acquire, otherwise it
+    //! is read from the device.
+    [[nodiscard]] virtual auto hw_position() noexcept
+            -> std::optional<pcm_hw_position>
+    {
+        return std::nullopt;
+    }
+
     virtual void clear() noexcept = 0;
 };
 
+//! Creates the writer for the access type and format of the device.
+auto make_writer(
+        system::device&,
+        pcm_device_config const&,
+        period_size,
+        period_count) -> std::unique_ptr<pcm_writer>;
+
 } // namespace piejam::audio::alsa
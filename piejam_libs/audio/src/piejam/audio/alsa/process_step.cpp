@@ -4,27 +4,39 @@
 
 #include "process_step.h"
 
+#include "pcm_aggregate.h"
+#include "pcm_hw_position.h"
+#include "pcm_mmap.h"
 #include "pcm_reader.h"
 #include "pcm_writer.h"
 
 #include <piejam/algorithm/transform_to_vector.h>
 #include <piejam/audio/cpu_load_meter.h>
-#include <piejam/audio/pcm_convert.h>
+#include <piejam/audio/pcm_convert_interleaved.h>
 #include <piejam/audio/pcm_format.h>
 #include <piejam/audio/pcm_io_config.h>
 #include <piejam/audio/pcm_sample_type.h>
+#include <piejam/audio/period_history.h>
 #include <piejam/audio/types.h>
 #include <piejam/numeric/rolling_mean.h>
 #include <piejam/range/iota.h>
-#include <piejam/range/strided_span.h>
 #include <piejam/system/device.h>
 
+#include <mipp.h>
+
 #include <sound/asound.h>
 #include <sys/ioctl.h>
+#include <time.h>
 
 #include <boost/assert.hpp>
+#include <boost/core/ignore_unused.hpp>
+#include <boost/hof/match.hpp>
 
 #include <algorithm>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <utility>
 
 namespace piejam::audio::alsa
 {
@@ -32,6 +44,29 @@ namespace piejam::audio::alsa
 namespace
 {
 
+using clock_t = std::chrono::steady_clock;
+
+//! From the hw pointer crossing the end of the period, to now. The hw
+//! timestamps are taken from CLOCK_MONOTONIC_RAW, as set in the sw params.
+//! Zero, if there is no position.
+auto
+wakeup_latency(
+        std::optional<pcm_hw_position> const& position,
+        sample_rate const sample_rate) noexcept -> std::chrono::nanoseconds
+{
+    if (!position)
+    {
+        return {};
+    }
+
+    timespec now{};
+    ::clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+
+    return std::chrono::seconds{now.tv_sec} +
+           std::chrono::nanoseconds{now.tv_nsec} -
+           period_time(*position, sample_rate);
+}
+
 template <class T>
 auto
 transferi(
@@ -93,6 +128,67 @@ writei(system::device& fd,
             channels_per_frame);
 }
 
+//! The buffer pointers are advanced on partial transfers and restored
+//! afterwards.
+template <class T>
+auto
+transfern(
+        system::device& fd,
+        unsigned long const request,
+        std::span<void*> const buffers,
+        std::size_t const frames) -> std::error_code
+{
+    std::error_code result;
+
+    std::size_t frames_transferred = 0;
+    while (frames_transferred < frames)
+    {
+        snd_xfern arg;
+        arg.bufs = buffers.data();
+        arg.frames = frames - frames_transferred;
+        arg.result = 0;
+
+        if ((result = fd.ioctl(request, arg)))
+        {
+            break;
+        }
+
+        auto const result_frames = static_cast<std::size_t>(arg.result);
+        for (void*& buffer : buffers)
+        {
+            buffer = static_cast<T*>(buffer) + result_frames;
+        }
+
+        frames_transferred += result_frames;
+        BOOST_ASSERT(frames_transferred <= frames);
+    }
+
+    for (void*& buffer : buffers)
+    {
+        buffer = static_cast<T*>(buffer) - frames_transferred;
+    }
+
+    return result;
+}
+
+template <class T>
+auto
+readn(system::device& fd,
+      std::span<void*> const buffers,
+      std::size_t const frames) -> std::error_code
+{
+    return transfern<T>(fd, SNDRV_PCM_IOCTL_READN_FRAMES, buffers, frames);
+}
+
+template <class T>
+auto
+writen(system::device& fd,
+       std::span<void*> const buffers,
+       std::size_t const frames) -> std::error_code
+{
+    return transfern<T>(fd, SNDRV_PCM_IOCTL_WRITEN_FRAMES, buffers, frames);
+}
+
 struct dummy_reader final : pcm_reader
 {
     auto converter() const noexcept -> std::span<converter_f const> override
@@ -105,49 +201,165 @@ struct dummy_reader final : pcm_reader
         return {};
     }
 
+    auto release() noexcept -> std::error_code override
+    {
+        return {};
+    }
+
     void clear() noexcept override
     {
     }
 };
 
+//! Reads the periods into an own buffer.
 template <pcm_format F>
-struct interleaved_reader final : pcm_reader
+class rw_capture
 {
-    interleaved_reader(
+public:
+    rw_capture(
             system::device& fd,
             std::size_t const num_channels,
-            audio::period_size const period_size)
+            audio::period_size const period_size,
+            audio::period_count)
         : m_fd(fd)
         , m_num_channels(num_channels)
         , m_period_size(period_size)
-        , m_read_buffer(num_channels * period_size.get())
+        , m_buffer(num_channels * period_size.get())
+    {
+        BOOST_ASSERT(m_fd);
+    }
+
+    auto samples() const noexcept -> std::span<pcm_sample_t<F> const>
+    {
+        return m_buffer;
+    }
+
+    auto transfer() noexcept -> std::error_code
+    {
+        return readi(
+                m_fd,
+                m_buffer.data(),
+                m_period_size.get(),
+                m_num_channels);
+    }
+
+    auto release() noexcept -> std::error_code
+    {
+        return {};
+    }
+
+    void clear() noexcept
+    {
+        std::ranges::fill(m_buffer, pcm_sample_t<F>{});
+    }
+
+    //! Taken after the period was read.
+    auto hw_position() noexcept -> std::optional<pcm_hw_position>
+    {
+        pcm_hw_position result;
+        if (pcm_status_hw_position(m_fd, 0, result))
+        {
+            return std::nullopt;
+        }
+
+        return result;
+    }
+
+private:
+    system::device& m_fd;
+    std::size_t m_num_channels;
+    period_size m_period_size;
+    std::vector<pcm_sample_t<F>> m_buffer;
+};
+
+//! Reads the periods directly from the DMA buffer.
+template <pcm_format F>
+class mmap_capture
+{
+public:
+    mmap_capture(
+            system::device& fd,
+            std::size_t const num_channels,
+            audio::period_size const period_size,
+            audio::period_count const period_count)
+        : m_mmap(
+                  fd,
+                  pcm_stream::capture,
+                  num_channels,
+                  sizeof(pcm_sample_t<F>),
+                  period_size,
+                  period_count)
+    {
+    }
+
+    auto samples() const noexcept -> std::span<pcm_sample_t<F> const>
+    {
+        std::span<std::byte> const period = m_mmap.period();
+        return {reinterpret_cast<pcm_sample_t<F> const*>(period.data()),
+                period.size() / sizeof(pcm_sample_t<F>)};
+    }
+
+    auto transfer() noexcept -> std::error_code
+    {
+        return m_mmap.acquire();
+    }
+
+    auto release() noexcept -> std::error_code
+    {
+        return m_mmap.commit();
+    }
+
+    void clear() noexcept
+    {
+    }
+
+    auto hw_position() noexcept -> std::optional<pcm_hw_position>
+    {
+        return m_mmap.hw_position();
+    }
+
+private:
+    pcm_mmap m_mmap;
+};
+
+template <pcm_format F, class Access>
+struct interleaved_reader final : pcm_reader
+{
+    interleaved_reader(
+            system::device& fd,
+            std::size_t const num_channels,
+            audio::period_size const period_size,
+            audio::period_count const period_count)
+        : m_num_channels(num_channels)
+        , m_period_size(period_size)
+        , m_access(fd, num_channels, period_size, period_count)
+        , m_buffer(num_channels * period_size.get())
+        , m_channels(algorithm::transform_to_vector(
+                  range::iota(num_channels),
+                  [this](std::size_t const channel) {
+                      return std::span<float>{m_buffer}.subspan(
+                              channel * m_period_size.get(),
+                              m_period_size.get());
+                  }))
         , m_converter(algorithm::transform_to_vector(
                   range::iota(num_channels),
                   [this](std::size_t const channel) {
                       return pcm_input_buffer_converter(
                               [this, channel](std::span<float> const buffer) {
-                                  convert(channel, buffer);
+                                  return convert(channel, buffer);
                               });
                   }))
     {
-        BOOST_ASSERT(m_fd);
     }
 
-    void
-    convert(std::size_t const channel, std::span<float> const buffer) noexcept
+    auto convert(std::size_t const channel, std::span<float> const buffer)
+            const noexcept -> std::span<float const>
     {
         BOOST_ASSERT(channel < m_num_channels);
         BOOST_ASSERT(m_period_size.get() == buffer.size());
+        boost::ignore_unused(buffer);
 
-        range::strided_span<pcm_sample_t<F>> interleaved{
-                m_read_buffer.data() + channel,
-                buffer.size(),
-                static_cast<std::ptrdiff_t>(m_num_channels)};
-
-        std::ranges::transform(
-                interleaved,
-                buffer.begin(),
-                &pcm_convert::from<F>);
+        return m_channels[channel];
     }
 
     auto converter() const noexcept -> std::span<converter_f const> override
@@ -155,82 +367,271 @@ struct interleaved_reader final : pcm_reader
         return m_converter;
     }
 
+    //! All channels are converted at once, the converters hand out the
+    //! converted channels without copying.
     auto transfer() noexcept -> std::error_code override
     {
-        if (auto err =
-                    readi(m_fd,
-                          m_read_buffer.data(),
-                          m_period_size.get(),
-                          m_num_channels))
+        auto err = m_access.transfer();
+
+        if (!err)
         {
-            return err;
+            pcm_convert::from_interleaved<F>(m_access.samples(), m_channels);
         }
 
-        return {};
+        return err;
+    }
+
+    auto release() noexcept -> std::error_code override
+    {
+        return m_access.release();
+    }
+
+    auto hw_position() noexcept -> std::optional<pcm_hw_position> override
+    {
+        return m_access.hw_position();
     }
 
     void clear() noexcept override
     {
-        std::ranges::fill(m_read_buffer, pcm_sample_t<F>{});
+        m_access.clear();
+        std::ranges::fill(m_buffer, 0.f);
+    }
+
+private:
+    std::size_t m_num_channels;
+    period_size m_period_size;
+    Access m_access;
+    mipp::vector<float> m_buffer;
+    std::vector<std::span<float>> m_channels;
+    std::vector<converter_f> m_converter;
+};
+
+//! Reads the periods of each channel into an own buffer.
+template <pcm_format F>
+class rw_noninterleaved_capture
+{
+public:
+    rw_noninterleaved_capture(
+            system::device& fd,
+            std::size_t const num_channels,
+            audio::period_size const period_size,
+            audio::period_count)
+        : m_fd(fd)
+        , m_period_size(period_size)
+        , m_buffer(num_channels * period_size.get())
+        , m_channels(algorithm::transform_to_vector(
+                  range::iota(num_channels),
+                  [this](std::size_t const channel) {
+                      return static_cast<void*>(
+                              m_buffer.data() +
+                              channel * m_period_size.get());
+                  }))
+    {
+        BOOST_ASSERT(m_fd);
+    }
+
+    auto channel_samples(std::size_t const channel) const noexcept
+            -> std::span<pcm_sample_t<F> const>
+    {
+        return {static_cast<pcm_sample_t<F> const*>(m_channels[channel]),
+                m_period_size.get()};
+    }
+
+    auto transfer() noexcept -> std::error_code
+    {
+        return readn<pcm_sample_t<F>>(m_fd, m_channels, m_period_size.get());
+    }
+
+    auto release() noexcept -> std::error_code
+    {
+        return {};
+    }
+
+    void clear() noexcept
+    {
+        std::ranges::fill(m_buffer, pcm_sample_t<F>{});
+    }
+
+    //! Taken after the period was read.
+    auto hw_position() noexcept -> std::optional<pcm_hw_position>
+    {
+        pcm_hw_position result;
+        if (pcm_status_hw_position(m_fd, 0, result))
+        {
+            return std::nullopt;
+        }
+
+        return result;
     }
 
 private:
     system::device& m_fd;
+    period_size m_period_size;
+    std::vector<pcm_sample_t<F>> m_buffer;
+    std::vector<void*> m_channels;
+};
+
+//! Reads the periods of each channel directly from the DMA buffer.
+template <pcm_format F>
+class mmap_noninterleaved_capture
+{
+public:
+    mmap_noninterleaved_capture(
+            system::device& fd,
+            std::size_t const num_channels,
+            audio::period_size const period_size,
+            audio::period_count const period_count)
+        : m_mmap(
+                  fd,
+                  pcm_stream::capture,
+                  num_channels,
+                  sizeof(pcm_sample_t<F>),
+                  period_size,
+                  period_count)
+    {
+    }
+
+    auto channel_samples(std::size_t const channel) const noexcept
+            -> std::span<pcm_sample_t<F> const>
+    {
+        std::span<std::byte> const period = m_mmap.channel_period(channel);
+        return {reinterpret_cast<pcm_sample_t<F> const*>(period.data()),
+                period.size() / sizeof(pcm_sample_t<F>)};
+    }
+
+    auto transfer() noexcept -> std::error_code
+    {
+        return m_mmap.acquire();
+    }
+
+    auto release() noexcept -> std::error_code
+    {
+        return m_mmap.commit();
+    }
+
+    void clear() noexcept
+    {
+    }
+
+    auto hw_position() noexcept -> std::optional<pcm_hw_position>
+    {
+        return m_mmap.hw_position();
+    }
+
+private:
+    pcm_mmap m_mmap;
+};
+
+//! Each channel is contiguous already, the converters read it directly.
+template <pcm_format F, class Access>
+struct noninterleaved_reader final : pcm_reader
+{
+    noninterleaved_reader(
+            system::device& fd,
+            std::size_t const num_channels,
+            audio::period_size const period_size,
+            audio::period_count const period_count)
+        : m_num_channels(num_channels)
+        , m_period_size(period_size)
+        , m_access(fd, num_channels, period_size, period_count)
+        , m_converter(algorithm::transform_to_vector(
+                  range::iota(num_channels),
+                  [this](std::size_t const channel) {
+                      return pcm_input_buffer_converter(
+                              [this, channel](std::span<float> const buffer) {
+                                  return convert(channel, buffer);
+                              });
+                  }))
+    {
+    }
+
+    auto convert(std::size_t const channel, std::span<float> const buffer)
+            const noexcept -> std::span<float const>
+    {
+        BOOST_ASSERT(channel < m_num_channels);
+        BOOST_ASSERT(m_period_size.get() == buffer.size());
+
+        pcm_convert::from_interleaved<F>(
+                m_access.channel_samples(channel),
+                std::span{&buffer, 1});
+
+        return buffer;
+    }
+
+    auto converter() const noexcept -> std::span<converter_f const> override
+    {
+        return m_converter;
+    }
+
+    auto transfer() noexcept -> std::error_code override
+    {
+        return m_access.transfer();
+    }
+
+    auto release() noexcept -> std::error_code override
+    {
+        return m_access.release();
+    }
+
+    auto hw_position() noexcept -> std::optional<pcm_hw_position> override
+    {
+        return m_access.hw_position();
+    }
+
+    void clear() noexcept override
+    {
+        m_access.clear();
+    }
+
+private:
     std::size_t m_num_channels;
     period_size m_period_size;
-    std::vector<pcm_sample_t<F>> m_read_buffer;
+    Access m_access;
     std::vector<converter_f> m_converter;
 };
 
+template <pcm_format F>
 auto
 make_reader(
         system::device& fd,
         pcm_device_config const& config,
-        audio::period_size const period_size) -> std::unique_ptr<pcm_reader>
+        audio::period_size const period_size,
+        audio::period_count const period_count) -> std::unique_ptr<pcm_reader>
 {
-    if (!fd)
-    {
-        return std::make_unique<dummy_reader>();
-    }
-
     if (config.interleaved)
     {
-
-#define M_PIEJAM_INTERLEAVED_READER_CASE(Format)                               \
-    case Format:                                                               \
-        return std::make_unique<interleaved_reader<Format>>(                   \
-                fd,                                                            \
-                config.num_channels,                                           \
-                period_size)
-
-        switch (config.format)
+        if (config.mmap)
         {
-            M_PIEJAM_INTERLEAVED_READER_CASE(pcm_format::s8);
-            M_PIEJAM_INTERLEAVED_READER_CASE(pcm_format::u8);
-            M_PIEJAM_INTERLEAVED_READER_CASE(pcm_format::s16_le);
-            M_PIEJAM_INTERLEAVED_READER_CASE(pcm_format::s16_be);
-            M_PIEJAM_INTERLEAVED_READER_CASE(pcm_format::u16_le);
-            M_PIEJAM_INTERLEAVED_READER_CASE(pcm_format::u16_be);
-            M_PIEJAM_INTERLEAVED_READER_CASE(pcm_format::s32_le);
-            M_PIEJAM_INTERLEAVED_READER_CASE(pcm_format::s32_be);
-            M_PIEJAM_INTERLEAVED_READER_CASE(pcm_format::u32_le);
-            M_PIEJAM_INTERLEAVED_READER_CASE(pcm_format::u32_be);
-            M_PIEJAM_INTERLEAVED_READER_CASE(pcm_format::s24_3le);
-            M_PIEJAM_INTERLEAVED_READER_CASE(pcm_format::s24_3be);
-            M_PIEJAM_INTERLEAVED_READER_CASE(pcm_format::u24_3le);
-            M_PIEJAM_INTERLEAVED_READER_CASE(pcm_format::u24_3be);
-
-            default:
-                BOOST_ASSERT(false);
-                return std::make_unique<dummy_reader>();
+            return std::make_unique<interleaved_reader<F, mmap_capture<F>>>(
+                    fd,
+                    config.num_channels,
+                    period_size,
+                    period_count);
         }
 
-#undef M_PIEJAM_INTERLEAVED_READER_CASE
+        return std::make_unique<interleaved_reader<F, rw_capture<F>>>(
+                fd,
+                config.num_channels,
+                period_size,
+                period_count);
     }
-    else
+
+    if (config.mmap)
     {
-        return std::make_unique<dummy_reader>();
+        return std::make_unique<
+                noninterleaved_reader<F, mmap_noninterleaved_capture<F>>>(
+                fd,
+                config.num_channels,
+                period_size,
+                period_count);
     }
+
+    return std::make_unique<
+            noninterleaved_reader<F, rw_noninterleaved_capture<F>>>(
+            fd,
+            config.num_channels,
+            period_size,
+            period_count);
 }
 
 struct dummy_writer final : pcm_writer
@@ -240,26 +641,135 @@ struct dummy_writer final : pcm_writer
         return {};
     }
 
+    auto acquire() noexcept -> std::error_code override
+    {
+        return {};
+    }
+
     auto transfer() noexcept -> std::error_code override
     {
         return {};
     }
+
     void clear() noexcept override
     {
     }
 };
 
+//! Writes the periods from an own buffer.
 template <pcm_format F>
-struct interleaved_writer final : pcm_writer
+class rw_playback
 {
-    interleaved_writer(
+public:
+    rw_playback(
             system::device& fd,
             std::size_t const num_channels,
-            audio::period_size const period_size)
+            audio::period_size const period_size,
+            audio::period_count)
         : m_fd(fd)
         , m_num_channels(num_channels)
         , m_period_size(period_size)
-        , m_write_buffer(num_channels * period_size.get())
+        , m_buffer(num_channels * period_size.get())
+    {
+        BOOST_ASSERT(m_fd);
+    }
+
+    auto samples() noexcept -> std::span<pcm_sample_t<F>>
+    {
+        return m_buffer;
+    }
+
+    auto acquire() noexcept -> std::error_code
+    {
+        return {};
+    }
+
+    auto transfer() noexcept -> std::error_code
+    {
+        return writei(
+                m_fd,
+                m_buffer.data(),
+                m_period_size.get(),
+                m_num_channels);
+    }
+
+    //! Taken before the period is written.
+    auto hw_position() noexcept -> std::optional<pcm_hw_position>
+    {
+        pcm_hw_position result;
+        if (pcm_status_hw_position(m_fd, m_period_size.get(), result))
+        {
+            return std::nullopt;
+        }
+
+        return result;
+    }
+
+private:
+    system::device& m_fd;
+    std::size_t m_num_channels;
+    period_size m_period_size;
+    std::vector<pcm_sample_t<F>> m_buffer;
+};
+
+//! Writes the periods directly into the DMA buffer.
+template <pcm_format F>
+class mmap_playback
+{
+public:
+    mmap_playback(
+            system::device& fd,
+            std::size_t const num_channels,
+            audio::period_size const period_size,
+            audio::period_count const period_count)
+        : m_mmap(
+                  fd,
+                  pcm_stream::playback,
+                  num_channels,
+                  sizeof(pcm_sample_t<F>),
+                  period_size,
+                  period_count)
+    {
+    }
+
+    auto samples() noexcept -> std::span<pcm_sample_t<F>>
+    {
+        std::span<std::byte> const period = m_mmap.period();
+        return {reinterpret_cast<pcm_sample_t<F>*>(period.data()),
+                period.size() / sizeof(pcm_sample_t<F>)};
+    }
+
+    auto acquire() noexcept -> std::error_code
+    {
+        return m_mmap.acquire();
+    }
+
+    auto transfer() noexcept -> std::error_code
+    {
+        return m_mmap.commit();
+    }
+
+    auto hw_position() noexcept -> std::optional<pcm_hw_position>
+    {
+        return m_mmap.hw_position();
+    }
+
+private:
+    pcm_mmap m_mmap;
+};
+
+template <pcm_format F, class Access>
+struct interleaved_writer final : pcm_writer
+{
+    interleaved_writer(
+            system::device& fd,
+            std::size_t const num_channels,
+            audio::period_size const period_size,
+            audio::period_count const period_count)
+        : m_num_channels(num_channels)
+        , m_period_size(period_size)
+        , m_access(fd, num_channels, period_size, period_count)
+        , m_sources(num_channels, 0.f)
         , m_converter(algorithm::transform_to_vector(
                   range::iota(num_channels),
                   [this](std::size_t const channel) {
@@ -270,42 +780,205 @@ struct interleaved_writer final : pcm_writer
                               });
                   }))
     {
-        BOOST_ASSERT(m_fd);
     }
 
+    //! Only remembers the source, all channels are converted at once on
+    //! transfer. The source buffers stay valid until the next engine cycle.
     void convert_source(
             std::size_t const channel,
-            pcm_output_source_buffer_t const& buffer)
+            pcm_output_source_buffer_t const& buffer) noexcept
     {
-        std::visit([=, this](auto const& b) { convert(channel, b); }, buffer);
+        BOOST_ASSERT(channel < m_num_channels);
+        BOOST_ASSERT(std::visit(
+                boost::hof::match(
+                        [](float) { return true; },
+                        [this](std::span<float const> const b) {
+                            return b.size() == m_period_size.get();
+                        }),
+                buffer));
+
+        m_sources[channel] = buffer;
     }
 
-    void convert(std::size_t const channel, std::span<float const> const buffer)
+    auto converter() const noexcept -> std::span<converter_f const> override
     {
-        BOOST_ASSERT(channel < m_num_channels);
-        BOOST_ASSERT(m_period_size.get() == buffer.size());
+        return m_converter;
+    }
 
-        range::strided_span<pcm_sample_t<F>> interleaved{
-                m_write_buffer.data() + channel,
-                m_period_size.get(),
-                static_cast<std::ptrdiff_t>(m_num_channels)};
+    auto acquire() noexcept -> std::error_code override
+    {
+        return m_access.acquire();
+    }
+
+    //! Channels without a source in this cycle are written silent.
+    auto transfer() noexcept -> std::error_code override
+    {
+        pcm_convert::to_interleaved<F>(m_sources, m_access.samples());
+        std::ranges::fill(m_sources, pcm_output_source_buffer_t{0.f});
 
-        std::ranges::transform(
-                buffer,
-                interleaved.begin(),
-                &pcm_convert::to<F>);
+        return m_access.transfer();
     }
 
-    void convert(std::size_t const channel, float const constant)
+    auto hw_position() noexcept -> std::optional<pcm_hw_position> override
     {
-        BOOST_ASSERT(channel < m_num_channels);
+        return m_access.hw_position();
+    }
 
-        range::strided_span<pcm_sample_t<F>> interleaved{
-                m_write_buffer.data() + channel,
-                m_period_size.get(),
-                static_cast<std::ptrdiff_t>(m_num_channels)};
+    void clear() noexcept override
+    {
+        std::ranges::fill(m_sources, pcm_output_source_buffer_t{0.f});
+    }
+
+private:
+    std::size_t m_num_channels;
+    period_size m_period_size;
+    Access m_access;
+    std::vector<pcm_output_source_buffer_t> m_sources;
+    std::vector<converter_f> m_converter;
+};
+
+//! Writes the periods of each channel from an own buffer.
+template <pcm_format F>
+class rw_noninterleaved_playback
+{
+public:
+    rw_noninterleaved_playback(
+            system::device& fd,
+            std::size_t const num_channels,
+            audio::period_size const period_size,
+            audio::period_count)
+        : m_fd(fd)
+        , m_period_size(period_size)
+        , m_buffer(num_channels * period_size.get())
+        , m_channels(algorithm::transform_to_vector(
+                  range::iota(num_channels),
+                  [this](std::size_t const channel) {
+                      return static_cast<void*>(
+                              m_buffer.data() +
+                              channel * m_period_size.get());
+                  }))
+    {
+        BOOST_ASSERT(m_fd);
+    }
+
+    auto channel_samples(std::size_t const channel) noexcept
+            -> std::span<pcm_sample_t<F>>
+    {
+        return {static_cast<pcm_sample_t<F>*>(m_channels[channel]),
+                m_period_size.get()};
+    }
+
+    auto acquire() noexcept -> std::error_code
+    {
+        return {};
+    }
+
+    auto transfer() noexcept -> std::error_code
+    {
+        return writen<pcm_sample_t<F>>(m_fd, m_channels, m_period_size.get());
+    }
+
+    //! Taken before the period is written.
+    auto hw_position() noexcept -> std::optional<pcm_hw_position>
+    {
+        pcm_hw_position result;
+        if (pcm_status_hw_position(m_fd, m_period_size.get(), result))
+        {
+            return std::nullopt;
+        }
+
+        return result;
+    }
+
+private:
+    system::device& m_fd;
+    period_size m_period_size;
+    std::vector<pcm_sample_t<F>> m_buffer;
+    std::vector<void*> m_channels;
+};
+
+//! Writes the periods of each channel directly into the DMA buffer.
+template <pcm_format F>
+class mmap_noninterleaved_playback
+{
+public:
+    mmap_noninterleaved_playback(
+            system::device& fd,
+            std::size_t const num_channels,
+            audio::period_size const period_size,
+            audio::period_count const period_count)
+        : m_mmap(
+                  fd,
+                  pcm_stream::playback,
+                  num_channels,
+                  sizeof(pcm_sample_t<F>),
+                  period_size,
+                  period_count)
+    {
+    }
+
+    auto channel_samples(std::size_t const channel) noexcept
+            -> std::span<pcm_sample_t<F>>
+    {
+        std::span<std::byte> const period = m_mmap.channel_period(channel);
+        return {reinterpret_cast<pcm_sample_t<F>*>(period.data()),
+                period.size() / sizeof(pcm_sample_t<F>)};
+    }
+
+    auto acquire() noexcept -> std::error_code
+    {
+        return m_mmap.acquire();
+    }
+
+    auto transfer() noexcept -> std::error_code
+    {
+        return m_mmap.commit();
+    }
+
+    auto hw_position() noexcept -> std::optional<pcm_hw_position>
+    {
+        return m_mmap.hw_position();
+    }
+
+private:
+    pcm_mmap m_mmap;
+};
 
-        std::ranges::fill(interleaved, pcm_convert::to<F>(constant));
+//! Each channel is contiguous already, the converters write it directly.
+template <pcm_format F, class Access>
+struct noninterleaved_writer final : pcm_writer
+{
+    noninterleaved_writer(
+            system::device& fd,
+            std::size_t const num_channels,
+            audio::period_size const period_size,
+            audio::period_count const period_count)
+        : m_num_channels(num_channels)
+        , m_period_size(period_size)
+        , m_access(fd, num_channels, period_size, period_count)
+        , m_converted(std::make_unique<bool[]>(num_channels))
+        , m_converter(algorithm::transform_to_vector(
+                  range::iota(num_channels),
+                  [this](std::size_t const channel) {
+                      return pcm_output_buffer_converter(
+                              [this, channel](pcm_output_source_buffer_t const&
+                                                      buffer) {
+                                  convert_source(channel, buffer);
+                              });
+                  }))
+    {
+    }
+
+    void convert_source(
+            std::size_t const channel,
+            pcm_output_source_buffer_t const& buffer) noexcept
+    {
+        BOOST_ASSERT(channel < m_num_channels);
+
+        pcm_convert::to_interleaved<F>(
+                std::span{&buffer, 1},
+                m_access.channel_samples(channel));
+        m_converted[channel] = true;
     }
 
     auto converter() const noexcept -> std::span<converter_f const> override
@@ -313,87 +986,181 @@ struct interleaved_writer final : pcm_writer
         return m_converter;
     }
 
+    auto acquire() noexcept -> std::error_code override
+    {
+        return m_access.acquire();
+    }
+
+    //! Channels without a source in this cycle are written silent.
     auto transfer() noexcept -> std::error_code override
     {
-        return writei(
-                m_fd,
-                m_write_buffer.data(),
-                m_period_size.get(),
-                m_num_channels);
+        for (std::size_t channel = 0; channel < m_num_channels; ++channel)
+        {
+            if (!std::exchange(m_converted[channel], false))
+            {
+                std::ranges::fill(
+                        m_access.channel_samples(channel),
+                        pcm_convert::to<F>(0.f));
+            }
+        }
+
+        return m_access.transfer();
+    }
+
+    auto hw_position() noexcept -> std::optional<pcm_hw_position> override
+    {
+        return m_access.hw_position();
     }
 
     void clear() noexcept override
     {
-        std::ranges::fill(m_write_buffer, pcm_sample_t<F>{});
+        std::fill_n(m_converted.get(), m_num_channels, false);
     }
 
 private:
-    system::device& m_fd;
     std::size_t m_num_channels;
     period_size m_period_size;
-    std::vector<pcm_sample_t<F>> m_write_buffer;
+    Access m_access;
+    std::unique_ptr<bool[]> m_converted;
     std::vector<converter_f> m_converter;
 };
 
+template <pcm_format F>
 auto
 make_writer(
         system::device& fd,
         pcm_device_config const& config,
-        audio::period_size const period_size) -> std::unique_ptr<pcm_writer>
+        audio::period_size const period_size,
+        audio::period_count const period_count) -> std::unique_ptr<pcm_writer>
 {
-    if (!fd)
+    if (config.interleaved)
     {
-        return std::make_unique<dummy_writer>();
+        if (config.mmap)
+        {
+            return std::make_unique<interleaved_writer<F, mmap_playback<F>>>(
+                    fd,
+                    config.num_channels,
+                    period_size,
+                    period_count);
+        }
+
+        return std::make_unique<interleaved_writer<F, rw_playback<F>>>(
+                fd,
+                config.num_channels,
+                period_size,
+                period_count);
     }
 
-    if (config.interleaved)
+    if (config.mmap)
     {
+        return std::make_unique<
+                noninterleaved_writer<F, mmap_noninterleaved_playback<F>>>(
+                fd,
+                config.num_channels,
+                period_size,
+                period_count);
+    }
 
-#define M_PIEJAM_INTERLEAVED_WRITER_CASE(Format)                               \
-    case Format:                                                               \
-        return std::make_unique<interleaved_writer<Format>>(                   \
-                fd,                                                            \
-                config.num_channels,                                           \
-                period_size)
+    return std::make_unique<
+            noninterleaved_writer<F, rw_noninterleaved_playback<F>>>(
+            fd,
+            config.num_channels,
+            period_size,
+            period_count);
+}
 
-        switch (config.format)
-        {
-            M_PIEJAM_INTERLEAVED_WRITER_CASE(pcm_format::s8);
-            M_PIEJAM_INTERLEAVED_WRITER_CASE(pcm_format::u8);
-            M_PIEJAM_INTERLEAVED_WRITER_CASE(pcm_format::s16_le);
-            M_PIEJAM_INTERLEAVED_WRITER_CASE(pcm_format::s16_be);
-            M_PIEJAM_INTERLEAVED_WRITER_CASE(pcm_format::u16_le);
-            M_PIEJAM_INTERLEAVED_WRITER_CASE(pcm_format::u16_be);
-            M_PIEJAM_INTERLEAVED_WRITER_CASE(pcm_format::s32_le);
-            M_PIEJAM_INTERLEAVED_WRITER_CASE(pcm_format::s32_be);
-            M_PIEJAM_INTERLEAVED_WRITER_CASE(pcm_format::u32_le);
-            M_PIEJAM_INTERLEAVED_WRITER_CASE(pcm_format::u32_be);
-            M_PIEJAM_INTERLEAVED_WRITER_CASE(pcm_format::s24_3le);
-            M_PIEJAM_INTERLEAVED_WRITER_CASE(pcm_format::s24_3be);
-            M_PIEJAM_INTERLEAVED_WRITER_CASE(pcm_format::u24_3le);
-            M_PIEJAM_INTERLEAVED_WRITER_CASE(pcm_format::u24_3be);
-
-            default:
-                BOOST_ASSERT(false);
-                return std::make_unique<dummy_writer>();
-        }
+} // namespace
+
+auto
+make_reader(
+        system::device& fd,
+        pcm_device_config const& config,
+        audio::period_size const period_size,
+        audio::period_count const period_count) -> std::unique_ptr<pcm_reader>
+{
+    if (!fd)
+    {
+        return std::make_unique<dummy_reader>();
+    }
+
+#define M_PIEJAM_READER_CASE(Format)                                           \
+    case Format:                                                               \
+        return make_reader<Format>(fd, config, period_size, period_count)
 
-#undef M_PIEJAM_INTERLEAVED_WRITER_CASE
+    switch (config.format)
+    {
+        M_PIEJAM_READER_CASE(pcm_format::s8);
+        M_PIEJAM_READER_CASE(pcm_format::u8);
+        M_PIEJAM_READER_CASE(pcm_format::s16_le);
+        M_PIEJAM_READER_CASE(pcm_format::s16_be);
+        M_PIEJAM_READER_CASE(pcm_format::u16_le);
+        M_PIEJAM_READER_CASE(pcm_format::u16_be);
+        M_PIEJAM_READER_CASE(pcm_format::s32_le);
+        M_PIEJAM_READER_CASE(pcm_format::s32_be);
+        M_PIEJAM_READER_CASE(pcm_format::u32_le);
+        M_PIEJAM_READER_CASE(pcm_format::u32_be);
+        M_PIEJAM_READER_CASE(pcm_format::s24_3le);
+        M_PIEJAM_READER_CASE(pcm_format::s24_3be);
+        M_PIEJAM_READER_CASE(pcm_format::u24_3le);
+        M_PIEJAM_READER_CASE(pcm_format::u24_3be);
+
+        default:
+            BOOST_ASSERT(false);
+            return std::make_unique<dummy_reader>();
     }
-    else
+
+#undef M_PIEJAM_READER_CASE
+}
+
+auto
+make_writer(
+        system::device& fd,
+        pcm_device_config const& config,
+        audio::period_size const period_size,
+        audio::period_count const period_count) -> std::unique_ptr<pcm_writer>
+{
+    if (!fd)
     {
         return std::make_unique<dummy_writer>();
     }
-}
 
-} // namespace
+#define M_PIEJAM_WRITER_CASE(Format)                                           \
+    case Format:                                                               \
+        return make_writer<Format>(fd, config, period_size, period_count)
+
+    switch (config.format)
+    {
+        M_PIEJAM_WRITER_CASE(pcm_format::s8);
+        M_PIEJAM_WRITER_CASE(pcm_format::u8);
+        M_PIEJAM_WRITER_CASE(pcm_format::s16_le);
+        M_PIEJAM_WRITER_CASE(pcm_format::s16_be);
+        M_PIEJAM_WRITER_CASE(pcm_format::u16_le);
+        M_PIEJAM_WRITER_CASE(pcm_format::u16_be);
+        M_PIEJAM_WRITER_CASE(pcm_format::s32_le);
+        M_PIEJAM_WRITER_CASE(pcm_format::s32_be);
+        M_PIEJAM_WRITER_CASE(pcm_format::u32_le);
+        M_PIEJAM_WRITER_CASE(pcm_format::u32_be);
+        M_PIEJAM_WRITER_CASE(pcm_format::s24_3le);
+        M_PIEJAM_WRITER_CASE(pcm_format::s24_3be);
+        M_PIEJAM_WRITER_CASE(pcm_format::u24_3le);
+        M_PIEJAM_WRITER_CASE(pcm_format::u24_3be);
+
+        default:
+            BOOST_ASSERT(false);
+            return std::make_unique<dummy_writer>();
+    }
+
+#undef M_PIEJAM_WRITER_CASE
+}
 
 process_step::process_step(
         system::device& input_fd,
         system::device& output_fd,
         pcm_io_config const& io_config,
+        std::span<std::unique_ptr<pcm_secondary> const> const secondaries,
         std::atomic<float>& cpu_load,
         std::atomic_size_t& xruns,
+        period_history& period_history,
         init_process_function const& init_process_function,
         process_function process_function)
     : m_input_fd(input_fd)
@@ -401,15 +1168,26 @@ process_step::process_step(
     , m_io_config(io_config)
     , m_cpu_load(cpu_load)
     , m_xruns(xruns)
+    , m_period_history(period_history)
     , m_process_function(std::move(process_function))
-    , m_reader(make_reader(
-              m_input_fd,
-              m_io_config.in_config,
-              m_io_config.process_config.period_size))
-    , m_writer(make_writer(
-              m_output_fd,
-              m_io_config.out_config,
-              m_io_config.process_config.period_size))
+    , m_reader(make_aggregate_reader(
+              m_input_fd ? m_input_fd : m_output_fd,
+              make_reader(
+                      m_input_fd,
+                      m_io_config.in_config,
+                      m_io_config.process_config.period_size,
+                      m_io_config.process_config.period_count),
+              secondaries,
+              m_io_config.process_config))
+    , m_writer(make_aggregate_writer(
+              m_input_fd ? m_input_fd : m_output_fd,
+              make_writer(
+                      m_output_fd,
+                      m_io_config.out_config,
+                      m_io_config.process_config.period_size,
+                      m_io_config.process_config.period_count),
+              secondaries,
+              m_io_config.process_config))
     , m_cpu_load_mean_acc(
               io_config.process_config.sample_rate.to_samples(
                       std::chrono::seconds{1}) /
@@ -438,12 +1216,17 @@ process_step::operator()() -> std::error_condition
 
         if (m_output_fd)
         {
-            m_writer->clear();
-
             for (unsigned i = 0;
                  i < m_io_config.process_config.period_count.get();
                  ++i)
             {
+                if (auto err = m_writer->acquire())
+                {
+                    return err.default_error_condition();
+                }
+
+                m_writer->clear();
+
                 if (auto err = m_writer->transfer())
                 {
                     return err.default_error_condition();
@@ -463,8 +1246,32 @@ process_step::operator()() -> std::error_condition
         m_starting = false;
     }
 
+    period_record record;
+    auto const read_start = clock_t::now();
+
     auto err = m_reader->transfer();
 
+    if (!err)
+    {
+        err = m_writer->acquire();
+    }
+
+    if (!err)
+    {
+        auto position = m_reader->hw_position();
+        if (!position)
+        {
+            position = m_writer->hw_position();
+        }
+
+        record.wakeup_latency = wakeup_latency(
+                position,
+                m_io_config.process_config.sample_rate);
+    }
+
+    auto const process_start = clock_t::now();
+    record.read = process_start - read_start;
+
     if (!err)
     {
         cpu_load_meter cpu_load_meter(
@@ -477,12 +1284,25 @@ process_step::operator()() -> std::error_condition
                 m_cpu_load_mean_acc(cpu_load_meter.stop()),
                 std::memory_order_relaxed);
 
-        err = m_writer->transfer();
+        auto const write_start = clock_t::now();
+        record.process = write_start - process_start;
+
+        err = m_reader->release();
+
+        if (!err)
+        {
+            err = m_writer->transfer();
+        }
+
+        record.write = clock_t::now() - write_start;
     }
 
+    record.xrun = err == std::make_error_code(std::errc::broken_pipe);
+    m_period_history.record(record);
+
     if (err)
     {
-        if (err == std::make_error_code(std::errc::broken_pipe))
+        if (record.xrun)
         {
             m_starting = true;
             ++m_xruns;
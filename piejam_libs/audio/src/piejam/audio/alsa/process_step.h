@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <piejam/audio/fwd.h>
 #include <piejam/audio/pcm_io_config.h>
 #include <piejam/audio/process_function.h>
 #include <piejam/numeric/rolling_mean.h>
@@ -11,6 +12,7 @@
 
 #include <atomic>
 #include <memory>
+#include <span>
 #include <system_error>
 #include <vector>
 
@@ -18,6 +20,7 @@ namespace piejam::audio::alsa
 {
 
 class pcm_reader;
+class pcm_secondary;
 class pcm_writer;
 
 class process_step
@@ -27,8 +30,10 @@ public:
             system::device& input_fd,
             system::device& output_fd,
             pcm_io_config const&,
+            std::span<std::unique_ptr<pcm_secondary> const>,
             std::atomic<float>& cpu_load,
             std::atomic_size_t& xruns,
+            period_history&,
             init_process_function const&,
             process_function);
     process_step(process_step&&);
@@ -42,6 +47,7 @@ private:
     pcm_io_config m_io_config;
     std::atomic<float>& m_cpu_load;
     std::atomic_size_t& m_xruns;
+    period_history& m_period_history;
     process_function m_process_function;
 
     bool m_starting{true};
@@ -0,0 +1,180 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/clock_bridge.h>
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <bit>
+
+namespace piejam::audio
+{
+
+namespace
+{
+
+// far beyond the tolerance of audio clocks, but bounds the pitch shift
+constexpr double max_drift = 0.005;
+
+// the controller is critically damped, the fill level settles within a few
+// time constants
+constexpr double time_constant = 2.; // seconds
+
+} // namespace
+
+clock_bridge::clock_bridge(
+        std::size_t const num_channels,
+        sample_rate const sample_rate,
+        std::size_t const producer_period_size,
+        std::size_t const consumer_period_size)
+    : m_num_channels(num_channels)
+    , m_sample_rate(sample_rate.get())
+    , m_consumer_period(static_cast<double>(consumer_period_size))
+    , m_target_fill(2 * producer_period_size + consumer_period_size)
+    , m_capacity(std::bit_ceil(4 * m_target_fill))
+    , m_ring(m_capacity * num_channels)
+    , m_resampler(num_channels, consumer_period_size, 1. + max_drift)
+{
+    BOOST_ASSERT(num_channels > 0);
+    BOOST_ASSERT(sample_rate.valid());
+}
+
+void
+clock_bridge::push(
+        std::span<float const> const frames,
+        timestamp const time) noexcept
+{
+    BOOST_ASSERT(frames.size() % m_num_channels == 0);
+
+    std::uint64_t const written = m_written.load(std::memory_order_relaxed);
+    std::uint64_t const read = m_read.load(std::memory_order_acquire);
+
+    std::size_t const free =
+            m_capacity - static_cast<std::size_t>(written - read);
+    std::size_t const num_frames =
+            std::min(frames.size() / m_num_channels, free);
+
+    std::size_t const begin = written % m_capacity;
+    std::size_t const first = std::min(num_frames, m_capacity - begin);
+
+    std::copy_n(
+            frames.begin(),
+            first * m_num_channels,
+            m_ring.begin() +
+                    static_cast<std::ptrdiff_t>(begin * m_num_channels));
+    std::copy_n(
+            frames.begin() +
+                    static_cast<std::ptrdiff_t>(first * m_num_channels),
+            (num_frames - first) * m_num_channels,
+            m_ring.begin());
+
+    m_written.store(written + num_frames, std::memory_order_release);
+    m_producer_position.push({.frames = written + num_frames, .time = time});
+}
+
+void
+clock_bridge::read(std::span<float> const frames) noexcept
+{
+    std::uint64_t const read = m_read.load(std::memory_order_relaxed);
+
+    std::size_t const num_frames = frames.size() / m_num_channels;
+    std::size_t const begin = read % m_capacity;
+    std::size_t const first = std::min(num_frames, m_capacity - begin);
+
+    auto const ring_begin =
+            m_ring.begin() +
+            static_cast<std::ptrdiff_t>(begin * m_num_channels);
+    std::copy_n(ring_begin, first * m_num_channels, frames.begin());
+    std::copy_n(
+            m_ring.begin(),
+            (num_frames - first) * m_num_channels,
+            frames.begin() +
+                    static_cast<std::ptrdiff_t>(first * m_num_channels));
+
+    m_read.store(read + num_frames, std::memory_order_release);
+}
+
+void
+clock_bridge::resync() noexcept
+{
+    m_running = false;
+    m_resyncs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+clock_bridge::pull(std::span<float> const frames, timestamp const time) noexcept
+{
+    BOOST_ASSERT(frames.size() % m_num_channels == 0);
+    std::size_t const num_frames = frames.size() / m_num_channels;
+
+    m_producer_position.pull(m_last_producer_position);
+
+    std::uint64_t const written = m_written.load(std::memory_order_acquire);
+    std::size_t available = static_cast<std::size_t>(
+            written - m_read.load(std::memory_order_relaxed));
+
+    if (m_running && available > 2 * m_target_fill)
+    {
+        resync();
+    }
+
+    if (!m_running)
+    {
+        if (available < m_target_fill)
+        {
+            std::ranges::fill(frames, 0.f);
+            return;
+        }
+
+        // skip to the target, the producer might have been running for a
+        // while already
+        m_read.store(written - m_target_fill, std::memory_order_release);
+        available = m_target_fill;
+
+        m_resampler.reset();
+        m_integral = 0.;
+        m_ratio = 1.;
+        m_running = true;
+    }
+
+    // fill level at our timestamp, the producer position is extrapolated
+    // from its last timestamp
+    double const elapsed = std::chrono::duration<double>(
+                                   time - m_last_producer_position.time)
+                                   .count();
+    double const fill =
+            static_cast<double>(m_last_producer_position.frames) +
+            elapsed * m_sample_rate -
+            static_cast<double>(m_read.load(std::memory_order_relaxed));
+    double const error = fill - static_cast<double>(m_target_fill);
+
+    double const kp = 1. / (time_constant * m_sample_rate);
+    double const ki =
+            1. / (4. * time_constant * time_constant * m_sample_rate);
+
+    m_integral = std::clamp(
+            m_integral + error * m_consumer_period / m_sample_rate,
+            -max_drift / ki,
+            max_drift / ki);
+    m_ratio = 1. + std::clamp(kp * error + ki * m_integral,
+                              -max_drift,
+                              max_drift);
+
+    auto const ratio = static_cast<float>(m_ratio);
+    std::size_t const input_frames =
+            m_resampler.input_frames(num_frames, ratio);
+
+    if (input_frames > available)
+    {
+        resync();
+        std::ranges::fill(frames, 0.f);
+        return;
+    }
+
+    read(m_resampler.input_buffer(input_frames));
+    m_resampler.process(input_frames, ratio, frames);
+}
+
+} // namespace piejam::audio
@@ -0,0 +1,47 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/engine/adaptive_worker_count.h>
+
+#include <boost/assert.hpp>
+
+namespace piejam::audio::engine
+{
+
+adaptive_worker_count::adaptive_worker_count(
+        std::size_t const max_workers,
+        float const shrink_below,
+        float const grow_above) noexcept
+    : m_max_workers(max_workers)
+    , m_shrink_below(shrink_below)
+    , m_grow_above(grow_above)
+    , m_value(max_workers)
+{
+    BOOST_ASSERT(shrink_below < grow_above);
+}
+
+auto
+adaptive_worker_count::update(float const cpu_load) noexcept -> std::size_t
+{
+    if (cpu_load > m_grow_above)
+    {
+        if (m_value < m_max_workers)
+        {
+            ++m_value;
+        }
+    }
+    else if (m_value > 0)
+    {
+        // the calling thread is processing as well
+        auto const num_threads = static_cast<float>(m_value + 1);
+        if (cpu_load * num_threads / (num_threads - 1.f) < m_shrink_below)
+        {
+            --m_value;
+        }
+    }
+
+    return m_value;
+}
+
+} // namespace piejam::audio::engine
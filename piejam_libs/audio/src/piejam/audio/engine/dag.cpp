@@ -8,7 +8,10 @@
 #include <piejam/audio/engine/dag_executor.h>
 #include <piejam/audio/engine/event_buffer_memory.h>
 #include <piejam/audio/engine/thread_context.h>
+#include <piejam/audio/engine/tracer.h>
 #include <piejam/range/indices.h>
+#include <piejam/thread/wait_policy.h>
+#include <piejam/thread/work_stealing_deque.h>
 #include <piejam/thread/worker.h>
 
 #include <boost/assert.hpp>
@@ -16,8 +19,15 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
 #include <ranges>
 #include <span>
+#include <unordered_map>
 #include <vector>
 
 namespace piejam::audio::engine
@@ -26,131 +36,323 @@ namespace piejam::audio::engine
 namespace
 {
 
-class dag_executor_base : public dag_executor
+//! The dag compiled into contiguous arrays. Nodes are stored in topological
+//! order, their children in compressed sparse row format. The counters of
+//! unprocessed parents are kept in a separate array, so they can be reset
+//! with a single copy.
+class compiled_dag
 {
-protected:
-    dag_executor_base(dag::tasks_t const& tasks, dag::graph_t const& graph)
-        : m_nodes(make_nodes(tasks, graph))
+public:
+    using node_index_t = std::uint32_t;
+    using counter_t = std::uint32_t;
+
+    static constexpr node_index_t no_node =
+            std::numeric_limits<node_index_t>::max();
+
+    compiled_dag(dag::tasks_t const& tasks, dag::graph_t const& graph)
+    {
+        BOOST_ASSERT(tasks.size() < no_node);
+
+        std::unordered_map<dag::task_id_t, node_index_t> index_of;
+        for (std::size_t const i : range::indices(tasks))
+        {
+            index_of[tasks[i].first] = static_cast<node_index_t>(i);
+        }
+
+        std::vector<std::vector<node_index_t>> children(tasks.size());
+        std::vector<counter_t> num_parents(tasks.size());
+        for (auto const& [parent_id, child_ids] : graph)
+        {
+            BOOST_ASSERT(index_of.count(parent_id));
+            auto& parent_children = children[index_of[parent_id]];
+            for (dag::task_id_t const child_id : child_ids)
+            {
+                BOOST_ASSERT(index_of.count(child_id));
+                parent_children.push_back(index_of[child_id]);
+                ++num_parents[index_of[child_id]];
+            }
+        }
+
+        // Kahn's algorithm, the roots end up at the front.
+        std::vector<node_index_t> order;
+        order.reserve(tasks.size());
+        std::vector<counter_t> parents_left(num_parents);
+        for (std::size_t const i : range::indices(tasks))
+        {
+            if (num_parents[i] == 0)
+            {
+                order.push_back(static_cast<node_index_t>(i));
+            }
+        }
+
+        m_num_roots = order.size();
+
+        for (std::size_t k = 0; k < order.size(); ++k)
+        {
+            for (node_index_t const child : children[order[k]])
+            {
+                if (--parents_left[child] == 0)
+                {
+                    order.push_back(child);
+                }
+            }
+        }
+
+        BOOST_ASSERT(order.size() == tasks.size());
+
+        std::vector<node_index_t> position_of(tasks.size());
+        for (std::size_t const k : range::indices(order))
+        {
+            position_of[order[k]] = static_cast<node_index_t>(k);
+        }
+
+        m_tasks.reserve(order.size());
+        m_nodes.reserve(order.size());
+        m_children_offsets.reserve(order.size() + 1);
+        m_num_parents.reserve(order.size());
+
+        for (node_index_t const i : order)
+        {
+            dag::task_t const& task = tasks[i].second;
+            m_tasks.push_back(task);
+            m_nodes.push_back({task.function(), task.context()});
+
+            m_children_offsets.push_back(m_children.size());
+            std::ranges::transform(
+                    children[i],
+                    std::back_inserter(m_children),
+                    [&position_of](node_index_t const child) {
+                        return position_of[child];
+                    });
+
+            m_num_parents.push_back(num_parents[i]);
+        }
+
+        m_children_offsets.push_back(m_children.size());
+        m_parents_to_process = m_num_parents;
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return m_nodes.size();
+    }
+
+    //! Nodes without parents, they are at the front.
+    [[nodiscard]] auto num_roots() const noexcept -> std::size_t
+    {
+        return m_num_roots;
+    }
+
+    void run(node_index_t const n, thread_context const& ctx) const
+    {
+        BOOST_ASSERT(n < m_nodes.size());
+        m_nodes[n].function(m_nodes[n].context, ctx);
+    }
+
+    [[nodiscard]] auto children(node_index_t const n) const noexcept
+            -> std::span<node_index_t const>
+    {
+        return std::span{m_children}.subspan(
+                m_children_offsets[n],
+                m_children_offsets[n + 1] - m_children_offsets[n]);
+    }
+
+    void reset_parents_to_process() noexcept
+    {
+        std::memcpy(
+                m_parents_to_process.data(),
+                m_num_parents.data(),
+                m_num_parents.size() * sizeof(counter_t));
+    }
+
+    [[nodiscard]] auto parents_to_process(node_index_t const n) noexcept
+            -> counter_t
+    {
+        return std::atomic_ref{m_parents_to_process[n]}.load(
+                std::memory_order_relaxed);
+    }
+
+    //! Returns true, if it was the last parent to process.
+    auto parent_processed(
+            node_index_t const n,
+            std::memory_order const order) noexcept -> bool
     {
+        return 1 == std::atomic_ref{m_parents_to_process[n]}.fetch_sub(
+                            1,
+                            order);
     }
 
-    struct node;
-    using node_ref = std::reference_wrapper<node>;
+private:
+    static_assert(std::atomic_ref<counter_t>::is_always_lock_free);
+    static_assert(
+            std::atomic_ref<counter_t>::required_alignment ==
+            alignof(counter_t));
 
     struct node
     {
-        std::atomic_size_t parents_to_process{};
-        std::size_t num_parents{};
-        dag::task_t task;
-        std::vector<node_ref> children;
+        dag_task::function_t function;
+        void* context;
     };
 
-    static void init_node_for_process(node& n)
+    //! Keeps the task contexts alive.
+    std::vector<dag::task_t> m_tasks;
+
+    std::vector<node> m_nodes;
+    std::vector<std::size_t> m_children_offsets;
+    std::vector<node_index_t> m_children;
+    std::vector<counter_t> m_num_parents;
+    std::vector<counter_t> m_parents_to_process;
+    std::size_t m_num_roots{};
+};
+
+auto
+active_ring(tracer const* const t, std::size_t const thread_index) noexcept
+        -> trace_ring*
+{
+    return t ? t->active_ring(thread_index) : nullptr;
+}
+
+//! Records the whole period as a span, if the thread is tracing.
+class period_trace
+{
+public:
+    explicit period_trace(trace_ring* const ring) noexcept
+        : m_ring(ring)
+        , m_begin(ring ? trace_event::clock_t::now()
+                       : trace_event::clock_t::time_point{})
     {
-        n.parents_to_process.store(n.num_parents, std::memory_order_relaxed);
     }
 
-    using nodes_t = std::unordered_map<dag::task_id_t, node>;
+    period_trace(period_trace const&) = delete;
+    auto operator=(period_trace const&) -> period_trace& = delete;
 
-    nodes_t m_nodes;
+    ~period_trace()
+    {
+        if (m_ring)
+        {
+            m_ring->record("period", m_begin, trace_event::clock_t::now());
+        }
+    }
 
 private:
-    static auto make_nodes(dag::tasks_t const& tasks, dag::graph_t const& graph)
-            -> nodes_t
+    trace_ring* m_ring;
+    trace_event::clock_t::time_point m_begin;
+};
+
+using idle_time_t = std::atomic<std::chrono::nanoseconds::rep>;
+
+static_assert(idle_time_t::is_always_lock_free);
+
+auto
+take_idle_time(idle_time_t& idle_time) noexcept -> std::chrono::nanoseconds
+{
+    return std::chrono::nanoseconds{
+            idle_time.exchange(0, std::memory_order_relaxed)};
+}
+
+//! Measures the time a thread waits, and adds it to the idle time of the
+//! executor when going out of scope.
+class idle_stopwatch
+{
+public:
+    explicit idle_stopwatch(idle_time_t& idle_time) noexcept
+        : m_idle_time(idle_time)
+    {
+    }
+
+    idle_stopwatch(idle_stopwatch const&) = delete;
+    auto operator=(idle_stopwatch const&) -> idle_stopwatch& = delete;
+
+    ~idle_stopwatch()
     {
-        nodes_t nodes;
-        for (auto const& [id, task] : tasks)
+        stop();
+
+        if (m_sum != clock_t::duration::zero())
         {
-            nodes[id].task = task;
+            m_idle_time.fetch_add(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            m_sum)
+                            .count(),
+                    std::memory_order_relaxed);
         }
+    }
 
-        for (auto const& [parent_id, children] : graph)
+    void start() noexcept
+    {
+        if (!m_running)
         {
-            BOOST_ASSERT(nodes.count(parent_id));
-            std::ranges::transform(
-                    children,
-                    std::back_inserter(nodes[parent_id].children),
-                    [&nodes](dag::task_id_t const child_id) {
-                        BOOST_ASSERT(nodes.count(child_id));
-                        return std::ref(nodes[child_id]);
-                    });
-
-            for (dag::task_id_t const child_id : children)
-            {
-                ++nodes[child_id].num_parents;
-            }
+            m_begin = clock_t::now();
+            m_running = true;
         }
+    }
 
-        return nodes;
+    void stop() noexcept
+    {
+        if (m_running)
+        {
+            m_sum += clock_t::now() - m_begin;
+            m_running = false;
+        }
     }
+
+private:
+    using clock_t = std::chrono::steady_clock;
+
+    idle_time_t& m_idle_time;
+    clock_t::time_point m_begin;
+    clock_t::duration m_sum{};
+    bool m_running{};
 };
 
-class dag_executor_st final : public dag_executor_base
+class dag_executor_st final : public dag_executor
 {
 public:
     dag_executor_st(
             dag::tasks_t const& tasks,
             dag::graph_t const& graph,
-            std::size_t const event_memory_size)
-        : dag_executor_base(tasks, graph)
+            std::size_t const event_memory_size,
+            tracer const* const tracer)
+        : m_dag(tasks, graph)
         , m_event_memory(event_memory_size)
+        , m_tracer(tracer)
     {
-        m_run_queue.reserve(m_nodes.size());
     }
 
     void operator()(std::size_t const buffer_size) override
     {
-        for (auto& [id, nd] : m_nodes)
-        {
-            init_node_for_process(nd);
-
-            if (nd.num_parents == 0)
-            {
-                BOOST_ASSERT(m_run_queue.size() < m_run_queue.capacity());
-                m_run_queue.emplace_back(std::addressof(nd));
-            }
-        }
-
         m_thread_context.buffer_size = buffer_size;
+        m_thread_context.trace = active_ring(m_tracer, 0);
 
-        while (!m_run_queue.empty())
-        {
-            node* const nd = m_run_queue.back();
-            m_run_queue.pop_back();
-
-            BOOST_ASSERT(
-                    nd->parents_to_process.load(std::memory_order_relaxed) ==
-                    0);
-            nd->task(m_thread_context);
+        period_trace const trace(m_thread_context.trace);
 
-            for (node& child : nd->children)
-            {
-                if (1 == child.parents_to_process.fetch_sub(
-                                 1,
-                                 std::memory_order_relaxed))
-                {
-                    BOOST_ASSERT(m_run_queue.size() < m_run_queue.capacity());
-                    m_run_queue.push_back(std::addressof(child));
-                }
-            }
+        // the nodes are stored in topological order, so we can just run
+        // them one after another
+        for (std::size_t n = 0, e = m_dag.size(); n < e; ++n)
+        {
+            m_dag.run(static_cast<node_index_t>(n), m_thread_context);
         }
 
         m_event_memory.release();
     }
 
 private:
+    using node_index_t = compiled_dag::node_index_t;
+
+    compiled_dag const m_dag;
     audio::engine::event_buffer_memory m_event_memory;
     audio::engine::thread_context m_thread_context{
             &m_event_memory.memory_resource()};
-    std::vector<node*> m_run_queue;
+    tracer const* m_tracer;
 };
 
-class dag_executor_mt final : public dag_executor_base
+class dag_executor_mt final : public dag_executor
 {
 public:
+    using node_index_t = compiled_dag::node_index_t;
+
     static constexpr std::size_t job_queue_capacity = 1024;
     using jobs_t = boost::lockfree::stack<
-            node*,
+            node_index_t,
             boost::lockfree::fixed_sized<true>,
             boost::lockfree::capacity<job_queue_capacity>>;
 
@@ -158,42 +360,63 @@ public:
             dag::tasks_t const& tasks,
             dag::graph_t const& graph,
             std::size_t const event_memory_size,
-            std::span<thread::worker> const worker_threads)
-        : dag_executor_base(tasks, graph)
+            std::span<thread::worker> const worker_threads,
+            tracer const* const tracer)
+        : m_dag(tasks, graph)
         , m_worker_threads(worker_threads)
-        , m_initial_tasks(distribute_initial_tasks(m_nodes))
         , m_main_worker(
+                  0,
                   event_memory_size,
+                  m_dag,
                   m_nodes_to_process,
+                  m_active_workers,
                   m_buffer_size,
-                  m_run_queue)
+                  m_run_queue,
+                  m_idle_time,
+                  thread::wait_policy{},
+                  tracer,
+                  false)
         , m_workers(make_workers(
-                  worker_threads.size(),
+                  worker_threads,
                   event_memory_size,
+                  m_dag,
                   m_nodes_to_process,
+                  m_active_workers,
                   m_buffer_size,
-                  m_run_queue))
+                  m_run_queue,
+                  m_idle_time,
+                  tracer))
+        , m_tracer(tracer)
+    {
+    }
+
+    ~dag_executor_mt() override
     {
+        wait_for_workers();
     }
 
     void operator()(std::size_t const buffer_size) override
     {
+        period_trace const trace(active_ring(m_tracer, 0));
+
+        // Workers of the previous period might still be about to leave their
+        // processing loop. They must be done, before the dag is reset.
+        wait_for_workers();
+
         m_buffer_size.store(buffer_size, std::memory_order_relaxed);
 
-        for (auto&& [id, n] : m_nodes)
-        {
-            init_node_for_process(n);
-        }
+        m_dag.reset_parents_to_process();
 
-        for (node* const n : m_initial_tasks)
+        for (std::size_t n = 0, e = m_dag.num_roots(); n < e; ++n)
         {
-            m_run_queue.unsynchronized_push(n);
+            m_run_queue.unsynchronized_push(static_cast<node_index_t>(n));
         }
 
-        m_nodes_to_process.store(m_nodes.size(), std::memory_order_release);
+        m_nodes_to_process.store(m_dag.size(), std::memory_order_release);
+        m_active_workers.store(m_num_workers + 1, std::memory_order_release);
 
         BOOST_ASSERT(m_workers.size() == m_worker_threads.size());
-        for (std::size_t const w : range::indices(m_worker_threads))
+        for (std::size_t w = 0; w < m_num_workers; ++w)
         {
             // Wrap into a reference_wrapper here to guarantee small-object
             // optimization inside the worker thread.
@@ -203,79 +426,119 @@ public:
         m_main_worker();
     }
 
-private:
-    static auto distribute_initial_tasks(nodes_t& nodes) -> std::vector<node*>
+    void set_num_workers(std::size_t const num_workers) noexcept override
     {
-        std::vector<node*> initial_tasks;
-        initial_tasks.reserve(nodes.size());
+        m_num_workers = std::min(num_workers, m_worker_threads.size());
+    }
+
+    auto take_idle_time() noexcept -> std::chrono::nanoseconds override
+    {
+        return engine::take_idle_time(m_idle_time);
+    }
 
-        for (auto&& [id, node] : nodes)
+private:
+    void wait_for_workers() const noexcept
+    {
+        thread::backoff idle(thread::wait_policy{});
+        while (m_active_workers.load(std::memory_order_acquire))
         {
-            if (node.num_parents == 0)
-            {
-                initial_tasks.push_back(std::addressof(node));
-            }
+            idle();
         }
-
-        return initial_tasks;
     }
 
     struct dag_worker
     {
         dag_worker(
+                std::size_t const index,
                 std::size_t const event_memory_size,
+                compiled_dag& dag,
                 std::atomic_size_t& nodes_to_process,
+                std::atomic_size_t& active_workers,
                 std::atomic_size_t& buffer_size,
-                jobs_t& run_queue)
-            : m_event_memory(event_memory_size)
+                jobs_t& run_queue,
+                idle_time_t& idle_time,
+                thread::wait_policy const& wait_policy,
+                tracer const* const tracer,
+                bool const leave_when_idle)
+            : m_index(index)
+            , m_event_memory(event_memory_size)
+            , m_dag(dag)
             , m_nodes_to_process(nodes_to_process)
+            , m_active_workers(active_workers)
             , m_buffer_size(buffer_size)
             , m_run_queue(run_queue)
+            , m_idle_time(idle_time)
+            , m_wait_policy(wait_policy)
+            , m_tracer(tracer)
+            , m_leave_when_idle(leave_when_idle)
         {
         }
 
         void operator()()
         {
+            // A worker might leave before the run is finished, so events it
+            // allocated could still be consumed by others. Hence the memory
+            // is released not before the next run.
+            m_event_memory.release();
+
             m_thread_context.buffer_size =
                     m_buffer_size.load(std::memory_order_relaxed);
+            m_thread_context.trace = active_ring(m_tracer, m_index);
 
-            while (m_nodes_to_process.load(std::memory_order_acquire))
             {
-                node* n{};
-                if (m_run_queue.pop(n))
+                thread::backoff idle(m_wait_policy);
+                idle_stopwatch idle_time(m_idle_time);
+
+                while (m_nodes_to_process.load(std::memory_order_acquire))
                 {
-                    while (n)
+                    node_index_t n{};
+                    if (m_run_queue.pop(n))
+                    {
+                        idle_time.stop();
+
+                        while (n != compiled_dag::no_node)
+                        {
+                            n = process_node(n);
+                        }
+
+                        idle.reset();
+                    }
+                    else if (m_leave_when_idle && idle.exhausted())
                     {
-                        n = process_node(*n);
+                        // Park in the worker thread, the main worker will
+                        // finish the run.
+                        break;
+                    }
+                    else
+                    {
+                        idle_time.start();
+                        idle();
                     }
                 }
             }
 
-            m_event_memory.release();
+            m_active_workers.fetch_sub(1, std::memory_order_release);
         }
 
     private:
-        auto process_node(node& n) -> node*
+        auto process_node(node_index_t const n) -> node_index_t
         {
-            BOOST_ASSERT(
-                    n.parents_to_process.load(std::memory_order_relaxed) == 0);
+            BOOST_ASSERT(m_dag.parents_to_process(n) == 0);
 
-            n.task(m_thread_context);
+            m_dag.run(n, m_thread_context);
 
-            node* next{};
-            for (node& child : n.children)
+            node_index_t next{compiled_dag::no_node};
+            for (node_index_t const child : m_dag.children(n))
             {
-                if (1 == child.parents_to_process.fetch_sub(
-                                 1,
-                                 std::memory_order_acq_rel))
+                if (m_dag.parent_processed(child, std::memory_order_acq_rel))
                 {
-                    if (next)
+                    if (next != compiled_dag::no_node)
                     {
-                        m_run_queue.push(std::addressof(child));
+                        m_run_queue.push(child);
                     }
                     else
                     {
-                        next = std::addressof(child);
+                        next = child;
                     }
                 }
             }
@@ -287,12 +550,19 @@ private:
             return next;
         }
 
+        std::size_t m_index;
         audio::engine::event_buffer_memory m_event_memory;
         audio::engine::thread_context m_thread_context{
                 &m_event_memory.memory_resource()};
+        compiled_dag& m_dag;
         std::atomic_size_t& m_nodes_to_process;
+        std::atomic_size_t& m_active_workers;
         std::atomic_size_t& m_buffer_size;
         jobs_t& m_run_queue;
+        idle_time_t& m_idle_time;
+        thread::wait_policy m_wait_policy;
+        tracer const* m_tracer;
+        bool m_leave_when_idle;
 
         static_assert(std::atomic_size_t::is_always_lock_free);
     };
@@ -300,115 +570,925 @@ private:
     using workers_t = std::vector<dag_worker>;
 
     static auto make_workers(
-            std::size_t const num_workers,
+            std::span<thread::worker const> const worker_threads,
             std::size_t const event_memory_size,
+            compiled_dag& dag,
             std::atomic_size_t& nodes_to_process,
+            std::atomic_size_t& active_workers,
             std::atomic_size_t& buffer_size,
-            jobs_t& run_queue) -> workers_t
+            jobs_t& run_queue,
+            idle_time_t& idle_time,
+            tracer const* const tracer) -> workers_t
     {
         workers_t workers;
-        workers.reserve(num_workers);
+        workers.reserve(worker_threads.size());
 
-        for (std::size_t i = 1; i < num_workers + 1; ++i)
+        // index 0 is the main worker
+        for (std::size_t const i : range::indices(worker_threads))
         {
             workers.emplace_back(
+                    i + 1,
                     event_memory_size,
+                    dag,
                     nodes_to_process,
+                    active_workers,
                     buffer_size,
-                    run_queue);
+                    run_queue,
+                    idle_time,
+                    worker_threads[i].wait_policy(),
+                    tracer,
+                    true);
         }
 
         return workers;
     }
 
+    compiled_dag m_dag;
     std::span<thread::worker> m_worker_threads;
     std::atomic_size_t m_nodes_to_process{};
-    std::vector<node*> const m_initial_tasks;
+    std::atomic_size_t m_active_workers{};
     jobs_t m_run_queue;
+    idle_time_t m_idle_time{};
     dag_worker m_main_worker;
     std::atomic_size_t m_buffer_size{};
     workers_t m_workers;
+    std::size_t m_num_workers{m_worker_threads.size()};
+    tracer const* m_tracer;
 };
 
-auto
-is_descendent(
-        dag::graph_t const& t,
-        dag::task_id_t const parent,
-        dag::task_id_t const descendent) -> bool
+class dag_executor_ws final : public dag_executor
 {
-    if (parent == descendent)
+public:
+    using node_index_t = compiled_dag::node_index_t;
+    using job_queue_t = thread::work_stealing_deque<node_index_t>;
+    using job_queues_t = std::vector<std::unique_ptr<job_queue_t>>;
+
+    dag_executor_ws(
+            dag::tasks_t const& tasks,
+            dag::graph_t const& graph,
+            std::size_t const event_memory_size,
+            std::span<thread::worker> const worker_threads,
+            tracer const* const tracer)
+        : m_dag(tasks, graph)
+        , m_worker_threads(worker_threads)
+        , m_job_queues(
+                  make_job_queues(worker_threads.size() + 1, m_dag.size()))
+        , m_workers(make_workers(
+                  worker_threads,
+                  event_memory_size,
+                  m_dag,
+                  m_job_queues,
+                  m_nodes_to_process,
+                  m_active_workers,
+                  m_buffer_size,
+                  m_idle_time,
+                  tracer))
+        , m_tracer(tracer)
     {
-        return true;
     }
 
-    return std::ranges::any_of(
-            t.at(parent),
-            [&t, descendent](dag::task_id_t const child) {
-                return is_descendent(t, child, descendent);
-            });
-}
+    ~dag_executor_ws() override
+    {
+        wait_for_workers();
+    }
 
-} // namespace
+    void operator()(std::size_t const buffer_size) override
+    {
+        period_trace const trace(active_ring(m_tracer, 0));
 
-dag::dag() = default;
+        // Workers of the previous period might still be about to leave their
+        // processing loop. They must be done, before we touch their queues.
+        wait_for_workers();
 
-auto
-dag::add_task(task_t t) -> task_id_t
-{
-    auto id = m_free_id++;
-    m_tasks.emplace_back(id, std::move(t));
-    m_graph[id];
-    return id;
-}
+        m_buffer_size.store(buffer_size, std::memory_order_relaxed);
 
-auto
-dag::add_child_task(task_id_t const parent, task_t t) -> task_id_t
-{
-    auto it = m_graph.find(parent);
+        m_dag.reset_parents_to_process();
 
-    BOOST_ASSERT_MSG(it != m_graph.end(), "parent node not found");
+        // Distribute the roots round robin over the queues of the workers
+        // taking part in this run.
+        std::size_t const num_queues = m_num_workers + 1;
+        for (std::size_t n = 0, e = m_dag.num_roots(); n < e; ++n)
+        {
+            m_job_queues[n % num_queues]->push(static_cast<node_index_t>(n));
+        }
 
-    auto id = add_task(std::move(t));
-    it->second.push_back(id);
-    return id;
-}
+        m_nodes_to_process.store(m_dag.size(), std::memory_order_release);
+        m_active_workers.store(num_queues, std::memory_order_release);
 
-void
-dag::add_child(task_id_t const parent, task_id_t const child)
-{
-    auto it_parent = m_graph.find(parent);
+        BOOST_ASSERT(m_workers.size() == m_worker_threads.size() + 1);
+        for (std::size_t w = 0; w < m_num_workers; ++w)
+        {
+            // Wrap into a reference_wrapper here to guarantee small-object
+            // optimization inside the worker thread.
+            m_worker_threads[w].wakeup(std::ref(m_workers[w + 1]));
+        }
 
-    BOOST_ASSERT_MSG(it_parent != m_graph.end(), "parent node not found");
+        m_workers.front()();
+    }
 
-    auto it_child = m_graph.find(child);
+    void set_num_workers(std::size_t const num_workers) noexcept override
+    {
+        m_num_workers = std::min(num_workers, m_worker_threads.size());
+    }
 
-    BOOST_ASSERT_MSG(it_child != m_graph.end(), "child node not found");
+    auto take_idle_time() noexcept -> std::chrono::nanoseconds override
+    {
+        return engine::take_idle_time(m_idle_time);
+    }
 
-    BOOST_ASSERT_MSG(
-            !is_descendent(m_graph, it_child->first, it_parent->first),
-            "child is ancestor of the parent");
+private:
+    void wait_for_workers() const noexcept
+    {
+        thread::backoff idle(thread::wait_policy{});
+        while (m_active_workers.load(std::memory_order_acquire))
+        {
+            idle();
+        }
+    }
 
-    it_parent->second.push_back(it_child->first);
-}
+    static auto make_job_queues(
+            std::size_t const num_queues,
+            std::size_t const num_nodes) -> job_queues_t
+    {
+        job_queues_t job_queues;
+        job_queues.reserve(num_queues);
 
-auto
-dag::make_runnable(
-        std::span<thread::worker> const worker_threads,
-        std::size_t const event_memory_size) -> std::unique_ptr<dag_executor>
-{
-    if (worker_threads.empty())
+        // Every node is pushed at most once per run, so a queue can never
+        // hold more than all nodes.
+        for (std::size_t i = 0; i < num_queues; ++i)
+        {
+            job_queues.push_back(std::make_unique<job_queue_t>(num_nodes));
+        }
+
+        return job_queues;
+    }
+
+    struct dag_worker
     {
-        return std::make_unique<dag_executor_st>(
-                m_tasks,
-                m_graph,
-                event_memory_size);
+        dag_worker(
+                std::size_t const index,
+                std::size_t const event_memory_size,
+                compiled_dag& dag,
+                job_queues_t const& job_queues,
+                std::atomic_size_t& nodes_to_process,
+                std::atomic_size_t& active_workers,
+                std::atomic_size_t& buffer_size,
+                idle_time_t& idle_time,
+                thread::wait_policy const& wait_policy,
+                tracer const* const tracer)
+            : m_index(index)
+            , m_event_memory(event_memory_size)
+            , m_dag(dag)
+            , m_job_queues(job_queues)
+            , m_nodes_to_process(nodes_to_process)
+            , m_active_workers(active_workers)
+            , m_buffer_size(buffer_size)
+            , m_idle_time(idle_time)
+            , m_wait_policy(wait_policy)
+            , m_tracer(tracer)
+        {
+        }
+
+        void operator()()
+        {
+            // A worker might leave before the run is finished, so events it
+            // allocated could still be consumed by others. Hence the memory
+            // is released not before the next run.
+            m_event_memory.release();
+
+            m_thread_context.buffer_size =
+                    m_buffer_size.load(std::memory_order_relaxed);
+            m_thread_context.trace = active_ring(m_tracer, m_index);
+
+            {
+                thread::backoff idle(m_wait_policy);
+                idle_stopwatch idle_time(m_idle_time);
+
+                while (m_nodes_to_process.load(std::memory_order_acquire))
+                {
+                    node_index_t n = next_job();
+                    if (n != compiled_dag::no_node)
+                    {
+                        idle_time.stop();
+
+                        while (n != compiled_dag::no_node)
+                        {
+                            n = process_node(n);
+                        }
+
+                        idle.reset();
+                    }
+                    else if (m_index != 0 && idle.exhausted())
+                    {
+                        // Own queue is empty and nothing to steal, park in
+                        // the worker thread. The main worker will finish the
+                        // run.
+                        break;
+                    }
+                    else
+                    {
+                        idle_time.start();
+                        idle();
+                    }
+                }
+            }
+
+            m_active_workers.fetch_sub(1, std::memory_order_release);
+        }
+
+    private:
+        auto next_job() -> node_index_t
+        {
+            if (auto n = m_job_queues[m_index]->pop())
+            {
+                return *n;
+            }
+
+            // Own queue is empty, try to steal, starting with the neighbour.
+            std::size_t const num_queues = m_job_queues.size();
+            for (std::size_t i = 1; i < num_queues; ++i)
+            {
+                if (auto n = m_job_queues[(m_index + i) % num_queues]->steal())
+                {
+                    return *n;
+                }
+            }
+
+            return compiled_dag::no_node;
+        }
+
+        auto process_node(node_index_t const n) -> node_index_t
+        {
+            BOOST_ASSERT(m_dag.parents_to_process(n) == 0);
+
+            m_dag.run(n, m_thread_context);
+
+            node_index_t next{compiled_dag::no_node};
+            for (node_index_t const child : m_dag.children(n))
+            {
+                if (m_dag.parent_processed(child, std::memory_order_acq_rel))
+                {
+                    if (next != compiled_dag::no_node)
+                    {
+                        m_job_queues[m_index]->push(child);
+                    }
+                    else
+                    {
+                        next = child;
+                    }
+                }
+            }
+
+            BOOST_VERIFY(
+                    0 <
+                    m_nodes_to_process.fetch_sub(1, std::memory_order_acq_rel));
+
+            return next;
+        }
+
+        std::size_t m_index;
+        audio::engine::event_buffer_memory m_event_memory;
+        audio::engine::thread_context m_thread_context{
+                &m_event_memory.memory_resource()};
+        compiled_dag& m_dag;
+        job_queues_t const& m_job_queues;
+        std::atomic_size_t& m_nodes_to_process;
+        std::atomic_size_t& m_active_workers;
+        std::atomic_size_t& m_buffer_size;
+        idle_time_t& m_idle_time;
+        thread::wait_policy m_wait_policy;
+        tracer const* m_tracer;
+    };
+
+    using workers_t = std::vector<dag_worker>;
+
+    static auto make_workers(
+            std::span<thread::worker const> const worker_threads,
+            std::size_t const event_memory_size,
+            compiled_dag& dag,
+            job_queues_t const& job_queues,
+            std::atomic_size_t& nodes_to_process,
+            std::atomic_size_t& active_workers,
+            std::atomic_size_t& buffer_size,
+            idle_time_t& idle_time,
+            tracer const* const tracer) -> workers_t
+    {
+        workers_t workers;
+        workers.reserve(job_queues.size());
+
+        // worker at index 0 is run on the calling thread
+        for (std::size_t const i : range::indices(job_queues))
+        {
+            workers.emplace_back(
+                    i,
+                    event_memory_size,
+                    dag,
+                    job_queues,
+                    nodes_to_process,
+                    active_workers,
+                    buffer_size,
+                    idle_time,
+                    i == 0 ? thread::wait_policy{}
+                           : worker_threads[i - 1].wait_policy(),
+                    tracer);
+        }
+
+        return workers;
+    }
+
+    compiled_dag m_dag;
+    std::span<thread::worker> m_worker_threads;
+    std::atomic_size_t m_nodes_to_process{};
+    std::atomic_size_t m_active_workers{};
+    std::atomic_size_t m_buffer_size{};
+    idle_time_t m_idle_time{};
+    job_queues_t const m_job_queues;
+    workers_t m_workers;
+    std::size_t m_num_workers{m_worker_threads.size()};
+    tracer const* m_tracer;
+};
+
+class dag_executor_static final : public dag_executor
+{
+public:
+    dag_executor_static(
+            dag::tasks_t const& tasks,
+            dag::graph_t const& graph,
+            dag::costs_t const& costs,
+            std::size_t const event_memory_size,
+            std::span<thread::worker> const worker_threads,
+            tracer const* const tracer)
+        : m_worker_threads(worker_threads)
+        , m_nodes(tasks.size())
+        , m_workers(make_workers(
+                  make_schedule(
+                          tasks,
+                          graph,
+                          costs,
+                          worker_threads.size() + 1,
+                          m_nodes),
+                  worker_threads,
+                  event_memory_size,
+                  m_run,
+                  m_active_workers,
+                  m_buffer_size,
+                  m_idle_time,
+                  tracer))
+        , m_tracer(tracer)
+    {
+    }
+
+    ~dag_executor_static() override
+    {
+        wait_for_workers();
+    }
+
+    void operator()(std::size_t const buffer_size) override
+    {
+        period_trace const trace(active_ring(m_tracer, 0));
+
+        m_buffer_size.store(buffer_size, std::memory_order_relaxed);
+        m_run.fetch_add(1, std::memory_order_relaxed);
+        m_active_workers.store(m_workers.size(), std::memory_order_release);
+
+        BOOST_ASSERT(m_workers.size() == m_worker_threads.size() + 1);
+        for (std::size_t const w : range::indices(m_worker_threads))
+        {
+            // Wrap into a reference_wrapper here to guarantee small-object
+            // optimization inside the worker thread.
+            m_worker_threads[w].wakeup(std::ref(m_workers[w + 1]));
+        }
+
+        m_workers.front()();
+
+        // The results of the nodes run by the worker threads are needed
+        // after returning, so we have to wait for them.
+        idle_stopwatch idle_time(m_idle_time);
+        idle_time.start();
+        wait_for_workers();
+    }
+
+    auto take_idle_time() noexcept -> std::chrono::nanoseconds override
+    {
+        return engine::take_idle_time(m_idle_time);
+    }
+
+private:
+    struct node
+    {
+        dag::task_t task;
+
+        //! Parents, which are run by other threads. From each other thread,
+        //! only the latest scheduled parent is needed.
+        std::vector<node const*> waits_for;
+
+        std::atomic_size_t finished_run{};
+    };
+
+    using nodes_t = std::vector<node>;
+    using sequence_t = std::vector<node*>;
+
+    void wait_for_workers() const noexcept
+    {
+        thread::backoff idle(thread::wait_policy{});
+        while (m_active_workers.load(std::memory_order_acquire))
+        {
+            idle();
+        }
+    }
+
+    //! List scheduling with the bottom-level (longest path to an exit node,
+    //! including the node itself) as priority. The ready node with the
+    //! highest priority is assigned to the thread, where it can start
+    //! earliest.
+    static auto make_schedule(
+            dag::tasks_t const& tasks,
+            dag::graph_t const& graph,
+            dag::costs_t const& costs,
+            std::size_t const num_threads,
+            nodes_t& nodes) -> std::vector<sequence_t>
+    {
+        using cost_t = dag::cost_t;
+
+        std::size_t const num_nodes = tasks.size();
+        BOOST_ASSERT(nodes.size() == num_nodes);
+
+        std::unordered_map<dag::task_id_t, std::size_t> index_of;
+        for (std::size_t const i : range::indices(tasks))
+        {
+            index_of[tasks[i].first] = i;
+            nodes[i].task = tasks[i].second;
+        }
+
+        std::vector<std::vector<std::size_t>> children(num_nodes);
+        std::vector<std::vector<std::size_t>> parents(num_nodes);
+        for (auto const& [parent_id, child_ids] : graph)
+        {
+            BOOST_ASSERT(index_of.count(parent_id));
+            std::size_t const parent = index_of[parent_id];
+            for (dag::task_id_t const child_id : child_ids)
+            {
+                BOOST_ASSERT(index_of.count(child_id));
+                children[parent].push_back(index_of[child_id]);
+                parents[index_of[child_id]].push_back(parent);
+            }
+        }
+
+        // Tasks without an estimate are assumed to cost the average.
+        std::vector<cost_t> cost(num_nodes);
+        {
+            cost_t known_sum{};
+            std::size_t num_known{};
+            for (auto const& [id, c] : costs)
+            {
+                if (index_of.count(id) && c > cost_t::zero())
+                {
+                    known_sum += c;
+                    ++num_known;
+                }
+            }
+
+            cost_t const default_cost =
+                    num_known ? std::max(
+                                        known_sum / static_cast<cost_t::rep>(
+                                                            num_known),
+                                        cost_t{1})
+                              : cost_t{1};
+
+            for (std::size_t const i : range::indices(tasks))
+            {
+                auto it = costs.find(tasks[i].first);
+                cost[i] = it != costs.end() && it->second > cost_t::zero()
+                                  ? it->second
+                                  : default_cost;
+            }
+        }
+
+        // topological order
+        std::vector<std::size_t> topo_order;
+        topo_order.reserve(num_nodes);
+        {
+            std::vector<std::size_t> parents_left(num_nodes);
+            for (std::size_t const i : range::indices(parents))
+            {
+                parents_left[i] = parents[i].size();
+                if (parents_left[i] == 0)
+                {
+                    topo_order.push_back(i);
+                }
+            }
+
+            for (std::size_t k = 0; k < topo_order.size(); ++k)
+            {
+                for (std::size_t const child : children[topo_order[k]])
+                {
+                    if (--parents_left[child] == 0)
+                    {
+                        topo_order.push_back(child);
+                    }
+                }
+            }
+
+            BOOST_ASSERT(topo_order.size() == num_nodes);
+        }
+
+        std::vector<cost_t> bottom_level(num_nodes);
+        for (std::size_t const i : std::views::reverse(topo_order))
+        {
+            cost_t max_child{};
+            for (std::size_t const child : children[i])
+            {
+                max_child = std::max(max_child, bottom_level[child]);
+            }
+
+            bottom_level[i] = cost[i] + max_child;
+        }
+
+        auto lower_priority = [&bottom_level](
+                                      std::size_t const l,
+                                      std::size_t const r) {
+            return bottom_level[l] < bottom_level[r] ||
+                   (bottom_level[l] == bottom_level[r] && l > r);
+        };
+
+        std::priority_queue<
+                std::size_t,
+                std::vector<std::size_t>,
+                decltype(lower_priority)>
+                ready(lower_priority);
+
+        std::vector<std::size_t> parents_left(num_nodes);
+        for (std::size_t const i : range::indices(parents))
+        {
+            parents_left[i] = parents[i].size();
+            if (parents_left[i] == 0)
+            {
+                ready.push(i);
+            }
+        }
+
+        std::vector<cost_t> ready_time(num_nodes);
+        std::vector<cost_t> thread_free(num_threads);
+        std::vector<std::size_t> thread_of(num_nodes);
+        std::vector<std::size_t> position_of(num_nodes);
+        std::vector<sequence_t> sequences(num_threads);
+
+        while (!ready.empty())
+        {
+            std::size_t const i = ready.top();
+            ready.pop();
+
+            auto start_time = [&](std::size_t const t) {
+                return std::max(thread_free[t], ready_time[i]);
+            };
+
+            std::size_t best_thread{};
+            for (std::size_t t = 1; t < num_threads; ++t)
+            {
+                if (start_time(t) < start_time(best_thread))
+                {
+                    best_thread = t;
+                }
+            }
+
+            cost_t const finish_time = start_time(best_thread) + cost[i];
+            thread_free[best_thread] = finish_time;
+            thread_of[i] = best_thread;
+            position_of[i] = sequences[best_thread].size();
+            sequences[best_thread].push_back(std::addressof(nodes[i]));
+
+            for (std::size_t const child : children[i])
+            {
+                ready_time[child] = std::max(ready_time[child], finish_time);
+
+                if (--parents_left[child] == 0)
+                {
+                    ready.push(child);
+                }
+            }
+        }
+
+        // Parents on the same thread are finished by construction. For the
+        // other threads, waiting for the latest parent is sufficient.
+        for (std::size_t const i : range::indices(nodes))
+        {
+            std::vector<std::optional<std::size_t>> latest_parent(num_threads);
+            for (std::size_t const parent : parents[i])
+            {
+                auto& latest = latest_parent[thread_of[parent]];
+                if (thread_of[parent] != thread_of[i] &&
+                    (!latest || position_of[*latest] < position_of[parent]))
+                {
+                    latest = parent;
+                }
+            }
+
+            for (auto const& parent : latest_parent)
+            {
+                if (parent)
+                {
+                    nodes[i].waits_for.push_back(std::addressof(nodes[*parent]));
+                }
+            }
+        }
+
+        return sequences;
+    }
+
+    struct dag_worker
+    {
+        dag_worker(
+                std::size_t const index,
+                sequence_t sequence,
+                std::size_t const event_memory_size,
+                std::atomic_size_t& run,
+                std::atomic_size_t& active_workers,
+                std::atomic_size_t& buffer_size,
+                idle_time_t& idle_time,
+                thread::wait_policy const& wait_policy,
+                tracer const* const tracer)
+            : m_index(index)
+            , m_sequence(std::move(sequence))
+            , m_event_memory(event_memory_size)
+            , m_run(run)
+            , m_active_workers(active_workers)
+            , m_buffer_size(buffer_size)
+            , m_idle_time(idle_time)
+            , m_wait_policy(wait_policy)
+            , m_tracer(tracer)
+        {
+        }
+
+        void operator()()
+        {
+            // Events of the previous run might have been consumed by other
+            // threads, so the memory is released not before now.
+            m_event_memory.release();
+
+            m_thread_context.buffer_size =
+                    m_buffer_size.load(std::memory_order_relaxed);
+            m_thread_context.trace = active_ring(m_tracer, m_index);
+
+            std::size_t const run = m_run.load(std::memory_order_relaxed);
+
+            {
+                idle_stopwatch idle_time(m_idle_time);
+
+                for (node* const n : m_sequence)
+                {
+                    for (node const* const parent : n->waits_for)
+                    {
+                        thread::backoff idle(m_wait_policy);
+                        while (parent->finished_run.load(
+                                       std::memory_order_acquire) != run)
+                        {
+                            idle_time.start();
+                            idle();
+                        }
+                    }
+
+                    idle_time.stop();
+
+                    n->task(m_thread_context);
+
+                    n->finished_run.store(run, std::memory_order_release);
+                }
+            }
+
+            m_active_workers.fetch_sub(1, std::memory_order_release);
+        }
+
+    private:
+        std::size_t m_index;
+        sequence_t m_sequence;
+        audio::engine::event_buffer_memory m_event_memory;
+        audio::engine::thread_context m_thread_context{
+                &m_event_memory.memory_resource()};
+        std::atomic_size_t& m_run;
+        std::atomic_size_t& m_active_workers;
+        std::atomic_size_t& m_buffer_size;
+        idle_time_t& m_idle_time;
+        thread::wait_policy m_wait_policy;
+        tracer const* m_tracer;
+    };
+
+    using workers_t = std::vector<dag_worker>;
+
+    static auto make_workers(
+            std::vector<sequence_t> sequences,
+            std::span<thread::worker const> const worker_threads,
+            std::size_t const event_memory_size,
+            std::atomic_size_t& run,
+            std::atomic_size_t& active_workers,
+            std::atomic_size_t& buffer_size,
+            idle_time_t& idle_time,
+            tracer const* const tracer) -> workers_t
+    {
+        workers_t workers;
+        workers.reserve(sequences.size());
+
+        // worker at index 0 is run on the calling thread
+        for (std::size_t const i : range::indices(sequences))
+        {
+            workers.emplace_back(
+                    i,
+                    std::move(sequences[i]),
+                    event_memory_size,
+                    run,
+                    active_workers,
+                    buffer_size,
+                    idle_time,
+                    i == 0 ? thread::wait_policy{}
+                           : worker_threads[i - 1].wait_policy(),
+                    tracer);
+        }
+
+        return workers;
+    }
+
+    std::span<thread::worker> m_worker_threads;
+    std::atomic_size_t m_run{};
+    std::atomic_size_t m_active_workers{};
+    std::atomic_size_t m_buffer_size{};
+    idle_time_t m_idle_time{};
+    nodes_t m_nodes;
+    workers_t m_workers;
+    tracer const* m_tracer;
+};
+
+auto
+is_descendent(
+        dag::graph_t const& t,
+        dag::task_id_t const parent,
+        dag::task_id_t const descendent) -> bool
+{
+    if (parent == descendent)
+    {
+        return true;
+    }
+
+    return std::ranges::any_of(
+            t.at(parent),
+            [&t, descendent](dag::task_id_t const child) {
+                return is_descendent(t, child, descendent);
+            });
+}
+
+} // namespace
+
+dag::dag() = default;
+
+auto
+dag::add_task(task_t t) -> task_id_t
+{
+    auto id = m_free_id++;
+    m_tasks.emplace_back(id, std::move(t));
+    m_graph[id];
+    return id;
+}
+
+auto
+dag::add_child_task(task_id_t const parent, task_t t) -> task_id_t
+{
+    auto it = m_graph.find(parent);
+
+    BOOST_ASSERT_MSG(it != m_graph.end(), "parent node not found");
+
+    auto id = add_task(std::move(t));
+    it->second.push_back(id);
+    return id;
+}
+
+void
+dag::add_child(task_id_t const parent, task_id_t const child)
+{
+    auto it_parent = m_graph.find(parent);
+
+    BOOST_ASSERT_MSG(it_parent != m_graph.end(), "parent node not found");
+
+    auto it_child = m_graph.find(child);
+
+    BOOST_ASSERT_MSG(it_child != m_graph.end(), "child node not found");
+
+    BOOST_ASSERT_MSG(
+            !is_descendent(m_graph, it_child->first, it_parent->first),
+            "child is ancestor of the parent");
+
+    it_parent->second.push_back(it_child->first);
+}
+
+void
+dag::set_cost(task_id_t const id, cost_t const cost)
+{
+    BOOST_ASSERT_MSG(m_graph.count(id), "node not found");
+
+    m_costs[id] = cost;
+}
+
+auto
+dag::max_parallelism() const -> std::size_t
+{
+    std::unordered_map<task_id_t, std::size_t> num_parents;
+    for (auto const& [id, children] : m_graph)
+    {
+        num_parents[id];
+        for (task_id_t const child : children)
+        {
+            ++num_parents[child];
+        }
+    }
+
+    std::vector<task_id_t> ready;
+    for (auto const& [id, count] : num_parents)
+    {
+        if (count == 0)
+        {
+            ready.push_back(id);
+        }
+    }
+
+    // depth is the longest path from a root
+    std::unordered_map<task_id_t, std::size_t> depth;
+    std::vector<std::size_t> width;
+    while (!ready.empty())
+    {
+        task_id_t const id = ready.back();
+        ready.pop_back();
+
+        std::size_t const d = depth[id];
+        if (width.size() <= d)
+        {
+            width.resize(d + 1);
+        }
+
+        ++width[d];
+
+        for (task_id_t const child : m_graph.at(id))
+        {
+            depth[child] = std::max(depth[child], d + 1);
+
+            if (--num_parents[child] == 0)
+            {
+                ready.push_back(child);
+            }
+        }
+    }
+
+    return width.empty() ? 0 : std::ranges::max(width);
+}
+
+auto
+dag::make_runnable(
+        std::span<thread::worker> const all_worker_threads,
+        std::size_t const event_memory_size,
+        scheduling const sched,
+        tracer const* const tracer) -> std::unique_ptr<dag_executor>
+{
+    // Waking more workers than tasks can run in parallel is pointless.
+    std::span<thread::worker> const worker_threads = all_worker_threads.first(
+            std::min(
+                    all_worker_threads.size(),
+                    std::max(max_parallelism(), std::size_t{1}) - 1));
+
+    if (worker_threads.empty())
+    {
+        return std::make_unique<dag_executor_st>(
+                m_tasks,
+                m_graph,
+                event_memory_size,
+                tracer);
+    }
+
+    switch (sched)
+    {
+        case scheduling::shared_queue:
+            return std::make_unique<dag_executor_mt>(
+                    m_tasks,
+                    m_graph,
+                    event_memory_size,
+                    worker_threads,
+                    tracer);
+
+        case scheduling::work_stealing:
+            return std::make_unique<dag_executor_ws>(
+                    m_tasks,
+                    m_graph,
+                    event_memory_size,
+                    worker_threads,
+                    tracer);
+
+        case scheduling::static_schedule:
+            return std::make_unique<dag_executor_static>(
+                    m_tasks,
+                    m_graph,
+                    m_costs,
+                    event_memory_size,
+                    worker_threads,
+                    tracer);
     }
 
-    return std::make_unique<dag_executor_mt>(
-            m_tasks,
-            m_graph,
-            event_memory_size,
-            worker_threads);
+    BOOST_ASSERT_MSG(false, "unknown scheduling");
+    return nullptr;
 }
 
 } // namespace piejam::audio::engine
@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <ranges>
 #include <set>
+#include <vector>
 
 namespace piejam::audio::engine
 {
@@ -128,36 +129,36 @@ remove_identities(graph::wires_access<W>& g)
 
     std::set<typename graph::wires_access<W>::wires_map::value_type> new_wires;
 
-    for (auto it = id_wires.begin(); it != id_wires.end();)
+    // Follow the wires of each source, which is not an identity, through the
+    // identities to the destinations, which are not identities. An identity
+    // passes its input to the output of the same port.
+    std::vector<graph_endpoint> pending;
+    for (auto const& [src, dst] : id_wires)
     {
-        if (is_identity_processor<W>(it->second.proc))
+        if (is_identity_processor<W>(src.proc))
         {
-            auto following = id_wires.equal_range(it->second);
+            continue;
+        }
+
+        pending.push_back(dst);
+        while (!pending.empty())
+        {
+            graph_endpoint const next = pending.back();
+            pending.pop_back();
 
-            for (auto const& [src, dst] : boost::make_iterator_range(following))
+            if (is_identity_processor<W>(next.proc))
             {
-                if (is_identity_processor<W>(it->first.proc) ||
-                    is_identity_processor<W>(dst.proc))
-                {
-                    id_wires.emplace(it->first, dst);
-                }
-                else
+                for (auto const& [id_out, following] :
+                     boost::make_iterator_range(id_wires.equal_range(next)))
                 {
-                    new_wires.emplace(it->first, dst);
+                    pending.push_back(following);
                 }
             }
-
-            it = id_wires.erase(it);
-
-            if (following.first != following.second)
+            else
             {
-                it = id_wires.begin();
+                new_wires.emplace(src, next);
             }
         }
-        else
-        {
-            ++it;
-        }
     }
 
     for (auto const& [src, dst] : new_wires)
@@ -167,7 +168,7 @@ remove_identities(graph::wires_access<W>& g)
 }
 
 auto
-insert_mixer(graph& g) -> mix_processors
+insert_mixer(graph& g, mix_processors const& previous) -> mix_processors
 {
     mix_processors result;
 
@@ -191,7 +192,19 @@ insert_mixer(graph& g) -> mix_processors
         if (num_ins > 1)
         {
             auto dst = it->first;
-            auto mixer = make_mix_processor(num_ins);
+
+            // reuse the mixer of the previous graph, so its job can be kept
+            std::shared_ptr<processor> mixer;
+            if (auto const prev = previous.find(dst);
+                prev != previous.end() && prev->second->num_inputs() == num_ins)
+            {
+                mixer = prev->second;
+            }
+            else
+            {
+                mixer = make_mix_processor(num_ins);
+            }
+
             std::size_t port{};
             while (it != it_up)
             {
@@ -204,7 +217,7 @@ insert_mixer(graph& g) -> mix_processors
 
             g.audio.insert(graph_endpoint{.proc = *mixer, .port = 0}, dst);
 
-            result.emplace_back(std::move(mixer));
+            result.emplace(dst, std::move(mixer));
         }
         else
         {
@@ -217,6 +230,38 @@ insert_mixer(graph& g) -> mix_processors
 
 } // namespace
 
+auto
+downstream_processors(
+        graph const& g,
+        std::span<graph_endpoint const> const srcs)
+        -> std::set<processor const*>
+{
+    std::set<processor const*> result;
+    std::vector<graph_endpoint> pending(srcs.begin(), srcs.end());
+
+    while (!pending.empty())
+    {
+        graph_endpoint const src = pending.back();
+        pending.pop_back();
+
+        for (auto const& wire :
+             boost::make_iterator_range(g.audio.equal_range(src)))
+        {
+            processor& dst = dst_processor(wire);
+
+            if (result.insert(&dst).second)
+            {
+                for (std::size_t port = 0; port < dst.num_outputs(); ++port)
+                {
+                    pending.push_back({.proc = dst, .port = port});
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
 void
 remove_event_identity_processors(graph& g)
 {
@@ -230,14 +275,15 @@ remove_identity_processors(graph& g)
 }
 
 auto
-finalize_graph(graph const& g) -> std::tuple<graph, mix_processors>
+finalize_graph(graph const& g, mix_processors const& previous)
+        -> std::tuple<graph, mix_processors>
 {
     graph result{g};
 
     remove_event_identity_processors(result);
     remove_identity_processors(result);
 
-    mix_processors mixers = insert_mixer(result);
+    mix_processors mixers = insert_mixer(result, previous);
 
     return std::tuple{std::move(result), std::move(mixers)};
 }
@@ -8,16 +8,23 @@
 #include <piejam/audio/engine/event_input_buffers.h>
 #include <piejam/audio/engine/event_output_buffers.h>
 #include <piejam/audio/engine/graph.h>
+#include <piejam/audio/engine/output_buffer_pool.h>
 #include <piejam/audio/engine/processor.h>
 #include <piejam/audio/engine/processor_job.h>
+#include <piejam/audio/engine/processor_timings.h>
 #include <piejam/audio/engine/slice.h>
+#include <piejam/audio/engine/thread_context.h>
 #include <piejam/audio/period_size.h>
 #include <piejam/functional/address_compare.h>
+#include <piejam/range/iota.h>
 
 #include <boost/assert.hpp>
 
+#include <mipp.h>
+
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <initializer_list>
 #include <map>
 #include <memory>
@@ -29,89 +36,424 @@
 namespace piejam::audio::engine
 {
 
+namespace
+{
+
+//! Jobs of a linear chain of processors, run back to back in a single task.
+//! Runs of splittable jobs are processed tile by tile, so the intermediate
+//! buffers stay in the L1 cache while passing through the chain.
+class fused_job
+{
+public:
+    struct member
+    {
+        std::shared_ptr<processor_job> job;
+        processor_timings::timing* timing{};
+
+        auto operator==(member const&) const noexcept -> bool = default;
+    };
+
+    fused_job(
+            std::vector<member> members,
+            std::size_t const tile_size,
+            std::shared_ptr<output_buffer_pool::buffers_t const> output_buffers)
+        : m_members(std::move(members))
+        , m_tile_size(tile_size)
+        , m_output_buffers(std::move(output_buffers))
+    {
+        for (std::size_t begin = 0; begin < m_members.size();)
+        {
+            std::size_t end = begin + 1;
+            if (m_tile_size != 0 && m_members[begin].job->splittable())
+            {
+                while (end < m_members.size() &&
+                       m_members[end].job->splittable())
+                {
+                    ++end;
+                }
+            }
+
+            // tiling a single job only adds overhead
+            m_segments.push_back({begin, end, end - begin > 1});
+            begin = end;
+        }
+    }
+
+    //! True, if it runs the same jobs with the same timings and tile size.
+    [[nodiscard]] auto runs(
+            std::span<member const> const members,
+            std::size_t const tile_size) const noexcept -> bool
+    {
+        return tile_size == m_tile_size &&
+               std::ranges::equal(members, m_members);
+    }
+
+    void operator()(thread_context const& ctx) const
+    {
+        for (segment const& s : m_segments)
+        {
+            run(s, ctx);
+        }
+    }
+
+    void run_timed(thread_context const& ctx) const
+    {
+        using clock_t = std::chrono::steady_clock;
+        auto start = clock_t::now();
+        for (segment const& s : m_segments)
+        {
+            run(s, ctx);
+
+            // tiled jobs are interleaved, their time is split equally
+            auto const end = clock_t::now();
+            auto const duration = (end - start) / (s.end - s.begin);
+            for (std::size_t i = s.begin; i < s.end; ++i)
+            {
+                m_members[i].timing->update(duration);
+            }
+            start = end;
+        }
+    }
+
+private:
+    struct segment
+    {
+        std::size_t begin;
+        std::size_t end;
+        bool tiled;
+    };
+
+    void run(segment const& s, thread_context const& ctx) const
+    {
+        if (!s.tiled)
+        {
+            for (std::size_t i = s.begin; i < s.end; ++i)
+            {
+                (*m_members[i].job)(ctx);
+            }
+
+            return;
+        }
+
+        for (std::size_t offset = 0; offset < ctx.buffer_size;
+             offset += m_tile_size)
+        {
+            std::size_t const size =
+                    std::min(m_tile_size, ctx.buffer_size - offset);
+
+            for (std::size_t i = s.begin; i < s.end; ++i)
+            {
+                m_members[i].job->process_tile(ctx, offset, size);
+            }
+        }
+    }
+
+    std::vector<member> m_members;
+    std::vector<segment> m_segments;
+    std::size_t m_tile_size;
+    std::shared_ptr<output_buffer_pool::buffers_t const> m_output_buffers;
+};
+
+//! Audio or event wire into an input of a job.
+struct input_wire
+{
+    bool event{};
+    std::size_t port{};
+    processor const* src{};
+    std::size_t src_port{};
+
+    auto operator==(input_wire const&) const noexcept -> bool = default;
+};
+
+struct job_node
+{
+    std::shared_ptr<processor_job> job;
+    std::vector<processor*> children;
+    std::size_t num_parents{};
+    processor* parent{}; //!< only meaningful with a single parent
+    dag::task_id_t task_id{};
+    std::vector<input_wire> inputs;
+    bool reused{};
+};
+
+} // namespace
+
+struct job_cache::entries
+{
+    struct job_entry
+    {
+        std::shared_ptr<processor_job> job;
+        std::vector<input_wire> inputs;
+    };
+
+    std::shared_ptr<output_buffer_pool> output_buffers;
+    std::map<processor const*, job_entry> jobs;
+
+    //! By the first processor of the chain.
+    std::map<processor const*, std::shared_ptr<fused_job>> chains;
+};
+
 auto
-graph_to_dag(graph const& g) -> dag
+graph_to_dag(
+        graph const& g,
+        processor_timings* const timings,
+        std::size_t const tile_size,
+        job_cache* const cache) -> dag
 {
+    BOOST_ASSERT(tile_size % mipp::N<float>() == 0);
+
     dag result;
 
+    job_cache::entries const* const previous =
+            cache ? cache->m_entries.get() : nullptr;
+
     std::map<
             std::reference_wrapper<processor>,
-            std::pair<dag::task_id_t, processor_job*>,
+            job_node,
             decltype(address_less<processor>)>
-            processor_job_mapping;
+            job_nodes;
 
-    std::vector<processor_job*> clear_event_buffer_jobs;
+    // in order of first appearance, to keep the task order deterministic
+    std::vector<processor*> processors;
 
-    auto add_job = [&](graph_endpoint const& e) {
-        auto job = std::make_shared<processor_job>(e.proc);
-        auto job_ptr = job.get();
-        auto id = result.add_task(
-                [j = std::move(job)](thread_context const& ctx) { (*j)(ctx); });
-        processor_job_mapping.emplace(e.proc, std::pair(id, job_ptr));
-        if (!e.proc.get().event_outputs().empty())
+    auto add_node = [&](graph_endpoint const& e) {
+        if (job_nodes.try_emplace(e.proc).second)
         {
-            clear_event_buffer_jobs.push_back(job_ptr);
+            processors.push_back(std::addressof(e.proc.get()));
         }
     };
 
-    // create a job for each processor
     for (auto const& [src, dst] : g.audio)
     {
-        if (!processor_job_mapping.count(src.proc))
-        {
-            add_job(src);
-        }
+        add_node(src);
+        add_node(dst);
+    }
 
-        if (!processor_job_mapping.count(dst.proc))
+    for (auto const& [src, dst] : g.event)
+    {
+        add_node(src);
+        add_node(dst);
+    }
+
+    std::set<std::pair<processor*, processor*>> added_deps;
+    auto add_dep = [&](processor& src, processor& dst) {
+        if (added_deps.emplace(&src, &dst).second)
         {
-            add_job(dst);
+            job_nodes[src].children.push_back(&dst);
+            ++job_nodes[dst].num_parents;
+            job_nodes[dst].parent = &src;
         }
+    };
+
+    for (auto const& [src, dst] : g.audio)
+    {
+        add_dep(src.proc, dst.proc);
+        job_nodes[dst.proc].inputs.push_back(
+                {.event = false,
+                 .port = dst.port,
+                 .src = std::addressof(src.proc.get()),
+                 .src_port = src.port});
     }
 
     for (auto const& [src, dst] : g.event)
     {
-        if (!processor_job_mapping.count(src.proc))
+        add_dep(src.proc, dst.proc);
+        job_nodes[dst.proc].inputs.push_back(
+                {.event = true,
+                 .port = dst.port,
+                 .src = std::addressof(src.proc.get()),
+                 .src_port = src.port});
+    }
+
+    // shared by all jobs, the tasks keep the buffers alive
+    auto output_buffers =
+            previous ? std::make_shared<output_buffer_pool>(
+                               g,
+                               *previous->output_buffers)
+                     : std::make_shared<output_buffer_pool>(g);
+
+    // A job is reused, if its processor has the same inputs and output
+    // buffers as before. Otherwise, a new job of a processor takes over the
+    // results of the previous one, so the reused jobs of the consumers stay
+    // connected. Reused jobs are still run by the previous dag, so they must
+    // not be modified.
+    auto previous_job = [previous](processor const& p)
+            -> job_cache::entries::job_entry const* {
+        if (previous)
         {
-            add_job(src);
+            if (auto const it = previous->jobs.find(&p);
+                it != previous->jobs.end())
+            {
+                return &it->second;
+            }
         }
 
-        if (!processor_job_mapping.count(dst.proc))
+        return nullptr;
+    };
+
+    std::vector<processor_job*> clear_event_buffer_jobs;
+
+    for (processor* const p : processors)
+    {
+        job_node& node = job_nodes[*p];
+
+        if (auto const* const prev = previous_job(*p))
         {
-            add_job(dst);
+            bool const outputs_kept = std::ranges::all_of(
+                    range::iota(p->num_outputs()),
+                    [&](std::size_t const port) {
+                        return output_buffers->kept({.proc = *p, .port = port});
+                    });
+
+            if (prev->inputs == node.inputs && outputs_kept)
+            {
+                node.job = prev->job;
+                node.reused = true;
+            }
+            else
+            {
+                node.job = std::make_shared<processor_job>(
+                        *p,
+                        *output_buffers,
+                        *prev->job);
+            }
+        }
+        else
+        {
+            node.job = std::make_shared<processor_job>(*p, *output_buffers);
+        }
+
+        if (!p->event_outputs().empty())
+        {
+            clear_event_buffer_jobs.push_back(node.job.get());
         }
     }
 
-    // connect jobs according to audio wires
-    std::set<std::pair<dag::task_id_t, dag::task_id_t>> added_deps;
+    // connect the new jobs according to audio wires
     for (auto const& [src, dst] : g.audio)
     {
-        auto const& [src_id, src_job] = processor_job_mapping[src.proc];
-        auto const& [dst_id, dst_job] = processor_job_mapping[dst.proc];
-
-        if (!added_deps.count({src_id, dst_id}))
+        if (job_node& dst_node = job_nodes[dst.proc]; !dst_node.reused)
         {
-            result.add_child(src_id, dst_id);
-            added_deps.emplace(src_id, dst_id);
+            dst_node.job->connect_result(
+                    dst.port,
+                    job_nodes[src.proc].job->result_ref(src.port));
         }
-
-        dst_job->connect_result(dst.port, src_job->result_ref(src.port));
     }
 
-    // connect jobs according to event wires
+    // connect the new jobs according to event wires
     for (auto const& [src, dst] : g.event)
     {
-        auto const& [src_id, src_job] = processor_job_mapping[src.proc];
-        auto const& [dst_id, dst_job] = processor_job_mapping[dst.proc];
+        if (job_node& dst_node = job_nodes[dst.proc]; !dst_node.reused)
+        {
+            dst_node.job->connect_event_result(
+                    dst.port,
+                    job_nodes[src.proc].job->event_result_ref(src.port));
+        }
+    }
+
+    // Fuse linear chains, where a processor is the only parent of its only
+    // child, into a single task. Their order is fixed anyway, so this saves
+    // the scheduling overhead.
+    auto continues_chain = [&](processor* const p) {
+        auto const& node = job_nodes[*p];
+        return node.children.size() == 1 &&
+               job_nodes[*node.children.front()].num_parents == 1;
+    };
+
+    auto starts_chain = [&](processor* const p) {
+        auto const& node = job_nodes[*p];
+        return node.num_parents != 1 || !continues_chain(node.parent);
+    };
+
+    std::map<processor const*, std::shared_ptr<fused_job>> chains;
+
+    for (processor* const head : processors)
+    {
+        if (!starts_chain(head))
+        {
+            continue;
+        }
 
-        if (!added_deps.count({src_id, dst_id}))
+        std::vector<fused_job::member> members;
+        std::vector<processor*> chain{head};
+        while (continues_chain(chain.back()))
         {
-            result.add_child(src_id, dst_id);
-            added_deps.emplace(src_id, dst_id);
+            chain.push_back(job_nodes[*chain.back()].children.front());
+        }
+
+        dag::cost_t cost{};
+        for (processor* const p : chain)
+        {
+            auto* const timing = timings ? &(*timings)[*p] : nullptr;
+            if (timing)
+            {
+                cost += timing->estimate();
+            }
+
+            members.push_back({job_nodes[*p].job, timing});
         }
 
-        dst_job->connect_event_result(
-                dst.port,
-                src_job->event_result_ref(src.port));
+        std::shared_ptr<fused_job> fused;
+        if (previous)
+        {
+            if (auto const it = previous->chains.find(head);
+                it != previous->chains.end() &&
+                it->second->runs(members, tile_size))
+            {
+                fused = it->second;
+            }
+        }
+
+        if (!fused)
+        {
+            fused = std::make_shared<fused_job>(
+                    std::move(members),
+                    tile_size,
+                    output_buffers->buffers());
+        }
+
+        if (cache)
+        {
+            chains.emplace(head, fused);
+        }
+
+        dag::task_id_t id{};
+        if (timings)
+        {
+            id = result.add_task(
+                    [f = std::move(fused)](thread_context const& ctx) {
+                        f->run_timed(ctx);
+                    });
+            result.set_cost(id, cost);
+        }
+        else
+        {
+            id = result.add_task(
+                    [f = std::move(fused)](thread_context const& ctx) {
+                        (*f)(ctx);
+                    });
+        }
+
+        for (processor* const p : chain)
+        {
+            job_nodes[*p].task_id = id;
+        }
+    }
+
+    // connect the tasks, edges within a chain are gone
+    std::set<std::pair<dag::task_id_t, dag::task_id_t>> added_task_deps;
+    for (processor* const p : processors)
+    {
+        dag::task_id_t const src_id = job_nodes[*p].task_id;
+        for (processor* const child : job_nodes[*p].children)
+        {
+            dag::task_id_t const dst_id = job_nodes[*child].task_id;
+            if (src_id != dst_id &&
+                added_task_deps.emplace(src_id, dst_id).second)
+            {
+                result.add_child(src_id, dst_id);
+            }
+        }
     }
 
     // if we have processors with event outputs, we need to clear their
@@ -146,6 +488,23 @@ graph_to_dag(graph const& g) -> dag
         }
     }
 
+    if (cache)
+    {
+        auto entries = std::make_shared<job_cache::entries>();
+        entries->output_buffers = std::move(output_buffers);
+        for (processor* const p : processors)
+        {
+            job_node& node = job_nodes[*p];
+            entries->jobs.emplace(
+                    p,
+                    job_cache::entries::job_entry{
+                            .job = std::move(node.job),
+                            .inputs = std::move(node.inputs)});
+        }
+        entries->chains = std::move(chains);
+        cache->m_entries = std::move(entries);
+    }
+
     return result;
 }
 
@@ -25,8 +25,7 @@ input_processor::process(process_context const& ctx)
 {
     verify_process_context(*this, ctx);
 
-    m_engine_input(ctx.outputs[0]);
-    ctx.results[0] = ctx.outputs[0];
+    ctx.results[0] = m_engine_input(ctx.outputs[0]);
 }
 
 } // namespace piejam::audio::engine
@@ -78,7 +78,7 @@ level_meter_processor::process(engine::process_context const& ctx)
     audio_slice::visit(
             boost::hof::match(
                     [this, bs = ctx.buffer_size](float const c) {
-                        std::fill_n(std::back_inserter(m_lm), bs, c);
+                        m_lm.append(c, bs);
                     },
                     [this](audio_slice::span_t const buffer) {
                         std::ranges::copy(buffer, std::back_inserter(m_lm));
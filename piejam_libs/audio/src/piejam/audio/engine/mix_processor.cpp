@@ -98,6 +98,16 @@ public:
         return {};
     }
 
+    auto block_splittable() const noexcept -> bool override
+    {
+        return true;
+    }
+
+    auto tail_length() const noexcept -> std::optional<std::size_t> override
+    {
+        return 0;
+    }
+
     void process(process_context const& ctx) override
     {
         verify_process_context(*this, ctx);
@@ -97,6 +97,22 @@ public:
         return {};
     }
 
+    auto in_place_input(std::size_t const /*output*/) const noexcept
+            -> std::optional<std::size_t> override
+    {
+        return 0;
+    }
+
+    auto block_splittable() const noexcept -> bool override
+    {
+        return true;
+    }
+
+    auto tail_length() const noexcept -> std::optional<std::size_t> override
+    {
+        return 0;
+    }
+
     void process(process_context const& ctx) override
     {
         verify_process_context(*this, ctx);
@@ -0,0 +1,393 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/engine/output_buffer_pool.h>
+
+#include <piejam/audio/engine/graph.h>
+#include <piejam/audio/engine/processor.h>
+#include <piejam/audio/simd.h>
+#include <piejam/range/indices.h>
+
+#include <boost/assert.hpp>
+#include <boost/dynamic_bitset.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+namespace piejam::audio::engine
+{
+
+namespace
+{
+
+struct node
+{
+    processor* proc{};
+
+    std::vector<std::size_t> audio_children;
+    std::vector<std::size_t> children;
+
+    //! Nodes, which are guaranteed to run after this one.
+    boost::dynamic_bitset<> descendants;
+};
+
+class nodes_builder
+{
+public:
+    explicit nodes_builder(graph const& g)
+    {
+        for (auto const& [src, dst] : g.audio)
+        {
+            std::size_t const s = index_of(src.proc);
+            std::size_t const d = index_of(dst.proc);
+            m_nodes[s].audio_children.push_back(d);
+            m_nodes[s].children.push_back(d);
+        }
+
+        for (auto const& [src, dst] : g.event)
+        {
+            std::size_t const s = index_of(src.proc);
+            std::size_t const d = index_of(dst.proc);
+            m_nodes[s].children.push_back(d);
+        }
+    }
+
+    auto index_of(processor& proc) -> std::size_t
+    {
+        auto [it, inserted] = m_index_of.emplace(&proc, m_nodes.size());
+        if (inserted)
+        {
+            m_nodes.emplace_back().proc = &proc;
+        }
+
+        return it->second;
+    }
+
+    auto index_of(processor const& proc) const -> std::size_t
+    {
+        return m_index_of.at(&proc);
+    }
+
+    auto nodes() -> std::vector<node>&
+    {
+        return m_nodes;
+    }
+
+private:
+    std::vector<node> m_nodes;
+    std::map<processor const*, std::size_t> m_index_of;
+};
+
+auto
+topological_order(std::vector<node> const& nodes) -> std::vector<std::size_t>
+{
+    std::vector<std::size_t> num_parents(nodes.size());
+    for (node const& n : nodes)
+    {
+        for (std::size_t const child : n.children)
+        {
+            ++num_parents[child];
+        }
+    }
+
+    std::vector<std::size_t> order;
+    order.reserve(nodes.size());
+
+    for (std::size_t const i : range::indices(nodes))
+    {
+        if (num_parents[i] == 0)
+        {
+            order.push_back(i);
+        }
+    }
+
+    for (std::size_t k = 0; k < order.size(); ++k)
+    {
+        for (std::size_t const child : nodes[order[k]].children)
+        {
+            if (--num_parents[child] == 0)
+            {
+                order.push_back(child);
+            }
+        }
+    }
+
+    BOOST_ASSERT_MSG(order.size() == nodes.size(), "graph has cycles");
+    return order;
+}
+
+void
+compute_descendants(
+        std::vector<node>& nodes,
+        std::vector<std::size_t> const& order)
+{
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        node& n = nodes[*it];
+        n.descendants.resize(nodes.size());
+
+        for (std::size_t const child : n.children)
+        {
+            n.descendants.set(child);
+            n.descendants |= nodes[child].descendants;
+        }
+    }
+}
+
+//! Processors which might see the output, without the producer itself.
+auto
+readers(std::vector<node> const& nodes,
+        std::vector<std::size_t> direct_readers) -> std::vector<std::size_t>
+{
+    std::vector<bool> visited(nodes.size(), false);
+    std::vector<std::size_t> result;
+
+    while (!direct_readers.empty())
+    {
+        std::size_t const r = direct_readers.back();
+        direct_readers.pop_back();
+
+        if (visited[r])
+        {
+            continue;
+        }
+
+        visited[r] = true;
+        result.push_back(r);
+
+        if (nodes[r].proc->results_may_alias_inputs())
+        {
+            std::ranges::copy(
+                    nodes[r].audio_children,
+                    std::back_inserter(direct_readers));
+        }
+    }
+
+    return result;
+}
+
+struct slot_occupant
+{
+    std::size_t producer;
+    std::vector<std::size_t> readers;
+};
+
+auto
+is_finished_before(
+        std::vector<node> const& nodes,
+        slot_occupant const& occupant,
+        std::size_t const n) -> bool
+{
+    return nodes[occupant.producer].descendants[n] &&
+           std::ranges::all_of(occupant.readers, [&](std::size_t const r) {
+               return nodes[r].descendants[n];
+           });
+}
+
+} // namespace
+
+output_buffer_pool::output_buffer_pool(graph const& g)
+    : output_buffer_pool(g, std::make_shared<buffers_t>(), nullptr)
+{
+}
+
+output_buffer_pool::output_buffer_pool(
+        graph const& g,
+        output_buffer_pool const& previous)
+    : output_buffer_pool(g, previous.m_buffers, &previous)
+{
+}
+
+output_buffer_pool::output_buffer_pool(
+        graph const& g,
+        std::shared_ptr<buffers_t> buffers,
+        output_buffer_pool const* const previous)
+    : m_buffers(std::move(buffers))
+{
+    nodes_builder builder(g);
+    std::vector<node>& nodes = builder.nodes();
+
+    auto const order = topological_order(nodes);
+    compute_descendants(nodes, order);
+
+    std::map<graph_endpoint, graph_endpoint> sources;
+    for (auto const& [src, dst] : g.audio)
+    {
+        sources.emplace(dst, src);
+    }
+
+    // An input can be processed in place, if its source has no other
+    // consumer. The output is written into the slot of the source then.
+    auto in_place_slot = [&](processor& proc, std::size_t const port)
+            -> std::optional<std::size_t> {
+        auto const input = proc.in_place_input(port);
+        if (!input)
+        {
+            return std::nullopt;
+        }
+
+        auto const it = sources.find({.proc = proc, .port = *input});
+        if (it == sources.end())
+        {
+            return std::nullopt;
+        }
+
+        auto const [first, last] = g.audio.equal_range(it->second);
+        if (std::distance(first, last) != 1)
+        {
+            return std::nullopt;
+        }
+
+        return m_slots.at(it->second);
+    };
+
+    auto previous_slot =
+            [&](graph_endpoint const& src) -> std::optional<std::size_t> {
+        if (previous)
+        {
+            if (auto const it = previous->m_slots.find(src);
+                it != previous->m_slots.end())
+            {
+                return it->second;
+            }
+        }
+
+        return std::nullopt;
+    };
+
+    // Outputs still to come, which might keep their previous slot.
+    std::vector<std::size_t> pending_keeps(m_buffers->size());
+    for (node const& n : nodes)
+    {
+        processor& proc = *n.proc;
+        for (std::size_t port = 0, e = proc.num_outputs(); port < e; ++port)
+        {
+            if (auto const slot = previous_slot({.proc = proc, .port = port}))
+            {
+                ++pending_keeps[*slot];
+            }
+        }
+    }
+
+    // Greedy assignment in topological order. A slot can be reused, if its
+    // last occupant is finished, before the processor runs. All previous
+    // occupants are finished before the last one was produced.
+    std::vector<std::optional<slot_occupant>> slots(m_buffers->size());
+    auto is_free = [&](std::size_t const slot, std::size_t const n) {
+        return !slots[slot] || is_finished_before(nodes, *slots[slot], n);
+    };
+
+    auto occupy = [&](graph_endpoint const& src,
+                      std::size_t const slot,
+                      slot_occupant occupant) {
+        slots[slot] = std::move(occupant);
+        m_slots.emplace(src, slot);
+    };
+
+    auto share = [&](graph_endpoint const& src,
+                     std::size_t const slot,
+                     slot_occupant const& occupant) {
+        std::ranges::copy(
+                occupant.readers,
+                std::back_inserter(slots[slot]->readers));
+        m_slots.emplace(src, slot);
+    };
+
+    for (std::size_t const n : order)
+    {
+        processor& proc = *nodes[n].proc;
+        for (std::size_t port = 0, e = proc.num_outputs(); port < e; ++port)
+        {
+            graph_endpoint const src{.proc = proc, .port = port};
+
+            std::vector<std::size_t> direct_readers;
+            auto const [first, last] = g.audio.equal_range(src);
+            for (auto it = first; it != last; ++it)
+            {
+                direct_readers.push_back(builder.index_of(it->second.proc));
+            }
+
+            slot_occupant occupant{
+                    .producer = n,
+                    .readers = readers(nodes, std::move(direct_readers))};
+
+            auto const in_place = in_place_slot(proc, port);
+
+            if (auto const prev = previous_slot(src))
+            {
+                --pending_keeps[*prev];
+
+                if (in_place && *in_place == *prev)
+                {
+                    share(src, *prev, occupant);
+                    m_kept.insert(src);
+                    continue;
+                }
+
+                if (is_free(*prev, n))
+                {
+                    occupy(src, *prev, std::move(occupant));
+                    m_kept.insert(src);
+                    continue;
+                }
+            }
+
+            if (in_place)
+            {
+                share(src, *in_place, occupant);
+                continue;
+            }
+
+            // prefer the most recently added slot, it's more likely to be
+            // still in the cache
+            std::size_t slot = slots.size();
+            while (slot > 0 &&
+                   (pending_keeps[slot - 1] != 0 || !is_free(slot - 1, n)))
+            {
+                --slot;
+            }
+
+            if (slot > 0)
+            {
+                occupy(src, slot - 1, std::move(occupant));
+            }
+            else
+            {
+                slots.emplace_back();
+                pending_keeps.push_back(0);
+                m_buffers->emplace_back();
+                occupy(src, slots.size() - 1, std::move(occupant));
+            }
+        }
+    }
+
+    BOOST_ASSERT((std::ranges::all_of(
+            *m_buffers,
+            simd::is_aligned,
+            [](auto& b) { return b.data(); })));
+}
+
+auto
+output_buffer_pool::slot(graph_endpoint const& src) const -> std::size_t
+{
+    auto const it = m_slots.find(src);
+    BOOST_ASSERT_MSG(it != m_slots.end(), "output not part of the graph");
+    return it->second;
+}
+
+auto
+output_buffer_pool::buffer(graph_endpoint const& src) -> std::span<float>
+{
+    return (*m_buffers)[slot(src)];
+}
+
+auto
+output_buffer_pool::kept(graph_endpoint const& src) const -> bool
+{
+    return m_kept.contains(src);
+}
+
+} // namespace piejam::audio::engine
@@ -12,6 +12,7 @@
 #include <boost/assert.hpp>
 
 #include <array>
+#include <span>
 
 namespace piejam::audio::engine
 {
@@ -26,7 +27,47 @@ output_processor::process(process_context const& ctx)
 {
     verify_process_context(*this, ctx);
 
-    m_engine_output(ctx.inputs[0].get().as_variant());
+    audio_slice const& in = ctx.inputs[0].get();
+
+    if (!m_gain || m_gain->is_unity())
+    {
+        m_engine_output(in.as_variant());
+        return;
+    }
+
+    if (in.is_constant() && m_gain->from == m_gain->to)
+    {
+        m_engine_output(in.constant() * m_gain->to);
+        return;
+    }
+
+    BOOST_ASSERT(ctx.buffer_size <= m_gain_buffer.size());
+
+    std::span<float> const out(m_gain_buffer.data(), ctx.buffer_size);
+    float const step = (m_gain->to - m_gain->from) /
+                       static_cast<float>(ctx.buffer_size);
+
+    auto const gain_at = [from = m_gain->from, step](std::size_t const frame) {
+        return from + step * static_cast<float>(frame);
+    };
+
+    if (in.is_constant())
+    {
+        for (std::size_t frame = 0; frame < out.size(); ++frame)
+        {
+            out[frame] = in.constant() * gain_at(frame);
+        }
+    }
+    else
+    {
+        auto const& in_buffer = in.buffer();
+        for (std::size_t frame = 0; frame < out.size(); ++frame)
+        {
+            out[frame] = in_buffer[frame] * gain_at(frame);
+        }
+    }
+
+    m_engine_output(std::span<float const>(out));
 }
 
 } // namespace piejam::audio::engine
@@ -8,6 +8,8 @@
 
 #include <boost/assert.hpp>
 
+#include <algorithm>
+
 namespace piejam::audio::engine
 {
 
@@ -24,8 +26,11 @@ public:
 
 } // namespace
 
-process::process()
+process::process(std::size_t const num_outputs)
     : m_executor(std::make_unique<dummy_dag_executor>())
+    , m_faded_outputs(num_outputs)
+    , m_output_gains(num_outputs)
+    , m_next_faded_outputs(num_outputs)
 {
 }
 
@@ -36,7 +41,10 @@ process::~process()
 }
 
 auto
-process::swap_executor(std::unique_ptr<dag_executor> next_dag_executor) -> bool
+process::swap_executor(
+        std::unique_ptr<dag_executor> next_dag_executor,
+        std::size_t const fade_periods,
+        std::span<std::size_t const> const faded_outputs) -> bool
 {
     if (!next_dag_executor)
     {
@@ -46,24 +54,50 @@ process::swap_executor(std::unique_ptr<dag_executor> next_dag_executor) -> bool
     m_prev_executor = {};
     auto prev_executor_future = m_prev_executor.get_future();
 
+    m_fade_periods.store(fade_periods, std::memory_order_relaxed);
+
+    for (std::atomic_bool& faded : m_next_faded_outputs)
+    {
+        faded.store(false, std::memory_order_relaxed);
+    }
+
+    for (std::size_t const output : faded_outputs)
+    {
+        BOOST_ASSERT(output < m_next_faded_outputs.size());
+        m_next_faded_outputs[output].store(true, std::memory_order_relaxed);
+    }
+
     m_next_executor.store(
             next_dag_executor.release(),
             std::memory_order_release);
 
-    if (auto const status =
-                prev_executor_future.wait_for(std::chrono::milliseconds(200));
+    if (auto const status = prev_executor_future.wait_for(
+                std::chrono::milliseconds(200) * (fade_periods + 1));
         status == std::future_status::ready)
     {
         prev_executor_future.get();
         return true;
     }
 
-    delete m_next_executor.exchange(nullptr, std::memory_order_acq_rel);
-    return false;
+    if (std::unique_ptr<dag_executor> const discarded{
+                m_next_executor.exchange(nullptr, std::memory_order_acq_rel)})
+    {
+        return false;
+    }
+
+    // taken by the processing thread, right after the timeout
+    prev_executor_future.get();
+    return true;
 }
 
 void
-process::operator()(std::size_t const buffer_size) noexcept
+process::set_num_workers(std::size_t const num_workers) noexcept
+{
+    m_num_workers.store(num_workers, std::memory_order_relaxed);
+}
+
+void
+process::swap_in_next_executor() noexcept
 {
     if (auto next_dag_executor = std::unique_ptr<dag_executor>(
                 m_next_executor.exchange(nullptr, std::memory_order_acq_rel)))
@@ -71,8 +105,86 @@ process::operator()(std::size_t const buffer_size) noexcept
         std::swap(m_executor, next_dag_executor);
         m_prev_executor.set_value(std::move(next_dag_executor));
     }
+}
+
+void
+process::operator()(std::size_t const buffer_size) noexcept
+{
+    if (buffer_size == 0)
+    {
+        // nothing to fade over, swap right away
+        swap_in_next_executor();
+        m_faded_periods = 0;
+        m_output_gain = {};
+        std::fill(m_faded_outputs.begin(), m_faded_outputs.end(), false);
+        std::ranges::fill(m_output_gains, gain_ramp{});
+        return;
+    }
+
+    bool const swap_pending =
+            m_next_executor.load(std::memory_order_acquire) != nullptr;
+    std::size_t const fade_periods =
+            m_fade_periods.load(std::memory_order_relaxed);
+
+    m_faded_periods = std::min(m_faded_periods, fade_periods);
+
+    if (swap_pending)
+    {
+        // outputs still fading from a previous swap keep fading
+        for (std::size_t output = 0; output < m_faded_outputs.size(); ++output)
+        {
+            if (m_next_faded_outputs[output].load(std::memory_order_relaxed))
+            {
+                m_faded_outputs[output] = true;
+            }
+        }
+    }
+
+    if (swap_pending && m_faded_periods < fade_periods)
+    {
+        ++m_faded_periods;
+    }
+    else
+    {
+        // only swap if the pending executor was seen together with its fade
+        if (swap_pending)
+        {
+            swap_in_next_executor();
+        }
+
+        if (m_faded_periods > 0)
+        {
+            --m_faded_periods;
+        }
+    }
 
+    m_output_gain = {
+            .from = m_output_gain.to,
+            .to = fade_periods == 0
+                          ? 1.f
+                          : 1.f - static_cast<float>(m_faded_periods) /
+                                          static_cast<float>(fade_periods)};
+
+    for (std::size_t output = 0; output < m_output_gains.size(); ++output)
+    {
+        m_output_gains[output] =
+                m_faded_outputs[output] ? m_output_gain : gain_ramp{};
+    }
+
+    if (!swap_pending && m_output_gain.is_unity())
+    {
+        std::fill(m_faded_outputs.begin(), m_faded_outputs.end(), false);
+    }
+
+    m_executor->set_num_workers(
+            m_num_workers.load(std::memory_order_relaxed));
     (*m_executor)(buffer_size);
 }
 
+auto
+process::take_idle_time() noexcept -> std::chrono::nanoseconds
+{
+    return m_executor->take_idle_time();
+}
+
 } // namespace piejam::audio::engine
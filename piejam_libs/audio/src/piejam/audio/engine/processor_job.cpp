@@ -4,14 +4,20 @@
 
 #include <piejam/audio/engine/processor_job.h>
 
+#include <piejam/audio/engine/event_buffer.h>
+#include <piejam/audio/engine/output_buffer_pool.h>
 #include <piejam/audio/engine/processor.h>
 #include <piejam/audio/engine/slice.h>
+#include <piejam/audio/engine/slice_algorithms.h>
 #include <piejam/audio/engine/thread_context.h>
+#include <piejam/audio/engine/tracer.h>
 #include <piejam/audio/simd.h>
+#include <piejam/range/indices.h>
 
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <chrono>
 
 namespace piejam::audio::engine
 {
@@ -23,17 +29,69 @@ empty_result_ref() -> std::reference_wrapper<audio_slice const>
     return std::cref(res);
 }
 
-processor_job::processor_job(processor& proc)
+static auto
+make_outputs(processor& proc, output_buffer_pool& output_buffers)
+        -> std::vector<std::span<float>>
+{
+    std::vector<std::span<float>> outputs;
+    outputs.reserve(proc.num_outputs());
+    for (std::size_t port = 0, e = proc.num_outputs(); port < e; ++port)
+    {
+        outputs.push_back(output_buffers.buffer({.proc = proc, .port = port}));
+    }
+    return outputs;
+}
+
+processor_job::results::results(processor const& proc)
+    : audio(proc.num_outputs())
+{
+    for (event_port const& port : proc.event_outputs())
+    {
+        events.add(port);
+    }
+}
+
+processor_job::processor_job(
+        processor& proc,
+        output_buffer_pool& output_buffers)
+    : processor_job(proc, output_buffers, std::make_shared<results>(proc))
+{
+}
+
+processor_job::processor_job(
+        processor& proc,
+        output_buffer_pool& output_buffers,
+        processor_job const& previous)
+    : processor_job(proc, output_buffers, previous.m_shared_results)
+{
+    BOOST_ASSERT(&previous.m_proc == &proc);
+}
+
+processor_job::processor_job(
+        processor& proc,
+        output_buffer_pool& output_buffers,
+        std::shared_ptr<results> shared_results)
     : m_proc(proc)
-    , m_output_buffers(m_proc.num_outputs(), output_buffer_t{})
+    , m_shared_results(std::move(shared_results))
     , m_inputs(m_proc.num_inputs(), empty_result_ref())
-    , m_outputs(m_output_buffers.begin(), m_output_buffers.end())
-    , m_results(m_proc.num_outputs())
+    , m_outputs(make_outputs(proc, output_buffers))
+    , m_results(m_shared_results->audio)
+    , m_event_outputs(m_shared_results->events)
     , m_process_context(
               {m_inputs, m_outputs, m_results, m_event_inputs, m_event_outputs})
+    , m_tile_input_slices(m_proc.num_inputs())
+    , m_tile_inputs(m_tile_input_slices.begin(), m_tile_input_slices.end())
+    , m_tile_outputs(m_proc.num_outputs())
+    , m_tile_results(m_proc.num_outputs())
+    , m_tile_context(
+              {m_tile_inputs,
+               m_tile_outputs,
+               m_tile_results,
+               m_event_inputs,
+               m_event_outputs})
 {
     BOOST_ASSERT((std::ranges::all_of(
-            m_output_buffers,
+            m_outputs,
             simd::is_aligned,
             [](auto const& b) { return b.data(); })));
     for (event_port const& port : m_proc.event_inputs())
@@ -41,10 +99,7 @@ processor_job::processor_job(processor& proc)
         m_event_inputs.add(port);
     }
     BOOST_ASSERT(m_proc.event_inputs().size() == m_event_inputs.size());
-    for (event_port const& port : m_proc.event_outputs())
-    {
-        m_event_outputs.add(port);
-    }
+    BOOST_ASSERT(m_proc.num_outputs() == m_results.size());
     BOOST_ASSERT(m_proc.event_outputs().size() == m_event_outputs.size());
 }
 
@@ -97,10 +152,140 @@ processor_job::operator()(thread_context const& ctx)
         m_process_context.buffer_size = buffer_size;
     }
 
+    if (bypass_on_silence(buffer_size))
+    {
+        return;
+    }
+
     BOOST_ASSERT(ctx.event_memory);
     m_event_outputs.set_event_memory(ctx.event_memory);
 
-    m_proc.process(m_process_context);
+    process_traced(ctx, m_process_context);
+}
+
+void
+processor_job::process_traced(
+        thread_context const& ctx,
+        process_context const& proc_ctx)
+{
+    if (ctx.trace)
+    {
+        using clock_t = trace_event::clock_t;
+        auto const begin = clock_t::now();
+        m_proc.process(proc_ctx);
+        ctx.trace->record(m_proc.name(), begin, clock_t::now());
+    }
+    else
+    {
+        m_proc.process(proc_ctx);
+    }
+}
+
+auto
+processor_job::silent_inputs() const noexcept -> bool
+{
+    return std::ranges::all_of(
+                   m_inputs,
+                   [](audio_slice const& in) { return is_silence(in); }) &&
+           std::ranges::all_of(
+                   m_event_inputs,
+                   [](abstract_event_buffer const* ev_buf) {
+                       return ev_buf->empty();
+                   });
+}
+
+auto
+processor_job::bypass_on_silence(std::size_t const buffer_size) -> bool
+{
+    // generators are never silent
+    if (m_inputs.empty() || !silent_inputs())
+    {
+        m_silent_frames = 0;
+        return false;
+    }
+
+    std::size_t const silent_frames = m_silent_frames;
+    m_silent_frames += buffer_size;
+
+    std::optional<std::size_t> const tail_length = m_proc.tail_length();
+    if (!tail_length || silent_frames < *tail_length)
+    {
+        return false;
+    }
+
+    std::ranges::fill(m_results, audio_slice{});
+    return true;
+}
+
+auto
+processor_job::splittable() const noexcept -> bool
+{
+    return m_proc.block_splittable() && m_proc.event_inputs().empty() &&
+           m_proc.event_outputs().empty();
+}
+
+void
+processor_job::process_tile(
+        thread_context const& ctx,
+        std::size_t const offset,
+        std::size_t const size)
+{
+    BOOST_ASSERT(splittable());
+    BOOST_ASSERT(offset + size <= ctx.buffer_size);
+
+    for (std::size_t const i : range::indices(m_inputs))
+    {
+        m_tile_input_slices[i] = subslice(m_inputs[i].get(), offset, size);
+    }
+
+    for (std::size_t const i : range::indices(m_outputs))
+    {
+        m_tile_outputs[i] = {m_outputs[i].data() + offset, size};
+    }
+
+    m_tile_context.buffer_size = size;
+
+    process_traced(ctx, m_tile_context);
+
+    for (std::size_t const i : range::indices(m_outputs))
+    {
+        merge_tile_result(
+                i,
+                {m_outputs[i].data(), ctx.buffer_size},
+                offset);
+    }
+}
+
+void
+processor_job::merge_tile_result(
+        std::size_t const index,
+        std::span<float> const period_output,
+        std::size_t const offset)
+{
+    audio_slice const& tile = m_tile_results[index];
+    audio_slice& result = m_results[index];
+    std::span<float> const tile_output = m_tile_outputs[index];
+
+    // Each tile is written to its part of the output, since other members of
+    // a tiled chain may already reuse the memory preceding it. The result
+    // stays constant, as long as all tiles are the same constant.
+    if (tile.is_constant())
+    {
+        std::ranges::fill(tile_output, tile.constant());
+
+        if (offset == 0 ||
+            (result.is_constant() && result.constant() == tile.constant()))
+        {
+            result = tile;
+            return;
+        }
+    }
+    else if (tile.buffer().data() != tile_output.data())
+    {
+        std::ranges::copy(tile.buffer(), tile_output.begin());
+    }
+
+    result = audio_slice(period_output);
 }
 
 } // namespace piejam::audio::engine
@@ -0,0 +1,171 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/engine/processor_timings.h>
+
+#include <piejam/audio/engine/graph.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <set>
+
+namespace piejam::audio::engine
+{
+
+namespace
+{
+
+// Four buckets per octave. Values below four have their own bucket.
+constexpr auto
+bucket_of(std::uint64_t const ns) noexcept -> std::size_t
+{
+    if (ns < 4)
+    {
+        return static_cast<std::size_t>(ns);
+    }
+
+    auto const octave = static_cast<std::size_t>(std::bit_width(ns) - 1);
+    auto const sub_bucket =
+            static_cast<std::size_t>((ns >> (octave - 2)) & 3);
+    return 4 * (octave - 1) + sub_bucket;
+}
+
+constexpr auto
+bucket_upper_bound(std::size_t const bucket) noexcept -> std::uint64_t
+{
+    if (bucket < 4)
+    {
+        return bucket;
+    }
+
+    std::size_t const octave = bucket / 4 + 1;
+    std::uint64_t const lower = std::uint64_t{4 + bucket % 4} << (octave - 2);
+    return lower + (std::uint64_t{1} << (octave - 2)) - 1;
+}
+
+static_assert(bucket_of(7) == 7);
+static_assert(bucket_of(8) == 8);
+static_assert(
+        bucket_of(1000) == bucket_of(bucket_upper_bound(bucket_of(1000))));
+static_assert(bucket_of(bucket_upper_bound(20) + 1) == 21);
+
+} // namespace
+
+void
+processor_timings::timing::update(duration const d) noexcept
+{
+    auto const prev = m_estimate.load(std::memory_order_relaxed);
+    m_estimate.store(
+            prev ? prev + (d.count() - prev) / 8 : d.count(),
+            std::memory_order_relaxed);
+
+    auto const ns = std::max(d.count(), duration::rep{});
+
+    m_sum.fetch_add(ns, std::memory_order_relaxed);
+
+    auto max = m_max.load(std::memory_order_relaxed);
+    while (max < ns && !m_max.compare_exchange_weak(
+                               max,
+                               ns,
+                               std::memory_order_relaxed))
+    {
+    }
+
+    m_histogram[std::min(
+                        bucket_of(static_cast<std::uint64_t>(ns)),
+                        num_buckets - 1)]
+            .fetch_add(1, std::memory_order_relaxed);
+}
+
+auto
+processor_timings::timing::take_statistics() noexcept -> statistics
+{
+    std::array<std::uint32_t, num_buckets> histogram;
+    std::size_t count{};
+    for (std::size_t b = 0; b < num_buckets; ++b)
+    {
+        histogram[b] = m_histogram[b].exchange(0, std::memory_order_relaxed);
+        count += histogram[b];
+    }
+
+    auto const sum = m_sum.exchange(0, std::memory_order_relaxed);
+    auto const max = m_max.exchange(0, std::memory_order_relaxed);
+
+    if (count == 0)
+    {
+        return {};
+    }
+
+    // smallest bucket, which covers 99% of the samples
+    std::size_t const p99_count = (count * 99 + 99) / 100;
+    std::size_t cumulated{};
+    std::size_t p99_bucket{};
+    for (; p99_bucket < num_buckets - 1; ++p99_bucket)
+    {
+        cumulated += histogram[p99_bucket];
+        if (cumulated >= p99_count)
+        {
+            break;
+        }
+    }
+
+    return {.mean = duration{sum / static_cast<duration::rep>(count)},
+            .p99 = std::min(
+                    duration{static_cast<duration::rep>(
+                            bucket_upper_bound(p99_bucket))},
+                    duration{max}),
+            .max = duration{max},
+            .count = count};
+}
+
+auto
+processor_timings::operator[](processor const& proc) -> timing&
+{
+    auto& t = m_timings[std::addressof(proc)];
+    if (!t)
+    {
+        t = std::make_unique<timing>();
+    }
+
+    return *t;
+}
+
+auto
+processor_timings::estimate(processor const& proc) const -> duration
+{
+    auto it = m_timings.find(std::addressof(proc));
+    return it != m_timings.end() ? it->second->estimate() : duration{};
+}
+
+auto
+processor_timings::take_statistics(processor const& proc) -> statistics
+{
+    auto it = m_timings.find(std::addressof(proc));
+    return it != m_timings.end() ? it->second->take_statistics()
+                                 : statistics{};
+}
+
+void
+processor_timings::retain(graph const& g)
+{
+    std::set<processor const*> procs;
+
+    auto insert_procs = [&procs](graph::wires_map const& wires) {
+        for (auto const& [src, dst] : wires)
+        {
+            procs.insert(std::addressof(src.proc.get()));
+            procs.insert(std::addressof(dst.proc.get()));
+        }
+    };
+
+    insert_procs(g.audio);
+    insert_procs(g.event);
+
+    std::erase_if(m_timings, [&procs](auto const& entry) {
+        return !procs.contains(entry.first);
+    });
+}
+
+} // namespace piejam::audio::engine
@@ -0,0 +1,197 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/engine/tracer.h>
+
+#include <fmt/format.h>
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace piejam::audio::engine
+{
+
+namespace
+{
+
+auto
+escape_json(std::string_view const str) -> std::string
+{
+    std::string result;
+    result.reserve(str.size());
+
+    for (char const c : str)
+    {
+        switch (c)
+        {
+            case '"':
+                result += "\\\"";
+                break;
+
+            case '\\':
+                result += "\\\\";
+                break;
+
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    result += fmt::format(
+                            "\\u{:04x}",
+                            static_cast<unsigned char>(c));
+                }
+                else
+                {
+                    result += c;
+                }
+                break;
+        }
+    }
+
+    return result;
+}
+
+auto
+to_microseconds(trace_event::clock_t::time_point const t) -> double
+{
+    return std::chrono::duration<double, std::micro>(t.time_since_epoch())
+            .count();
+}
+
+} // namespace
+
+trace_ring::trace_ring(std::size_t const capacity)
+    : m_events(capacity)
+{
+    BOOST_ASSERT(capacity > 0);
+}
+
+auto
+trace_ring::record(
+        std::string_view const name,
+        trace_event::clock_t::time_point const begin,
+        trace_event::clock_t::time_point const end) noexcept -> bool
+{
+    std::size_t const write = m_write.load(std::memory_order_relaxed);
+    if (write - m_read.load(std::memory_order_acquire) == m_events.size())
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    trace_event& event = m_events[write % m_events.size()];
+
+    std::size_t const length =
+            std::min(name.size(), trace_event::max_name_length);
+    std::copy_n(name.data(), length, event.name.data());
+    event.name[length] = '\0';
+    event.begin = begin;
+    event.end = end;
+
+    m_write.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+tracer::tracer(std::size_t const num_threads, std::size_t const ring_capacity)
+    : m_drained(num_threads)
+{
+    m_rings.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i)
+    {
+        m_rings.push_back(std::make_unique<trace_ring>(ring_capacity));
+    }
+}
+
+tracer::~tracer() = default;
+
+void
+tracer::set_enabled(bool const enabled) noexcept
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+auto
+tracer::active_ring(std::size_t const thread_index) const noexcept
+        -> trace_ring*
+{
+    return enabled() && thread_index < m_rings.size()
+                   ? m_rings[thread_index].get()
+                   : nullptr;
+}
+
+void
+tracer::drain()
+{
+    std::lock_guard const lock(m_drain_mutex);
+    drain_locked();
+}
+
+void
+tracer::drain_locked()
+{
+    for (std::size_t tid = 0; tid < m_rings.size(); ++tid)
+    {
+        m_rings[tid]->consume([&events = m_drained[tid]](
+                                      trace_event const& event) {
+            events.push_back(event);
+        });
+    }
+}
+
+void
+tracer::write_chrome_trace(std::ostream& out)
+{
+    std::lock_guard const lock(m_drain_mutex);
+
+    drain_locked();
+
+    out << "{\"traceEvents\":[";
+
+    bool first{true};
+    auto separator = [&first]() {
+        return std::exchange(first, false) ? "\n" : ",\n";
+    };
+
+    for (std::size_t tid = 0; tid < m_rings.size(); ++tid)
+    {
+        out << separator()
+            << fmt::format(
+                       "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+                       "\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+                       tid,
+                       tid == 0 ? std::string("audio_main")
+                                : fmt::format("worker {}", tid - 1));
+
+        for (trace_event const& event : m_drained[tid])
+        {
+            out << separator()
+                << fmt::format(
+                           "{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":0,"
+                           "\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                           escape_json(event.name.data()),
+                           tid,
+                           to_microseconds(event.begin),
+                           to_microseconds(event.end) -
+                                   to_microseconds(event.begin));
+        }
+
+        m_drained[tid].clear();
+    }
+
+    std::size_t dropped{};
+    for (auto const& ring : m_rings)
+    {
+        dropped += ring->dropped();
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ns\","
+        << fmt::format(
+                   "\"otherData\":{{\"dropped_events\":{}}}}}\n",
+                   dropped - std::exchange(m_reported_dropped, dropped));
+}
+
+} // namespace piejam::audio::engine
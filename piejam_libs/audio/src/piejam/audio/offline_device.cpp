@@ -0,0 +1,193 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/offline_device.h>
+
+#include <boost/assert.hpp>
+#include <boost/hof/match.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace piejam::audio
+{
+
+namespace
+{
+
+constexpr std::chrono::milliseconds handover_interval{1};
+
+} // namespace
+
+offline_device::offline_device(
+        pcm_io_config const& io_config,
+        offline_source source,
+        offline_sink sink)
+    : m_process_config(io_config.process_config)
+    , m_source(std::move(source))
+    , m_sink(std::move(sink))
+{
+    std::size_t const period_size = m_process_config.period_size.get();
+    std::size_t const num_inputs = io_config.num_input_channels();
+    std::size_t const num_outputs = io_config.num_output_channels();
+
+    BOOST_ASSERT(period_size > 0);
+
+    m_input.resize(num_inputs * period_size);
+    m_output.resize(num_outputs * period_size);
+    m_output_sources.resize(num_outputs, 0.f);
+
+    for (std::size_t ch = 0; ch < num_inputs; ++ch)
+    {
+        m_input_channels.emplace_back(
+                std::span<float>{m_input}.subspan(
+                        ch * period_size,
+                        period_size));
+
+        m_input_converter.emplace_back([this, ch](std::span<float> const out) {
+            BOOST_ASSERT(out.size() <= m_input_channels[ch].size());
+            std::ranges::copy_n(
+                    m_input_channels[ch].begin(),
+                    static_cast<std::ptrdiff_t>(out.size()),
+                    out.begin());
+            return std::span<float const>{out};
+        });
+    }
+
+    for (std::size_t ch = 0; ch < num_outputs; ++ch)
+    {
+        m_output_channels.emplace_back(
+                std::span<float const>{m_output}.subspan(
+                        ch * period_size,
+                        period_size));
+
+        m_output_converter.emplace_back(
+                [this, ch](pcm_output_source_buffer_t const& source) {
+                    m_output_sources[ch] = source;
+                });
+    }
+}
+
+void
+offline_device::close()
+{
+    BOOST_ASSERT(!is_running());
+    m_open = false;
+}
+
+void
+offline_device::start(
+        thread::configuration const&,
+        init_process_function const& init_process_function,
+        process_function process_function)
+{
+    BOOST_ASSERT(is_open());
+    BOOST_ASSERT(!is_running());
+
+    init_process_function(m_input_converter, m_output_converter);
+    m_process_function = std::move(process_function);
+
+    m_handover_thread = std::jthread([this](std::stop_token const stop) {
+        while (!stop.stop_requested())
+        {
+            {
+                std::lock_guard const lock(m_mutex);
+                m_process_function(0);
+            }
+
+            std::this_thread::sleep_for(handover_interval);
+        }
+    });
+}
+
+void
+offline_device::stop()
+{
+    BOOST_ASSERT(is_running());
+
+    m_handover_thread = {};
+    m_process_function = {};
+}
+
+void
+offline_device::process_period()
+{
+    std::size_t const period_size = m_process_config.period_size.get();
+
+    m_process_function(period_size);
+
+    for (std::size_t ch = 0; ch < m_output_sources.size(); ++ch)
+    {
+        std::span<float> const out = std::span<float>{m_output}.subspan(
+                ch * period_size,
+                period_size);
+
+        std::visit(
+                boost::hof::match(
+                        [out](float const constant) {
+                            std::ranges::fill(out, constant);
+                        },
+                        [out](std::span<float const> const buffer) {
+                            BOOST_ASSERT(buffer.size() == out.size());
+                            std::ranges::copy(buffer, out.begin());
+                        }),
+                m_output_sources[ch]);
+
+        // unconnected outputs are silent in the next period
+        m_output_sources[ch] = 0.f;
+    }
+}
+
+void
+offline_device::render(std::size_t num_frames)
+{
+    BOOST_ASSERT(is_running());
+
+    std::lock_guard const lock(m_mutex);
+
+    std::size_t const period_size = m_process_config.period_size.get();
+    std::size_t const total_frames = num_frames;
+
+    auto const render_start = std::chrono::steady_clock::now();
+
+    while (num_frames > 0)
+    {
+        std::size_t const frames = std::min(num_frames, period_size);
+
+        m_source(m_input_channels);
+
+        process_period();
+
+        if (frames == period_size)
+        {
+            m_sink(m_output_channels);
+        }
+        else
+        {
+            std::vector<std::span<float const>> partial;
+            for (std::span<float const> const channel : m_output_channels)
+            {
+                partial.push_back(channel.first(frames));
+            }
+
+            m_sink(partial);
+        }
+
+        num_frames -= frames;
+        m_rendered_frames += frames;
+    }
+
+    std::chrono::duration<float> const processing_time =
+            std::chrono::steady_clock::now() - render_start;
+    std::chrono::duration<float> const rendered_time{
+            static_cast<float>(total_frames) /
+            static_cast<float>(m_process_config.sample_rate.get())};
+
+    m_cpu_load.store(
+            total_frames > 0 ? processing_time / rendered_time : 0.f,
+            std::memory_order_relaxed);
+}
+
+} // namespace piejam::audio
@@ -0,0 +1,85 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/offline_device_manager.h>
+
+#include <piejam/audio/pcm_descriptor.h>
+#include <piejam/audio/pcm_format.h>
+#include <piejam/audio/pcm_hw_params.h>
+
+#include <algorithm>
+
+namespace piejam::audio
+{
+
+namespace
+{
+
+auto
+offline_input() -> pcm_descriptor
+{
+    return {.name = "offline_in", .path = {}};
+}
+
+auto
+offline_output() -> pcm_descriptor
+{
+    return {.name = "offline_out", .path = {}};
+}
+
+} // namespace
+
+offline_device_manager::offline_device_manager(
+        unsigned const num_input_channels,
+        unsigned const num_output_channels,
+        sample_rate const sample_rate,
+        period_size const period_size,
+        offline_source source,
+        offline_sink sink)
+    : m_num_input_channels(num_input_channels)
+    , m_num_output_channels(num_output_channels)
+    , m_sample_rate(sample_rate)
+    , m_period_size(period_size)
+    , m_source(std::move(source))
+    , m_sink(std::move(sink))
+{
+}
+
+auto
+offline_device_manager::io_descriptors() -> pcm_io_descriptors
+{
+    return {.inputs = {offline_input()}, .outputs = {offline_output()}};
+}
+
+auto
+offline_device_manager::hw_params(
+        pcm_descriptor const& d,
+        sample_rate const*,
+        period_size const*) -> pcm_hw_params
+{
+    // the format is only relevant for hardware devices
+    return pcm_hw_params{
+            .interleaved = false,
+            .mmap = false,
+            .format = pcm_format::unsupported,
+            .num_channels = d == offline_input() ? m_num_input_channels
+                                                 : m_num_output_channels,
+            .sample_rates = {m_sample_rate},
+            .period_sizes = {m_period_size},
+            .period_counts = {preferred_period_counts.front()}};
+}
+
+auto
+offline_device_manager::make_device(
+        pcm_descriptor const&,
+        pcm_descriptor const&,
+        pcm_io_config const& io_config) -> std::unique_ptr<device>
+{
+    auto result =
+            std::make_unique<offline_device>(io_config, m_source, m_sink);
+    m_device = result.get();
+    return result;
+}
+
+} // namespace piejam::audio
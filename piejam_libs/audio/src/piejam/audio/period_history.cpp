@@ -0,0 +1,83 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/period_history.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace piejam::audio
+{
+
+period_history::period_history(
+        std::size_t const periods_before,
+        std::size_t const periods_after)
+    : m_periods_after(periods_after)
+    , m_ring(periods_before + periods_after + 1)
+    , m_capture(m_ring.size())
+{
+}
+
+void
+period_history::add_worker_idle(period_record::duration const idle) noexcept
+{
+    m_worker_idle += idle;
+}
+
+void
+period_history::record(period_record rec) noexcept
+{
+    rec.period = m_next_period++;
+    rec.worker_idle = std::exchange(m_worker_idle, {});
+    m_ring[rec.period % m_ring.size()] = rec;
+
+    // Following xruns within the window are part of the same capture.
+    if (rec.xrun && !m_capture_end)
+    {
+        m_capture_end = rec.period + m_periods_after;
+    }
+
+    if (m_capture_end != rec.period)
+    {
+        return;
+    }
+
+    m_capture_end.reset();
+
+    if (m_capture_ready.load(std::memory_order_acquire))
+    {
+        m_missed_captures.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    m_capture_size = std::min(rec.period + 1, m_ring.size());
+    for (std::size_t i = 0; i < m_capture_size; ++i)
+    {
+        std::size_t const period = rec.period + 1 - m_capture_size + i;
+        m_capture[i] = m_ring[period % m_ring.size()];
+    }
+
+    m_capture_ready.store(true, std::memory_order_release);
+}
+
+auto
+period_history::take_capture() -> std::vector<period_record>
+{
+    if (!m_capture_ready.load(std::memory_order_acquire))
+    {
+        return {};
+    }
+
+    std::vector<period_record> result(
+            m_capture.begin(),
+            std::next(
+                    m_capture.begin(),
+                    static_cast<std::ptrdiff_t>(m_capture_size)));
+
+    m_capture_ready.store(false, std::memory_order_release);
+
+    return result;
+}
+
+} // namespace piejam::audio
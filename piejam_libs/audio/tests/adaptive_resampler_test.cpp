@@ -0,0 +1,73 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/dsp/adaptive_resampler.h>
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <vector>
+
+namespace piejam::audio::dsp::test
+{
+
+TEST(adaptive_resampler, ratio_one_delays_the_input)
+{
+    adaptive_resampler<float> sut(2, 8, 1.f);
+
+    std::vector<float> output(16);
+    ASSERT_EQ(8u, sut.input_frames(8, 1.f));
+    auto input = sut.input_buffer(8);
+    std::iota(input.begin(), input.end(), 1.f);
+    sut.process(8, 1.f, output);
+
+    std::vector<float> const expected{
+            0.f, 0.f, 0.f, 0.f, 0.f, 0.f, // delay
+            1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f};
+    EXPECT_EQ(expected, output);
+}
+
+TEST(adaptive_resampler, linear_input_is_interpolated_exactly)
+{
+    adaptive_resampler<float> sut(1, 16, 1.f);
+
+    std::vector<float> output;
+    float next_input{};
+
+    for (std::size_t block = 0; block < 4; ++block)
+    {
+        std::vector<float> block_output(16);
+        std::size_t const input_frames = sut.input_frames(16, 0.75f);
+        for (float& x : sut.input_buffer(input_frames))
+        {
+            x = next_input++;
+        }
+        sut.process(input_frames, 0.75f, block_output);
+        output.insert(output.end(), block_output.begin(), block_output.end());
+    }
+
+    // skip the zero history
+    for (std::size_t i = 8; i < output.size(); ++i)
+    {
+        EXPECT_FLOAT_EQ(0.75f, output[i] - output[i - 1]);
+    }
+}
+
+TEST(adaptive_resampler, ratio_above_one_consumes_more_input)
+{
+    adaptive_resampler<float> sut(1, 16, 1.5f);
+
+    std::size_t consumed{};
+    for (std::size_t block = 0; block < 8; ++block)
+    {
+        std::vector<float> output(16);
+        std::size_t const input_frames = sut.input_frames(16, 1.5f);
+        sut.process(input_frames, 1.5f, output);
+        consumed += input_frames;
+    }
+
+    EXPECT_EQ(192u, consumed);
+}
+
+} // namespace piejam::audio::dsp::test
@@ -0,0 +1,49 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/engine/adaptive_worker_count.h>
+
+#include <gtest/gtest.h>
+
+namespace piejam::audio::engine::test
+{
+
+TEST(adaptive_worker_count, starts_with_max_workers)
+{
+    adaptive_worker_count sut(3);
+    EXPECT_EQ(3u, sut.value());
+}
+
+TEST(adaptive_worker_count, shrinks_on_low_load_down_to_zero)
+{
+    adaptive_worker_count sut(3);
+
+    EXPECT_EQ(2u, sut.update(0.1f));
+    EXPECT_EQ(1u, sut.update(0.1f));
+    EXPECT_EQ(0u, sut.update(0.1f));
+    EXPECT_EQ(0u, sut.update(0.1f));
+}
+
+TEST(adaptive_worker_count, grows_on_high_load_up_to_max)
+{
+    adaptive_worker_count sut(2);
+    sut.update(0.f);
+    sut.update(0.f);
+    ASSERT_EQ(0u, sut.value());
+
+    EXPECT_EQ(1u, sut.update(0.9f));
+    EXPECT_EQ(2u, sut.update(0.9f));
+    EXPECT_EQ(2u, sut.update(0.9f));
+}
+
+TEST(adaptive_worker_count, does_not_shrink_if_extrapolated_load_is_too_high)
+{
+    adaptive_worker_count sut(1);
+
+    // with one thread less, the load would be 0.8
+    EXPECT_EQ(1u, sut.update(0.4f));
+    EXPECT_EQ(0u, sut.update(0.2f));
+}
+
+} // namespace piejam::audio::engine::test
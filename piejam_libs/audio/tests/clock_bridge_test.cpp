@@ -0,0 +1,104 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/clock_bridge.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace piejam::audio::test
+{
+
+namespace
+{
+
+constexpr std::size_t period_size = 64;
+constexpr sample_rate rate{48000};
+
+//! Runs producer and consumer on clocks, which differ by the given drift.
+//! Returns the ratio of the bridge after the duration.
+auto
+run(clock_bridge& sut,
+    double const drift,
+    std::chrono::seconds const duration,
+    std::vector<float>& last_output) -> double
+{
+    double const producer_period =
+            period_size / (rate.get() * (1. + drift)) * 1e9;
+    double const consumer_period = period_size / double(rate.get()) * 1e9;
+
+    std::vector<float> const input(period_size * sut.num_channels(), 1.f);
+    last_output.resize(period_size * sut.num_channels());
+
+    double producer_time{};
+    double consumer_time{producer_period / 2};
+
+    while (consumer_time < std::chrono::nanoseconds(duration).count())
+    {
+        if (producer_time <= consumer_time)
+        {
+            sut.push(
+                    input,
+                    std::chrono::nanoseconds(
+                            static_cast<long long>(producer_time)));
+            producer_time += producer_period;
+        }
+        else
+        {
+            sut.pull(
+                    last_output,
+                    std::chrono::nanoseconds(
+                            static_cast<long long>(consumer_time)));
+            consumer_time += consumer_period;
+        }
+    }
+
+    return sut.ratio();
+}
+
+} // namespace
+
+TEST(clock_bridge, pulls_silence_until_target_fill_is_reached)
+{
+    clock_bridge sut(1, rate, period_size, period_size);
+
+    std::vector<float> const input(period_size, 1.f);
+    sut.push(input, std::chrono::nanoseconds{});
+
+    std::vector<float> output(period_size, 2.f);
+    sut.pull(output, std::chrono::nanoseconds{});
+
+    EXPECT_TRUE(std::ranges::all_of(output, [](float x) { return x == 0.f; }));
+    EXPECT_EQ(0u, sut.resyncs());
+}
+
+TEST(clock_bridge, ratio_follows_faster_producer)
+{
+    clock_bridge sut(2, rate, period_size, period_size);
+
+    std::vector<float> output;
+    double const ratio = run(sut, 200e-6, std::chrono::seconds{30}, output);
+
+    EXPECT_NEAR(1. + 200e-6, ratio, 20e-6);
+    EXPECT_EQ(0u, sut.resyncs());
+    EXPECT_TRUE(std::ranges::all_of(output, [](float x) {
+        return std::abs(x - 1.f) < 1e-5f;
+    }));
+}
+
+TEST(clock_bridge, ratio_follows_slower_producer)
+{
+    clock_bridge sut(1, rate, period_size, period_size);
+
+    std::vector<float> output;
+    double const ratio = run(sut, -300e-6, std::chrono::seconds{30}, output);
+
+    EXPECT_NEAR(1. - 300e-6, ratio, 20e-6);
+    EXPECT_EQ(0u, sut.resyncs());
+}
+
+} // namespace piejam::audio::test
@@ -10,6 +10,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 namespace piejam::audio::engine::test
 {
 
@@ -95,4 +97,210 @@ TEST(dag, split_and_merge_graph_mt)
     }
 }
 
+TEST(dag, split_and_merge_graph_mt_shared_queue)
+{
+    int x{}, y{}, z{};
+    dag sut;
+
+    auto parent_id = sut.add_task([&x](auto const&) { x = 5; });
+    auto child1_id =
+            sut.add_child_task(parent_id, [&y](auto const&) { y = 2; });
+    auto child2_id =
+            sut.add_child_task(parent_id, [&z](auto const&) { z = 3; });
+    auto result_id = sut.add_child_task(child1_id, [&x, &y, &z](auto const&) {
+        x += y + z;
+    });
+    sut.add_child(child2_id, result_id);
+
+    std::unique_ptr<audio::engine::dag_executor> executor;
+    {
+        std::vector<thread::worker> workers(2);
+        executor = sut.make_runnable(
+                workers,
+                1u << 16,
+                dag::scheduling::shared_queue);
+        for (std::size_t n = 0; n < 10; ++n)
+        {
+            (*executor)(1);
+            EXPECT_EQ(10, x);
+        }
+    }
+}
+
+TEST(dag, wide_graph_mt_work_stealing)
+{
+    constexpr std::size_t num_branches = 200;
+    std::vector<int> branch_results(num_branches);
+    int sum{};
+    dag sut;
+
+    auto const result_id = sut.add_task([&](auto const&) {
+        sum = 0;
+        for (int const r : branch_results)
+        {
+            sum += r;
+        }
+    });
+
+    for (std::size_t i = 0; i < num_branches; ++i)
+    {
+        auto const src_id = sut.add_task(
+                [&branch_results, i](auto const&) { branch_results[i] = 1; });
+        auto const mid_id =
+                sut.add_child_task(src_id, [&branch_results, i](auto const&) {
+                    branch_results[i] *= 2;
+                });
+        sut.add_child(mid_id, result_id);
+    }
+
+    std::unique_ptr<audio::engine::dag_executor> executor;
+    {
+        std::vector<thread::worker> workers(3);
+        executor = sut.make_runnable(
+                workers,
+                1u << 16,
+                dag::scheduling::work_stealing);
+        for (std::size_t n = 0; n < 100; ++n)
+        {
+            (*executor)(1);
+            EXPECT_EQ(2 * static_cast<int>(num_branches), sum);
+        }
+    }
+}
+
+TEST(dag, wide_graph_mt_work_stealing_with_varying_num_workers)
+{
+    constexpr std::size_t num_branches = 50;
+    std::vector<int> branch_results(num_branches);
+    int sum{};
+    dag sut;
+
+    auto const result_id = sut.add_task([&](auto const&) {
+        sum = 0;
+        for (int const r : branch_results)
+        {
+            sum += r;
+        }
+    });
+
+    for (std::size_t i = 0; i < num_branches; ++i)
+    {
+        auto const src_id = sut.add_task(
+                [&branch_results, i](auto const&) { branch_results[i] = 1; });
+        sut.add_child(src_id, result_id);
+    }
+
+    std::unique_ptr<audio::engine::dag_executor> executor;
+    {
+        std::vector<thread::worker> workers(3);
+        executor = sut.make_runnable(
+                workers,
+                1u << 16,
+                dag::scheduling::work_stealing);
+        for (std::size_t n = 0; n < 20; ++n)
+        {
+            executor->set_num_workers(n % 5);
+            std::ranges::fill(branch_results, 0);
+            (*executor)(1);
+            EXPECT_EQ(static_cast<int>(num_branches), sum);
+        }
+    }
+}
+
+TEST(dag, max_parallelism)
+{
+    dag sut;
+    EXPECT_EQ(0u, sut.max_parallelism());
+
+    auto const a = sut.add_task([](auto const&) {});
+    auto const b = sut.add_child_task(a, [](auto const&) {});
+    EXPECT_EQ(1u, sut.max_parallelism());
+
+    auto const c = sut.add_child_task(a, [](auto const&) {});
+    auto const d = sut.add_child_task(a, [](auto const&) {});
+    EXPECT_EQ(3u, sut.max_parallelism());
+
+    auto const e = sut.add_child_task(b, [](auto const&) {});
+    sut.add_child(c, e);
+    sut.add_child(d, e);
+    EXPECT_EQ(3u, sut.max_parallelism());
+
+    sut.add_task([](auto const&) {});
+    EXPECT_EQ(3u, sut.max_parallelism());
+}
+
+TEST(dag, split_and_merge_graph_mt_static_schedule)
+{
+    int x{}, y{}, z{};
+    dag sut;
+
+    auto parent_id = sut.add_task([&x](auto const&) { x = 5; });
+    auto child1_id =
+            sut.add_child_task(parent_id, [&y](auto const&) { y = 2; });
+    auto child2_id =
+            sut.add_child_task(parent_id, [&z](auto const&) { z = 3; });
+    auto result_id = sut.add_child_task(child1_id, [&x, &y, &z](auto const&) {
+        x += y + z;
+    });
+    sut.add_child(child2_id, result_id);
+    sut.set_cost(child1_id, std::chrono::microseconds(10));
+    sut.set_cost(child2_id, std::chrono::microseconds(20));
+
+    std::unique_ptr<audio::engine::dag_executor> executor;
+    {
+        std::vector<thread::worker> workers(2);
+        executor = sut.make_runnable(
+                workers,
+                1u << 16,
+                dag::scheduling::static_schedule);
+        for (std::size_t n = 0; n < 10; ++n)
+        {
+            (*executor)(1);
+            EXPECT_EQ(10, x);
+        }
+    }
+}
+
+TEST(dag, wide_graph_mt_static_schedule)
+{
+    constexpr std::size_t num_branches = 200;
+    std::vector<int> branch_results(num_branches);
+    int sum{};
+    dag sut;
+
+    auto const result_id = sut.add_task([&](auto const&) {
+        sum = 0;
+        for (int const r : branch_results)
+        {
+            sum += r;
+        }
+    });
+
+    for (std::size_t i = 0; i < num_branches; ++i)
+    {
+        auto const src_id = sut.add_task(
+                [&branch_results, i](auto const&) { branch_results[i] = 1; });
+        auto const mid_id =
+                sut.add_child_task(src_id, [&branch_results, i](auto const&) {
+                    branch_results[i] *= 2;
+                });
+        sut.add_child(mid_id, result_id);
+        sut.set_cost(src_id, std::chrono::nanoseconds(100 * (i % 7 + 1)));
+    }
+
+    std::unique_ptr<audio::engine::dag_executor> executor;
+    {
+        std::vector<thread::worker> workers(3);
+        executor = sut.make_runnable(
+                workers,
+                1u << 16,
+                dag::scheduling::static_schedule);
+        for (std::size_t n = 0; n < 100; ++n)
+        {
+            (*executor)(1);
+            EXPECT_EQ(2 * static_cast<int>(num_branches), sum);
+        }
+    }
+}
+
 } // namespace piejam::audio::engine::test
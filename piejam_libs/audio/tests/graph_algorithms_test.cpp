@@ -17,7 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
 #include <fstream>
+#include <set>
 
 namespace piejam::audio::engine::test
 {
@@ -39,11 +41,49 @@ TEST(finalize_graph, connect_to_already_connected_will_insert_a_mixer)
     EXPECT_FALSE(has_audio_wire(result, {src1, 0}, {dst, 0}));
     EXPECT_FALSE(has_audio_wire(result, {src2, 0}, {dst, 0}));
     ASSERT_EQ(1u, mixers.size());
-    EXPECT_TRUE(is_mix_processor(*mixers.front()));
-    EXPECT_EQ(2u, mixers.front()->num_inputs());
-    EXPECT_TRUE(has_audio_wire(result, {src1, 0}, {*mixers.front(), 0}));
-    EXPECT_TRUE(has_audio_wire(result, {src2, 0}, {*mixers.front(), 1}));
-    EXPECT_TRUE(has_audio_wire(result, {*mixers.front(), 0}, {dst, 0}));
+    processor& mixer = *mixers.at({dst, 0});
+    EXPECT_TRUE(is_mix_processor(mixer));
+    EXPECT_EQ(2u, mixer.num_inputs());
+    EXPECT_TRUE(has_audio_wire(result, {src1, 0}, {mixer, 0}));
+    EXPECT_TRUE(has_audio_wire(result, {src2, 0}, {mixer, 1}));
+    EXPECT_TRUE(has_audio_wire(result, {mixer, 0}, {dst, 0}));
+}
+
+TEST(finalize_graph, mixer_of_the_previous_result_is_reused)
+{
+    fake_processor src1{"src1", 0, 1};
+    fake_processor src2{"src2", 0, 1};
+    fake_processor dst{"dst", 1, 0};
+    graph sut;
+    sut.audio.insert({src1, 0}, {dst, 0});
+    sut.audio.insert({src2, 0}, {dst, 0});
+
+    auto [previous, previous_mixers] = finalize_graph(sut);
+    auto [result, mixers] = finalize_graph(sut, previous_mixers);
+
+    ASSERT_EQ(1u, mixers.size());
+    EXPECT_EQ(previous_mixers.at({dst, 0}), mixers.at({dst, 0}));
+    EXPECT_TRUE(has_audio_wire(result, {*mixers.at({dst, 0}), 0}, {dst, 0}));
+}
+
+TEST(finalize_graph, mixer_is_not_reused_for_another_number_of_sources)
+{
+    fake_processor src1{"src1", 0, 1};
+    fake_processor src2{"src2", 0, 1};
+    fake_processor src3{"src3", 0, 1};
+    fake_processor dst{"dst", 1, 0};
+    graph sut;
+    sut.audio.insert({src1, 0}, {dst, 0});
+    sut.audio.insert({src2, 0}, {dst, 0});
+
+    auto [previous, previous_mixers] = finalize_graph(sut);
+
+    sut.audio.insert({src3, 0}, {dst, 0});
+    auto [result, mixers] = finalize_graph(sut, previous_mixers);
+
+    ASSERT_EQ(1u, mixers.size());
+    EXPECT_NE(previous_mixers.at({dst, 0}), mixers.at({dst, 0}));
+    EXPECT_EQ(3u, mixers.at({dst, 0})->num_inputs());
 }
 
 TEST(remove_event_identity_processors, identity_without_output)
@@ -336,23 +376,44 @@ TEST(finalize_graph, connect_two_components_to_one)
     EXPECT_EQ(6u, result.audio.size());
     EXPECT_TRUE(result.event.empty());
 
-    if (has_audio_wire(result, {src_proc1, 0}, {*mixers[0], 0}))
-    {
-        EXPECT_TRUE(has_audio_wire(result, {src_proc1, 1}, {*mixers[1], 0}));
-        EXPECT_TRUE(has_audio_wire(result, {src_proc2, 0}, {*mixers[0], 1}));
-        EXPECT_TRUE(has_audio_wire(result, {src_proc2, 1}, {*mixers[1], 1}));
-        EXPECT_TRUE(has_audio_wire(result, {*mixers[0], 0}, {dst_proc, 0}));
-        EXPECT_TRUE(has_audio_wire(result, {*mixers[1], 0}, {dst_proc, 1}));
-    }
-    else
-    {
-        EXPECT_TRUE(has_audio_wire(result, {src_proc1, 0}, {*mixers[1], 0}));
-        EXPECT_TRUE(has_audio_wire(result, {src_proc1, 1}, {*mixers[0], 0}));
-        EXPECT_TRUE(has_audio_wire(result, {src_proc2, 0}, {*mixers[1], 1}));
-        EXPECT_TRUE(has_audio_wire(result, {src_proc2, 1}, {*mixers[0], 1}));
-        EXPECT_TRUE(has_audio_wire(result, {*mixers[1], 0}, {dst_proc, 0}));
-        EXPECT_TRUE(has_audio_wire(result, {*mixers[0], 0}, {dst_proc, 1}));
-    }
+    processor& mixer0 = *mixers.at({dst_proc, 0});
+    processor& mixer1 = *mixers.at({dst_proc, 1});
+    EXPECT_TRUE(has_audio_wire(result, {src_proc1, 0}, {mixer0, 0}));
+    EXPECT_TRUE(has_audio_wire(result, {src_proc1, 1}, {mixer1, 0}));
+    EXPECT_TRUE(has_audio_wire(result, {src_proc2, 0}, {mixer0, 1}));
+    EXPECT_TRUE(has_audio_wire(result, {src_proc2, 1}, {mixer1, 1}));
+    EXPECT_TRUE(has_audio_wire(result, {mixer0, 0}, {dst_proc, 0}));
+    EXPECT_TRUE(has_audio_wire(result, {mixer1, 0}, {dst_proc, 1}));
+}
+
+TEST(downstream_processors, follows_the_audio_wires_of_the_sources)
+{
+    fake_processor src{
+            "src",
+            0,
+            2,
+            {},
+            {event_port(std::in_place_type<float>)}};
+    fake_processor proc{"proc", 1, 1};
+    fake_processor dst{"dst", 1, 0};
+    fake_processor other_src{"other_src", 0, 1};
+    fake_processor other_dst{"other_dst", 1, 0};
+    fake_processor event_dst{
+            "event_dst",
+            0,
+            0,
+            {event_port(std::in_place_type<float>)}};
+
+    graph g;
+    g.audio.insert({src, 1}, {proc, 0});
+    g.audio.insert({proc, 0}, {dst, 0});
+    g.audio.insert({other_src, 0}, {other_dst, 0});
+    g.event.insert({src, 0}, {event_dst, 0});
+
+    std::array const srcs{graph_endpoint{.proc = src, .port = 1}};
+    auto const result = downstream_processors(g, srcs);
+
+    EXPECT_EQ((std::set<processor const*>{&proc, &dst}), result);
 }
 
 } // namespace piejam::audio::engine::test
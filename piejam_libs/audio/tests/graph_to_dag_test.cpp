@@ -5,6 +5,7 @@
 #include "processor_mock.h"
 
 #include <piejam/audio/engine/audio_slice.h>
+#include <piejam/audio/engine/clip_processor.h>
 #include <piejam/audio/engine/dag.h>
 #include <piejam/audio/engine/dag_executor.h>
 #include <piejam/audio/engine/event_input_buffers.h>
@@ -14,9 +15,13 @@
 #include <piejam/audio/engine/graph_to_dag.h>
 #include <piejam/audio/engine/process_context.h>
 #include <piejam/audio/engine/thread_context.h>
+#include <piejam/thread/worker.h>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace piejam::audio::engine::test
 {
 
@@ -56,6 +61,47 @@ TEST(graph_to_dag, audio_is_transferred_to_connected_proc)
     (*d)(buffer_size);
 }
 
+TEST(graph_to_dag, audio_is_transferred_to_connected_proc_work_stealing)
+{
+    ::testing::NiceMock<processor_mock> in_proc;
+    ::testing::NiceMock<processor_mock> out_proc;
+
+    graph g;
+
+    using namespace testing;
+
+    ON_CALL(in_proc, num_outputs()).WillByDefault(Return(1));
+    ON_CALL(out_proc, num_inputs()).WillByDefault(Return(1));
+    g.audio.insert({in_proc, 0}, {out_proc, 0});
+
+    std::vector<thread::worker> workers(2);
+
+    std::size_t buffer_size = 1;
+    auto d = graph_to_dag(g).make_runnable(
+            workers,
+            1u << 16,
+            dag::scheduling::work_stealing);
+
+    EXPECT_CALL(in_proc, process(_))
+            .WillOnce(Invoke([](process_context const& ctx) {
+                ASSERT_EQ(1u, ctx.outputs.size());
+                auto const& buf = ctx.outputs[0];
+                ASSERT_EQ(1u, buf.size());
+                buf[0] = 23.f;
+                ctx.results[0] = buf;
+            }));
+
+    auto input_has_sample = [](process_context const& ctx) {
+        return ctx.inputs.size() == 1 &&
+               ctx.inputs[0].get().buffer().size() == 1 &&
+               ctx.inputs[0].get().buffer()[0] == 23.f;
+    };
+
+    EXPECT_CALL(out_proc, process(Truly(input_has_sample))).Times(1);
+
+    (*d)(buffer_size);
+}
+
 TEST(graph_to_dag, audio_can_spread_to_multiple_ins)
 {
     ::testing::NiceMock<processor_mock> in_proc;
@@ -152,6 +198,208 @@ TEST(graph_to_dag, unconnected_input_will_have_silence_buffer)
     (*d)(buffer_size);
 }
 
+TEST(graph_to_dag, linear_chain_is_fused_into_one_task)
+{
+    ::testing::NiceMock<processor_mock> proc1;
+    ::testing::NiceMock<processor_mock> proc2;
+    ::testing::NiceMock<processor_mock> proc3;
+
+    graph g;
+
+    using namespace testing;
+
+    ON_CALL(proc1, num_outputs()).WillByDefault(Return(1));
+    ON_CALL(proc2, num_inputs()).WillByDefault(Return(1));
+    ON_CALL(proc2, num_outputs()).WillByDefault(Return(1));
+    ON_CALL(proc3, num_inputs()).WillByDefault(Return(1));
+    g.audio.insert({proc1, 0}, {proc2, 0});
+    g.audio.insert({proc2, 0}, {proc3, 0});
+
+    auto sut = graph_to_dag(g);
+    EXPECT_EQ(1u, sut.graph().size());
+
+    Sequence seq;
+    EXPECT_CALL(proc1, process(_)).InSequence(seq);
+    EXPECT_CALL(proc2, process(_)).InSequence(seq);
+    EXPECT_CALL(proc3, process(_)).InSequence(seq);
+
+    (*sut.make_runnable())(1);
+}
+
+TEST(graph_to_dag, branches_are_not_fused)
+{
+    ::testing::NiceMock<processor_mock> src_proc;
+    ::testing::NiceMock<processor_mock> dst_proc1;
+    ::testing::NiceMock<processor_mock> dst_proc2;
+
+    graph g;
+
+    using namespace testing;
+
+    ON_CALL(src_proc, num_outputs()).WillByDefault(Return(1));
+    ON_CALL(dst_proc1, num_inputs()).WillByDefault(Return(1));
+    ON_CALL(dst_proc2, num_inputs()).WillByDefault(Return(1));
+    g.audio.insert({src_proc, 0}, {dst_proc1, 0});
+    g.audio.insert({src_proc, 0}, {dst_proc2, 0});
+
+    auto sut = graph_to_dag(g);
+    EXPECT_EQ(3u, sut.graph().size());
+}
+
+TEST(graph_to_dag, tiled_chain_gives_same_result_as_whole_period)
+{
+    ::testing::NiceMock<processor_mock> src_proc;
+    auto clip_proc1 = make_clip_processor(-0.5f, 0.5f);
+    auto clip_proc2 = make_clip_processor(-0.25f, 0.75f);
+    ::testing::NiceMock<processor_mock> dst_proc;
+
+    graph g;
+
+    using namespace testing;
+
+    ON_CALL(src_proc, num_outputs()).WillByDefault(Return(1));
+    ON_CALL(dst_proc, num_inputs()).WillByDefault(Return(1));
+    g.audio.insert({src_proc, 0}, {*clip_proc1, 0});
+    g.audio.insert({*clip_proc1, 0}, {*clip_proc2, 0});
+    g.audio.insert({*clip_proc2, 0}, {dst_proc, 0});
+
+    std::size_t const buffer_size = 200;
+    auto d = graph_to_dag(g, nullptr, 64).make_runnable();
+
+    EXPECT_CALL(src_proc, process(_))
+            .WillOnce(Invoke([](process_context const& ctx) {
+                for (std::size_t i = 0; i < ctx.buffer_size; ++i)
+                {
+                    ctx.outputs[0][i] = static_cast<float>(i) / 100.f - 1.f;
+                }
+                ctx.results[0] = ctx.outputs[0];
+            }));
+
+    std::vector<float> result;
+    EXPECT_CALL(dst_proc, process(_))
+            .WillOnce(Invoke([&result](process_context const& ctx) {
+                auto const& in = ctx.inputs[0].get();
+                ASSERT_TRUE(in.is_buffer());
+                result.assign(in.buffer().begin(), in.buffer().end());
+            }));
+
+    (*d)(buffer_size);
+
+    ASSERT_EQ(buffer_size, result.size());
+    for (std::size_t i = 0; i < buffer_size; ++i)
+    {
+        EXPECT_FLOAT_EQ(
+                std::clamp(static_cast<float>(i) / 100.f - 1.f, -0.25f, 0.5f),
+                result[i]);
+    }
+}
+
+TEST(graph_to_dag, tiled_chain_keeps_constant_result)
+{
+    ::testing::NiceMock<processor_mock> src_proc;
+    auto clip_proc1 = make_clip_processor();
+    auto clip_proc2 = make_clip_processor(-0.5f, 0.5f);
+    ::testing::NiceMock<processor_mock> dst_proc;
+
+    graph g;
+
+    using namespace testing;
+
+    ON_CALL(src_proc, num_outputs()).WillByDefault(Return(1));
+    ON_CALL(dst_proc, num_inputs()).WillByDefault(Return(1));
+    g.audio.insert({src_proc, 0}, {*clip_proc1, 0});
+    g.audio.insert({*clip_proc1, 0}, {*clip_proc2, 0});
+    g.audio.insert({*clip_proc2, 0}, {dst_proc, 0});
+
+    std::size_t const buffer_size = 256;
+    auto d = graph_to_dag(g, nullptr, 64).make_runnable();
+
+    EXPECT_CALL(src_proc, process(_))
+            .WillOnce(Invoke([](process_context const& ctx) {
+                ctx.results[0] = 2.f;
+            }));
+
+    auto input_is_constant = [](process_context const& ctx) {
+        auto const& in = ctx.inputs[0].get();
+        return in.is_constant() && in.constant() == 0.5f;
+    };
+    EXPECT_CALL(dst_proc, process(Truly(input_is_constant))).Times(1);
+
+    (*d)(buffer_size);
+}
+
+TEST(graph_to_dag, processor_is_bypassed_after_silence_longer_than_tail)
+{
+    ::testing::NiceMock<processor_mock> src_proc;
+    ::testing::NiceMock<processor_mock> fx_proc;
+    ::testing::NiceMock<processor_mock> dst_proc;
+
+    graph g;
+
+    using namespace testing;
+
+    ON_CALL(src_proc, num_outputs()).WillByDefault(Return(1));
+    ON_CALL(fx_proc, num_inputs()).WillByDefault(Return(1));
+    ON_CALL(fx_proc, num_outputs()).WillByDefault(Return(1));
+    ON_CALL(fx_proc, tail_length()).WillByDefault(Return(2u));
+    ON_CALL(dst_proc, num_inputs()).WillByDefault(Return(1));
+    g.audio.insert({src_proc, 0}, {fx_proc, 0});
+    g.audio.insert({fx_proc, 0}, {dst_proc, 0});
+
+    std::size_t const buffer_size = 1;
+    auto d = graph_to_dag(g).make_runnable();
+
+    ON_CALL(src_proc, process(_))
+            .WillByDefault(Invoke(
+                    [](process_context const& ctx) { ctx.results[0] = 0.f; }));
+    ON_CALL(fx_proc, process(_))
+            .WillByDefault(Invoke(
+                    [](process_context const& ctx) { ctx.results[0] = 1.f; }));
+
+    auto input_is_silent = [](process_context const& ctx) {
+        return is_silence(ctx.inputs[0].get());
+    };
+
+    EXPECT_CALL(fx_proc, process(_)).Times(2);
+
+    Sequence seq;
+    EXPECT_CALL(dst_proc, process(Not(Truly(input_is_silent))))
+            .Times(2)
+            .InSequence(seq);
+    EXPECT_CALL(dst_proc, process(Truly(input_is_silent))).InSequence(seq);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        (*d)(buffer_size);
+    }
+}
+
+TEST(graph_to_dag, processor_without_tail_length_is_not_bypassed)
+{
+    ::testing::NiceMock<processor_mock> src_proc;
+    ::testing::NiceMock<processor_mock> fx_proc;
+
+    graph g;
+
+    using namespace testing;
+
+    ON_CALL(src_proc, num_outputs()).WillByDefault(Return(1));
+    ON_CALL(fx_proc, num_inputs()).WillByDefault(Return(1));
+    g.audio.insert({src_proc, 0}, {fx_proc, 0});
+
+    auto d = graph_to_dag(g).make_runnable();
+
+    ON_CALL(src_proc, process(_))
+            .WillByDefault(Invoke(
+                    [](process_context const& ctx) { ctx.results[0] = 0.f; }));
+    EXPECT_CALL(fx_proc, process(_)).Times(3);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        (*d)(1);
+    }
+}
+
 TEST(graph_to_dag, event_is_transferred)
 {
     ::testing::NiceMock<processor_mock> in_proc;
@@ -222,4 +470,98 @@ TEST(graph_to_dag, event_output_buffer_is_cleared_after_dag_run)
     EXPECT_TRUE(ev_buf->empty());
 }
 
+
+TEST(graph_to_dag, jobs_of_unchanged_processors_are_reused)
+{
+    ::testing::NiceMock<processor_mock> in_proc;
+    ::testing::NiceMock<processor_mock> out_proc;
+    ::testing::NiceMock<processor_mock> added_proc;
+
+    graph g;
+
+    using namespace testing;
+
+    ON_CALL(in_proc, num_outputs()).WillByDefault(Return(1));
+    ON_CALL(out_proc, num_inputs()).WillByDefault(Return(1));
+    ON_CALL(added_proc, num_inputs()).WillByDefault(Return(1));
+    g.audio.insert({in_proc, 0}, {out_proc, 0});
+
+    std::vector<process_context const*> in_contexts;
+    std::vector<process_context const*> out_contexts;
+    ON_CALL(in_proc, process(_))
+            .WillByDefault(Invoke([&](process_context const& ctx) {
+                in_contexts.push_back(&ctx);
+            }));
+    ON_CALL(out_proc, process(_))
+            .WillByDefault(Invoke([&](process_context const& ctx) {
+                out_contexts.push_back(&ctx);
+            }));
+
+    std::size_t buffer_size = 1;
+    job_cache jobs;
+    auto d = graph_to_dag(g, nullptr, 0, &jobs).make_runnable();
+    (*d)(buffer_size);
+
+    g.audio.insert({in_proc, 0}, {added_proc, 0});
+
+    EXPECT_CALL(added_proc, process(_)).Times(1);
+
+    d = graph_to_dag(g, nullptr, 0, &jobs).make_runnable();
+    (*d)(buffer_size);
+
+    ASSERT_EQ(2u, in_contexts.size());
+    ASSERT_EQ(2u, out_contexts.size());
+    EXPECT_EQ(in_contexts[0], in_contexts[1]);
+    EXPECT_EQ(out_contexts[0], out_contexts[1]);
+}
+
+TEST(graph_to_dag, new_job_feeds_the_reused_jobs_of_its_consumers)
+{
+    ::testing::NiceMock<processor_mock> src_proc;
+    ::testing::NiceMock<processor_mock> changed_proc;
+    ::testing::NiceMock<processor_mock> out_proc;
+
+    graph g;
+
+    using namespace testing;
+
+    ON_CALL(src_proc, num_outputs()).WillByDefault(Return(1));
+    ON_CALL(changed_proc, num_inputs()).WillByDefault(Return(1));
+    ON_CALL(changed_proc, num_outputs()).WillByDefault(Return(1));
+    ON_CALL(out_proc, num_inputs()).WillByDefault(Return(1));
+    g.audio.insert({changed_proc, 0}, {out_proc, 0});
+
+    std::vector<process_context const*> changed_contexts;
+    std::vector<process_context const*> out_contexts;
+    ON_CALL(changed_proc, process(_))
+            .WillByDefault(Invoke([&](process_context const& ctx) {
+                changed_contexts.push_back(&ctx);
+                ctx.outputs[0][0] = static_cast<float>(changed_contexts.size());
+                ctx.results[0] = ctx.outputs[0];
+            }));
+
+    std::vector<float> out_samples;
+    ON_CALL(out_proc, process(_))
+            .WillByDefault(Invoke([&](process_context const& ctx) {
+                out_contexts.push_back(&ctx);
+                out_samples.push_back(ctx.inputs[0].get().buffer()[0]);
+            }));
+
+    std::size_t buffer_size = 1;
+    job_cache jobs;
+    auto d = graph_to_dag(g, nullptr, 0, &jobs).make_runnable();
+    (*d)(buffer_size);
+
+    g.audio.insert({src_proc, 0}, {changed_proc, 0});
+
+    d = graph_to_dag(g, nullptr, 0, &jobs).make_runnable();
+    (*d)(buffer_size);
+
+    ASSERT_EQ(2u, changed_contexts.size());
+    ASSERT_EQ(2u, out_contexts.size());
+    EXPECT_NE(changed_contexts[0], changed_contexts[1]);
+    EXPECT_EQ(out_contexts[0], out_contexts[1]);
+    EXPECT_EQ((std::vector{1.f, 2.f}), out_samples);
+}
+
 } // namespace piejam::audio::engine::test
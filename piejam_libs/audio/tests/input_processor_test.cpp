@@ -13,6 +13,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 namespace piejam::audio::engine::test
 {
 
@@ -25,8 +29,9 @@ TEST(input_processor, input_is_propagated_to_outputs)
     std::vector<std::span<float>> outputs{out_buf};
     std::vector<audio_slice> results(1);
     auto converter =
-            pcm_input_buffer_converter([&out_buf](std::span<float> const buf) {
-                std::ranges::copy(out_buf, buf.begin());
+            pcm_input_buffer_converter([&data](std::span<float> const buf) {
+                std::ranges::copy(data, buf.begin());
+                return std::span<float const>{buf};
             });
     sut.set_input(converter);
     sut.process({{}, outputs, results, {}, {}, 4});
@@ -34,6 +39,31 @@ TEST(input_processor, input_is_propagated_to_outputs)
     ASSERT_TRUE(results[0].is_buffer());
     EXPECT_EQ(results[0].buffer().data(), out_buf.data());
     EXPECT_EQ(results[0].buffer().size(), out_buf.size());
+    EXPECT_TRUE(std::ranges::equal(data, out_buf));
+}
+
+TEST(input_processor, buffer_of_the_converter_is_propagated_without_copy)
+{
+    alignas(mipp::RequiredAlignment) std::array<float, 4> pcm_buf{
+            2.f,
+            3.f,
+            5.f,
+            7.f};
+    input_processor sut;
+
+    alignas(mipp::RequiredAlignment) std::array<float, 4> out_buf{};
+    std::vector<std::span<float>> outputs{out_buf};
+    std::vector<audio_slice> results(1);
+    auto converter = pcm_input_buffer_converter([&pcm_buf](std::span<float>) {
+        return std::span<float const>{pcm_buf};
+    });
+    sut.set_input(converter);
+    sut.process({{}, outputs, results, {}, {}, 4});
+
+    ASSERT_TRUE(results[0].is_buffer());
+    EXPECT_EQ(results[0].buffer().data(), pcm_buf.data());
+    EXPECT_EQ(results[0].buffer().size(), pcm_buf.size());
+    EXPECT_TRUE(std::ranges::all_of(out_buf, [](float x) { return x == 0.f; }));
 }
 
 } // namespace piejam::audio::engine::test
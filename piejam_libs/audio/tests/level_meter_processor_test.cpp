@@ -16,6 +16,7 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <iterator>
 #include <span>
 #include <vector>
 
@@ -78,4 +79,35 @@ TEST_F(level_meter_processor_test,
     EXPECT_LT(ev_out_bufs.get<float>(0).begin()->value(), .7f);
 }
 
+TEST_F(level_meter_processor_test,
+       constant_input_decays_peak_like_the_same_buffer_input)
+{
+    auto ref = make_level_meter_processor(sample_rate(48000));
+    event_output_buffers ref_ev_out_bufs;
+    ref_ev_out_bufs.set_event_memory(std::pmr::get_default_resource());
+    for (auto const& port : ref->event_outputs())
+    {
+        ref_ev_out_bufs.add(port);
+    }
+
+    in_buf.fill(.7f);
+    sut->process({in_bufs, {}, {}, {}, ev_out_bufs, in_buf.size()});
+    ref->process({in_bufs, {}, {}, {}, ref_ev_out_bufs, in_buf.size()});
+
+    in_buf.fill(.1f);
+    ref->process({in_bufs, {}, {}, {}, ref_ev_out_bufs, in_buf.size()});
+
+    in_buf_spans[0] = .1f;
+    sut->process({in_bufs, {}, {}, {}, ev_out_bufs, in_buf.size()});
+
+    ASSERT_EQ(2u, ev_out_bufs.get<float>(0).size());
+    ASSERT_EQ(2u, ref_ev_out_bufs.get<float>(0).size());
+    EXPECT_FLOAT_EQ(
+            std::next(ref_ev_out_bufs.get<float>(0).begin())->value(),
+            std::next(ev_out_bufs.get<float>(0).begin())->value());
+    EXPECT_FLOAT_EQ(
+            std::next(ref_ev_out_bufs.get<float>(1).begin())->value(),
+            std::next(ev_out_bufs.get<float>(1).begin())->value());
+}
+
 } // namespace piejam::audio::engine::test
@@ -0,0 +1,163 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/offline_device.h>
+#include <piejam/audio/offline_device_manager.h>
+
+#include <piejam/audio/pcm_descriptor.h>
+#include <piejam/audio/pcm_hw_params.h>
+#include <piejam/thread/configuration.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace piejam::audio::test
+{
+
+namespace
+{
+
+auto
+make_io_config(unsigned num_inputs, unsigned num_outputs) -> pcm_io_config
+{
+    return pcm_io_config{
+            .in_config = {.num_channels = num_inputs},
+            .out_config = {.num_channels = num_outputs},
+            .process_config = {
+                    .sample_rate = sample_rate(48000u),
+                    .period_size = period_size(4u),
+                    .period_count = period_count(2u)}};
+}
+
+} // namespace
+
+TEST(offline_device, is_open_until_closed)
+{
+    offline_device sut(make_io_config(0, 0), [](auto) {}, [](auto) {});
+    EXPECT_TRUE(sut.is_open());
+    EXPECT_FALSE(sut.is_running());
+    EXPECT_FALSE(sut.is_realtime());
+
+    sut.close();
+    EXPECT_FALSE(sut.is_open());
+}
+
+TEST(offline_device, render_passes_inputs_through_process_to_outputs)
+{
+    float next_input{};
+    std::vector<float> rendered;
+
+    offline_device sut(
+            make_io_config(1, 2),
+            [&](std::span<std::span<float> const> channels) {
+                ASSERT_EQ(1u, channels.size());
+                for (float& x : channels[0])
+                {
+                    x = next_input++;
+                }
+            },
+            [&](std::span<std::span<float const> const> channels) {
+                ASSERT_EQ(2u, channels.size());
+                ASSERT_EQ(channels[0].size(), channels[1].size());
+                rendered.insert(
+                        rendered.end(),
+                        channels[0].begin(),
+                        channels[0].end());
+                EXPECT_TRUE(std::ranges::all_of(channels[1], [](float x) {
+                    return x == 0.f;
+                }));
+            });
+
+    std::vector<float> buffer(4);
+    std::span<pcm_input_buffer_converter const> in_converter;
+    std::span<pcm_output_buffer_converter const> out_converter;
+
+    sut.start(
+            {},
+            [&](auto const& in, auto const& out) {
+                in_converter = in;
+                out_converter = out;
+            },
+            [&](std::size_t const buffer_size) {
+                if (buffer_size == 0)
+                {
+                    return;
+                }
+
+                ASSERT_EQ(4u, buffer_size);
+                in_converter[0](buffer);
+                // only the first output is connected
+                out_converter[0](std::span<float const>{buffer});
+            });
+    ASSERT_TRUE(sut.is_running());
+
+    sut.render(10);
+
+    EXPECT_EQ(10u, sut.rendered_frames());
+    EXPECT_EQ(
+            (std::vector<float>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}),
+            rendered);
+
+    sut.stop();
+    EXPECT_FALSE(sut.is_running());
+}
+
+TEST(offline_device, nothing_is_processed_between_renders)
+{
+    offline_device sut(make_io_config(0, 0), [](auto) {}, [](auto) {});
+
+    std::vector<std::size_t> buffer_sizes;
+    sut.start(
+            {},
+            [](auto const&, auto const&) {},
+            [&](std::size_t const buffer_size) {
+                buffer_sizes.push_back(buffer_size);
+            });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    sut.render(8);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    sut.stop();
+
+    EXPECT_EQ(2, std::ranges::count(buffer_sizes, 4u));
+    EXPECT_TRUE(std::ranges::all_of(buffer_sizes, [](std::size_t x) {
+        return x == 0 || x == 4;
+    }));
+    EXPECT_LT(2u, buffer_sizes.size());
+}
+
+TEST(offline_device_manager, offers_one_input_and_one_output)
+{
+    offline_device_manager sut(
+            3,
+            5,
+            sample_rate(44100u),
+            period_size(64u),
+            [](auto) {},
+            [](auto) {});
+
+    auto const descriptors = sut.io_descriptors();
+    ASSERT_EQ(1u, descriptors.inputs.size());
+    ASSERT_EQ(1u, descriptors.outputs.size());
+
+    auto const in = sut.hw_params(descriptors.inputs[0], nullptr, nullptr);
+    auto const out = sut.hw_params(descriptors.outputs[0], nullptr, nullptr);
+    EXPECT_EQ(3u, in.num_channels);
+    EXPECT_EQ(5u, out.num_channels);
+    EXPECT_EQ(sample_rates_t{sample_rate(44100u)}, in.sample_rates);
+    EXPECT_EQ(period_sizes_t{period_size(64u)}, out.period_sizes);
+
+    auto device = sut.make_device(
+            descriptors.inputs[0],
+            descriptors.outputs[0],
+            make_io_config(3, 5));
+    EXPECT_EQ(device.get(), sut.last_device());
+}
+
+} // namespace piejam::audio::test
@@ -0,0 +1,193 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "processor_mock.h"
+
+#include <piejam/audio/engine/graph.h>
+#include <piejam/audio/engine/output_buffer_pool.h>
+
+#include <gtest/gtest.h>
+
+namespace piejam::audio::engine::test
+{
+
+using namespace testing;
+
+struct output_buffer_pool_test : Test
+{
+    void make_proc(
+            processor_mock& proc,
+            std::size_t num_inputs,
+            std::size_t num_outputs,
+            bool may_alias = true)
+    {
+        ON_CALL(proc, num_inputs()).WillByDefault(Return(num_inputs));
+        ON_CALL(proc, num_outputs()).WillByDefault(Return(num_outputs));
+        ON_CALL(proc, results_may_alias_inputs())
+                .WillByDefault(Return(may_alias));
+    }
+
+    NiceMock<processor_mock> a;
+    NiceMock<processor_mock> b;
+    NiceMock<processor_mock> c;
+    NiceMock<processor_mock> d;
+
+    graph g;
+};
+
+TEST_F(output_buffer_pool_test, outputs_of_one_processor_get_own_slots)
+{
+    make_proc(a, 0, 2);
+    make_proc(b, 2, 0);
+    g.audio.insert({a, 0}, {b, 0});
+    g.audio.insert({a, 1}, {b, 1});
+
+    output_buffer_pool sut(g);
+
+    EXPECT_EQ(2u, sut.num_slots());
+    EXPECT_NE(sut.slot({a, 0}), sut.slot({a, 1}));
+}
+
+TEST_F(output_buffer_pool_test, aliasing_consumers_extend_the_lifetime)
+{
+    make_proc(a, 0, 1);
+    make_proc(b, 1, 1);
+    make_proc(c, 1, 1);
+    make_proc(d, 1, 0);
+    g.audio.insert({a, 0}, {b, 0});
+    g.audio.insert({b, 0}, {c, 0});
+    g.audio.insert({c, 0}, {d, 0});
+
+    output_buffer_pool sut(g);
+
+    EXPECT_EQ(3u, sut.num_slots());
+    EXPECT_NE(sut.slot({a, 0}), sut.slot({c, 0}));
+}
+
+TEST_F(output_buffer_pool_test, slot_is_reused_after_last_reader)
+{
+    make_proc(a, 0, 1);
+    make_proc(b, 1, 1, false);
+    make_proc(c, 1, 1);
+    make_proc(d, 1, 0);
+    g.audio.insert({a, 0}, {b, 0});
+    g.audio.insert({b, 0}, {c, 0});
+    g.audio.insert({c, 0}, {d, 0});
+
+    output_buffer_pool sut(g);
+
+    EXPECT_EQ(2u, sut.num_slots());
+    EXPECT_EQ(sut.slot({a, 0}), sut.slot({c, 0}));
+    EXPECT_NE(sut.slot({a, 0}), sut.slot({b, 0}));
+}
+
+TEST_F(output_buffer_pool_test, parallel_branches_dont_share_slots)
+{
+    make_proc(a, 0, 1);
+    make_proc(b, 1, 1, false);
+    make_proc(c, 1, 1, false);
+    g.audio.insert({a, 0}, {b, 0});
+    g.audio.insert({a, 0}, {c, 0});
+
+    output_buffer_pool sut(g);
+
+    EXPECT_EQ(3u, sut.num_slots());
+}
+
+TEST_F(output_buffer_pool_test, event_wires_order_processors)
+{
+    std::array event_ports{event_port(std::in_place_type<float>, {})};
+
+    make_proc(a, 0, 1);
+    make_proc(b, 1, 0);
+    make_proc(c, 0, 1);
+    ON_CALL(b, event_outputs()).WillByDefault(Return(event_ports));
+    ON_CALL(c, event_inputs()).WillByDefault(Return(event_ports));
+    g.audio.insert({a, 0}, {b, 0});
+    g.event.insert({b, 0}, {c, 0});
+
+    output_buffer_pool sut(g);
+
+    EXPECT_EQ(1u, sut.num_slots());
+    EXPECT_EQ(sut.slot({a, 0}), sut.slot({c, 0}));
+}
+
+TEST_F(output_buffer_pool_test, in_place_output_uses_slot_of_input)
+{
+    make_proc(a, 0, 1);
+    make_proc(b, 1, 1);
+    make_proc(c, 1, 0);
+    ON_CALL(b, in_place_input(0)).WillByDefault(Return(0u));
+    g.audio.insert({a, 0}, {b, 0});
+    g.audio.insert({b, 0}, {c, 0});
+
+    output_buffer_pool sut(g);
+
+    EXPECT_EQ(1u, sut.num_slots());
+    EXPECT_EQ(sut.slot({a, 0}), sut.slot({b, 0}));
+}
+
+TEST_F(output_buffer_pool_test, no_in_place_if_input_has_other_consumers)
+{
+    make_proc(a, 0, 1);
+    make_proc(b, 1, 1);
+    make_proc(c, 1, 0);
+    make_proc(d, 1, 0);
+    ON_CALL(b, in_place_input(0)).WillByDefault(Return(0u));
+    g.audio.insert({a, 0}, {b, 0});
+    g.audio.insert({a, 0}, {d, 0});
+    g.audio.insert({b, 0}, {c, 0});
+
+    output_buffer_pool sut(g);
+
+    EXPECT_EQ(2u, sut.num_slots());
+    EXPECT_NE(sut.slot({a, 0}), sut.slot({b, 0}));
+}
+
+
+TEST_F(output_buffer_pool_test, outputs_keep_the_slots_of_the_previous_pool)
+{
+    make_proc(a, 0, 1);
+    make_proc(b, 1, 1, false);
+    make_proc(c, 1, 0);
+    make_proc(d, 1, 0);
+    g.audio.insert({a, 0}, {b, 0});
+    g.audio.insert({b, 0}, {c, 0});
+
+    output_buffer_pool previous(g);
+
+    g.audio.insert({a, 0}, {d, 0});
+
+    output_buffer_pool sut(g, previous);
+
+    EXPECT_TRUE(sut.kept({a, 0}));
+    EXPECT_TRUE(sut.kept({b, 0}));
+    EXPECT_EQ(previous.buffer({a, 0}).data(), sut.buffer({a, 0}).data());
+    EXPECT_EQ(previous.buffer({b, 0}).data(), sut.buffer({b, 0}).data());
+}
+
+TEST_F(output_buffer_pool_test, slot_isnt_kept_if_the_lifetimes_overlap)
+{
+    make_proc(a, 0, 1);
+    make_proc(b, 1, 1, false);
+    make_proc(c, 1, 1, false);
+    make_proc(d, 2, 0);
+    g.audio.insert({a, 0}, {b, 0});
+    g.audio.insert({b, 0}, {c, 0});
+    g.audio.insert({c, 0}, {d, 0});
+
+    output_buffer_pool previous(g);
+    ASSERT_EQ(previous.slot({a, 0}), previous.slot({c, 0}));
+
+    // the output of a is read after c now
+    g.audio.insert({a, 0}, {d, 1});
+
+    output_buffer_pool sut(g, previous);
+
+    EXPECT_TRUE(sut.kept({a, 0}));
+    EXPECT_FALSE(sut.kept({c, 0}));
+    EXPECT_NE(sut.slot({a, 0}), sut.slot({c, 0}));
+}
+
+} // namespace piejam::audio::engine::test
@@ -46,4 +46,37 @@ TEST(output_processor, input_is_propagated_to_outputs)
     EXPECT_FLOAT_EQ(0.91f, data[3]);
 }
 
+TEST(output_processor, gain_is_ramped_over_the_period)
+{
+    mipp::vector<float> data({0.f, 0.f, 0.f, 0.f});
+    output_processor sut;
+    auto converter = pcm_output_buffer_converter(
+            [&data](pcm_output_source_buffer_t const& buf) {
+                std::ranges::copy(
+                        std::get<std::span<float const>>(buf),
+                        data.begin());
+            });
+    sut.set_output(converter);
+
+    gain_ramp const gain{.from = 0.f, .to = 1.f};
+    sut.set_gain(gain);
+
+    alignas(mipp::RequiredAlignment) std::array<float, 4> in_buf{
+            1.f,
+            1.f,
+            1.f,
+            1.f};
+    std::vector<audio_slice> in_spans{in_buf};
+    std::vector<std::reference_wrapper<audio_slice const>> inputs{
+            in_spans.begin(),
+            in_spans.end()};
+
+    sut.process({inputs, {}, {}, {}, {}, 4});
+
+    EXPECT_FLOAT_EQ(0.f, data[0]);
+    EXPECT_FLOAT_EQ(.25f, data[1]);
+    EXPECT_FLOAT_EQ(.5f, data[2]);
+    EXPECT_FLOAT_EQ(.75f, data[3]);
+}
+
 } // namespace piejam::audio::engine::test
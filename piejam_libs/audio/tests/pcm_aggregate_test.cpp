@@ -0,0 +1,295 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/alsa/pcm_aggregate.h>
+
+#include <piejam/audio/alsa/pcm_reader.h>
+#include <piejam/audio/alsa/pcm_writer.h>
+#include <piejam/audio/clock_bridge.h>
+#include <piejam/system/device.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace piejam::audio::alsa::test
+{
+
+namespace
+{
+
+constexpr std::size_t frames_per_period = 64;
+constexpr sample_rate rate{48000};
+constexpr std::chrono::nanoseconds period_duration{
+        frames_per_period * 1'000'000'000 / 48000};
+constexpr pcm_process_config process_config{
+        .sample_rate = rate,
+        .period_size = period_size(frames_per_period),
+        .period_count = period_count(2)};
+
+//! Main device, whose channels carry constant values. Its hw timestamp
+//! is set by the test.
+class fake_reader final : public pcm_reader
+{
+public:
+    fake_reader(
+            std::vector<float> const& values,
+            std::chrono::nanoseconds const& time)
+        : m_time(time)
+    {
+        for (float const value : values)
+        {
+            m_converter.emplace_back([value](std::span<float> const out) {
+                std::ranges::fill(out, value);
+                return std::span<float const>{out};
+            });
+        }
+    }
+
+    auto converter() const noexcept -> std::span<converter_f const> override
+    {
+        return m_converter;
+    }
+
+    auto transfer() noexcept -> std::error_code override
+    {
+        return {};
+    }
+
+    auto release() noexcept -> std::error_code override
+    {
+        return {};
+    }
+
+    auto hw_position() noexcept -> std::optional<pcm_hw_position> override
+    {
+        return pcm_hw_position{.time = m_time, .late_frames = 0};
+    }
+
+    void clear() noexcept override
+    {
+    }
+
+private:
+    std::chrono::nanoseconds const& m_time;
+    std::vector<converter_f> m_converter;
+};
+
+//! Main device, which drops its channels. Its hw timestamp is set by the
+//! test.
+class fake_writer final : public pcm_writer
+{
+public:
+    fake_writer(
+            std::size_t const num_channels,
+            std::chrono::nanoseconds const& time)
+        : m_time(time)
+        , m_converter(num_channels, [](pcm_output_source_buffer_t const&) {})
+    {
+    }
+
+    auto converter() const noexcept -> std::span<converter_f const> override
+    {
+        return m_converter;
+    }
+
+    auto acquire() noexcept -> std::error_code override
+    {
+        return {};
+    }
+
+    auto transfer() noexcept -> std::error_code override
+    {
+        return {};
+    }
+
+    auto hw_position() noexcept -> std::optional<pcm_hw_position> override
+    {
+        return pcm_hw_position{.time = m_time, .late_frames = 0};
+    }
+
+    void clear() noexcept override
+    {
+    }
+
+private:
+    std::chrono::nanoseconds const& m_time;
+    std::vector<converter_f> m_converter;
+};
+
+auto
+read_period(pcm_reader& reader) -> std::vector<std::vector<float>>
+{
+    std::vector<std::vector<float>> result;
+
+    std::vector<float> buffer(frames_per_period);
+
+    for (auto const& convert : reader.converter())
+    {
+        auto const samples = convert(buffer);
+        result.emplace_back(samples.begin(), samples.end());
+    }
+
+    return result;
+}
+
+} // namespace
+
+TEST(pcm_aggregate, reader_without_bridges_is_the_main_reader)
+{
+    system::device clock_fd;
+    std::chrono::nanoseconds time{};
+    auto main = std::make_unique<fake_reader>(std::vector{1.f}, time);
+    pcm_reader* const main_ptr = main.get();
+
+    auto sut = make_aggregate_reader(
+            clock_fd,
+            std::move(main),
+            std::vector<clock_bridge*>{},
+            process_config);
+
+    EXPECT_EQ(main_ptr, sut.get());
+}
+
+TEST(pcm_aggregate, reader_appends_secondary_channels_from_the_bridge)
+{
+    system::device clock_fd;
+    std::chrono::nanoseconds time{};
+
+    // the secondary capture device, pushing periods at its own clock
+    clock_bridge secondary(1, rate, frames_per_period, frames_per_period);
+    std::vector<float> const secondary_period(frames_per_period, .5f);
+
+    auto sut = make_aggregate_reader(
+            clock_fd,
+            std::make_unique<fake_reader>(std::vector{1.f, 2.f}, time),
+            std::vector{&secondary},
+            process_config);
+
+    ASSERT_EQ(3u, sut->converter().size());
+
+    secondary.push(secondary_period, time);
+    time += period_duration / 2;
+    ASSERT_FALSE(sut->transfer());
+
+    auto period = read_period(*sut);
+    EXPECT_TRUE(std::ranges::all_of(period[0], [](float x) {
+        return x == 1.f;
+    }));
+    EXPECT_TRUE(std::ranges::all_of(period[1], [](float x) {
+        return x == 2.f;
+    }));
+    EXPECT_TRUE(std::ranges::all_of(period[2], [](float x) {
+        return x == 0.f;
+    }));
+
+    for (std::size_t n = 0; n < 100; ++n)
+    {
+        secondary.push(secondary_period, time);
+        time += period_duration;
+        ASSERT_FALSE(sut->transfer());
+        period = read_period(*sut);
+    }
+
+    EXPECT_TRUE(std::ranges::all_of(period[0], [](float x) {
+        return x == 1.f;
+    }));
+    EXPECT_TRUE(std::ranges::all_of(period[1], [](float x) {
+        return x == 2.f;
+    }));
+    for (float const x : period[2])
+    {
+        EXPECT_NEAR(.5f, x, 1e-6f);
+    }
+    EXPECT_EQ(0u, secondary.resyncs());
+}
+
+TEST(pcm_aggregate, writer_without_bridges_is_the_main_writer)
+{
+    system::device clock_fd;
+    std::chrono::nanoseconds time{};
+    auto main = std::make_unique<fake_writer>(1, time);
+    pcm_writer* const main_ptr = main.get();
+
+    auto sut = make_aggregate_writer(
+            clock_fd,
+            std::move(main),
+            std::vector<clock_bridge*>{},
+            process_config);
+
+    EXPECT_EQ(main_ptr, sut.get());
+}
+
+TEST(pcm_aggregate, writer_passes_secondary_channels_to_the_bridge)
+{
+    system::device clock_fd;
+    std::chrono::nanoseconds time{};
+
+    // the secondary playback device, pulling periods at its own clock
+    clock_bridge secondary(2, rate, frames_per_period, frames_per_period);
+    std::vector<float> secondary_period(2 * frames_per_period);
+
+    auto sut = make_aggregate_writer(
+            clock_fd,
+            std::make_unique<fake_writer>(1, time),
+            std::vector{&secondary},
+            process_config);
+
+    ASSERT_EQ(3u, sut->converter().size());
+
+    std::vector<float> const buffer(frames_per_period, .25f);
+
+    for (std::size_t n = 0; n < 100; ++n)
+    {
+        ASSERT_FALSE(sut->acquire());
+        sut->converter()[1](-1.f);
+        sut->converter()[2](std::span<float const>{buffer});
+        ASSERT_FALSE(sut->transfer());
+
+        secondary.pull(secondary_period, time + period_duration / 2);
+        time += period_duration;
+    }
+
+    for (std::size_t frame = 0; frame < frames_per_period; ++frame)
+    {
+        EXPECT_NEAR(-1.f, secondary_period[2 * frame], 1e-6f);
+        EXPECT_NEAR(.25f, secondary_period[2 * frame + 1], 1e-6f);
+    }
+    EXPECT_EQ(0u, secondary.resyncs());
+}
+
+TEST(pcm_aggregate, writer_doesnt_pass_cleared_periods_to_the_bridge)
+{
+    system::device clock_fd;
+    std::chrono::nanoseconds time{};
+
+    clock_bridge secondary(1, rate, frames_per_period, frames_per_period);
+
+    auto sut = make_aggregate_writer(
+            clock_fd,
+            std::make_unique<fake_writer>(1, time),
+            std::vector{&secondary},
+            process_config);
+
+    // enough periods for the bridge to reach its target fill, if they were
+    // passed on
+    for (std::size_t n = 0; n < 4; ++n)
+    {
+        ASSERT_FALSE(sut->acquire());
+        sut->clear();
+        sut->converter()[1](1.f);
+        ASSERT_FALSE(sut->transfer());
+    }
+
+    std::vector<float> secondary_period(frames_per_period, 2.f);
+    secondary.pull(secondary_period, time);
+
+    EXPECT_TRUE(std::ranges::all_of(secondary_period, [](float x) {
+        return x == 0.f;
+    }));
+}
+
+} // namespace piejam::audio::alsa::test
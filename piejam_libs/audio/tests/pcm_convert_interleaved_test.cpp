@@ -0,0 +1,117 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/pcm_convert_interleaved.h>
+
+#include <gtest/gtest.h>
+
+#include <span>
+#include <vector>
+
+namespace piejam::audio::pcm_convert::test
+{
+
+template <class T>
+struct pcm_convert_interleaved_test : ::testing::Test
+{
+    using type = T;
+
+    // odd sizes, to exercise chunk boundaries and the scalar remainder
+    static constexpr std::size_t num_channels = 3;
+    static constexpr std::size_t num_frames = 211;
+};
+
+using pcm_convert_interleaved_types = ::testing::Types<
+        pcm_sample_descriptor_t<pcm_format::s8>,
+        pcm_sample_descriptor_t<pcm_format::u8>,
+        pcm_sample_descriptor_t<pcm_format::s16_le>,
+        pcm_sample_descriptor_t<pcm_format::s16_be>,
+        pcm_sample_descriptor_t<pcm_format::u16_le>,
+        pcm_sample_descriptor_t<pcm_format::u16_be>,
+        pcm_sample_descriptor_t<pcm_format::s32_le>,
+        pcm_sample_descriptor_t<pcm_format::s32_be>,
+        pcm_sample_descriptor_t<pcm_format::u32_le>,
+        pcm_sample_descriptor_t<pcm_format::u32_be>,
+        pcm_sample_descriptor_t<pcm_format::s24_3le>,
+        pcm_sample_descriptor_t<pcm_format::s24_3be>,
+        pcm_sample_descriptor_t<pcm_format::u24_3le>,
+        pcm_sample_descriptor_t<pcm_format::u24_3be>>;
+
+TYPED_TEST_CASE(pcm_convert_interleaved_test, pcm_convert_interleaved_types);
+
+TYPED_TEST(pcm_convert_interleaved_test, from_interleaved_equals_scalar)
+{
+    using desc_t = typename TestFixture::type;
+    constexpr auto F = desc_t::format;
+    constexpr auto num_channels = TestFixture::num_channels;
+    constexpr auto num_frames = TestFixture::num_frames;
+
+    std::vector<pcm_sample_t<F>> interleaved(num_channels * num_frames);
+    for (std::size_t i = 0; i < interleaved.size(); ++i)
+    {
+        float const x = -1.f + 2.f * static_cast<float>(i) /
+                                       static_cast<float>(interleaved.size());
+        interleaved[i] = to<F>(x);
+    }
+    interleaved[0] = endian_to_format<F>(desc_t::min);
+    interleaved[1] = endian_to_format<F>(desc_t::max);
+
+    std::vector<std::vector<float>> buffers(
+            num_channels,
+            std::vector<float>(num_frames));
+    std::vector<std::span<float>> channels(buffers.begin(), buffers.end());
+
+    from_interleaved<F>(interleaved, channels);
+
+    for (std::size_t frame = 0; frame < num_frames; ++frame)
+    {
+        for (std::size_t channel = 0; channel < num_channels; ++channel)
+        {
+            EXPECT_EQ(
+                    from<F>(interleaved[frame * num_channels + channel]),
+                    buffers[channel][frame]);
+        }
+    }
+}
+
+TYPED_TEST(pcm_convert_interleaved_test, to_interleaved_equals_scalar)
+{
+    using desc_t = typename TestFixture::type;
+    constexpr auto F = desc_t::format;
+    constexpr auto num_channels = TestFixture::num_channels;
+    constexpr auto num_frames = TestFixture::num_frames;
+
+    std::vector<std::vector<float>> buffers(
+            num_channels - 1,
+            std::vector<float>(num_frames));
+    for (std::size_t channel = 0; channel < buffers.size(); ++channel)
+    {
+        for (std::size_t frame = 0; frame < num_frames; ++frame)
+        {
+            // exceeds the full scale, to check the clamping
+            buffers[channel][frame] = -1.5f + 3.f * static_cast<float>(frame) /
+                                                      num_frames +
+                                      0.1f * static_cast<float>(channel);
+        }
+    }
+
+    std::vector<pcm_output_source_buffer_t> sources{
+            std::span<float const>(buffers[0]),
+            0.25f,
+            std::span<float const>(buffers[1])};
+
+    std::vector<pcm_sample_t<F>> interleaved(num_channels * num_frames);
+    to_interleaved<F>(sources, interleaved);
+
+    for (std::size_t frame = 0; frame < num_frames; ++frame)
+    {
+        EXPECT_EQ(to<F>(buffers[0][frame]), interleaved[frame * num_channels]);
+        EXPECT_EQ(to<F>(0.25f), interleaved[frame * num_channels + 1]);
+        EXPECT_EQ(
+                to<F>(buffers[1][frame]),
+                interleaved[frame * num_channels + 2]);
+    }
+}
+
+} // namespace piejam::audio::pcm_convert::test
@@ -0,0 +1,71 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/alsa/pcm_hw_position.h>
+
+#include <gtest/gtest.h>
+
+namespace piejam::audio::alsa::test
+{
+
+namespace
+{
+
+constexpr sample_rate rate{48000};
+
+auto
+fake_status(long const sec, long const nsec, std::size_t const avail)
+        -> snd_pcm_status
+{
+    snd_pcm_status status{};
+    status.tstamp.tv_sec = sec;
+    status.tstamp.tv_nsec = nsec;
+    status.avail = avail;
+    return status;
+}
+
+} // namespace
+
+TEST(pcm_hw_position, frames_beyond_the_pending_ones_are_late)
+{
+    auto const sut = make_pcm_hw_position(fake_status(2, 500, 96), 64);
+
+    EXPECT_EQ(std::chrono::nanoseconds{2'000'000'500}, sut.time);
+    EXPECT_EQ(32u, sut.late_frames);
+}
+
+TEST(pcm_hw_position, not_late_if_less_than_pending_are_available)
+{
+    auto const sut = make_pcm_hw_position(fake_status(1, 0, 32), 64);
+
+    EXPECT_EQ(0u, sut.late_frames);
+}
+
+TEST(pcm_hw_position, period_time_is_the_timestamp_if_not_late)
+{
+    auto const sut = make_pcm_hw_position(fake_status(1, 0, 64), 64);
+
+    EXPECT_EQ(std::chrono::seconds{1}, period_time(sut, rate));
+}
+
+TEST(pcm_hw_position, period_time_is_before_the_timestamp_by_the_late_frames)
+{
+    // a period of 48 frames is 1ms at 48kHz
+    auto const sut = make_pcm_hw_position(fake_status(1, 0, 64 + 48), 64);
+
+    EXPECT_EQ(
+            std::chrono::seconds{1} - std::chrono::milliseconds{1},
+            period_time(sut, rate));
+}
+
+TEST(pcm_hw_position, all_available_frames_are_late_after_a_read)
+{
+    auto const sut = make_pcm_hw_position(fake_status(1, 0, 480), 0);
+
+    EXPECT_EQ(
+            std::chrono::seconds{1} - std::chrono::milliseconds{10},
+            period_time(sut, rate));
+}
+
+} // namespace piejam::audio::alsa::test
@@ -0,0 +1,109 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/period_history.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <vector>
+
+namespace piejam::audio::test
+{
+
+namespace
+{
+
+void
+record_periods(period_history& sut, std::size_t const num_periods)
+{
+    for (std::size_t i = 0; i < num_periods; ++i)
+    {
+        sut.record({});
+    }
+}
+
+auto
+periods(std::vector<period_record> const& records) -> std::vector<std::size_t>
+{
+    std::vector<std::size_t> result;
+    std::ranges::transform(
+            records,
+            std::back_inserter(result),
+            &period_record::period);
+    return result;
+}
+
+} // namespace
+
+TEST(period_history, nothing_is_captured_without_xrun)
+{
+    period_history sut(2, 1);
+
+    record_periods(sut, 10);
+
+    EXPECT_TRUE(sut.take_capture().empty());
+}
+
+TEST(period_history, periods_around_xrun_are_captured)
+{
+    period_history sut(2, 1);
+
+    record_periods(sut, 5);
+    sut.record({.xrun = true});
+
+    // not before the periods after the xrun are recorded
+    EXPECT_TRUE(sut.take_capture().empty());
+
+    record_periods(sut, 3);
+
+    auto const capture = sut.take_capture();
+    EXPECT_EQ((std::vector<std::size_t>{3, 4, 5, 6}), periods(capture));
+    EXPECT_TRUE(capture[2].xrun);
+
+    EXPECT_TRUE(sut.take_capture().empty());
+}
+
+TEST(period_history, capture_is_limited_to_recorded_periods)
+{
+    period_history sut(4, 0);
+
+    sut.record({});
+    sut.record({.xrun = true});
+
+    EXPECT_EQ((std::vector<std::size_t>{0, 1}), periods(sut.take_capture()));
+}
+
+TEST(period_history, worker_idle_is_attached_to_next_record)
+{
+    period_history sut(1, 0);
+
+    sut.add_worker_idle(std::chrono::microseconds{3});
+    sut.add_worker_idle(std::chrono::microseconds{4});
+    sut.record({});
+    sut.record({.xrun = true});
+
+    auto const capture = sut.take_capture();
+    ASSERT_EQ(2u, capture.size());
+    EXPECT_EQ(std::chrono::microseconds{7}, capture[0].worker_idle);
+    EXPECT_EQ(period_record::duration::zero(), capture[1].worker_idle);
+}
+
+TEST(period_history, xrun_is_missed_while_capture_is_not_taken)
+{
+    period_history sut(1, 0);
+
+    sut.record({.xrun = true});
+    sut.record({.xrun = true});
+
+    EXPECT_EQ(1u, sut.missed_captures());
+    EXPECT_EQ((std::vector<std::size_t>{0}), periods(sut.take_capture()));
+
+    sut.record({.xrun = true});
+    EXPECT_EQ((std::vector<std::size_t>{1, 2}), periods(sut.take_capture()));
+}
+
+} // namespace piejam::audio::test
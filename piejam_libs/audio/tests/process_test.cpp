@@ -10,8 +10,10 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
 #include <atomic>
 #include <thread>
+#include <vector>
 
 namespace piejam::audio::engine::test
 {
@@ -26,6 +28,52 @@ struct test_dummy_dag_executor : public dag_executor
     }
 };
 
+struct gain_recording_dag_executor : public dag_executor
+{
+    gain_recording_dag_executor(
+            process const& proc,
+            std::vector<gain_ramp>& gains,
+            std::atomic_size_t& runs)
+        : proc(proc)
+        , gains(gains)
+        , runs(runs)
+    {
+    }
+
+    void operator()(std::size_t) override
+    {
+        gains.push_back(proc.output_gain());
+        runs.fetch_add(1, std::memory_order_release);
+    }
+
+    process const& proc;
+    std::vector<gain_ramp>& gains;
+    std::atomic_size_t& runs;
+};
+
+struct output_gains_recording_dag_executor : public dag_executor
+{
+    output_gains_recording_dag_executor(
+            process const& proc,
+            std::vector<std::array<gain_ramp, 2>>& gains,
+            std::atomic_size_t& runs)
+        : proc(proc)
+        , gains(gains)
+        , runs(runs)
+    {
+    }
+
+    void operator()(std::size_t) override
+    {
+        gains.push_back({proc.output_gain(0), proc.output_gain(1)});
+        runs.fetch_add(1, std::memory_order_release);
+    }
+
+    process const& proc;
+    std::vector<std::array<gain_ramp, 2>>& gains;
+    std::atomic_size_t& runs;
+};
+
 } // namespace
 
 TEST(process_test, swap_executor)
@@ -56,4 +104,130 @@ TEST(process_test, swap_executor_fails_if_processing_thread_is_not_running)
             sut.swap_executor(std::make_unique<test_dummy_dag_executor>()));
 }
 
+TEST(process_test, swap_executor_with_fade)
+{
+    std::atomic_bool running{true};
+    process sut;
+    std::thread process_thread([&running, &sut] {
+        while (running.load(std::memory_order_relaxed))
+        {
+            sut(2);
+        }
+    });
+
+    std::vector<gain_ramp> prev_gains;
+    std::atomic_size_t prev_runs{};
+    ASSERT_TRUE(sut.swap_executor(std::make_unique<gain_recording_dag_executor>(
+            sut,
+            prev_gains,
+            prev_runs)));
+
+    std::vector<gain_ramp> next_gains;
+    std::atomic_size_t next_runs{};
+    ASSERT_TRUE(sut.swap_executor(
+            std::make_unique<gain_recording_dag_executor>(
+                    sut,
+                    next_gains,
+                    next_runs),
+            2));
+
+    while (next_runs.load(std::memory_order_acquire) < 3)
+    {
+        std::this_thread::yield();
+    }
+
+    running = false;
+    process_thread.join();
+
+    ASSERT_LE(2u, prev_gains.size());
+    EXPECT_EQ(
+            (gain_ramp{.from = 1.f, .to = .5f}),
+            prev_gains[prev_gains.size() - 2]);
+    EXPECT_EQ((gain_ramp{.from = .5f, .to = 0.f}), prev_gains.back());
+
+    ASSERT_LE(3u, next_gains.size());
+    EXPECT_EQ((gain_ramp{.from = 0.f, .to = .5f}), next_gains[0]);
+    EXPECT_EQ((gain_ramp{.from = .5f, .to = 1.f}), next_gains[1]);
+    EXPECT_TRUE(next_gains[2].is_unity());
+}
+
+TEST(process_test, swap_executor_fades_only_the_faded_outputs)
+{
+    std::atomic_bool running{true};
+    process sut(2);
+    std::thread process_thread([&running, &sut] {
+        while (running.load(std::memory_order_relaxed))
+        {
+            sut(2);
+        }
+    });
+
+    std::vector<std::array<gain_ramp, 2>> prev_gains;
+    std::atomic_size_t prev_runs{};
+    ASSERT_TRUE(
+            sut.swap_executor(
+                    std::make_unique<output_gains_recording_dag_executor>(
+                            sut,
+                            prev_gains,
+                            prev_runs)));
+
+    std::vector<std::array<gain_ramp, 2>> next_gains;
+    std::atomic_size_t next_runs{};
+    std::array const faded_outputs{std::size_t{1}};
+    ASSERT_TRUE(sut.swap_executor(
+            std::make_unique<output_gains_recording_dag_executor>(
+                    sut,
+                    next_gains,
+                    next_runs),
+            2,
+            faded_outputs));
+
+    while (next_runs.load(std::memory_order_acquire) < 3)
+    {
+        std::this_thread::yield();
+    }
+
+    running = false;
+    process_thread.join();
+
+    ASSERT_LE(2u, prev_gains.size());
+    EXPECT_TRUE(prev_gains.back()[0].is_unity());
+    EXPECT_EQ((gain_ramp{.from = .5f, .to = 0.f}), prev_gains.back()[1]);
+
+    ASSERT_LE(3u, next_gains.size());
+    EXPECT_TRUE(next_gains[0][0].is_unity());
+    EXPECT_EQ((gain_ramp{.from = 0.f, .to = .5f}), next_gains[0][1]);
+    EXPECT_TRUE(next_gains[2][0].is_unity());
+    EXPECT_TRUE(next_gains[2][1].is_unity());
+}
+
+TEST(process_test, zero_buffer_size_swaps_without_fade_and_processing)
+{
+    process sut;
+    std::atomic_bool swapped{};
+    std::thread process_thread([&swapped, &sut] {
+        while (!swapped.load(std::memory_order_relaxed))
+        {
+            sut(0);
+        }
+    });
+
+    std::vector<gain_ramp> gains;
+    std::atomic_size_t runs{};
+    EXPECT_TRUE(sut.swap_executor(
+            std::make_unique<gain_recording_dag_executor>(sut, gains, runs),
+            4));
+
+    swapped = true;
+    process_thread.join();
+
+    EXPECT_EQ(0u, runs);
+    EXPECT_TRUE(sut.output_gain().is_unity());
+
+    sut(2);
+
+    ASSERT_EQ(1u, gains.size());
+    EXPECT_TRUE(gains[0].is_unity());
+}
+
 } // namespace piejam::audio::engine::test
@@ -26,6 +26,26 @@ struct processor_mock : public processor
     MOCK_METHOD(event_ports, event_inputs, (), (const, noexcept, override));
     MOCK_METHOD(event_ports, event_outputs, (), (const, noexcept, override));
 
+    MOCK_METHOD(
+            bool,
+            results_may_alias_inputs,
+            (),
+            (const, noexcept, override));
+
+    MOCK_METHOD(
+            std::optional<std::size_t>,
+            in_place_input,
+            (std::size_t),
+            (const, noexcept, override));
+
+    MOCK_METHOD(
+            std::optional<std::size_t>,
+            tail_length,
+            (),
+            (const, noexcept, override));
+
+    MOCK_METHOD(bool, block_splittable, (), (const, noexcept, override));
+
     MOCK_METHOD(void, process, (process_context const&), (override));
 };
 
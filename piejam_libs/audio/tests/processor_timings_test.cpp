@@ -0,0 +1,117 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "processor_mock.h"
+
+#include <piejam/audio/engine/graph.h>
+#include <piejam/audio/engine/processor_timings.h>
+
+#include <gtest/gtest.h>
+
+namespace piejam::audio::engine::test
+{
+
+using namespace std::chrono_literals;
+
+TEST(processor_timings, estimate_of_unknown_processor_is_zero)
+{
+    processor_mock proc;
+    processor_timings sut;
+
+    EXPECT_EQ(0ns, sut.estimate(proc));
+}
+
+TEST(processor_timings, first_update_is_taken_as_estimate)
+{
+    processor_mock proc;
+    processor_timings sut;
+
+    sut[proc].update(800ns);
+
+    EXPECT_EQ(800ns, sut.estimate(proc));
+}
+
+TEST(processor_timings, further_updates_are_averaged)
+{
+    processor_mock proc;
+    processor_timings sut;
+
+    sut[proc].update(800ns);
+    sut[proc].update(1600ns);
+
+    EXPECT_EQ(900ns, sut.estimate(proc));
+}
+
+TEST(processor_timings, retain_removes_processors_not_in_graph)
+{
+    ::testing::NiceMock<processor_mock> proc1;
+    ::testing::NiceMock<processor_mock> proc2;
+    ::testing::NiceMock<processor_mock> proc3;
+    processor_timings sut;
+
+    sut[proc1].update(100ns);
+    sut[proc2].update(200ns);
+    sut[proc3].update(300ns);
+
+    using namespace testing;
+
+    ON_CALL(proc1, num_outputs()).WillByDefault(Return(1));
+    ON_CALL(proc2, num_inputs()).WillByDefault(Return(1));
+
+    graph g;
+    g.audio.insert({proc1, 0}, {proc2, 0});
+
+    sut.retain(g);
+
+    EXPECT_EQ(100ns, sut.estimate(proc1));
+    EXPECT_EQ(200ns, sut.estimate(proc2));
+    EXPECT_EQ(0ns, sut.estimate(proc3));
+}
+
+TEST(processor_timings, statistics_of_unknown_processor_are_empty)
+{
+    processor_mock proc;
+    processor_timings sut;
+
+    auto const stats = sut.take_statistics(proc);
+
+    EXPECT_EQ(0u, stats.count);
+    EXPECT_EQ(0ns, stats.max);
+}
+
+TEST(processor_timings, statistics_cover_the_updates_since_last_taken)
+{
+    processor_mock proc;
+    processor_timings sut;
+
+    for (int i = 0; i < 99; ++i)
+    {
+        sut[proc].update(1000ns);
+    }
+
+    sut[proc].update(100'000ns);
+
+    auto const stats = sut.take_statistics(proc);
+    EXPECT_EQ(100u, stats.count);
+    EXPECT_EQ(1990ns, stats.mean);
+    EXPECT_EQ(100'000ns, stats.max);
+
+    // within the histogram bucket of 1000ns
+    EXPECT_LE(1000ns, stats.p99);
+    EXPECT_GT(1200ns, stats.p99);
+
+    EXPECT_EQ(0u, sut.take_statistics(proc).count);
+}
+
+TEST(processor_timings, p99_is_limited_by_max)
+{
+    processor_mock proc;
+    processor_timings sut;
+
+    sut[proc].update(1001ns);
+
+    EXPECT_EQ(1001ns, sut.take_statistics(proc).p99);
+}
+
+} // namespace piejam::audio::engine::test
@@ -0,0 +1,186 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "processor_mock.h"
+
+#include <piejam/audio/engine/tracer.h>
+
+#include <piejam/audio/engine/dag.h>
+#include <piejam/audio/engine/dag_executor.h>
+#include <piejam/audio/engine/graph.h>
+#include <piejam/audio/engine/graph_to_dag.h>
+
+#include <fmt/format.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace piejam::audio::engine::test
+{
+
+namespace
+{
+
+auto
+consume_names(trace_ring& ring) -> std::vector<std::string>
+{
+    std::vector<std::string> names;
+    ring.consume([&names](trace_event const& event) {
+        names.emplace_back(event.name.data());
+    });
+    return names;
+}
+
+} // namespace
+
+TEST(trace_ring, consume_returns_recorded_events_in_order)
+{
+    trace_ring sut(4);
+    auto const now = trace_event::clock_t::now();
+
+    EXPECT_TRUE(sut.record("a", now, now));
+    EXPECT_TRUE(sut.record("b", now, now));
+
+    EXPECT_EQ((std::vector<std::string>{"a", "b"}), consume_names(sut));
+    EXPECT_TRUE(consume_names(sut).empty());
+}
+
+TEST(trace_ring, events_are_dropped_when_full)
+{
+    trace_ring sut(2);
+    auto const now = trace_event::clock_t::now();
+
+    EXPECT_TRUE(sut.record("a", now, now));
+    EXPECT_TRUE(sut.record("b", now, now));
+    EXPECT_FALSE(sut.record("c", now, now));
+    EXPECT_EQ(1u, sut.dropped());
+
+    EXPECT_EQ((std::vector<std::string>{"a", "b"}), consume_names(sut));
+
+    EXPECT_TRUE(sut.record("d", now, now));
+    EXPECT_EQ((std::vector<std::string>{"d"}), consume_names(sut));
+}
+
+TEST(trace_ring, long_names_are_truncated)
+{
+    trace_ring sut(1);
+    auto const now = trace_event::clock_t::now();
+
+    sut.record(std::string(100, 'x'), now, now);
+
+    EXPECT_EQ(
+            (std::vector<std::string>{
+                    std::string(trace_event::max_name_length, 'x')}),
+            consume_names(sut));
+}
+
+TEST(tracer, no_active_ring_while_disabled)
+{
+    tracer sut(2);
+    EXPECT_EQ(nullptr, sut.active_ring(0));
+
+    sut.set_enabled(true);
+    EXPECT_NE(nullptr, sut.active_ring(0));
+    EXPECT_NE(nullptr, sut.active_ring(1));
+    EXPECT_EQ(nullptr, sut.active_ring(2));
+}
+
+TEST(tracer, processor_execution_is_written_as_chrome_trace)
+{
+    using namespace testing;
+
+    NiceMock<processor_mock> in_proc;
+    NiceMock<processor_mock> out_proc;
+    ON_CALL(in_proc, name()).WillByDefault(Return("in_proc"));
+    ON_CALL(in_proc, num_outputs()).WillByDefault(Return(1));
+    ON_CALL(out_proc, name()).WillByDefault(Return("out\"proc"));
+    ON_CALL(out_proc, num_inputs()).WillByDefault(Return(1));
+
+    graph g;
+    g.audio.insert({in_proc, 0}, {out_proc, 0});
+
+    tracer sut(1);
+    auto executor = graph_to_dag(g).make_runnable(
+            {},
+            1u << 16,
+            dag::scheduling::work_stealing,
+            &sut);
+
+    (*executor)(1);
+
+    std::ostringstream untraced;
+    sut.write_chrome_trace(untraced);
+    EXPECT_EQ(std::string::npos, untraced.str().find("in_proc"));
+
+    sut.set_enabled(true);
+    (*executor)(1);
+
+    std::ostringstream traced;
+    sut.write_chrome_trace(traced);
+    std::string const json = traced.str();
+
+    EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+    EXPECT_NE(
+            std::string::npos,
+            json.find("\"name\":\"in_proc\",\"ph\":\"X\""));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"out\\\"proc\""));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"period\""));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"thread_name\""));
+}
+
+TEST(tracer, drained_events_are_kept_until_written)
+{
+    tracer sut(1, 2);
+    sut.set_enabled(true);
+
+    trace_event::clock_t::time_point const now{};
+    trace_ring* const ring = sut.active_ring(0);
+    ASSERT_NE(nullptr, ring);
+
+    EXPECT_TRUE(ring->record("a", now, now));
+    EXPECT_TRUE(ring->record("b", now, now));
+    sut.drain();
+    EXPECT_TRUE(ring->record("c", now, now));
+    EXPECT_TRUE(ring->record("d", now, now));
+
+    std::ostringstream os;
+    sut.write_chrome_trace(os);
+    std::string const json = os.str();
+
+    for (char const* const name : {"a", "b", "c", "d"})
+    {
+        EXPECT_NE(
+                std::string::npos,
+                json.find(fmt::format("\"name\":\"{}\"", name)))
+                << name;
+    }
+    EXPECT_NE(std::string::npos, json.find("\"dropped_events\":0"));
+}
+
+TEST(tracer, dropped_events_since_the_last_write_are_written)
+{
+    tracer sut(1, 1);
+    sut.set_enabled(true);
+
+    trace_event::clock_t::time_point const now{};
+    trace_ring* const ring = sut.active_ring(0);
+    ASSERT_NE(nullptr, ring);
+
+    EXPECT_TRUE(ring->record("a", now, now));
+    EXPECT_FALSE(ring->record("b", now, now));
+    EXPECT_FALSE(ring->record("c", now, now));
+
+    std::ostringstream first;
+    sut.write_chrome_trace(first);
+    EXPECT_NE(std::string::npos, first.str().find("\"dropped_events\":2"));
+
+    std::ostringstream second;
+    sut.write_chrome_trace(second);
+    EXPECT_NE(std::string::npos, second.str().find("\"dropped_events\":0"));
+}
+
+} // namespace piejam::audio::engine::test
@@ -4,11 +4,10 @@
 
 #pragma once
 
-#include <piejam/box.h>
 #include <piejam/entity_id.h>
+#include <piejam/persistent_map.h>
 
 #include <boost/assert.hpp>
-#include <boost/container/flat_map.hpp>
 
 #include <concepts>
 #include <span>
@@ -16,121 +15,104 @@
 namespace piejam
 {
 
+//! Entities are kept in a persistent map. Copies of the map share their
+//! nodes, adding, updating or removing a single entity copies only the
+//! path to it.
 template <class Entity>
 class entity_map
 {
 public:
     using id_t = entity_id<Entity>;
-    using map_t = boost::container::flat_map<id_t, Entity>;
+    using map_t = persistent_map<id_t, Entity>;
     using value_type = typename map_t::value_type;
 
     [[nodiscard]] auto empty() const noexcept
     {
-        return m_map->empty();
+        return m_map.empty();
     }
 
     [[nodiscard]] auto size() const noexcept
     {
-        return m_map->size();
+        return m_map.size();
     }
 
     [[nodiscard]] auto begin() const noexcept
     {
-        return m_map->begin();
+        return m_map.begin();
     }
 
     [[nodiscard]] auto end() const noexcept
     {
-        return m_map->end();
+        return m_map.end();
     }
 
     [[nodiscard]] auto contains(id_t const id) const noexcept
     {
-        return m_map->contains(id);
+        return m_map.contains(id);
     }
 
     [[nodiscard]] auto find(id_t const id) const noexcept -> Entity const*
     {
-        auto it = m_map->find(id);
-        return it != m_map->end() ? std::addressof(it->second) : nullptr;
+        return m_map.find(id);
     }
 
     [[nodiscard]] auto operator[](id_t const id) const noexcept -> Entity const&
     {
-        auto it = m_map->find(id);
-        BOOST_ASSERT(it != m_map->end());
-        return it->second;
+        auto const* const entity = m_map.find(id);
+        BOOST_ASSERT(entity);
+        return *entity;
     }
 
     template <class... Args>
     [[nodiscard]] auto add(Args&&... args) -> id_t
     {
         auto id = id_t::generate();
-        m_map.update([&, id](map_t& m) {
-            m.emplace_hint(
-                    m.end(),
-                    std::piecewise_construct,
-                    std::forward_as_tuple(id),
-                    std::forward_as_tuple(std::forward<Args>(args)...));
-        });
+        BOOST_VERIFY(m_map.emplace(id, std::forward<Args>(args)...));
         return id;
     }
 
     template <std::invocable<Entity&> U>
     auto update(id_t const id, U&& u)
     {
-        return m_map.update([id, &u](map_t& m) {
-            auto it = m.find(id);
-            BOOST_ASSERT(it != m.end());
-            return u(it->second);
-        });
+        return m_map.update(id, std::forward<U>(u));
     }
 
     template <std::invocable<id_t, Entity&> U>
     auto update(std::span<id_t const> const ids, U&& u)
     {
-        m_map.update([ids, &u](map_t& m) {
-            for (auto const id : ids)
+        for (auto const id : ids)
+        {
+            if (m_map.contains(id))
             {
-                if (auto it = m.find(id); it != m.end())
-                {
-                    u(id, it->second);
-                }
+                m_map.update(id, [id, &u](Entity& e) { u(id, e); });
             }
-        });
+        }
     }
 
     template <std::invocable<id_t, Entity&> U>
     auto update(U&& u)
     {
-        m_map.update([&u](map_t& m) {
-            for (auto&& [id, value] : m)
-            {
-                u(id, value);
-            }
-        });
+        m_map.update(std::forward<U>(u));
     }
 
     auto remove(id_t const id) -> typename map_t::size_type
     {
-        return m_map.update([id](map_t& m) { return m.erase(id); });
+        return m_map.erase(id);
     }
 
     template <std::ranges::range RangeOfIds>
     void remove(RangeOfIds const& ids)
     {
-        m_map.update([&](map_t& m) {
-            for (id_t const id : ids)
-            {
-                m.erase(id);
-            }
-        });
+        for (id_t const id : ids)
+        {
+            m_map.erase(id);
+        }
     }
 
     auto operator==(entity_map const&) const noexcept -> bool = default;
 
 private:
-    box<map_t> m_map;
+    map_t m_map;
 };
 
 } // namespace piejam
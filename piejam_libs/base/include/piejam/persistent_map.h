@@ -0,0 +1,545 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/scope_guard.h>
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace piejam
+{
+
+//! Ordered map with value semantics and structural sharing, implemented as
+//! a B+tree of immutable nodes. Copying is O(1), an update copies only the
+//! nodes on the path to the changed entry. Maps with up to NodeSize entries
+//! consist of a single node.
+template <class Key, class Value, std::size_t NodeSize = 32>
+class persistent_map
+{
+    static_assert(NodeSize >= 4);
+
+    struct node
+    {
+    };
+
+    using node_ptr = std::shared_ptr<node const>;
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = std::size_t;
+
+    class const_iterator;
+    using iterator = const_iterator;
+
+    persistent_map()
+        : m_root(std::make_shared<leaf const>())
+    {
+    }
+
+    [[nodiscard]] auto empty() const noexcept -> bool
+    {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] auto size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] auto begin() const noexcept -> const_iterator
+    {
+        return const_iterator(*m_root, m_depth);
+    }
+
+    [[nodiscard]] auto end() const noexcept -> const_iterator
+    {
+        return const_iterator();
+    }
+
+    [[nodiscard]] auto contains(Key const& key) const noexcept -> bool
+    {
+        return find(key) != nullptr;
+    }
+
+    [[nodiscard]] auto find(Key const& key) const noexcept -> Value const*
+    {
+        node const* n = m_root.get();
+        for (std::size_t depth = m_depth; depth > 0; --depth)
+        {
+            auto const& in = as_inner(*n);
+            n = in.children[child_index(in, key)].get();
+        }
+
+        auto const& values = as_leaf(*n).values;
+        auto it = lower_bound(values, key);
+        return it != values.end() && it->first == key ? &it->second
+                                                      : nullptr;
+    }
+
+    //! Inserts a new entry, if the key isn't contained yet.
+    template <class... Args>
+    auto emplace(Key const& key, Args&&... args) -> bool
+    {
+        if (contains(key))
+        {
+            return false;
+        }
+
+        auto [root, split] =
+                insert(*m_root, m_depth, key, std::forward<Args>(args)...);
+
+        if (split)
+        {
+            auto new_root = std::make_shared<inner>();
+            new_root->keys = {first_key(*root, m_depth),
+                              first_key(*split, m_depth)};
+            new_root->children = {std::move(root), std::move(split)};
+
+            m_root = std::move(new_root);
+            ++m_depth;
+        }
+        else
+        {
+            m_root = std::move(root);
+        }
+
+        ++m_size;
+        return true;
+    }
+
+    //! Updates the value of an existing entry.
+    template <std::invocable<Value&> U>
+    auto update(Key const& key, U&& u)
+    {
+        node_ptr new_root;
+        node_ptr* slot = &new_root;
+        node const* n = m_root.get();
+
+        for (std::size_t depth = m_depth; depth > 0; --depth)
+        {
+            auto in = std::make_shared<inner>(as_inner(*n));
+            std::size_t const index = child_index(*in, key);
+            n = in->children[index].get();
+
+            *slot = in;
+            slot = &in->children[index];
+        }
+
+        auto l = std::make_shared<leaf>(as_leaf(*n));
+        auto it = lower_bound(l->values, key);
+        BOOST_ASSERT(it != l->values.end() && it->first == key);
+        Value& value = it->second;
+        *slot = std::move(l);
+
+        on_scope_exit on_exit([this, &new_root]() {
+            m_root = std::move(new_root);
+        });
+        return std::invoke(std::forward<U>(u), value);
+    }
+
+    //! Updates the values of all entries.
+    template <std::invocable<Key const&, Value&> U>
+    void update(U&& u)
+    {
+        m_root = update_all(*m_root, m_depth, u);
+    }
+
+    auto erase(Key const& key) -> size_type
+    {
+        if (!contains(key))
+        {
+            return 0;
+        }
+
+        m_root = remove(*m_root, m_depth, key);
+
+        while (m_depth > 0 && as_inner(*m_root).children.size() == 1)
+        {
+            m_root = as_inner(*m_root).children.front();
+            --m_depth;
+        }
+
+        --m_size;
+        return 1;
+    }
+
+    auto operator==(persistent_map const& other) const noexcept -> bool
+    {
+        return m_root == other.m_root ||
+               (m_size == other.m_size &&
+                std::equal(begin(), end(), other.begin()));
+    }
+
+private:
+    static constexpr std::size_t min_node_size{NodeSize / 2};
+
+    struct leaf final : node
+    {
+        std::vector<value_type> values;
+    };
+
+    //! keys[i] is the lower bound of the keys in children[i]. keys[0] is
+    //! only kept for splitting and merging, lookups don't use it.
+    struct inner final : node
+    {
+        std::vector<Key> keys;
+        std::vector<node_ptr> children;
+    };
+
+    using split_result = std::pair<node_ptr, node_ptr>;
+
+    static auto as_leaf(node const& n) noexcept -> leaf const&
+    {
+        return static_cast<leaf const&>(n);
+    }
+
+    static auto as_inner(node const& n) noexcept -> inner const&
+    {
+        return static_cast<inner const&>(n);
+    }
+
+    template <class Values>
+    static auto lower_bound(Values& values, Key const& key) noexcept
+    {
+        return std::ranges::lower_bound(
+                values,
+                key,
+                std::ranges::less{},
+                &value_type::first);
+    }
+
+    static auto child_index(inner const& in, Key const& key) noexcept
+            -> std::size_t
+    {
+        auto const it = std::upper_bound(
+                std::next(in.keys.begin()),
+                in.keys.end(),
+                key);
+        return static_cast<std::size_t>(it - in.keys.begin() - 1);
+    }
+
+    static auto node_size(node const& n, std::size_t const depth) noexcept
+            -> std::size_t
+    {
+        return depth == 0 ? as_leaf(n).values.size()
+                          : as_inner(n).children.size();
+    }
+
+    static auto first_key(node const& n, std::size_t const depth) -> Key const&
+    {
+        return depth == 0 ? as_leaf(n).values.front().first
+                          : as_inner(n).keys.front();
+    }
+
+    template <class Vector>
+    static auto split_off(Vector& v, std::size_t const pos) -> Vector
+    {
+        Vector result(
+                std::make_move_iterator(std::next(v.begin(), pos)),
+                std::make_move_iterator(v.end()));
+        v.erase(std::next(v.begin(), pos), v.end());
+        return result;
+    }
+
+    static auto split(std::shared_ptr<leaf> l) -> split_result
+    {
+        if (l->values.size() <= NodeSize)
+        {
+            return {std::move(l), nullptr};
+        }
+
+        auto right = std::make_shared<leaf>();
+        right->values = split_off(l->values, l->values.size() / 2);
+        return {std::move(l), std::move(right)};
+    }
+
+    static auto split(std::shared_ptr<inner> in) -> split_result
+    {
+        if (in->children.size() <= NodeSize)
+        {
+            return {std::move(in), nullptr};
+        }
+
+        std::size_t const pos = in->children.size() / 2;
+        auto right = std::make_shared<inner>();
+        right->keys = split_off(in->keys, pos);
+        right->children = split_off(in->children, pos);
+        return {std::move(in), std::move(right)};
+    }
+
+    template <class... Args>
+    static auto insert(
+            node const& n,
+            std::size_t const depth,
+            Key const& key,
+            Args&&... args) -> split_result
+    {
+        if (depth == 0)
+        {
+            auto l = std::make_shared<leaf>(as_leaf(n));
+            l->values.emplace(
+                    lower_bound(l->values, key),
+                    std::piecewise_construct,
+                    std::forward_as_tuple(key),
+                    std::forward_as_tuple(std::forward<Args>(args)...));
+            return split(std::move(l));
+        }
+
+        auto in = std::make_shared<inner>(as_inner(n));
+        std::size_t const index = child_index(*in, key);
+
+        auto [child, sibling] = insert(
+                *in->children[index],
+                depth - 1,
+                key,
+                std::forward<Args>(args)...);
+
+        in->children[index] = std::move(child);
+
+        if (sibling)
+        {
+            in->keys.insert(
+                    std::next(in->keys.begin(), index + 1),
+                    first_key(*sibling, depth - 1));
+            in->children.insert(
+                    std::next(in->children.begin(), index + 1),
+                    std::move(sibling));
+        }
+
+        return split(std::move(in));
+    }
+
+    static auto remove(node const& n, std::size_t const depth, Key const& key)
+            -> node_ptr
+    {
+        if (depth == 0)
+        {
+            auto l = std::make_shared<leaf>(as_leaf(n));
+            l->values.erase(lower_bound(l->values, key));
+            return l;
+        }
+
+        auto in = std::make_shared<inner>(as_inner(n));
+        std::size_t const index = child_index(*in, key);
+
+        in->children[index] = remove(*in->children[index], depth - 1, key);
+
+        if (node_size(*in->children[index], depth - 1) < min_node_size &&
+            in->children.size() > 1)
+        {
+            rebalance(
+                    *in,
+                    index + 1 < in->children.size() ? index : index - 1,
+                    depth - 1);
+        }
+
+        return in;
+    }
+
+    //! Merges the children at index and index + 1. If the merged child is
+    //! too large, it is split in the middle again, leaving both halves above
+    //! the minimum size.
+    static void rebalance(
+            inner& in,
+            std::size_t const index,
+            std::size_t const child_depth)
+    {
+        auto [left, right] = child_depth == 0
+                                     ? merge(as_leaf(*in.children[index]),
+                                             as_leaf(*in.children[index + 1]))
+                                     : merge(as_inner(*in.children[index]),
+                                             as_inner(*in.children[index + 1]),
+                                             in.keys[index + 1]);
+
+        in.children[index] = std::move(left);
+
+        if (right)
+        {
+            in.keys[index + 1] = first_key(*right, child_depth);
+            in.children[index + 1] = std::move(right);
+        }
+        else
+        {
+            in.keys.erase(std::next(in.keys.begin(), index + 1));
+            in.children.erase(std::next(in.children.begin(), index + 1));
+        }
+    }
+
+    static auto merge(leaf const& left, leaf const& right) -> split_result
+    {
+        auto merged = std::make_shared<leaf>(left);
+        merged->values.insert(
+                merged->values.end(),
+                right.values.begin(),
+                right.values.end());
+        return split(std::move(merged));
+    }
+
+    static auto
+    merge(inner const& left, inner const& right, Key const& separator)
+            -> split_result
+    {
+        auto merged = std::make_shared<inner>(left);
+        merged->keys.push_back(separator);
+        merged->keys.insert(
+                merged->keys.end(),
+                std::next(right.keys.begin()),
+                right.keys.end());
+        merged->children.insert(
+                merged->children.end(),
+                right.children.begin(),
+                right.children.end());
+        return split(std::move(merged));
+    }
+
+    template <class U>
+    static auto update_all(node const& n, std::size_t const depth, U& u)
+            -> node_ptr
+    {
+        if (depth == 0)
+        {
+            auto l = std::make_shared<leaf>(as_leaf(n));
+            for (auto& [key, value] : l->values)
+            {
+                std::invoke(u, std::as_const(key), value);
+            }
+            return l;
+        }
+
+        auto in = std::make_shared<inner>(as_inner(n));
+        for (node_ptr& child : in->children)
+        {
+            child = update_all(*child, depth - 1, u);
+        }
+        return in;
+    }
+
+    node_ptr m_root;
+    std::size_t m_depth{};
+    size_type m_size{};
+
+public:
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = persistent_map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type const*;
+        using reference = value_type const&;
+
+        const_iterator() noexcept = default;
+
+        auto operator*() const noexcept -> reference
+        {
+            return m_leaf->values[m_index];
+        }
+
+        auto operator->() const noexcept -> pointer
+        {
+            return &m_leaf->values[m_index];
+        }
+
+        auto operator++() noexcept -> const_iterator&
+        {
+            if (++m_index == m_leaf->values.size())
+            {
+                next_leaf();
+            }
+
+            return *this;
+        }
+
+        auto operator++(int) noexcept -> const_iterator
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        auto operator==(const_iterator const& other) const noexcept -> bool
+        {
+            return m_leaf == other.m_leaf && m_index == other.m_index;
+        }
+
+    private:
+        friend class persistent_map;
+
+        const_iterator(node const& root, std::size_t const depth) noexcept
+            : m_root(&root)
+            , m_depth(depth)
+        {
+            first_leaf(root, depth);
+        }
+
+        void first_leaf(node const& n, std::size_t const depth) noexcept
+        {
+            node const* first = &n;
+            for (std::size_t d = depth; d > 0; --d)
+            {
+                first = as_inner(*first).children.front().get();
+            }
+
+            // only the root leaf can be empty
+            m_leaf = as_leaf(*first).values.empty() ? nullptr
+                                                    : &as_leaf(*first);
+            m_index = 0;
+        }
+
+        //! Nodes don't know their siblings, the next leaf is looked up from
+        //! the root. This happens only once per leaf.
+        void next_leaf() noexcept
+        {
+            Key const& last = m_leaf->values.back().first;
+
+            node const* n = m_root;
+            node const* next{};
+            std::size_t next_depth{};
+
+            for (std::size_t depth = m_depth; depth > 0; --depth)
+            {
+                auto const& in = as_inner(*n);
+                std::size_t const index = child_index(in, last);
+
+                if (index + 1 < in.children.size())
+                {
+                    next = in.children[index + 1].get();
+                    next_depth = depth - 1;
+                }
+
+                n = in.children[index].get();
+            }
+
+            if (next)
+            {
+                first_leaf(*next, next_depth);
+            }
+            else
+            {
+                m_leaf = nullptr;
+                m_index = 0;
+            }
+        }
+
+        node const* m_root{};
+        std::size_t m_depth{};
+        leaf const* m_leaf{};
+        std::size_t m_index{};
+    };
+};
+
+} // namespace piejam
@@ -0,0 +1,187 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/persistent_map.h>
+
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace piejam::test
+{
+
+// small nodes, to have deep trees with few entries
+using small_map = persistent_map<int, int, 4>;
+
+namespace
+{
+
+auto
+to_vector(small_map const& m) -> std::vector<std::pair<int, int>>
+{
+    return {m.begin(), m.end()};
+}
+
+} // namespace
+
+TEST(persistent_map, default_ctor)
+{
+    small_map sut;
+    EXPECT_TRUE(sut.empty());
+    EXPECT_EQ(0u, sut.size());
+    EXPECT_EQ(sut.begin(), sut.end());
+}
+
+TEST(persistent_map, emplace_and_find)
+{
+    small_map sut;
+    EXPECT_TRUE(sut.emplace(5, 50));
+    EXPECT_FALSE(sut.emplace(5, 51));
+
+    ASSERT_NE(nullptr, sut.find(5));
+    EXPECT_EQ(50, *sut.find(5));
+    EXPECT_EQ(nullptr, sut.find(6));
+    EXPECT_EQ(1u, sut.size());
+}
+
+TEST(persistent_map, iterates_in_key_order)
+{
+    small_map sut;
+    for (int key : {7, 3, 9, 1, 5, 8, 2, 6, 4, 0})
+    {
+        sut.emplace(key, key * 10);
+    }
+
+    std::vector<std::pair<int, int>> expected;
+    for (int key = 0; key < 10; ++key)
+    {
+        expected.emplace_back(key, key * 10);
+    }
+
+    EXPECT_EQ(expected, to_vector(sut));
+}
+
+TEST(persistent_map, update_returns_result_and_leaves_copy_untouched)
+{
+    small_map sut;
+    for (int key = 0; key < 20; ++key)
+    {
+        sut.emplace(key, key);
+    }
+
+    small_map const copy = sut;
+
+    EXPECT_EQ(30, sut.update(13, [](int& value) { return value += 17; }));
+    EXPECT_EQ(30, *sut.find(13));
+    EXPECT_EQ(13, *copy.find(13));
+    EXPECT_FALSE(sut == copy);
+}
+
+TEST(persistent_map, update_all)
+{
+    small_map sut;
+    for (int key = 0; key < 20; ++key)
+    {
+        sut.emplace(key, key);
+    }
+
+    small_map const copy = sut;
+
+    sut.update([](int key, int& value) { value = key * 2; });
+
+    for (int key = 0; key < 20; ++key)
+    {
+        EXPECT_EQ(key * 2, *sut.find(key));
+        EXPECT_EQ(key, *copy.find(key));
+    }
+}
+
+TEST(persistent_map, erase)
+{
+    small_map sut;
+    for (int key = 0; key < 20; ++key)
+    {
+        sut.emplace(key, key);
+    }
+
+    small_map const copy = sut;
+
+    EXPECT_EQ(1u, sut.erase(7));
+    EXPECT_EQ(0u, sut.erase(7));
+    EXPECT_EQ(19u, sut.size());
+    EXPECT_FALSE(sut.contains(7));
+    EXPECT_TRUE(copy.contains(7));
+
+    for (int key = 0; key < 20; ++key)
+    {
+        sut.erase(key);
+    }
+
+    EXPECT_TRUE(sut.empty());
+    EXPECT_EQ(sut.begin(), sut.end());
+    EXPECT_EQ(20u, copy.size());
+}
+
+TEST(persistent_map, equality)
+{
+    small_map a;
+    a.emplace(1, 1);
+    a.emplace(2, 2);
+
+    small_map b = a;
+    EXPECT_TRUE(a == b);
+
+    b.update(1, [](int&) {});
+    EXPECT_TRUE(a == b);
+
+    b.update(1, [](int& value) { value = 3; });
+    EXPECT_FALSE(a == b);
+}
+
+TEST(persistent_map, behaves_like_std_map)
+{
+    std::mt19937 gen(1234);
+    std::uniform_int_distribution<int> key_dist(0, 200);
+    std::uniform_int_distribution<int> op_dist(0, 2);
+
+    small_map sut;
+    std::map<int, int> expected;
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        int const key = key_dist(gen);
+        switch (op_dist(gen))
+        {
+            case 0:
+                EXPECT_EQ(
+                        expected.emplace(key, i).second,
+                        sut.emplace(key, i));
+                break;
+
+            case 1:
+                if (expected.contains(key))
+                {
+                    expected[key] = i;
+                    sut.update(key, [i](int& value) { value = i; });
+                }
+                break;
+
+            default:
+                EXPECT_EQ(expected.erase(key), sut.erase(key));
+                break;
+        }
+
+        ASSERT_EQ(expected.size(), sut.size());
+    }
+
+    EXPECT_EQ(
+            (std::vector<std::pair<int, int>>{expected.begin(), expected.end()}),
+            to_vector(sut));
+}
+
+} // namespace piejam::test
@@ -21,6 +21,12 @@ class FxChainModule : public Subscribable<SubscribableModel>
 
     Q_PROPERTY(QString name READ name NOTIFY nameChanged FINAL)
     Q_PROPERTY(bool focused READ focused NOTIFY focusedChanged FINAL)
+    Q_PROPERTY(double processingCostMean READ processingCostMean NOTIFY
+                       processingCostChanged FINAL)
+    Q_PROPERTY(double processingCostP99 READ processingCostP99 NOTIFY
+                       processingCostChanged FINAL)
+    Q_PROPERTY(double processingCostMax READ processingCostMax NOTIFY
+                       processingCostChanged FINAL)
 
 public:
     FxChainModule(
@@ -58,6 +64,34 @@ public:
         }
     }
 
+    //! Processing costs per period in microseconds.
+    auto processingCostMean() const noexcept -> double
+    {
+        return m_processingCostMean;
+    }
+
+    auto processingCostP99() const noexcept -> double
+    {
+        return m_processingCostP99;
+    }
+
+    auto processingCostMax() const noexcept -> double
+    {
+        return m_processingCostMax;
+    }
+
+    void setProcessingCost(double mean, double p99, double max)
+    {
+        if (m_processingCostMean != mean || m_processingCostP99 != p99 ||
+            m_processingCostMax != max)
+        {
+            m_processingCostMean = mean;
+            m_processingCostP99 = p99;
+            m_processingCostMax = max;
+            emit processingCostChanged();
+        }
+    }
+
     Q_INVOKABLE void remove();
     Q_INVOKABLE void focus();
     Q_INVOKABLE void showFxModule();
@@ -65,6 +99,7 @@ public:
 signals:
     void nameChanged();
     void focusedChanged();
+    void processingCostChanged();
 
 private:
     void onSubscribe() override;
@@ -74,6 +109,9 @@ private:
 
     QString m_name;
     bool m_focused{};
+    double m_processingCostMean{};
+    double m_processingCostP99{};
+    double m_processingCostMax{};
 };
 
 } // namespace piejam::gui::model
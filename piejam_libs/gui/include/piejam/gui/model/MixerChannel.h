@@ -25,6 +25,12 @@ class MixerChannel final : public Subscribable<SubscribableModel>
     Q_PROPERTY(
             piejam::gui::model::MixerChannelEdit* edit READ edit CONSTANT FINAL)
     Q_PROPERTY(piejam::gui::model::MixerChannelFx* fx READ fx CONSTANT FINAL)
+    Q_PROPERTY(double processingCostMean READ processingCostMean NOTIFY
+                       processingCostChanged FINAL)
+    Q_PROPERTY(double processingCostP99 READ processingCostP99 NOTIFY
+                       processingCostChanged FINAL)
+    Q_PROPERTY(double processingCostMax READ processingCostMax NOTIFY
+                       processingCostChanged FINAL)
 
 public:
     MixerChannel(
@@ -37,11 +43,46 @@ public:
     auto edit() const -> MixerChannelEdit*;
     auto fx() const -> MixerChannelFx*;
 
+    //! Processing costs per period in microseconds.
+    auto processingCostMean() const noexcept -> double
+    {
+        return m_processingCostMean;
+    }
+
+    auto processingCostP99() const noexcept -> double
+    {
+        return m_processingCostP99;
+    }
+
+    auto processingCostMax() const noexcept -> double
+    {
+        return m_processingCostMax;
+    }
+
+    void setProcessingCost(double mean, double p99, double max)
+    {
+        if (m_processingCostMean != mean || m_processingCostP99 != p99 ||
+            m_processingCostMax != max)
+        {
+            m_processingCostMean = mean;
+            m_processingCostP99 = p99;
+            m_processingCostMax = max;
+            emit processingCostChanged();
+        }
+    }
+
+signals:
+    void processingCostChanged();
+
 private:
     void onSubscribe() override;
 
     struct Impl;
     std::unique_ptr<Impl> m_impl;
+
+    double m_processingCostMean{};
+    double m_processingCostP99{};
+    double m_processingCostMax{};
 };
 
 } // namespace piejam::gui::model
@@ -14,9 +14,22 @@
 #include <boost/assert.hpp>
 #include <boost/hof/match.hpp>
 
+#include <chrono>
+
 namespace piejam::gui::model
 {
 
+namespace
+{
+
+auto
+to_microseconds(std::chrono::nanoseconds const ns) -> double
+{
+    return std::chrono::duration<double, std::micro>(ns).count();
+}
+
+} // namespace
+
 struct FxChainModule::Impl
 {
     runtime::mixer::channel_id const fx_chain_id;
@@ -47,6 +60,15 @@ FxChainModule::onSubscribe()
             [this](auto const focused_fx_mod_id) {
                 setFocused(focused_fx_mod_id == m_impl->fx_mod_id);
             });
+
+    observe(runtime::selectors::make_fx_module_processing_cost_selector(
+                    m_impl->fx_mod_id),
+            [this](runtime::processing_cost const& cost) {
+                setProcessingCost(
+                        to_microseconds(cost.mean),
+                        to_microseconds(cost.p99),
+                        to_microseconds(cost.max));
+            });
 }
 
 void
@@ -7,12 +7,27 @@
 #include <piejam/gui/model/MixerChannelEdit.h>
 #include <piejam/gui/model/MixerChannelFx.h>
 #include <piejam/gui/model/MixerChannelPerform.h>
+#include <piejam/runtime/selectors.h>
+
+#include <chrono>
 
 namespace piejam::gui::model
 {
 
+namespace
+{
+
+auto
+to_microseconds(std::chrono::nanoseconds const ns) -> double
+{
+    return std::chrono::duration<double, std::micro>(ns).count();
+}
+
+} // namespace
+
 struct MixerChannel::Impl
 {
+    runtime::mixer::channel_id id;
     std::unique_ptr<MixerChannelPerform> m_perform;
     std::unique_ptr<MixerChannelEdit> m_edit;
     std::unique_ptr<MixerChannelFx> m_fx;
@@ -24,6 +39,7 @@ MixerChannel::MixerChannel(
         runtime::mixer::channel_id const id)
     : Subscribable(store_dispatch, state_change_subscriber)
     , m_impl(std::make_unique<Impl>(
+              id,
               std::make_unique<MixerChannelPerform>(
                       store_dispatch,
                       state_change_subscriber,
@@ -44,6 +60,14 @@ MixerChannel::~MixerChannel() = default;
 void
 MixerChannel::onSubscribe()
 {
+    observe(runtime::selectors::make_mixer_channel_processing_cost_selector(
+                    m_impl->id),
+            [this](runtime::processing_cost const& cost) {
+                setProcessingCost(
+                        to_microseconds(cost.mean),
+                        to_microseconds(cost.p99),
+                        to_microseconds(cost.max));
+            });
 }
 
 auto
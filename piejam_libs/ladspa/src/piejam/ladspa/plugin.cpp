@@ -27,6 +27,7 @@
 #include <boost/numeric/conversion/cast.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <stdexcept>
 #include <variant>
@@ -283,6 +284,11 @@ public:
         m_descriptor.cleanup(m_handle);
     }
 
+    auto in_place_broken() const noexcept -> bool
+    {
+        return LADSPA_IS_INPLACE_BROKEN(m_descriptor.Properties);
+    }
+
 private:
     LADSPA_Descriptor const& m_descriptor;
     LADSPA_Handle m_handle;
@@ -414,9 +420,11 @@ public:
             std::span<port_descriptor const> audio_inputs,
             std::span<port_descriptor const> audio_outputs,
             std::span<port_descriptor const> control_inputs,
-            std::span<port_descriptor const> control_outputs)
+            std::span<port_descriptor const> control_outputs,
+            std::size_t const tail_length)
         : m_instance(std::move(instance))
         , m_name(name)
+        , m_tail_length(tail_length)
         , m_input_port_indices(audio_inputs.size())
         , m_output_port_indices(audio_outputs.size())
         , m_event_inputs(to_event_ports(control_inputs))
@@ -495,6 +503,27 @@ public:
         return m_event_outputs;
     }
 
+    auto results_may_alias_inputs() const noexcept -> bool override
+    {
+        return false;
+    }
+
+    auto in_place_input(std::size_t const output) const noexcept
+            -> std::optional<std::size_t> override
+    {
+        if (m_instance.in_place_broken() || output >= num_inputs())
+        {
+            return std::nullopt;
+        }
+
+        return output;
+    }
+
+    auto tail_length() const noexcept -> std::optional<std::size_t> override
+    {
+        return m_tail_length;
+    }
+
     void process(audio::engine::process_context const& ctx) override
     {
         audio::engine::verify_process_context(*this, ctx);
@@ -570,6 +599,7 @@ public:
 private:
     plugin_instance m_instance;
     std::string m_name;
+    std::size_t m_tail_length;
     std::vector<unsigned long> m_input_port_indices{};
     std::vector<unsigned long> m_output_port_indices{};
     std::vector<audio::engine::event_port> m_event_inputs;
@@ -580,6 +610,9 @@ private:
     std::vector<float> m_control_outputs;
 };
 
+// LADSPA doesn't describe tails, so assume a long reverb.
+constexpr std::chrono::seconds max_tail_duration{10};
+
 class plugin_impl final : public plugin
 {
 public:
@@ -668,7 +701,8 @@ public:
                     m_ports.input.audio,
                     m_ports.output.audio,
                     m_ports.input.control,
-                    m_ports.output.control);
+                    m_ports.output.control,
+                    sample_rate.to_samples(max_tail_duration));
         }
 
         return nullptr;
@@ -0,0 +1,271 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "engine_session.h"
+
+#include <piejam/audio/engine/processor.h>
+#include <piejam/ladspa/instance_manager_processor_factory.h>
+#include <piejam/ladspa/plugin.h>
+#include <piejam/ladspa/plugin_descriptor.h>
+#include <piejam/ladspa/scan.h>
+#include <piejam/runtime/audio_engine.h>
+#include <piejam/runtime/state.h>
+#include <piejam/thread/configuration.h>
+#include <piejam/thread/worker.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// Synthetic sessions run through the whole audio engine. For tracking results
+// across releases, run with
+//   --benchmark_out=<file>.json --benchmark_out_format=json
+// or build the run_piejam_runtime_benchmark target.
+
+namespace piejam::runtime
+{
+
+namespace
+{
+
+constexpr audio::sample_rate sample_rate{48000u};
+
+using test::ladspa_plugin;
+
+//! First plugin in the default location, which processes audio.
+auto
+find_ladspa_plugin() -> std::optional<ladspa::plugin_descriptor>
+{
+    auto const plugins = ladspa::scan_directory("/usr/lib/ladspa");
+    auto const it = std::ranges::find_if(
+            plugins,
+            [](ladspa::plugin_descriptor const& desc) {
+                return desc.num_inputs > 0 &&
+                       desc.num_inputs == desc.num_outputs;
+            });
+    return it != plugins.end() ? std::optional{*it} : std::nullopt;
+}
+
+//! Engine with the device buffers faked, inputs are a constant signal and
+//! outputs are discarded.
+struct engine_fixture
+{
+    engine_fixture(
+            std::size_t const num_channels,
+            std::size_t const num_workers,
+            ladspa_plugin* const plugin)
+        : workers(num_workers)
+        , engine(workers,
+                 sample_rate,
+                 test::session_device_inputs(num_channels),
+                 2)
+        , ladspa_factory([plugin](ladspa::instance_id const& id) {
+            return plugin ? plugin->manager.make_processor(id, sample_rate)
+                          : nullptr;
+        })
+    {
+        input_converter.resize(
+                test::session_device_inputs(num_channels),
+                [](std::span<float> const buffer) {
+                    std::ranges::fill(buffer, 0.25f);
+                    return std::span<float const>{buffer};
+                });
+        output_converter.resize(
+                2,
+                [](audio::pcm_output_source_buffer_t const&) {});
+
+        engine.init_process(input_converter, output_converter);
+        engine.set_num_workers(num_workers);
+    }
+
+    auto rebuild(state const& st, std::size_t const period_size) -> bool
+    {
+        return test::rebuild_while_processing(
+                engine,
+                st,
+                period_size,
+                ladspa_factory);
+    }
+
+    std::vector<thread::worker> workers;
+    audio_engine engine;
+    fx::simple_ladspa_processor_factory ladspa_factory;
+    std::vector<audio::pcm_input_buffer_converter> input_converter;
+    std::vector<audio::pcm_output_buffer_converter> output_converter;
+};
+
+void
+set_session_counters(
+        benchmark::State& bench_state,
+        std::size_t const num_channels,
+        std::size_t const num_fx)
+{
+    bench_state.counters["channels"] = static_cast<double>(num_channels);
+    bench_state.counters["fx"] = static_cast<double>(num_channels * num_fx);
+}
+
+} // namespace
+
+static void
+BM_audio_engine_rebuild(benchmark::State& bench_state)
+{
+    auto const num_channels = static_cast<std::size_t>(bench_state.range(0));
+    auto const num_fx = static_cast<std::size_t>(bench_state.range(1));
+    auto const num_workers = static_cast<std::size_t>(bench_state.range(2));
+
+    state const st = test::make_session(sample_rate, num_channels, num_fx);
+
+    for (auto _ : bench_state)
+    {
+        bench_state.PauseTiming();
+        auto fixture = std::make_unique<engine_fixture>(
+                num_channels,
+                num_workers,
+                nullptr);
+        bench_state.ResumeTiming();
+
+        bool const rebuilt = fixture->rebuild(st, 128);
+        benchmark::DoNotOptimize(rebuilt);
+
+        bench_state.PauseTiming();
+        fixture.reset();
+        bench_state.ResumeTiming();
+    }
+
+    set_session_counters(bench_state, num_channels, num_fx);
+}
+
+BENCHMARK(BM_audio_engine_rebuild)
+        ->ArgNames({"channels", "fx_per_channel", "workers"})
+        ->ArgsProduct({{1, 8, 32}, {0, 2, 4}, {0, 3}})
+        ->Unit(benchmark::kMicrosecond);
+
+//! Inserting an fx into one channel of a running session. Every other
+//! rebuild removes it again.
+static void
+BM_audio_engine_insert_fx(benchmark::State& bench_state)
+{
+    auto const num_channels = static_cast<std::size_t>(bench_state.range(0));
+    auto const num_fx = static_cast<std::size_t>(bench_state.range(1));
+    auto const num_workers = static_cast<std::size_t>(bench_state.range(2));
+
+    state const st = test::make_session(sample_rate, num_channels, num_fx);
+    state st_with_fx = st;
+    insert_internal_fx_module(
+            st_with_fx,
+            st.mixer_state.inputs->back(),
+            npos,
+            fx::internal::filter,
+            {},
+            {});
+
+    engine_fixture fixture(num_channels, num_workers, nullptr);
+
+    if (!fixture.rebuild(st, 128))
+    {
+        bench_state.SkipWithError("rebuilding the engine failed");
+        return;
+    }
+
+    bool with_fx{};
+    for (auto _ : bench_state)
+    {
+        with_fx = !with_fx;
+        bool const rebuilt = fixture.rebuild(with_fx ? st_with_fx : st, 128);
+        benchmark::DoNotOptimize(rebuilt);
+    }
+
+    set_session_counters(bench_state, num_channels, num_fx);
+}
+
+BENCHMARK(BM_audio_engine_insert_fx)
+        ->ArgNames({"channels", "fx_per_channel", "workers"})
+        ->ArgsProduct({{8, 32, 64}, {4}, {0, 3}})
+        ->Unit(benchmark::kMicrosecond);
+
+static void
+run_process_benchmark(
+        benchmark::State& bench_state,
+        ladspa_plugin* const plugin)
+{
+    auto const num_channels = static_cast<std::size_t>(bench_state.range(0));
+    auto const num_fx = static_cast<std::size_t>(bench_state.range(1));
+    auto const period_size = static_cast<std::size_t>(bench_state.range(2));
+    auto const num_workers = static_cast<std::size_t>(bench_state.range(3));
+
+    engine_fixture fixture(num_channels, num_workers, plugin);
+
+    if (!fixture.rebuild(
+                test::make_session(sample_rate, num_channels, num_fx, plugin),
+                period_size))
+    {
+        bench_state.SkipWithError("rebuilding the engine failed");
+        return;
+    }
+
+    // let parameter smoothing and tails settle
+    for (std::size_t i = 0; i < sample_rate.get() / period_size; ++i)
+    {
+        fixture.engine.process(period_size);
+    }
+
+    for (auto _ : bench_state)
+    {
+        fixture.engine.process(period_size);
+        benchmark::ClobberMemory();
+    }
+
+    set_session_counters(bench_state, num_channels, num_fx);
+    bench_state.SetItemsProcessed(
+            static_cast<std::int64_t>(bench_state.iterations()) *
+            static_cast<std::int64_t>(period_size));
+
+    // fraction of the period spent processing
+    bench_state.counters["rt_load"] = benchmark::Counter(
+            static_cast<double>(bench_state.iterations()) *
+                    static_cast<double>(period_size) / sample_rate.get(),
+            benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+static void
+BM_audio_engine_process(benchmark::State& bench_state)
+{
+    run_process_benchmark(bench_state, nullptr);
+}
+
+BENCHMARK(BM_audio_engine_process)
+        ->ArgNames({"channels", "fx_per_channel", "period_size", "workers"})
+        ->ArgsProduct(
+                {{1, 8, 32},
+                 {0, 2, 4},
+                 {16, 64, 256, 1024},
+                 {0, 3}})
+        ->Unit(benchmark::kMicrosecond)
+        ->UseRealTime();
+
+static void
+BM_audio_engine_process_ladspa(benchmark::State& bench_state)
+{
+    static ladspa_plugin plugin{{}, find_ladspa_plugin()};
+
+    if (!plugin.descriptor)
+    {
+        bench_state.SkipWithError("no LADSPA plugin found");
+        return;
+    }
+
+    run_process_benchmark(bench_state, &plugin);
+}
+
+BENCHMARK(BM_audio_engine_process_ladspa)
+        ->ArgNames({"channels", "fx_per_channel", "period_size", "workers"})
+        ->ArgsProduct({{8, 32}, {4}, {16, 256, 1024}, {0, 3}})
+        ->Unit(benchmark::kMicrosecond)
+        ->UseRealTime();
+
+} // namespace piejam::runtime
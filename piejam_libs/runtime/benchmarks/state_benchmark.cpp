@@ -2,6 +2,7 @@
 // SPDX-FileCopyrightText: 2020  Dimitrij Kotrev
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include <piejam/box.h>
 #include <piejam/ladspa/scan.h>
 #include <piejam/reselect/selector.h>
 #include <piejam/runtime/actions/finalize_ladspa_fx_plugin_scan.h>
@@ -10,6 +11,8 @@
 
 #include <benchmark/benchmark.h>
 
+#include <boost/container/flat_map.hpp>
+
 namespace piejam::runtime
 {
 
@@ -17,18 +20,18 @@ static void
 BM_copy_state_benchmark(benchmark::State& bench_state)
 {
     state st;
-    auto in1 = add_mixer_channel(st, "In1yohohofoobarbaz");
+    auto in1 = add_mixer_channel(st, "In1yohohofoobarbaz", audio::bus_type::stereo);
     insert_internal_fx_module(st, in1, npos, fx::internal::tool, {}, {});
-    auto in2 = add_mixer_channel(st, "In2");
+    auto in2 = add_mixer_channel(st, "In2", audio::bus_type::stereo);
     insert_internal_fx_module(st, in2, npos, fx::internal::tool, {}, {});
-    auto in3 = add_mixer_channel(st, "In3");
+    auto in3 = add_mixer_channel(st, "In3", audio::bus_type::stereo);
     insert_internal_fx_module(st, in3, npos, fx::internal::tool, {}, {});
-    auto out = add_mixer_channel(st, "out");
+    auto out = add_mixer_channel(st, "out", audio::bus_type::stereo);
     insert_internal_fx_module(st, out, npos, fx::internal::tool, {}, {});
 
     actions::finalize_ladspa_fx_plugin_scan ladspa_fx_scan;
     ladspa_fx_scan.plugins = ladspa::scan_directory("/usr/lib/ladspa");
-    st = ladspa_fx_scan.reduce(st);
+    ladspa_fx_scan.reduce(st);
 
     for (auto _ : bench_state)
     {
@@ -44,13 +47,13 @@ static void
 BM_get_bus_name_benchmark(benchmark::State& bench_state)
 {
     state st;
-    auto in1 = add_mixer_channel(st, "In1");
+    auto in1 = add_mixer_channel(st, "In1", audio::bus_type::stereo);
     insert_internal_fx_module(st, in1, npos, fx::internal::tool, {}, {});
-    auto in2 = add_mixer_channel(st, "In2");
+    auto in2 = add_mixer_channel(st, "In2", audio::bus_type::stereo);
     insert_internal_fx_module(st, in2, npos, fx::internal::tool, {}, {});
-    auto in3 = add_mixer_channel(st, "In3");
+    auto in3 = add_mixer_channel(st, "In3", audio::bus_type::stereo);
     insert_internal_fx_module(st, in3, npos, fx::internal::tool, {}, {});
-    auto out = add_mixer_channel(st, "out");
+    auto out = add_mixer_channel(st, "out", audio::bus_type::stereo);
     insert_internal_fx_module(st, out, npos, fx::internal::tool, {}, {});
 
     auto const get_name = selectors::make_mixer_channel_name_selector(in1);
@@ -65,4 +68,83 @@ BM_get_bus_name_benchmark(benchmark::State& bench_state)
 
 BENCHMARK(BM_get_bus_name_benchmark);
 
+// Single entity updates, like the reducers do them. The entity_map shares
+// all untouched entities with the previous state, the boxed flat_map (its
+// former storage) copies all of them.
+
+static void
+BM_entity_map_update_benchmark(benchmark::State& bench_state)
+{
+    auto const num_entities = bench_state.range(0);
+
+    mixer::channels_t channels;
+    mixer::channel_id id;
+    for (auto i = num_entities; i > 0; --i)
+    {
+        auto const added = channels.add();
+        if (i == num_entities / 2)
+        {
+            id = added;
+        }
+    }
+
+    boxed_string const name(std::string("renamed"));
+
+    for (auto _ : bench_state)
+    {
+        auto new_channels = channels;
+        new_channels.update(id, [&name](mixer::channel& channel) {
+            channel.name = name;
+        });
+        benchmark::DoNotOptimize(new_channels);
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(BM_entity_map_update_benchmark)
+        ->ArgName("entities")
+        ->Arg(1000)
+        ->Arg(10000)
+        ->Arg(100000);
+
+static void
+BM_boxed_flat_map_update_benchmark(benchmark::State& bench_state)
+{
+    using map_t = boost::container::flat_map<mixer::channel_id, mixer::channel>;
+
+    auto const num_entities = bench_state.range(0);
+
+    box<map_t> channels;
+    mixer::channel_id id;
+    channels.update([num_entities, &id](map_t& m) {
+        for (auto i = num_entities; i > 0; --i)
+        {
+            auto const added = mixer::channel_id::generate();
+            m.emplace(added, mixer::channel{});
+            if (i == num_entities / 2)
+            {
+                id = added;
+            }
+        }
+    });
+
+    boxed_string const name(std::string("renamed"));
+
+    for (auto _ : bench_state)
+    {
+        auto new_channels = channels;
+        new_channels.update([id, &name](map_t& m) {
+            m.find(id)->second.name = name;
+        });
+        benchmark::DoNotOptimize(new_channels);
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(BM_boxed_flat_map_update_benchmark)
+        ->ArgName("entities")
+        ->Arg(1000)
+        ->Arg(10000)
+        ->Arg(100000);
+
 } // namespace piejam::runtime
@@ -38,7 +38,10 @@ struct engine_action_visitor
               stop_midi_learning,
               update_midi_assignments,
               start_recording,
-              stop_recording>
+              stop_recording,
+              start_tracing,
+              stop_tracing,
+              export_graph>
 {
 };
 
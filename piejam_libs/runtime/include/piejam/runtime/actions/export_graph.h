@@ -0,0 +1,31 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/runtime/actions/engine_action.h>
+#include <piejam/runtime/fwd.h>
+#include <piejam/runtime/ui/action.h>
+#include <piejam/runtime/ui/cloneable_action.h>
+
+#include <filesystem>
+
+namespace piejam::runtime::actions
+{
+
+//! Writes the graph of the audio engine in dot format, which can be
+//! rendered with Graphviz.
+struct export_graph final
+    : ui::cloneable_action<export_graph, action>
+    , visitable_engine_action<export_graph>
+{
+    export_graph(std::filesystem::path file)
+        : file(std::move(file))
+    {
+    }
+
+    std::filesystem::path file;
+};
+
+} // namespace piejam::runtime::actions
@@ -84,6 +84,11 @@ struct save_session;
 struct start_recording;
 struct stop_recording;
 
+struct start_tracing;
+struct stop_tracing;
+
+struct export_graph;
+
 // visitors
 
 struct device_action_visitor;
@@ -0,0 +1,37 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/runtime/actions/engine_action.h>
+#include <piejam/runtime/fwd.h>
+#include <piejam/runtime/ui/action.h>
+#include <piejam/runtime/ui/cloneable_action.h>
+
+#include <filesystem>
+
+namespace piejam::runtime::actions
+{
+
+struct start_tracing final
+    : ui::cloneable_action<start_tracing, action>
+    , visitable_engine_action<start_tracing>
+{
+};
+
+//! Stops tracing the processor execution and writes the trace as Chrome
+//! trace JSON, which can be opened in Perfetto.
+struct stop_tracing final
+    : ui::cloneable_action<stop_tracing, action>
+    , visitable_engine_action<stop_tracing>
+{
+    stop_tracing(std::filesystem::path file)
+        : file(std::move(file))
+    {
+    }
+
+    std::filesystem::path file;
+};
+
+} // namespace piejam::runtime::actions
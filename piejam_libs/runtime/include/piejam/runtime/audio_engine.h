@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <piejam/audio/engine/dag.h>
 #include <piejam/audio/fwd.h>
 #include <piejam/audio/pair.h>
 #include <piejam/audio/pcm_buffer_converter.h>
@@ -12,9 +13,12 @@
 #include <piejam/runtime/audio_stream.h>
 #include <piejam/runtime/fwd.h>
 #include <piejam/runtime/fx/ladspa_processor_factory.h>
+#include <piejam/runtime/processing_cost.h>
 #include <piejam/runtime/stereo_level.h>
 #include <piejam/thread/fwd.h>
 
+#include <chrono>
+#include <iosfwd>
 #include <map>
 #include <memory>
 #include <optional>
@@ -30,13 +34,19 @@ public:
             std::span<thread::worker> workers,
             audio::sample_rate,
             unsigned num_device_input_channels,
-            unsigned num_device_output_channels);
+            unsigned num_device_output_channels,
+            audio::engine::dag::scheduling =
+                    audio::engine::dag::scheduling::work_stealing);
     ~audio_engine();
 
     template <class P>
     void set_parameter_value(parameter::id_t<P>, typename P::value_type const&)
             const;
 
+    //! Fetches the changes of the engine driven parameters, which are then
+    //! returned by get_parameter_update.
+    void fetch_parameter_updates() const;
+
     template <class P>
     [[nodiscard]] auto get_parameter_update(parameter::id_t<P>) const
             -> std::optional<typename P::value_type>;
@@ -46,10 +56,14 @@ public:
 
     [[nodiscard]] auto get_stream(audio_stream_id) const -> audio_stream_buffer;
 
+    //! With fade periods, the running graph is faded out over them, before
+    //! the new one is faded in. Only the outputs fed by recreated mixer
+    //! channel or fx components are faded, they start from a fresh state.
     [[nodiscard]] auto
     rebuild(state const&,
             fx::simple_ladspa_processor_factory const&,
-            std::unique_ptr<midi::input_event_handler>) -> bool;
+            std::unique_ptr<midi::input_event_handler>,
+            std::size_t fade_periods = 0) -> bool;
 
     void init_process(
             std::span<audio::pcm_input_buffer_converter const>,
@@ -57,6 +71,32 @@ public:
 
     void process(std::size_t buffer_size) noexcept;
 
+    //! Time the processing threads spent waiting, since the previous call.
+    //! Called from the audio thread, after processing.
+    [[nodiscard]] auto take_worker_idle_time() noexcept
+            -> std::chrono::nanoseconds;
+
+    //! Limits the number of worker threads used for processing.
+    void set_num_workers(std::size_t) noexcept;
+
+    //! Costs of the mixer channels and fx modules, since they were taken the
+    //! last time.
+    [[nodiscard]] auto take_processing_costs() -> processing_costs;
+
+    //! Records the execution of each processor, while enabled.
+    void set_tracing(bool) noexcept;
+
+    //! Moves the recorded execution out of the realtime buffers. Has to be
+    //! called periodically while tracing, to not lose events.
+    void drain_trace();
+
+    //! Writes the recorded execution as Chrome trace JSON. The events are
+    //! consumed, so consecutive calls only write new ones.
+    void write_trace(std::ostream&);
+
+    //! Writes the graph, which is currently executed, in dot format.
+    void write_graph(std::ostream&) const;
+
 private:
     struct impl;
     std::unique_ptr<impl> const m_impl;
@@ -4,16 +4,20 @@
 
 #pragma once
 
+#include <piejam/audio/engine/adaptive_worker_count.h>
 #include <piejam/audio/fwd.h>
 #include <piejam/ladspa/fwd.h>
 #include <piejam/runtime/actions/fwd.h>
+#include <piejam/runtime/audio_engine_structure.h>
 #include <piejam/runtime/fwd.h>
 #include <piejam/runtime/fx/ladspa_processor_factory.h>
 #include <piejam/thread/configuration.h>
 #include <piejam/thread/fwd.h>
 
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <span>
 #include <vector>
 
@@ -23,12 +27,17 @@ namespace piejam::runtime
 class audio_engine_middleware final
 {
 public:
+    //! With a rebuild fade, the outputs fed by recreated components are
+    //! faded over it on structural changes, while running in realtime.
+    //! About 10ms are short enough to keep the changes responsive and long
+    //! enough to not click. Off by default.
     audio_engine_middleware(
             thread::configuration const& audio_thread_config,
             std::span<const thread::configuration> wt_configs,
             audio::device_manager&,
             ladspa::processor_factory&,
-            std::unique_ptr<midi_input_controller>);
+            std::unique_ptr<midi_input_controller>,
+            std::chrono::milliseconds rebuild_fade = {});
     audio_engine_middleware(audio_engine_middleware&&) noexcept = default;
     ~audio_engine_middleware();
 
@@ -54,13 +63,21 @@ private:
 
     thread::configuration m_audio_thread_config;
     std::vector<thread::worker> m_workers;
+    audio::engine::adaptive_worker_count m_worker_count;
 
     audio::device_manager& m_device_manager;
     ladspa::processor_factory& m_ladspa_processor_factory;
     std::unique_ptr<midi_input_controller> m_midi_controller;
+    std::chrono::milliseconds m_rebuild_fade;
 
     std::unique_ptr<audio_engine> m_engine;
     std::unique_ptr<audio::device> m_device;
+
+    //! The structure of the running graph, rebuilds are skipped until it
+    //! changes.
+    std::optional<audio_engine_structure> m_engine_structure;
+
+    std::chrono::steady_clock::time_point m_last_processing_costs_update{};
 };
 
 } // namespace piejam::runtime
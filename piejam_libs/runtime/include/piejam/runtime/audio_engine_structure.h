@@ -0,0 +1,39 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/box.h>
+#include <piejam/runtime/device_io.h>
+#include <piejam/runtime/fwd.h>
+#include <piejam/runtime/fx/module.h>
+#include <piejam/runtime/midi_assignment.h>
+#include <piejam/runtime/mixer.h>
+#include <piejam/runtime/recorder.h>
+
+#include <optional>
+
+namespace piejam::runtime
+{
+
+//! The parts of the state, from which the audio engine graph is built.
+//! The maps share their storage with the state, comparing two structures
+//! is cheap, unless they were actually changed.
+struct audio_engine_structure
+{
+    explicit audio_engine_structure(state const&);
+
+    mixer::channels_t channels;
+    fx::modules_t fx_modules;
+    device_io::buses_t device_buses;
+    box<midi_assignments_map> midi_assignments;
+    std::optional<midi_assignment_id> midi_learning;
+    bool recording{};
+    unique_box<recorder_streams_t> recorder_streams;
+
+    auto operator==(audio_engine_structure const&) const noexcept
+            -> bool = default;
+};
+
+} // namespace piejam::runtime
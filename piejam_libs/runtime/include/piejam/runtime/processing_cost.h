@@ -0,0 +1,48 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/entity_id.h>
+#include <piejam/runtime/fx/fwd.h>
+#include <piejam/runtime/mixer_fwd.h>
+
+#include <boost/container/flat_map.hpp>
+
+#include <chrono>
+
+namespace piejam::runtime
+{
+
+//! Execution time per period. For groups of processors, these are the sums
+//! of the processors, so p99 and max are upper bounds.
+struct processing_cost
+{
+    std::chrono::nanoseconds mean{};
+    std::chrono::nanoseconds p99{};
+    std::chrono::nanoseconds max{};
+
+    constexpr auto operator+=(processing_cost const& other) noexcept
+            -> processing_cost&
+    {
+        mean += other.mean;
+        p99 += other.p99;
+        max += other.max;
+        return *this;
+    }
+
+    constexpr bool operator==(processing_cost const&) const noexcept = default;
+};
+
+struct processing_costs
+{
+    //! Including the fx modules of the channel.
+    boost::container::flat_map<mixer::channel_id, processing_cost>
+            mixer_channels;
+    boost::container::flat_map<fx::module_id, processing_cost> fx_modules;
+
+    bool operator==(processing_costs const&) const noexcept = default;
+};
+
+} // namespace piejam::runtime
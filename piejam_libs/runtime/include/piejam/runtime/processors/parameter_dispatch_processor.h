@@ -0,0 +1,310 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/audio/engine/event.h>
+#include <piejam/audio/engine/event_input_buffers.h>
+#include <piejam/audio/engine/event_output_buffers.h>
+#include <piejam/audio/engine/event_port.h>
+#include <piejam/audio/engine/named_processor.h>
+#include <piejam/audio/engine/process_context.h>
+#include <piejam/audio/engine/verify_process_context.h>
+#include <piejam/npos.h>
+#include <piejam/range/indices.h>
+#include <piejam/thread/spsc_snapshot.h>
+
+#include <boost/assert.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace piejam::runtime::processors
+{
+
+//! Dispatches the parameter changes of a period in a single task. The
+//! parameters are kept in a dense table, changes from the ui thread are
+//! passed through a single queue. Only changed parameters are sent as an
+//! event, to the processors listening to them.
+template <class... T>
+class parameter_dispatch_processor final : public audio::engine::named_processor
+{
+public:
+    using value_type = std::variant<T...>;
+
+    //! A listened parameter gets an event output. A driven one gets an
+    //! event input, through which other processors change it. Changes from
+    //! the event input are forwarded to the event output and published to
+    //! the ui thread.
+    struct parameter
+    {
+        std::string_view name{};
+        value_type value{};
+        bool initialized{};
+        bool listened{};
+        bool driven{};
+    };
+
+    static constexpr std::size_t default_queue_capacity{1024};
+
+    parameter_dispatch_processor(
+            std::span<parameter const> const params,
+            std::string_view const name = {},
+            std::size_t const queue_capacity = default_queue_capacity)
+        : named_processor(name)
+        , m_updates(count_driven(params))
+        , m_received(m_updates.size())
+        , m_commands(queue_capacity)
+    {
+        m_table.reserve(params.size());
+        m_dirty.reserve(params.size());
+
+        for (parameter const& param : params)
+        {
+            entry& e = m_table.emplace_back(entry{.value = param.value});
+
+            if (param.listened)
+            {
+                e.event_output = m_event_outputs.size();
+                m_event_outputs.push_back(make_event_port(param));
+
+                if (param.initialized)
+                {
+                    mark_dirty(m_table.size() - 1);
+                }
+            }
+
+            if (param.driven)
+            {
+                e.event_input = m_event_inputs.size();
+                m_event_inputs.push_back(make_event_port(param));
+                m_event_input_params.push_back(m_table.size() - 1);
+            }
+        }
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return m_table.size();
+    }
+
+    [[nodiscard]] auto event_output_port(std::size_t const index) const noexcept
+            -> std::size_t
+    {
+        BOOST_ASSERT(index < m_table.size());
+        return m_table[index].event_output;
+    }
+
+    [[nodiscard]] auto event_input_port(std::size_t const index) const noexcept
+            -> std::size_t
+    {
+        BOOST_ASSERT(index < m_table.size());
+        return m_table[index].event_input;
+    }
+
+    //! Called from the ui thread. If the queue is full, the change is kept
+    //! back until the next set or fetch_updates.
+    void set(std::size_t const index, value_type const& value)
+    {
+        BOOST_ASSERT(index < m_table.size());
+
+        flush_backlog();
+
+        command const cmd{.index = index, .value = value};
+        if (!m_backlog.empty() || !m_commands.push(cmd))
+        {
+            m_backlog.push_back(cmd);
+        }
+    }
+
+    //! Called from the ui thread. Copies out the driven parameters, which
+    //! were changed since the last fetch, in a single pass.
+    void fetch_updates()
+    {
+        flush_backlog();
+
+        m_updates.consume([this](std::size_t const port, value_type const& v) {
+            m_received[port] = v;
+        });
+    }
+
+    //! Called from the ui thread, with the last fetched change of a driven
+    //! parameter.
+    template <class V, class F>
+    void consume(std::size_t const index, F&& f)
+    {
+        BOOST_ASSERT(index < m_table.size());
+
+        if (std::size_t const port = m_table[index].event_input; port != npos)
+        {
+            if (auto& received = m_received[port]; received.has_value())
+            {
+                std::invoke(f, std::get<V>(*received));
+                received.reset();
+            }
+        }
+    }
+
+    [[nodiscard]] auto type_name() const noexcept -> std::string_view override
+    {
+        return "parameter_dispatch";
+    }
+
+    [[nodiscard]] auto num_inputs() const noexcept -> std::size_t override
+    {
+        return 0;
+    }
+
+    [[nodiscard]] auto num_outputs() const noexcept -> std::size_t override
+    {
+        return 0;
+    }
+
+    [[nodiscard]] auto event_inputs() const noexcept -> event_ports override
+    {
+        return m_event_inputs;
+    }
+
+    [[nodiscard]] auto event_outputs() const noexcept -> event_ports override
+    {
+        return m_event_outputs;
+    }
+
+    void process(audio::engine::process_context const& ctx) override
+    {
+        audio::engine::verify_process_context(*this, ctx);
+
+        m_commands.consume_all([this](command const& cmd) {
+            m_table[cmd.index].value = cmd.value;
+            mark_dirty(cmd.index);
+        });
+
+        for (std::size_t const index : m_dirty)
+        {
+            entry& e = m_table[index];
+            e.dirty = false;
+
+            std::visit(
+                    [&ctx, &e]<class V>(V const& value) {
+                        ctx.event_outputs.get<V>(e.event_output)
+                                .insert(0, value);
+                    },
+                    e.value);
+        }
+
+        m_dirty.clear();
+
+        if (m_event_input_params.empty())
+        {
+            return;
+        }
+
+        m_updates.update([&](auto& updates) {
+            for (std::size_t const port : range::indices(m_event_input_params))
+            {
+                entry& e = m_table[m_event_input_params[port]];
+
+                std::visit(
+                        [&]<class V>(V& value) {
+                            auto const& events = ctx.event_inputs.get<V>(port);
+                            if (events.empty())
+                            {
+                                return;
+                            }
+
+                            for (audio::engine::event<V> const& ev : events)
+                            {
+                                value = ev.value();
+
+                                if (e.event_output != npos)
+                                {
+                                    ctx.event_outputs.get<V>(e.event_output)
+                                            .insert(ev.offset(), ev.value());
+                                }
+                            }
+
+                            updates.set(port, e.value);
+                        },
+                        e.value);
+            }
+        });
+    }
+
+private:
+    struct entry
+    {
+        value_type value;
+        std::size_t event_output{npos};
+        std::size_t event_input{npos};
+        bool dirty{};
+    };
+
+    struct command
+    {
+        std::size_t index;
+        value_type value;
+    };
+
+    static auto make_event_port(parameter const& param)
+            -> audio::engine::event_port
+    {
+        return std::visit(
+                [&param]<class V>(V const&) {
+                    return audio::engine::event_port(
+                            std::in_place_type<V>,
+                            param.name);
+                },
+                param.value);
+    }
+
+    static auto count_driven(std::span<parameter const> const params)
+            -> std::size_t
+    {
+        return static_cast<std::size_t>(std::ranges::count_if(
+                params,
+                &parameter::driven));
+    }
+
+    void mark_dirty(std::size_t const index) noexcept
+    {
+        entry& e = m_table[index];
+        if (e.event_output != npos && !e.dirty)
+        {
+            e.dirty = true;
+            m_dirty.push_back(index);
+        }
+    }
+
+    void flush_backlog()
+    {
+        auto it = m_backlog.begin();
+        while (it != m_backlog.end() && m_commands.push(*it))
+        {
+            ++it;
+        }
+
+        m_backlog.erase(m_backlog.begin(), it);
+    }
+
+    std::vector<entry> m_table;
+    std::vector<std::size_t> m_dirty;
+
+    std::vector<audio::engine::event_port> m_event_inputs;
+    std::vector<audio::engine::event_port> m_event_outputs;
+    std::vector<std::size_t> m_event_input_params;
+
+    thread::spsc_snapshot<value_type> m_updates;
+    std::vector<std::optional<value_type>> m_received;
+
+    boost::lockfree::spsc_queue<command> m_commands;
+    std::vector<command> m_backlog;
+};
+
+} // namespace piejam::runtime::processors
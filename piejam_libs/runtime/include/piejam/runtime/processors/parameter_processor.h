@@ -0,0 +1,78 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/audio/engine/event_port.h>
+#include <piejam/audio/engine/named_processor.h>
+
+#include <boost/assert.hpp>
+
+#include <array>
+#include <typeinfo>
+#include <utility>
+
+namespace piejam::runtime::processors
+{
+
+//! Stands in for a parameter in the graph. Before the graph is executed,
+//! it is replaced by the ports of a parameter_dispatch_processor.
+class parameter_processor final : public audio::engine::named_processor
+{
+public:
+    template <class T>
+    parameter_processor(
+            std::in_place_type_t<T> t,
+            std::string_view const name = {})
+        : named_processor(name)
+        , m_event_inputs({audio::engine::event_port(t, "in")})
+        , m_event_outputs({audio::engine::event_port(t, "out")})
+    {
+    }
+
+    [[nodiscard]] auto type_name() const noexcept -> std::string_view override
+    {
+        return "parameter";
+    }
+
+    [[nodiscard]] auto num_inputs() const noexcept -> std::size_t override
+    {
+        return 0;
+    }
+
+    [[nodiscard]] auto num_outputs() const noexcept -> std::size_t override
+    {
+        return 0;
+    }
+
+    [[nodiscard]] auto event_inputs() const noexcept -> event_ports override
+    {
+        return m_event_inputs;
+    }
+
+    [[nodiscard]] auto event_outputs() const noexcept -> event_ports override
+    {
+        return m_event_outputs;
+    }
+
+    void process(audio::engine::process_context const&) override
+    {
+        BOOST_ASSERT_MSG(
+                false,
+                "Should be replaced by the parameter dispatch before "
+                "executing.");
+    }
+
+private:
+    std::array<audio::engine::event_port, 1> m_event_inputs;
+    std::array<audio::engine::event_port, 1> m_event_outputs;
+};
+
+inline auto
+is_parameter_processor(audio::engine::processor const& p) noexcept -> bool
+{
+    return typeid(p) == typeid(parameter_processor);
+}
+
+} // namespace piejam::runtime::processors
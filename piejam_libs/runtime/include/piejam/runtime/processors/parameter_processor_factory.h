@@ -4,18 +4,25 @@
 
 #pragma once
 
-#include <piejam/audio/engine/value_io_processor.h>
+#include <piejam/audio/engine/graph.h>
 #include <piejam/entity_id_hash.h>
 #include <piejam/runtime/parameter/fwd.h>
+#include <piejam/runtime/processors/parameter_dispatch_processor.h>
+#include <piejam/runtime/processors/parameter_processor.h>
 
 #include <boost/assert.hpp>
-#include <boost/mp11/tuple.hpp>
+#include <boost/mp11/algorithm.hpp>
+#include <boost/mp11/list.hpp>
 
+#include <algorithm>
 #include <concepts>
 #include <memory>
 #include <string_view>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace piejam::runtime::processors
 {
@@ -24,65 +31,258 @@ template <class... Parameter>
 class parameter_processor_factory
 {
 public:
-    template <class P>
-    using parameter_processor =
-            audio::engine::value_io_processor<typename P::value_type>;
+    using dispatch_processor = boost::mp11::mp_rename<
+            boost::mp11::mp_unique<
+                    boost::mp11::mp_list<typename Parameter::value_type...>>,
+            parameter_dispatch_processor>;
 
     template <class P>
     using processor_map = std::unordered_map<
             parameter::id_t<P>,
-            std::weak_ptr<parameter_processor<P>>>;
+            std::weak_ptr<parameter_processor>>;
+
+    //! Position of a parameter in the table of a dispatch processor.
+    struct dispatch_slot
+    {
+        bool listened{};
+        std::size_t index{};
+    };
 
+    template <class P>
+    using dispatch_slot_map =
+            std::unordered_map<parameter::id_t<P>, dispatch_slot>;
+
+    //! The listened parameters are dispatched by the first processor. The
+    //! ones which are only driven by other processors are collected by the
+    //! second one, so the graph stays acyclic, even if the driving
+    //! processors are listening to other parameters.
+    struct dispatch
+    {
+        std::unique_ptr<dispatch_processor> listened;
+        std::unique_ptr<dispatch_processor> driven;
+        std::tuple<dispatch_slot_map<Parameter>...> slots;
+    };
+
+    //! There is one parameter processor per parameter. It is shared by
+    //! all components using the parameter.
     template <class P>
     auto make_processor(parameter::id_t<P> id, std::string_view const name = {})
-            -> std::shared_ptr<parameter_processor<P>>
+            -> std::shared_ptr<parameter_processor>
     {
-        auto proc = std::make_shared<parameter_processor<P>>(name);
-        std::get<processor_map<P>>(m_procs).insert_or_assign(id, proc);
+        auto& weak_proc = std::get<processor_map<P>>(m_procs)[id];
+
+        auto proc = weak_proc.lock();
+        if (!proc)
+        {
+            proc = std::make_shared<parameter_processor>(
+                    std::in_place_type<typename P::value_type>,
+                    name);
+            weak_proc = proc;
+        }
+
         return proc;
     }
 
     template <class P>
     auto find_processor(parameter::id_t<P> id) const
-            -> std::shared_ptr<parameter_processor<P>>
+            -> std::shared_ptr<parameter_processor>
     {
         auto const& map = std::get<processor_map<P>>(m_procs);
         auto it = map.find(id);
         return it != map.end() ? it->second.lock() : nullptr;
     }
 
+    //! Replaces the parameter processors in the graph by the ports of the
+    //! dispatch processors. The listened parameters are initialized with
+    //! the values found by find_value.
     template <class FindValue>
-    void initialize(FindValue&& find_value) const
+    auto make_dispatch(audio::engine::graph& g, FindValue&& find_value) const
+            -> dispatch
     {
-        boost::mp11::tuple_for_each(m_procs, [&](auto&& procs) {
-            for (auto&& [id, weak_proc] : procs)
+        struct usage
+        {
+            bool listened{};
+            bool driven{};
+        };
+
+        std::unordered_map<audio::engine::processor const*, usage> used;
+        for (auto const& [src, dst] : g.event)
+        {
+            if (is_parameter_processor(src.proc.get()))
             {
-                if (auto proc = weak_proc.lock())
-                {
-                    if (auto const value = find_value(id); value)
+                used[&src.proc.get()].listened = true;
+            }
+
+            if (is_parameter_processor(dst.proc.get()))
+            {
+                used[&dst.proc.get()].driven = true;
+            }
+        }
+
+        dispatch result;
+
+        std::vector<typename dispatch_processor::parameter> listened_params;
+        std::vector<typename dispatch_processor::parameter> driven_params;
+        std::unordered_map<audio::engine::processor const*, dispatch_slot>
+                replaced;
+
+        boost::mp11::mp_for_each<
+                boost::mp11::mp_list<boost::mp11::mp_identity<Parameter>...>>(
+                [&](auto p) {
+                    using P = typename decltype(p)::type;
+                    using value_type = typename P::value_type;
+
+                    for (auto const& [id, weak_proc] :
+                         std::get<processor_map<P>>(m_procs))
                     {
-                        proc->set(*value);
+                        auto const proc = weak_proc.lock();
+                        if (!proc)
+                        {
+                            continue;
+                        }
+
+                        auto const it = used.find(proc.get());
+                        if (it == used.end())
+                        {
+                            continue;
+                        }
+
+                        typename dispatch_processor::parameter param{
+                                .name = proc->name(),
+                                .value = typename dispatch_processor::
+                                        value_type{
+                                                std::in_place_type<
+                                                        value_type>},
+                                .listened = it->second.listened,
+                                .driven = it->second.driven};
+
+                        if (param.listened)
+                        {
+                            if (auto const value = find_value(id); value)
+                            {
+                                param.value.template emplace<value_type>(
+                                        *value);
+                                param.initialized = true;
+                            }
+                        }
+
+                        auto& params = param.listened ? listened_params
+                                                      : driven_params;
+                        dispatch_slot const slot{
+                                .listened = param.listened,
+                                .index = params.size()};
+                        params.push_back(param);
+
+                        std::get<dispatch_slot_map<P>>(result.slots)
+                                .emplace(id, slot);
+                        replaced.emplace(proc.get(), slot);
                     }
+                });
+
+        result.listened = std::make_unique<dispatch_processor>(
+                listened_params,
+                "parameters");
+        result.driven = std::make_unique<dispatch_processor>(
+                driven_params,
+                "parameter_updates");
+
+        auto dispatch_endpoint = [&](audio::engine::processor const& proc,
+                                     bool const is_src) {
+            auto const it = replaced.find(&proc);
+            BOOST_ASSERT(it != replaced.end());
+
+            auto const& [listened, index] = it->second;
+            auto& dispatch_proc =
+                    listened ? *result.listened : *result.driven;
+
+            return audio::engine::graph_endpoint{
+                    .proc = dispatch_proc,
+                    .port = is_src ? dispatch_proc.event_output_port(index)
+                                   : dispatch_proc.event_input_port(index)};
+        };
+
+        std::vector<audio::engine::wire_t> rewired;
+        for (auto it = g.event.begin(); it != g.event.end();)
+        {
+            audio::engine::graph_endpoint src = it->first;
+            audio::engine::graph_endpoint dst = it->second;
+
+            bool const src_replaced = is_parameter_processor(src.proc.get());
+            bool const dst_replaced = is_parameter_processor(dst.proc.get());
+
+            if (src_replaced || dst_replaced)
+            {
+                if (src_replaced)
+                {
+                    src = dispatch_endpoint(src.proc.get(), true);
                 }
+
+                if (dst_replaced)
+                {
+                    dst = dispatch_endpoint(dst.proc.get(), false);
+                }
+
+                rewired.emplace_back(src, dst);
+                it = g.event.erase(it);
             }
-        });
+            else
+            {
+                ++it;
+            }
+        }
+
+        for (auto const& [src, dst] : rewired)
+        {
+            g.event.insert(src, dst);
+        }
+
+        return result;
+    }
+
+    //! Called, once the graph with the new dispatch is executed. Changes
+    //! and updates are passed through the new dispatch from then on.
+    void replace_dispatch(dispatch&& d) noexcept
+    {
+        m_dispatch = std::move(d);
     }
 
     template <class P, std::convertible_to<typename P::value_type> V>
-    void set(parameter::id_t<P> id, V&& value) const
+    void set(parameter::id_t<P> id, V&& value)
     {
-        if (auto proc = find_processor(id))
+        if (auto* const slot = find_slot(id))
+        {
+            dispatch_processor_of(*slot).set(
+                    slot->index,
+                    typename dispatch_processor::value_type{
+                            std::in_place_type<typename P::value_type>,
+                            std::forward<V>(value)});
+        }
+    }
+
+    //! Fetches the changes of the driven parameters, to be consumed
+    //! afterwards.
+    void fetch_updates()
+    {
+        if (m_dispatch.listened)
+        {
+            m_dispatch.listened->fetch_updates();
+        }
+
+        if (m_dispatch.driven)
         {
-            proc->set(std::forward<V>(value));
+            m_dispatch.driven->fetch_updates();
         }
     }
 
     template <class P, class F>
-    auto consume(parameter::id_t<P> id, F&& f) const
+    void consume(parameter::id_t<P> id, F&& f)
     {
-        if (auto proc = find_processor(id))
+        if (auto* const slot = find_slot(id))
         {
-            proc->consume(std::forward<F>(f));
+            dispatch_processor_of(*slot)
+                    .template consume<typename P::value_type>(
+                            slot->index,
+                            std::forward<F>(f));
         }
     }
 
@@ -97,6 +297,20 @@ public:
     }
 
 private:
+    template <class P>
+    auto find_slot(parameter::id_t<P> id) const -> dispatch_slot const*
+    {
+        auto const& map = std::get<dispatch_slot_map<P>>(m_dispatch.slots);
+        auto it = map.find(id);
+        return it != map.end() ? &it->second : nullptr;
+    }
+
+    auto dispatch_processor_of(dispatch_slot const& slot) const
+            -> dispatch_processor&
+    {
+        return slot.listened ? *m_dispatch.listened : *m_dispatch.driven;
+    }
+
     template <class P>
     static bool expired(typename processor_map<P>::value_type const& p) noexcept
     {
@@ -118,6 +332,7 @@ private:
     }
 
     std::tuple<processor_map<Parameter>...> m_procs;
+    dispatch m_dispatch;
 };
 
 template <class ProcessorFactory, class... P>
@@ -22,6 +22,7 @@
 #include <piejam/runtime/midi_assignment_id.h>
 #include <piejam/runtime/mixer_fwd.h>
 #include <piejam/runtime/parameters.h>
+#include <piejam/runtime/processing_cost.h>
 #include <piejam/runtime/stereo_level.h>
 
 #include <cstddef>
@@ -137,6 +138,9 @@ auto make_device_bus_name_selector(device_io::bus_id) -> selector<boxed_string>;
 auto make_mixer_channel_name_selector(mixer::channel_id)
         -> selector<boxed_string>;
 
+auto make_mixer_channel_processing_cost_selector(mixer::channel_id)
+        -> selector<processing_cost>;
+
 auto make_mixer_channel_can_move_left_selector(mixer::channel_id)
         -> selector<bool>;
 auto make_mixer_channel_can_move_right_selector(mixer::channel_id)
@@ -165,6 +169,8 @@ auto make_fx_module_name_selector(fx::module_id) -> selector<boxed_string>;
 auto make_fx_module_bus_type_selector(fx::module_id)
         -> selector<audio::bus_type>;
 auto make_fx_module_bypass_selector(fx::module_id) -> selector<bool>;
+auto make_fx_module_processing_cost_selector(fx::module_id)
+        -> selector<processing_cost>;
 auto make_fx_module_parameters_selector(fx::module_id)
         -> selector<box<fx::module_parameters>>;
 auto make_fx_module_can_move_up_selector(mixer::channel_id) -> selector<bool>;
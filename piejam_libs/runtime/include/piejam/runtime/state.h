@@ -6,6 +6,7 @@
 
 #include <piejam/audio/pcm_descriptor.h>
 #include <piejam/audio/pcm_hw_params.h>
+#include <piejam/audio/pcm_io_config.h>
 #include <piejam/audio/period_count.h>
 #include <piejam/audio/period_size.h>
 #include <piejam/audio/sample_rate.h>
@@ -33,6 +34,7 @@
 #include <piejam/runtime/parameter/map.h>
 #include <piejam/runtime/parameters.h>
 #include <piejam/runtime/parameters_map.h>
+#include <piejam/runtime/processing_cost.h>
 #include <piejam/runtime/recorder.h>
 #include <piejam/runtime/root_view_mode.h>
 #include <piejam/runtime/selected_device.h>
@@ -53,6 +55,11 @@ struct state
     selected_device input;
     selected_device output;
 
+    //! Devices on own clocks, whose channels are appended to the ones of
+    //! the selected devices. Not selectable in the app yet.
+    boxed_vector<audio::pcm_secondary_config> input_secondaries;
+    boxed_vector<audio::pcm_secondary_config> output_secondaries;
+
     audio::sample_rate sample_rate{};
     audio::period_size period_size{};
     audio::period_count period_count{};
@@ -84,6 +91,7 @@ struct state
 
     std::size_t xruns{};
     float cpu_load{};
+    box<processing_costs> processing_costs_;
 
     struct
     {
@@ -98,6 +106,12 @@ struct state
 
 auto make_initial_state() -> state;
 
+//! Channels of the selected device, followed by the ones of its secondaries.
+auto num_device_channels(state const&, io_direction) -> std::size_t;
+
+//! Configuration of the selected devices and their secondaries.
+auto make_pcm_io_config(state const&) -> audio::pcm_io_config;
+
 auto sample_rates(
         box<audio::pcm_hw_params> input_hw_params,
         box<audio::pcm_hw_params> output_hw_params) -> audio::sample_rates_t;
@@ -39,9 +39,7 @@ default_bus_name(state const& st, io_direction io_dir, audio::bus_type bus_type)
 auto
 default_channels(state const& st, io_direction io_dir, audio::bus_type bus_type)
 {
-    auto num_channels = io_dir == io_direction::input
-                                ? st.input.hw_params->num_channels
-                                : st.output.hw_params->num_channels;
+    auto num_channels = num_device_channels(st, io_dir);
 
     std::vector<bool> assigned_channels(num_channels);
 
@@ -48,12 +48,12 @@ apply_app_config::reduce(state& st) const
     apply_bus_configs<io_direction::input>(
             st,
             conf.input_bus_config,
-            st.input.hw_params->num_channels);
+            num_device_channels(st, io_direction::input));
 
     apply_bus_configs<io_direction::output>(
             st,
             conf.output_bus_config,
-            st.output.hw_params->num_channels);
+            num_device_channels(st, io_direction::output));
 
     st.rec_session = conf.rec_session;
 }
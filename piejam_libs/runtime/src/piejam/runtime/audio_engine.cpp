@@ -18,7 +18,9 @@
 #include <piejam/audio/engine/mix_processor.h>
 #include <piejam/audio/engine/output_processor.h>
 #include <piejam/audio/engine/process.h>
+#include <piejam/audio/engine/processor_timings.h>
 #include <piejam/audio/engine/stream_processor.h>
+#include <piejam/audio/engine/tracer.h>
 #include <piejam/audio/engine/value_io_processor.h>
 #include <piejam/audio/sample_rate.h>
 #include <piejam/midi/event.h>
@@ -43,6 +45,7 @@
 #include <piejam/runtime/solo_group.h>
 #include <piejam/runtime/state.h>
 #include <piejam/thread/configuration.h>
+#include <piejam/thread/realtime_scope.h>
 #include <piejam/thread/worker.h>
 
 #include <fmt/format.h>
@@ -51,8 +54,9 @@
 #include <boost/range/algorithm_ext/erase.hpp>
 
 #include <algorithm>
-#include <fstream>
+#include <iterator>
 #include <optional>
+#include <ostream>
 #include <ranges>
 #include <unordered_map>
 
@@ -62,6 +66,9 @@ namespace piejam::runtime
 namespace
 {
 
+// 64 frames per buffer keep a chain's intermediate buffers in the L1 cache.
+constexpr std::size_t tile_size = 64;
+
 enum class engine_processors
 {
     midi_input,
@@ -108,10 +115,113 @@ using recorders_t = std::unordered_map<
         mixer::channel_id,
         std::shared_ptr<audio::engine::processor>>;
 
+using processor_group = std::vector<audio::engine::processor const*>;
+
+struct mixer_channel_cost_group
+{
+    processor_group procs;
+    std::vector<fx::module_id> fx_modules;
+};
+
+//! Processors of the components, which make up the mixer channels and fx
+//! modules. Their timings are summed up to the processing costs.
+struct cost_groups
+{
+    std::vector<std::pair<mixer::channel_id, mixer_channel_cost_group>>
+            mixer_channels;
+    std::vector<std::pair<fx::module_id, processor_group>> fx_modules;
+};
+
+//! The processors of a component are found, by connecting it into an own
+//! graph.
+void
+append_processors(
+        audio::engine::component const& comp,
+        processor_group& procs)
+{
+    audio::engine::graph g;
+    comp.connect(g);
+
+    auto append = [&procs](audio::engine::processor const& proc) {
+        if (std::ranges::find(procs, &proc) == procs.end())
+        {
+            procs.push_back(&proc);
+        }
+    };
+
+    for (auto const endpoints :
+         {comp.inputs(),
+          comp.outputs(),
+          comp.event_inputs(),
+          comp.event_outputs()})
+    {
+        for (audio::engine::graph_endpoint const& ep : endpoints)
+        {
+            append(ep.proc);
+        }
+    }
+
+    auto append_wired = [&append](auto const& wires) {
+        for (auto const& [src, dst] : wires)
+        {
+            append(src.proc);
+            append(dst.proc);
+        }
+    };
+
+    append_wired(g.audio);
+    append_wired(g.event);
+}
+
+auto
+make_cost_groups(component_map const& comps, mixer::channels_t const& channels)
+        -> cost_groups
+{
+    cost_groups groups;
+
+    for (auto const& [mixer_channel_id, mixer_channel] : channels)
+    {
+        mixer_channel_cost_group channel_group;
+
+        if (auto const comp = comps.find(mixer_input_key{
+                    .channel_id = mixer_channel_id,
+                    .route = mixer_channel.in}))
+        {
+            append_processors(*comp, channel_group.procs);
+        }
+
+        if (auto const comp = comps.find(
+                    mixer_output_key{.channel_id = mixer_channel_id}))
+        {
+            append_processors(*comp, channel_group.procs);
+        }
+
+        for (fx::module_id const fx_mod_id : *mixer_channel.fx_chain)
+        {
+            if (auto const comp = comps.find(fx_mod_id))
+            {
+                processor_group fx_procs;
+                append_processors(*comp, fx_procs);
+                groups.fx_modules.emplace_back(fx_mod_id, std::move(fx_procs));
+                channel_group.fx_modules.push_back(fx_mod_id);
+            }
+        }
+
+        groups.mixer_channels.emplace_back(
+                mixer_channel_id,
+                std::move(channel_group));
+    }
+
+    return groups;
+}
+
+using created_components = std::vector<audio::engine::component const*>;
+
 void
 make_mixer_components(
         component_map& comps,
         component_map& prev_comps,
+        created_components& created,
         audio::sample_rate const sample_rate,
         mixer::channels_t const& channels,
         parameter_processor_factory& param_procs)
@@ -127,9 +237,9 @@ make_mixer_components(
         }
         else
         {
-            comps.insert(
-                    in_key,
-                    components::make_mixer_channel_input(mixer_channel));
+            auto in_comp = components::make_mixer_channel_input(mixer_channel);
+            created.push_back(in_comp.get());
+            comps.insert(in_key, std::move(in_comp));
         }
 
         mixer_output_key const out_key{.channel_id = mixer_channel_id};
@@ -139,12 +249,12 @@ make_mixer_components(
         }
         else
         {
-            comps.insert(
-                    out_key,
-                    components::make_mixer_channel_output(
-                            mixer_channel,
-                            param_procs,
-                            sample_rate));
+            auto out_comp = components::make_mixer_channel_output(
+                    mixer_channel,
+                    param_procs,
+                    sample_rate);
+            created.push_back(out_comp.get());
+            comps.insert(out_key, std::move(out_comp));
         }
     }
 }
@@ -167,6 +277,7 @@ auto
 make_fx_chain_components(
         component_map& comps,
         component_map& prev_comps,
+        created_components& created,
         fx::modules_t const& fx_modules,
         ui_parameter_descriptors_map const& ui_params,
         parameter_processor_factory& param_procs,
@@ -205,6 +316,7 @@ make_fx_chain_components(
                     sample_rate);
             if (comp)
             {
+                created.push_back(comp.get());
                 comps.insert(fx_mod_id, std::move(comp));
             }
         }
@@ -555,6 +667,34 @@ make_graph(
     return g;
 }
 
+//! Indices of the output processors fed by any of the components.
+auto
+fed_outputs(
+        audio::engine::graph const& g,
+        std::span<audio::engine::component const* const> const comps,
+        std::span<audio::engine::output_processor const> const output_procs)
+        -> std::vector<std::size_t>
+{
+    std::vector<audio::engine::graph_endpoint> comp_outputs;
+    for (audio::engine::component const* const comp : comps)
+    {
+        std::ranges::copy(comp->outputs(), std::back_inserter(comp_outputs));
+    }
+
+    auto const fed = audio::engine::downstream_processors(g, comp_outputs);
+
+    std::vector<std::size_t> result;
+    for (std::size_t output = 0; output < output_procs.size(); ++output)
+    {
+        if (fed.contains(&output_procs[output]))
+        {
+            result.push_back(output);
+        }
+    }
+
+    return result;
+}
+
 void
 connect_midi(
         audio::engine::graph& g,
@@ -662,8 +802,12 @@ struct audio_engine::impl
     impl(audio::sample_rate const sr,
          std::span<thread::worker> const workers,
          std::size_t num_device_input_channels,
-         std::size_t num_device_output_channels)
+         std::size_t num_device_output_channels,
+         audio::engine::dag::scheduling sched)
         : sample_rate(sr)
+        , scheduling(sched)
+        , tracer(workers.size() + 1)
+        , process(num_device_output_channels)
         , worker_threads(workers)
         , input_procs(make_io_processors<audio::engine::input_processor>(
                   num_device_input_channels))
@@ -672,10 +816,18 @@ struct audio_engine::impl
         , output_clip_procs(
                   std::vector<processor_ptr>(num_device_output_channels))
     {
+        for (std::size_t output = 0; output < output_procs.size(); ++output)
+        {
+            output_procs[output].set_gain(process.output_gain(output));
+        }
     }
 
     audio::sample_rate sample_rate;
 
+    audio::engine::dag::scheduling scheduling;
+    audio::engine::processor_timings processor_timings;
+    audio::engine::tracer tracer;
+
     audio::engine::process process;
     std::span<thread::worker> worker_threads;
 
@@ -683,7 +835,7 @@ struct audio_engine::impl
     std::vector<audio::engine::output_processor> output_procs;
 
     std::vector<processor_ptr> output_clip_procs;
-    std::vector<processor_ptr> mixer_procs;
+    audio::engine::mix_processors mixer_procs;
     value_io_processor_ptr<midi::external_event> midi_learn_output_proc;
 
     processor_map procs;
@@ -695,18 +847,22 @@ struct audio_engine::impl
     recorders_t recorders;
 
     audio::engine::graph graph;
+    audio::engine::job_cache jobs;
+    cost_groups costs;
 };
 
 audio_engine::audio_engine(
         std::span<thread::worker> const workers,
         audio::sample_rate const sample_rate,
         unsigned const num_device_input_channels,
-        unsigned const num_device_output_channels)
+        unsigned const num_device_output_channels,
+        audio::engine::dag::scheduling const scheduling)
     : m_impl(std::make_unique<impl>(
               sample_rate,
               workers,
               num_device_input_channels,
-              num_device_output_channels))
+              num_device_output_channels,
+              scheduling))
 {
 }
 
@@ -730,6 +886,12 @@ audio_engine::set_parameter_value(float_parameter_id, float const&) const;
 template void
 audio_engine::set_parameter_value(int_parameter_id, int const&) const;
 
+void
+audio_engine::fetch_parameter_updates() const
+{
+    m_impl->param_procs.fetch_updates();
+}
+
 template <class P>
 auto
 audio_engine::get_parameter_update(parameter::id_t<P> const id) const
@@ -785,19 +947,23 @@ bool
 audio_engine::rebuild(
         state const& st,
         fx::simple_ladspa_processor_factory const& ladspa_fx_proc_factory,
-        std::unique_ptr<midi::input_event_handler> midi_in)
+        std::unique_ptr<midi::input_event_handler> midi_in,
+        std::size_t const fade_periods)
 {
     component_map comps;
+    created_components created_comps;
 
     make_mixer_components(
             comps,
             m_impl->comps,
+            created_comps,
             m_impl->sample_rate,
             st.mixer_state.channels,
             m_impl->param_procs);
     make_fx_chain_components(
             comps,
             m_impl->comps,
+            created_comps,
             st.fx_modules,
             st.ui_params,
             m_impl->param_procs,
@@ -807,11 +973,6 @@ audio_engine::rebuild(
     auto const solo_groups = runtime::solo_groups(st.mixer_state.channels);
     make_solo_group_components(comps, solo_groups, m_impl->param_procs);
 
-    m_impl->param_procs.initialize([&st](auto const id) {
-        auto const* const desc = st.params.find(id);
-        return desc ? std::optional{desc->value.get()} : std::nullopt;
-    });
-
     processor_map procs;
 
     bool const midi_learn = static_cast<bool>(st.midi_learning);
@@ -857,35 +1018,59 @@ audio_engine::rebuild(
 
     connect_solo_groups(new_graph, comps, solo_groups);
 
-    auto [final_graph, mixers] = audio::engine::finalize_graph(new_graph);
+    auto const faded_outputs =
+            fade_periods > 0 ? fed_outputs(
+                                       new_graph,
+                                       created_comps,
+                                       m_impl->output_procs)
+                             : std::vector<std::size_t>{};
+
+    auto param_dispatch = m_impl->param_procs.make_dispatch(
+            new_graph,
+            [&st](auto const id) {
+                auto const* const desc = st.params.find(id);
+                return desc ? std::optional{desc->value.get()} : std::nullopt;
+            });
 
+    // Only the changed part of the graph gets new mixers and jobs, the rest
+    // is reused.
+    auto [final_graph, mixers] =
+            audio::engine::finalize_graph(new_graph, m_impl->mixer_procs);
+    audio::engine::job_cache jobs{m_impl->jobs};
+
+    // Timings are the cost estimates for the static schedule and are
+    // published as processing costs.
     if (!m_impl->process.swap_executor(
-                audio::engine::graph_to_dag(final_graph)
-                        .make_runnable(m_impl->worker_threads)))
+                audio::engine::graph_to_dag(
+                        final_graph,
+                        &m_impl->processor_timings,
+                        tile_size,
+                        &jobs)
+                        .make_runnable(
+                                m_impl->worker_threads,
+                                1u << 16,
+                                m_impl->scheduling,
+                                &m_impl->tracer),
+                faded_outputs.empty() ? 0 : fade_periods,
+                faded_outputs))
     {
         return false;
     }
 
     m_impl->graph = std::move(final_graph);
+    m_impl->jobs = std::move(jobs);
     m_impl->output_clip_procs = std::move(output_clip_procs);
     m_impl->mixer_procs = std::move(mixers);
     m_impl->midi_learn_output_proc = std::move(midi_learn_output_proc);
     m_impl->procs = std::move(procs);
     m_impl->comps = std::move(comps);
     m_impl->recorders = std::move(recorders);
+    m_impl->costs = make_cost_groups(m_impl->comps, st.mixer_state.channels);
 
+    m_impl->param_procs.replace_dispatch(std::move(param_dispatch));
     m_impl->param_procs.clear_expired();
     m_impl->stream_procs.clear_expired();
-
-    {
-        std::ofstream os("graph.dot");
-        audio::engine::export_graph_as_dot(new_graph, os) << std::endl;
-    }
-
-    {
-        std::ofstream os("final_graph.dot");
-        audio::engine::export_graph_as_dot(m_impl->graph, os) << std::endl;
-    }
+    m_impl->processor_timings.retain(m_impl->graph);
 
     return true;
 }
@@ -911,7 +1096,78 @@ audio_engine::init_process(
 void
 audio_engine::process(std::size_t const buffer_size) noexcept
 {
+    thread::realtime_scope const realtime;
     m_impl->process(buffer_size);
 }
 
+auto
+audio_engine::take_worker_idle_time() noexcept -> std::chrono::nanoseconds
+{
+    return m_impl->process.take_idle_time();
+}
+
+void
+audio_engine::set_num_workers(std::size_t const num_workers) noexcept
+{
+    m_impl->process.set_num_workers(num_workers);
+}
+
+auto
+audio_engine::take_processing_costs() -> processing_costs
+{
+    auto take_cost = [this](processor_group const& procs) {
+        processing_cost cost;
+        for (audio::engine::processor const* const proc : procs)
+        {
+            auto const stats = m_impl->processor_timings.take_statistics(*proc);
+            cost += {.mean = stats.mean, .p99 = stats.p99, .max = stats.max};
+        }
+        return cost;
+    };
+
+    processing_costs costs;
+
+    for (auto const& [fx_mod_id, procs] : m_impl->costs.fx_modules)
+    {
+        costs.fx_modules.emplace(fx_mod_id, take_cost(procs));
+    }
+
+    for (auto const& [mixer_channel_id, group] : m_impl->costs.mixer_channels)
+    {
+        processing_cost cost = take_cost(group.procs);
+        for (fx::module_id const fx_mod_id : group.fx_modules)
+        {
+            cost += costs.fx_modules.at(fx_mod_id);
+        }
+
+        costs.mixer_channels.emplace(mixer_channel_id, cost);
+    }
+
+    return costs;
+}
+
+void
+audio_engine::set_tracing(bool const enabled) noexcept
+{
+    m_impl->tracer.set_enabled(enabled);
+}
+
+void
+audio_engine::drain_trace()
+{
+    m_impl->tracer.drain();
+}
+
+void
+audio_engine::write_trace(std::ostream& out)
+{
+    m_impl->tracer.write_chrome_trace(out);
+}
+
+void
+audio_engine::write_graph(std::ostream& out) const
+{
+    audio::engine::export_graph_as_dot(m_impl->graph, out) << std::endl;
+}
+
 } // namespace piejam::runtime
@@ -11,6 +11,7 @@
 #include <piejam/runtime/actions/deactivate_midi_device.h>
 #include <piejam/runtime/actions/delete_bus.h>
 #include <piejam/runtime/actions/delete_fx_module.h>
+#include <piejam/runtime/actions/export_graph.h>
 #include <piejam/runtime/actions/fx_chain_actions.h>
 #include <piejam/runtime/actions/initiate_device_selection.h>
 #include <piejam/runtime/actions/insert_fx_module.h>
@@ -24,6 +25,7 @@
 #include <piejam/runtime/actions/select_period_size.h>
 #include <piejam/runtime/actions/select_sample_rate.h>
 #include <piejam/runtime/actions/set_parameter_value.h>
+#include <piejam/runtime/actions/tracing.h>
 #include <piejam/runtime/actions/update_parameter_values.h>
 #include <piejam/runtime/actions/update_streams.h>
 #include <piejam/runtime/audio_engine.h>
@@ -44,6 +46,7 @@
 #include <piejam/audio/pcm_descriptor.h>
 #include <piejam/audio/pcm_hw_params.h>
 #include <piejam/audio/pcm_io_config.h>
+#include <piejam/audio/period_history.h>
 #include <piejam/ladspa/plugin.h>
 #include <piejam/ladspa/plugin_descriptor.h>
 #include <piejam/ladspa/port_descriptor.h>
@@ -59,6 +62,10 @@
 #include <boost/mp11/tuple.hpp>
 #include <boost/range/algorithm_ext/erase.hpp>
 
+#include <algorithm>
+#include <fstream>
+#include <span>
+
 namespace piejam::runtime
 {
 
@@ -97,7 +104,8 @@ struct update_devices final
 
         st.device_io_state.buses.update(
                 *st.device_io_state.inputs,
-                [num_in_channels = input.hw_params->num_channels](
+                [num_in_channels =
+                         num_device_channels(st, io_direction::input)](
                         device_io::bus_id,
                         device_io::bus& bus) {
                     update_channel(bus.channels.left, num_in_channels);
@@ -106,7 +114,8 @@ struct update_devices final
 
         st.device_io_state.buses.update(
                 *st.device_io_state.outputs,
-                [num_out_channels = output.hw_params->num_channels](
+                [num_out_channels =
+                         num_device_channels(st, io_direction::output)](
                         device_io::bus_id,
                         device_io::bus& bus) {
                     update_channel(bus.channels.left, num_out_channels);
@@ -127,6 +136,75 @@ struct update_info final : ui::cloneable_action<update_info, reducible_action>
     }
 };
 
+struct update_processing_costs final
+    : ui::cloneable_action<update_processing_costs, reducible_action>
+{
+    box<processing_costs> costs;
+
+    void reduce(state& st) const override
+    {
+        st.processing_costs_ = costs;
+    }
+};
+
+// Long enough to have a meaningful p99, even with large periods.
+constexpr std::chrono::seconds processing_costs_update_interval{1};
+
+auto
+rebuild_fade_periods(
+        state const& st,
+        std::chrono::milliseconds const rebuild_fade) -> std::size_t
+{
+    if (rebuild_fade == std::chrono::milliseconds::zero())
+    {
+        return 0;
+    }
+
+    std::size_t const period_size = st.period_size.get();
+    return std::max<std::size_t>(
+            1,
+            (st.sample_rate.to_samples(rebuild_fade) + period_size - 1) /
+                    period_size);
+}
+
+//! A late wakeup points to scheduling latency, a process time beyond the
+//! deadline to processing overload.
+void
+log_xrun_capture(
+        std::span<audio::period_record const> const records,
+        std::size_t const missed_captures,
+        state const& st)
+{
+    if (records.empty())
+    {
+        return;
+    }
+
+    auto to_us = [](auto const duration) {
+        return std::chrono::duration<double, std::micro>(duration).count();
+    };
+
+    spdlog::warn(
+            "xrun captured, period deadline {:.1f} us, {} captures missed",
+            to_us(st.sample_rate.to_nanoseconds<double>(
+                    st.period_size.get())),
+            missed_captures);
+
+    for (audio::period_record const& record : records)
+    {
+        spdlog::warn(
+                "period {}: wakeup {:.1f} us, read {:.1f} us, "
+                "process {:.1f} us, write {:.1f} us, worker idle {:.1f} us{}",
+                record.period,
+                to_us(record.wakeup_latency),
+                to_us(record.read),
+                to_us(record.process),
+                to_us(record.write),
+                to_us(record.worker_idle),
+                record.xrun ? ", xrun" : "");
+    }
+}
+
 } // namespace
 
 audio_engine_middleware::audio_engine_middleware(
@@ -134,14 +212,17 @@ audio_engine_middleware::audio_engine_middleware(
         std::span<thread::configuration const> const wt_configs,
         audio::device_manager& device_manager,
         ladspa::processor_factory& ladspa_processor_factory,
-        std::unique_ptr<midi_input_controller> midi_controller)
+        std::unique_ptr<midi_input_controller> midi_controller,
+        std::chrono::milliseconds const rebuild_fade)
     : m_audio_thread_config(audio_thread_config)
     , m_workers(wt_configs.begin(), wt_configs.end())
+    , m_worker_count(m_workers.size())
     , m_device_manager(device_manager)
     , m_ladspa_processor_factory(ladspa_processor_factory)
     , m_midi_controller(
               midi_controller ? std::move(midi_controller)
                               : make_dummy_midi_input_controller())
+    , m_rebuild_fade(rebuild_fade)
     , m_device(audio::make_dummy_device())
 {
 }
@@ -399,6 +480,10 @@ audio_engine_middleware::process_device_action(
     if (m_midi_controller->activate_input_device(action.device_id))
     {
         mw_fs.next(action);
+
+        // the midi input of the engine is bound to the active devices
+        m_engine_structure.reset();
+        rebuild(mw_fs);
     }
 }
 
@@ -410,6 +495,9 @@ audio_engine_middleware::process_device_action(
 {
     m_midi_controller->deactivate_input_device(action.device_id);
     mw_fs.next(action);
+
+    m_engine_structure.reset();
+    rebuild(mw_fs);
 }
 
 template <class Action>
@@ -444,6 +532,8 @@ audio_engine_middleware::process_engine_action(
 {
     if (m_engine)
     {
+        m_engine->fetch_parameter_updates();
+
         actions::update_parameter_values next_action;
 
         boost::mp11::tuple_for_each(
@@ -532,11 +622,37 @@ audio_engine_middleware::process_engine_action(
         next_action.xruns = m_device->xruns();
         next_action.cpu_load = m_device->cpu_load();
 
+        if (auto* const history = m_device->period_history())
+        {
+            log_xrun_capture(
+                    history->take_capture(),
+                    history->missed_captures(),
+                    mw_fs.get_state());
+        }
+
+        if (m_engine)
+        {
+            m_engine->set_num_workers(
+                    m_worker_count.update(next_action.cpu_load));
+            m_engine->drain_trace();
+        }
+
         mw_fs.next(next_action);
     }
 
     if (m_engine)
     {
+        auto const now = std::chrono::steady_clock::now();
+        if (now - m_last_processing_costs_update >=
+            processing_costs_update_interval)
+        {
+            m_last_processing_costs_update = now;
+
+            update_processing_costs next_action;
+            next_action.costs = m_engine->take_processing_costs();
+            mw_fs.next(next_action);
+        }
+
         if (auto learned_midi = m_engine->get_learned_midi())
         {
             if (auto const* const cc_event =
@@ -561,6 +677,58 @@ audio_engine_middleware::process_engine_action(
     }
 }
 
+template <>
+void
+audio_engine_middleware::process_engine_action(
+        middleware_functors const&,
+        actions::start_tracing const&)
+{
+    if (m_engine)
+    {
+        m_engine->set_tracing(true);
+    }
+}
+
+template <>
+void
+audio_engine_middleware::process_engine_action(
+        middleware_functors const&,
+        actions::stop_tracing const& a)
+{
+    if (m_engine)
+    {
+        m_engine->set_tracing(false);
+
+        std::ofstream os(a.file);
+        if (!os)
+        {
+            spdlog::error("Could not open trace file {}.", a.file.string());
+            return;
+        }
+
+        m_engine->write_trace(os);
+    }
+}
+
+template <>
+void
+audio_engine_middleware::process_engine_action(
+        middleware_functors const&,
+        actions::export_graph const& a)
+{
+    if (m_engine)
+    {
+        std::ofstream os(a.file);
+        if (!os)
+        {
+            spdlog::error("Could not open graph file {}.", a.file.string());
+            return;
+        }
+
+        m_engine->write_graph(os);
+    }
+}
+
 void
 audio_engine_middleware::close_device()
 {
@@ -569,6 +737,7 @@ audio_engine_middleware::close_device()
     // The engine is executed by a device, we can safely destroy it after device
     // was closed.
     m_engine.reset();
+    m_engine_structure.reset();
 }
 
 void
@@ -588,19 +757,7 @@ audio_engine_middleware::open_device(middleware_functors const& mw_fs)
         auto device = m_device_manager.make_device(
                 st.pcm_devices->inputs[st.input.index],
                 st.pcm_devices->outputs[st.output.index],
-                audio::pcm_io_config{
-                        audio::pcm_device_config{
-                                st.input.hw_params->interleaved,
-                                st.input.hw_params->format,
-                                st.input.hw_params->num_channels},
-                        audio::pcm_device_config{
-                                st.output.hw_params->interleaved,
-                                st.output.hw_params->format,
-                                st.output.hw_params->num_channels},
-                        audio::pcm_process_config{
-                                st.sample_rate,
-                                st.period_size,
-                                st.period_count}});
+                make_pcm_io_config(st));
         m_device.swap(device);
     }
     catch (std::exception const& err)
@@ -619,19 +776,30 @@ audio_engine_middleware::start_engine(middleware_functors const& mw_fs)
     {
         auto const& state = mw_fs.get_state();
 
+        auto const io_config = make_pcm_io_config(state);
+
         m_engine = std::make_unique<audio_engine>(
                 m_workers,
                 state.sample_rate,
-                state.input.hw_params->num_channels,
-                state.output.hw_params->num_channels);
+                io_config.num_input_channels(),
+                io_config.num_output_channels());
+        m_engine->set_num_workers(m_worker_count.value());
+        m_engine_structure.reset();
 
         m_device->start(
                 m_audio_thread_config,
                 [engine = m_engine.get()](auto const& in, auto const& out) {
                     engine->init_process(in, out);
                 },
-                [engine = m_engine.get()](auto const buffer_size) {
+                [engine = m_engine.get(),
+                 history = m_device->period_history()](auto const buffer_size) {
                     engine->process(buffer_size);
+
+                    if (history)
+                    {
+                        history->add_worker_idle(
+                                engine->take_worker_idle_time());
+                    }
                 });
 
         rebuild(mw_fs);
@@ -647,12 +815,26 @@ audio_engine_middleware::rebuild(middleware_functors const& mw_fs)
     }
 
     auto const& st = mw_fs.get_state();
-    if (!m_engine->rebuild(
+
+    audio_engine_structure structure(st);
+    if (structure == m_engine_structure)
+    {
+        return;
+    }
+
+    if (m_engine->rebuild(
                 st,
                 [this, sr = st.sample_rate](ladspa::instance_id id) {
                     return m_ladspa_processor_factory.make_processor(id, sr);
                 },
-                m_midi_controller->make_input_event_handler()))
+                m_midi_controller->make_input_event_handler(),
+                m_engine_structure && m_device->is_realtime()
+                        ? rebuild_fade_periods(st, m_rebuild_fade)
+                        : 0))
+    {
+        m_engine_structure = std::move(structure);
+    }
+    else
     {
         spdlog::error("Rebuilding audio engine graph failed.");
     }
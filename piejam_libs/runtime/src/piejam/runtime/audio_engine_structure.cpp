@@ -0,0 +1,23 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/runtime/audio_engine_structure.h>
+
+#include <piejam/runtime/state.h>
+
+namespace piejam::runtime
+{
+
+audio_engine_structure::audio_engine_structure(state const& st)
+    : channels(st.mixer_state.channels)
+    , fx_modules(st.fx_modules)
+    , device_buses(st.device_io_state.buses)
+    , midi_assignments(st.midi_assignments)
+    , midi_learning(st.midi_learning)
+    , recording(st.recording)
+    , recorder_streams(st.recorder_streams)
+{
+}
+
+} // namespace piejam::runtime
@@ -141,18 +141,14 @@ public:
     }
 
 private:
-    std::shared_ptr<audio::engine::value_io_processor<float>>
-            m_volume_input_proc;
-    std::shared_ptr<audio::engine::value_io_processor<float>>
-            m_pan_balance_input_proc;
-    std::shared_ptr<audio::engine::value_io_processor<bool>> m_mute_input_proc;
+    std::shared_ptr<audio::engine::processor> m_volume_input_proc;
+    std::shared_ptr<audio::engine::processor> m_pan_balance_input_proc;
+    std::shared_ptr<audio::engine::processor> m_mute_input_proc;
     std::unique_ptr<audio::engine::component> m_volume_pan_balance;
     std::unique_ptr<audio::engine::component> m_mute_solo;
     std::unique_ptr<audio::engine::component> m_level_meter;
-    std::shared_ptr<audio::engine::value_io_processor<stereo_level>>
-            m_peak_level_proc;
-    std::shared_ptr<audio::engine::value_io_processor<stereo_level>>
-            m_rms_level_proc;
+    std::shared_ptr<audio::engine::processor> m_peak_level_proc;
+    std::shared_ptr<audio::engine::processor> m_rms_level_proc;
 
     std::array<audio::engine::graph_endpoint, 1> m_event_inputs{
             {m_mute_solo->event_inputs()[1]}};
@@ -6,6 +6,7 @@
 
 #include <piejam/io_pair.h>
 
+#include <boost/container/flat_map.hpp>
 #include <boost/hof/unpack.hpp>
 
 #include <algorithm>
@@ -32,6 +32,7 @@
 #include <boost/mp11/map.hpp>
 
 #include <cmath>
+#include <limits>
 #include <numbers>
 
 namespace piejam::runtime::modules::filter
@@ -202,6 +203,17 @@ public:
         return {};
     }
 
+    auto in_place_input(std::size_t const /*output*/) const noexcept
+            -> std::optional<std::size_t> override
+    {
+        return 0;
+    }
+
+    auto tail_length() const noexcept -> std::optional<std::size_t> override
+    {
+        return m_tail_length;
+    }
+
     void process(audio::engine::process_context const& ctx) override
     {
         verify_process_context(*this, ctx);
@@ -257,6 +269,13 @@ public:
 
         m_biquad_first.coeffs = ev.value().coeffs;
 
+        constexpr std::size_t max_decay_length =
+                std::numeric_limits<std::size_t>::max();
+        std::size_t const decay_length =
+                m_type == type::bypass
+                        ? 0
+                        : biqflt::decay_length<float>(ev.value().coeffs);
+
         switch (m_type)
         {
             case type::lp4:
@@ -264,11 +283,16 @@ public:
             case type::hp4:
                 m_biquad_second.coeffs = ev.value().coeffs;
                 m_process_sample = &processor::process_sample;
+                // two cascaded biquads, an unstable one is never bypassed
+                m_tail_length = decay_length > max_decay_length / 2
+                                        ? max_decay_length
+                                        : 2 * decay_length;
                 break;
 
             default:
                 m_biquad_second.coeffs = {};
                 m_process_sample = &processor::process_sample_first_only;
+                m_tail_length = decay_length;
                 break;
         }
     }
@@ -285,6 +309,7 @@ public:
 
 private:
     type m_type{type::bypass};
+    std::size_t m_tail_length{};
     audio::dsp::biquad<float> m_biquad_first;
     audio::dsp::biquad<float> m_biquad_second;
     using process_sample_t = float (processor::*)(float);
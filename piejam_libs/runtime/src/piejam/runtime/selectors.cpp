@@ -69,12 +69,12 @@ make_num_device_channels_selector(io_direction const bd)
     {
         case io_direction::input:
             return selector<std::size_t>([](state const& st) -> std::size_t {
-                return st.input.hw_params->num_channels;
+                return num_device_channels(st, io_direction::input);
             });
 
         case io_direction::output:
             return selector<std::size_t>([](state const& st) -> std::size_t {
-                return st.output.hw_params->num_channels;
+                return num_device_channels(st, io_direction::output);
             });
     }
 }
@@ -453,6 +453,18 @@ make_mixer_channel_name_selector(mixer::channel_id const channel_id)
     };
 }
 
+auto
+make_mixer_channel_processing_cost_selector(mixer::channel_id const channel_id)
+        -> selector<processing_cost>
+{
+    return [channel_id](state const& st) -> processing_cost {
+        auto const it = st.processing_costs_->mixer_channels.find(channel_id);
+        return it != st.processing_costs_->mixer_channels.end()
+                       ? it->second
+                       : processing_cost{};
+    };
+}
+
 auto
 make_mixer_channel_can_move_left_selector(mixer::channel_id const channel_id)
         -> selector<bool>
@@ -659,6 +671,18 @@ make_fx_module_bypass_selector(fx::module_id const fx_mod_id) -> selector<bool>
     };
 }
 
+auto
+make_fx_module_processing_cost_selector(fx::module_id const fx_mod_id)
+        -> selector<processing_cost>
+{
+    return [fx_mod_id](state const& st) -> processing_cost {
+        auto const it = st.processing_costs_->fx_modules.find(fx_mod_id);
+        return it != st.processing_costs_->fx_modules.end()
+                       ? it->second
+                       : processing_cost{};
+    };
+}
+
 auto
 make_fx_module_parameters_selector(fx::module_id const fx_mod_id)
         -> selector<box<fx::module_parameters>>
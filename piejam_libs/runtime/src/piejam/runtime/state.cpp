@@ -114,6 +114,47 @@ make_initial_state() -> state
     return st;
 }
 
+auto
+num_device_channels(state const& st, io_direction const io_dir)
+        -> std::size_t
+{
+    switch (io_dir)
+    {
+        case io_direction::input:
+            return audio::aggregate_num_channels(
+                    st.input.hw_params->num_channels,
+                    *st.input_secondaries);
+
+        case io_direction::output:
+            return audio::aggregate_num_channels(
+                    st.output.hw_params->num_channels,
+                    *st.output_secondaries);
+    }
+}
+
+auto
+make_pcm_io_config(state const& st) -> audio::pcm_io_config
+{
+    auto device_config = [](audio::pcm_hw_params const& hw_params) {
+        return audio::pcm_device_config{
+                .interleaved = hw_params.interleaved,
+                .mmap = hw_params.mmap,
+                .format = hw_params.format,
+                .num_channels = hw_params.num_channels};
+    };
+
+    return audio::pcm_io_config{
+            .in_config = device_config(st.input.hw_params),
+            .out_config = device_config(st.output.hw_params),
+            .process_config =
+                    audio::pcm_process_config{
+                            .sample_rate = st.sample_rate,
+                            .period_size = st.period_size,
+                            .period_count = st.period_count},
+            .in_secondaries = *st.input_secondaries,
+            .out_secondaries = *st.output_secondaries};
+}
+
 template <class Vector>
 static auto
 set_intersection(Vector const& in, Vector const& out)
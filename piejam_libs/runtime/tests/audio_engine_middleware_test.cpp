@@ -5,9 +5,12 @@
 #include "audio_device_manager_mock.h"
 #include "ladspa_processor_factory_mock.h"
 #include "middleware_functors_mock.h"
+#include "midi_input_controller_mock.h"
 
 #include <piejam/audio/device.h>
 #include <piejam/audio/engine/processor.h>
+#include <piejam/audio/offline_device.h>
+#include <piejam/audio/pcm_format.h>
 #include <piejam/audio/period_count.h>
 #include <piejam/audio/period_size.h>
 #include <piejam/audio/sample_rate.h>
@@ -22,6 +25,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 namespace piejam::runtime::test
 {
 
@@ -176,4 +181,115 @@ TEST_F(audio_engine_middleware_test,
     EXPECT_EQ(1u, st.input.index);
 }
 
+TEST(audio_engine_middleware_aggregate_test,
+     channels_of_a_secondary_input_device_reach_the_engine)
+{
+    using namespace testing;
+
+    NiceMock<middleware_functors_mock> mf_mock;
+    StrictMock<audio_device_manager_mock> audio_device_manager;
+    StrictMock<ladspa_processor_factory_mock> ladspa_processor_factory;
+
+    audio_engine_middleware sut{
+            {},
+            {},
+            audio_device_manager,
+            ladspa_processor_factory,
+            std::make_unique<NiceMock<midi_input_controller_mock>>()};
+
+    audio::pcm_hw_params const hw_params{
+            .interleaved = true,
+            .mmap = false,
+            .format = audio::pcm_format::s32_le,
+            .num_channels = 2,
+            .sample_rates = {audio::sample_rate(48000u)},
+            .period_sizes = {audio::period_size(64u)},
+            .period_counts = {audio::period_count(2u)}};
+
+    state st = make_initial_state();
+    st.pcm_devices = audio::pcm_io_descriptors{
+            .inputs = {audio::pcm_descriptor{.name = "main", .path = {}}},
+            .outputs = {audio::pcm_descriptor{.name = "main", .path = {}}}};
+    st.input.index = 0;
+    st.input.hw_params = hw_params;
+    st.output.index = 0;
+    st.output.hw_params = hw_params;
+    st.input_secondaries = std::vector{audio::pcm_secondary_config{
+            .descriptor = {.name = "secondary", .path = {}},
+            .device_config = {
+                    .interleaved = true,
+                    .mmap = false,
+                    .format = audio::pcm_format::s32_le,
+                    .num_channels = 2}}};
+
+    // the first channel of the secondary is routed to the main output
+    auto const in_bus = add_device_bus(
+            st,
+            "Secondary",
+            io_direction::input,
+            audio::bus_type::mono,
+            channel_index_pair{2, 2});
+    auto const out_bus = add_device_bus(
+            st,
+            "Out",
+            io_direction::output,
+            audio::bus_type::stereo,
+            channel_index_pair{0, 1});
+    st.mixer_state.channels.update(
+            st.mixer_state.main,
+            [out_bus](mixer::channel& main) { main.out = out_bus; });
+    auto const channel_id = add_mixer_channel(st, "In", audio::bus_type::mono);
+    st.mixer_state.channels.update(channel_id, [in_bus](mixer::channel& ch) {
+        ch.in = in_bus;
+    });
+
+    float output_peak{};
+    audio::offline_device* device{};
+
+    EXPECT_CALL(mf_mock, get_state()).WillRepeatedly(ReturnRef(st));
+    EXPECT_CALL(mf_mock, next(_)).WillRepeatedly([&st](auto const& a) {
+        dynamic_cast<reducible_action const&>(a).reduce(st);
+    });
+    EXPECT_CALL(audio_device_manager, hw_params(_, _, _))
+            .WillRepeatedly(Return(hw_params));
+    EXPECT_CALL(audio_device_manager, make_device(_, _, _))
+            .WillOnce([&](auto const&,
+                          auto const&,
+                          audio::pcm_io_config const& io_config) {
+                EXPECT_EQ(4u, io_config.num_input_channels());
+                EXPECT_EQ(2u, io_config.num_output_channels());
+
+                auto result = std::make_unique<audio::offline_device>(
+                        io_config,
+                        [](std::span<std::span<float> const> const in) {
+                            for (std::size_t ch = 0; ch < in.size(); ++ch)
+                            {
+                                std::ranges::fill(in[ch], ch == 2 ? 1.f : 0.f);
+                            }
+                        },
+                        [&output_peak](std::span<std::span<float const> const>
+                                               out) {
+                            for (float const x : out[0])
+                            {
+                                output_peak = std::max(output_peak, x);
+                            }
+                        });
+                device = result.get();
+                return result;
+            });
+
+    actions::initiate_device_selection action;
+    action.input = true;
+    action.index = 0;
+    sut(make_middleware_functors(mf_mock), action);
+
+    EXPECT_EQ(4u, num_device_channels(st, io_direction::input));
+    EXPECT_EQ(2u, st.device_io_state.buses[in_bus].channels.left);
+
+    ASSERT_NE(nullptr, device);
+    device->render(64 * 16);
+
+    EXPECT_GT(output_peak, 0.f);
+}
+
 } // namespace piejam::runtime::test
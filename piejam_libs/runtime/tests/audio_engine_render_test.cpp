@@ -2,11 +2,15 @@
 // SPDX-FileCopyrightText: 2020  Dimitrij Kotrev
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include <piejam/audio/offline_device.h>
 #include <piejam/audio/types.h>
+#include <piejam/io_direction.h>
 #include <piejam/midi/input_event_handler.h>
 #include <piejam/runtime/audio_engine.h>
 #include <piejam/runtime/fwd.h>
+#include <piejam/runtime/fx/internal.h>
 #include <piejam/runtime/state.h>
+#include <piejam/thread/configuration.h>
 
 #include <gtest/gtest.h>
 
@@ -15,13 +19,14 @@
 #include <filesystem>
 #include <fstream>
 #include <future>
+#include <span>
 #include <vector>
 
 namespace piejam::runtime::test
 {
 
-// plot with gnuplot:
-//     plot 'add_input_channel.txt' using 1 with lines
+// the output is dumped into the temp directory, plot with gnuplot:
+//     plot '/tmp/add_input_channel.txt' using 1 with lines
 
 struct audio_engine_render_test : public ::testing::Test
 {
@@ -39,9 +44,11 @@ struct audio_engine_render_test : public ::testing::Test
     std::vector<audio::pcm_input_buffer_converter> in_converter{
             [this](std::span<float> const buffer) {
                 std::ranges::copy(audio_in_left, buffer.begin());
+                return std::span<float const>{buffer};
             },
             [this](std::span<float> const buffer) {
                 std::ranges::copy(audio_in_right, buffer.begin());
+                return std::span<float const>{buffer};
             }};
     std::vector<audio::pcm_output_buffer_converter> out_converter{
             [this](audio::pcm_output_source_buffer_t const& buffer) {
@@ -97,9 +104,9 @@ struct audio_engine_render_test : public ::testing::Test
                  std::future_status::ready);
     }
 
-    void dump_output(std::filesystem::path const& file)
+    void dump_output(std::filesystem::path const& file_name)
     {
-        std::ofstream os(file);
+        std::ofstream os(std::filesystem::temp_directory_path() / file_name);
         for (auto const& p : output)
         {
             os << p.left << '\t' << p.right << std::endl;
@@ -125,4 +132,135 @@ TEST_F(audio_engine_render_test, add_input_channel)
     dump_output("add_input_channel.txt");
 }
 
+namespace
+{
+
+//! Each session is a structural change of the previous one, like the
+//! sessions passed while a session file is loaded.
+auto
+make_sessions(audio::sample_rate const sample_rate) -> std::vector<state>
+{
+    std::vector<state> sessions;
+
+    state st = make_initial_state();
+    st.sample_rate = sample_rate;
+
+    auto const out_bus = add_device_bus(
+            st,
+            "Out",
+            io_direction::output,
+            audio::bus_type::stereo,
+            channel_index_pair{0, 1});
+    st.mixer_state.channels.update(
+            st.mixer_state.main,
+            [out_bus](mixer::channel& main) { main.out = out_bus; });
+    sessions.push_back(st);
+
+    auto const in_bus = add_device_bus(
+            st,
+            "In",
+            io_direction::input,
+            audio::bus_type::stereo,
+            channel_index_pair{0, 1});
+    auto const channel_id =
+            add_mixer_channel(st, "In", audio::bus_type::stereo);
+    st.mixer_state.channels.update(
+            channel_id,
+            [in_bus, main = st.mixer_state.main](mixer::channel& channel) {
+                channel.in = in_bus;
+                channel.out = main;
+            });
+    sessions.push_back(st);
+
+    insert_internal_fx_module(
+            st,
+            channel_id,
+            npos,
+            fx::internal::filter,
+            {},
+            {});
+    sessions.push_back(st);
+
+    return sessions;
+}
+
+//! Rebuilds the engine for each session, then renders from an offline
+//! device.
+auto
+render_offline(
+        std::span<state const> const sessions,
+        std::size_t const fade_periods) -> std::vector<float>
+{
+    audio::sample_rate const sample_rate{48000};
+    std::size_t const num_frames{4800};
+
+    std::size_t input_pos{};
+    std::vector<float> output;
+
+    audio::offline_device device(
+            audio::pcm_io_config{
+                    .in_config = {.num_channels = 2},
+                    .out_config = {.num_channels = 2},
+                    .process_config =
+                            {.sample_rate = sample_rate,
+                             .period_size = audio::period_size(128u),
+                             .period_count = audio::period_count(2u)}},
+            [&](std::span<std::span<float> const> const channels) {
+                for (std::size_t frame = 0; frame < channels[0].size();
+                     ++frame, ++input_pos)
+                {
+                    channels[0][frame] = std::sin(
+                            input_pos / sample_rate.as_float() * 440.f);
+                    channels[1][frame] = -channels[0][frame];
+                }
+            },
+            [&](std::span<std::span<float const> const> const channels) {
+                for (std::span<float const> const channel : channels)
+                {
+                    output.insert(output.end(), channel.begin(), channel.end());
+                }
+            });
+
+    audio_engine engine{{}, sample_rate, 2, 2};
+
+    device.start(
+            {},
+            [&engine](auto const& in, auto const& out) {
+                engine.init_process(in, out);
+            },
+            [&engine](std::size_t const buffer_size) {
+                engine.process(buffer_size);
+            });
+
+    for (state const& st : sessions)
+    {
+        EXPECT_TRUE(engine.rebuild(st, {}, nullptr, fade_periods));
+    }
+
+    device.render(num_frames);
+    device.stop();
+
+    return output;
+}
+
+} // namespace
+
+TEST(audio_engine_offline_render_test, output_is_independent_of_the_rebuilds)
+{
+    auto const sessions = make_sessions(audio::sample_rate{48000});
+
+    auto const expected = render_offline(std::span{sessions}.last(1), 0);
+    ASSERT_TRUE(std::ranges::any_of(expected, [](float const x) {
+        return x != 0.f;
+    }));
+
+    for (std::size_t const fade_periods : {0u, 4u})
+    {
+        for (int run = 0; run < 3; ++run)
+        {
+            EXPECT_EQ(expected, render_offline(sessions, fade_periods));
+        }
+    }
+}
+
 } // namespace piejam::runtime::test
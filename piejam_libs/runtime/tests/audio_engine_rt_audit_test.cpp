@@ -0,0 +1,109 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "engine_session.h"
+
+#include <piejam/audio/engine/processor.h>
+#include <piejam/runtime/audio_engine.h>
+#include <piejam/runtime/state.h>
+#include <piejam/thread/realtime_scope.h>
+#include <piejam/thread/worker.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+// Runs representative sessions through the audio engine, while the audio
+// threads are audited. Built with PIEJAM_RT_AUDIT only.
+
+namespace piejam::runtime::test
+{
+
+namespace
+{
+
+constexpr audio::sample_rate sample_rate{48000u};
+constexpr std::size_t period_size{128};
+constexpr std::size_t num_channels{8};
+
+} // namespace
+
+struct audio_engine_rt_audit_test
+    : ::testing::TestWithParam<
+              std::tuple<std::size_t, audio::engine::dag::scheduling>>
+{
+    std::vector<thread::worker> workers{std::get<0>(GetParam())};
+    audio_engine sut{
+            workers,
+            sample_rate,
+            session_device_inputs(num_channels),
+            2,
+            std::get<1>(GetParam())};
+
+    std::vector<audio::pcm_input_buffer_converter> in_converter{
+            session_device_inputs(num_channels),
+            [](std::span<float> const buffer) {
+                std::ranges::fill(buffer, 0.25f);
+                return std::span<float const>{buffer};
+            }};
+    std::vector<audio::pcm_output_buffer_converter> out_converter{
+            [](audio::pcm_output_source_buffer_t const&) {},
+            [](audio::pcm_output_source_buffer_t const&) {}};
+
+    audio_engine_rt_audit_test()
+    {
+        sut.init_process(in_converter, out_converter);
+    }
+
+    void rebuild(state const& st)
+    {
+        EXPECT_TRUE(rebuild_while_processing(
+                sut,
+                st,
+                period_size,
+                [](ladspa::instance_id const&) { return nullptr; }));
+    }
+};
+
+TEST_P(audio_engine_rt_audit_test, no_violations_while_processing)
+{
+    auto const violations = thread::rt_audit::violations();
+
+    state st = make_session(sample_rate, num_channels, 3);
+    rebuild(st);
+
+    auto const& channel =
+            st.mixer_state.channels[st.mixer_state.inputs->back()];
+
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        sut.set_parameter_value(channel.volume, (i % 100) / 100.f);
+        sut.process(period_size);
+    }
+
+    // changing the session swaps the executor while processing
+    add_mixer_channel(st, "Added", audio::bus_type::stereo);
+    rebuild(st);
+
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        sut.process(period_size);
+    }
+
+    EXPECT_EQ(violations, thread::rt_audit::violations());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+        sessions,
+        audio_engine_rt_audit_test,
+        ::testing::Combine(
+                ::testing::Values(std::size_t{0}, std::size_t{3}),
+                ::testing::Values(
+                        audio::engine::dag::scheduling::shared_queue,
+                        audio::engine::dag::scheduling::work_stealing,
+                        audio::engine::dag::scheduling::static_schedule)));
+
+} // namespace piejam::runtime::test
@@ -0,0 +1,64 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/runtime/audio_engine_structure.h>
+
+#include <piejam/runtime/fx/internal.h>
+#include <piejam/runtime/state.h>
+
+#include <gtest/gtest.h>
+
+namespace piejam::runtime::test
+{
+
+TEST(audio_engine_structure, equal_for_copied_state)
+{
+    state st;
+    add_mixer_channel(st, "foo", audio::bus_type::stereo);
+
+    state const copy = st;
+
+    EXPECT_EQ(audio_engine_structure(st), audio_engine_structure(copy));
+}
+
+TEST(audio_engine_structure, unchanged_by_reordering_mixer_channels)
+{
+    state st;
+    add_mixer_channel(st, "foo", audio::bus_type::stereo);
+    add_mixer_channel(st, "bar", audio::bus_type::stereo);
+
+    audio_engine_structure const before(st);
+
+    st.mixer_state.inputs.update([](mixer::channel_ids_t& ids) {
+        std::swap(ids[0], ids[1]);
+    });
+
+    EXPECT_EQ(before, audio_engine_structure(st));
+}
+
+TEST(audio_engine_structure, changed_by_inserting_fx_module)
+{
+    state st;
+    auto const channel_id =
+            add_mixer_channel(st, "foo", audio::bus_type::stereo);
+
+    audio_engine_structure const before(st);
+
+    insert_internal_fx_module(st, channel_id, 0, fx::internal::tool, {}, {});
+
+    EXPECT_NE(before, audio_engine_structure(st));
+}
+
+TEST(audio_engine_structure, changed_by_midi_learning)
+{
+    state st;
+
+    audio_engine_structure const before(st);
+
+    st.midi_learning = midi_assignment_id{};
+
+    EXPECT_NE(before, audio_engine_structure(st));
+}
+
+} // namespace piejam::runtime::test
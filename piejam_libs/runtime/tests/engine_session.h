@@ -0,0 +1,194 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/audio/types.h>
+#include <piejam/io_direction.h>
+#include <piejam/ladspa/instance_manager_processor_factory.h>
+#include <piejam/ladspa/plugin_descriptor.h>
+#include <piejam/midi/input_event_handler.h>
+#include <piejam/runtime/audio_engine.h>
+#include <piejam/runtime/fx/internal.h>
+#include <piejam/runtime/fx/ladspa_processor_factory.h>
+#include <piejam/runtime/state.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+// Synthetic sessions, shared by the engine benchmarks and tests.
+
+namespace piejam::runtime::test
+{
+
+struct null_midi_input final : midi::input_event_handler
+{
+    void process(midi::event_handler&) override
+    {
+    }
+};
+
+struct ladspa_plugin
+{
+    ladspa::instance_manager_processor_factory manager;
+    std::optional<ladspa::plugin_descriptor> descriptor;
+};
+
+inline constexpr std::array session_internal_fx{
+        fx::internal::filter,
+        fx::internal::scope,
+        fx::internal::spectrum};
+
+//! Half of the channels are mono, the other half stereo. Every four
+//! channels are routed into a group channel, which forms a solo group with
+//! one of them soloed. The volume of every channel is assigned to a MIDI cc.
+//! Without a plugin, only internal fx are inserted.
+inline auto
+make_session(
+        audio::sample_rate const sample_rate,
+        std::size_t const num_channels,
+        std::size_t const num_fx,
+        ladspa_plugin* const plugin = nullptr) -> state
+{
+    state st = make_initial_state();
+    st.sample_rate = sample_rate;
+
+    auto const out_bus = add_device_bus(
+            st,
+            "Out",
+            io_direction::output,
+            audio::bus_type::stereo,
+            channel_index_pair{0, 1});
+    st.mixer_state.channels.update(
+            st.mixer_state.main,
+            [out_bus](mixer::channel& main) { main.out = out_bus; });
+
+    midi_assignments_map midi_assigns;
+    std::optional<mixer::channel_id> group;
+    std::size_t device_channel{};
+
+    for (std::size_t index = 0; index < num_channels; ++index)
+    {
+        if (index % 4 == 0)
+        {
+            group = add_mixer_channel(
+                    st,
+                    "Group " + std::to_string(index / 4),
+                    audio::bus_type::stereo);
+        }
+
+        auto const bus_type = index % 2 == 0 ? audio::bus_type::mono
+                                             : audio::bus_type::stereo;
+        auto const name = "In " + std::to_string(index);
+
+        auto const in_bus = add_device_bus(
+                st,
+                name,
+                io_direction::input,
+                bus_type,
+                bus_type == audio::bus_type::mono
+                        ? channel_index_pair{device_channel, device_channel}
+                        : channel_index_pair{
+                                  device_channel,
+                                  device_channel + 1});
+        device_channel += bus_type == audio::bus_type::mono ? 1 : 2;
+
+        auto const channel_id = add_mixer_channel(st, name, bus_type);
+        st.mixer_state.channels.update(
+                channel_id,
+                [in_bus, group_id = *group](mixer::channel& channel) {
+                    channel.in = in_bus;
+                    channel.out = group_id;
+                });
+
+        auto const& channel = st.mixer_state.channels[channel_id];
+
+        if (index % 4 == 0)
+        {
+            st.params[channel.solo].value.set(true);
+        }
+
+        midi_assigns.emplace(
+                channel.volume,
+                midi_assignment{
+                        .channel = 0,
+                        .control_type = midi_assignment::type::cc,
+                        .control_id = index % 128});
+
+        for (std::size_t fx_index = 0; fx_index < num_fx; ++fx_index)
+        {
+            if (plugin && fx_index % (session_internal_fx.size() + 1) == 0)
+            {
+                auto const instance_id =
+                        plugin->manager.load(*plugin->descriptor);
+                insert_ladspa_fx_module(
+                        st,
+                        channel_id,
+                        npos,
+                        instance_id,
+                        *plugin->descriptor,
+                        plugin->manager.control_inputs(instance_id),
+                        {},
+                        {});
+            }
+            else
+            {
+                insert_internal_fx_module(
+                        st,
+                        channel_id,
+                        npos,
+                        session_internal_fx
+                                [fx_index % session_internal_fx.size()],
+                        {},
+                        {});
+            }
+        }
+    }
+
+    update_midi_assignments(st, midi_assigns);
+
+    return st;
+}
+
+//! Device inputs used by a session with the given number of channels.
+inline auto
+session_device_inputs(std::size_t const num_channels) -> unsigned
+{
+    // alternating mono and stereo
+    return static_cast<unsigned>(num_channels / 2 * 3 + num_channels % 2);
+}
+
+//! The rebuilt graph is handed over to the process thread, which is faked
+//! for the duration of the rebuild.
+inline auto
+rebuild_while_processing(
+        audio_engine& engine,
+        state const& st,
+        std::size_t const period_size,
+        fx::simple_ladspa_processor_factory const& ladspa_factory) -> bool
+{
+    std::atomic_bool rebuilt{};
+    std::thread process_thread([&engine, &rebuilt, period_size]() {
+        while (!rebuilt.load(std::memory_order_acquire))
+        {
+            engine.process(period_size);
+        }
+    });
+
+    bool const result = engine.rebuild(
+            st,
+            ladspa_factory,
+            std::make_unique<null_midi_input>());
+
+    rebuilt.store(true, std::memory_order_release);
+    process_thread.join();
+
+    return result;
+}
+
+} // namespace piejam::runtime::test
@@ -0,0 +1,190 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/runtime/processors/parameter_dispatch_processor.h>
+
+#include <piejam/audio/engine/processor_test_environment.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <optional>
+
+namespace piejam::runtime::processors::test
+{
+
+using sut_t = parameter_dispatch_processor<int, float>;
+
+TEST(parameter_dispatch_processor, ports_only_for_listened_and_driven)
+{
+    std::array const params{
+            sut_t::parameter{.value = 1, .listened = true},
+            sut_t::parameter{.value = 2.f, .driven = true},
+            sut_t::parameter{.value = 3, .listened = true, .driven = true},
+            sut_t::parameter{.value = 4.f}};
+    sut_t sut(params);
+
+    ASSERT_EQ(4u, sut.size());
+    EXPECT_EQ(2u, sut.event_outputs().size());
+    EXPECT_EQ(2u, sut.event_inputs().size());
+
+    EXPECT_EQ(0u, sut.event_output_port(0));
+    EXPECT_EQ(npos, sut.event_input_port(0));
+    EXPECT_EQ(npos, sut.event_output_port(1));
+    EXPECT_EQ(0u, sut.event_input_port(1));
+    EXPECT_EQ(1u, sut.event_output_port(2));
+    EXPECT_EQ(1u, sut.event_input_port(2));
+    EXPECT_EQ(npos, sut.event_output_port(3));
+    EXPECT_EQ(npos, sut.event_input_port(3));
+}
+
+TEST(parameter_dispatch_processor, initialized_values_are_sent_once)
+{
+    std::array const params{
+            sut_t::parameter{
+                    .value = 5,
+                    .initialized = true,
+                    .listened = true},
+            sut_t::parameter{.value = 2.f, .listened = true}};
+    sut_t sut(params);
+
+    audio::engine::processor_test_environment test_env(sut, 16);
+
+    sut.process(test_env.ctx);
+
+    auto const& ev_out = test_env.event_outputs.get<int>(0);
+    ASSERT_EQ(1u, ev_out.size());
+    EXPECT_EQ(0u, ev_out.begin()->offset());
+    EXPECT_EQ(5, ev_out.begin()->value());
+    EXPECT_TRUE(test_env.event_outputs.get<float>(1).empty());
+
+    test_env.event_outputs.clear_buffers();
+    sut.process(test_env.ctx);
+
+    EXPECT_TRUE(test_env.event_outputs.get<int>(0).empty());
+}
+
+TEST(parameter_dispatch_processor, only_last_set_value_is_sent)
+{
+    std::array const params{
+            sut_t::parameter{.value = 0, .listened = true},
+            sut_t::parameter{.value = 0.f, .listened = true}};
+    sut_t sut(params);
+
+    sut.set(1, 2.f);
+    sut.set(1, 3.f);
+
+    audio::engine::processor_test_environment test_env(sut, 16);
+
+    sut.process(test_env.ctx);
+
+    EXPECT_TRUE(test_env.event_outputs.get<int>(0).empty());
+
+    auto const& ev_out = test_env.event_outputs.get<float>(1);
+    ASSERT_EQ(1u, ev_out.size());
+    EXPECT_EQ(0u, ev_out.begin()->offset());
+    EXPECT_FLOAT_EQ(3.f, ev_out.begin()->value());
+}
+
+TEST(parameter_dispatch_processor, driven_value_is_forwarded_and_consumable)
+{
+    std::array const params{
+            sut_t::parameter{.value = 0, .listened = true, .driven = true}};
+    sut_t sut(params);
+
+    audio::engine::processor_test_environment test_env(sut, 16);
+    test_env.insert_input_event(0, 3, 7);
+    test_env.insert_input_event(0, 9, 8);
+
+    sut.process(test_env.ctx);
+
+    auto const& ev_out = test_env.event_outputs.get<int>(0);
+    ASSERT_EQ(2u, ev_out.size());
+    EXPECT_EQ(3u, ev_out.begin()->offset());
+    EXPECT_EQ(7, ev_out.begin()->value());
+    EXPECT_EQ(9u, std::next(ev_out.begin())->offset());
+    EXPECT_EQ(8, std::next(ev_out.begin())->value());
+
+    sut.fetch_updates();
+
+    std::optional<int> consumed;
+    sut.consume<int>(0, [&](int const value) { consumed = value; });
+    EXPECT_EQ(8, consumed);
+
+    consumed.reset();
+    sut.consume<int>(0, [&](int const value) { consumed = value; });
+    EXPECT_FALSE(consumed.has_value());
+}
+
+TEST(parameter_dispatch_processor, only_changed_driven_values_are_fetched)
+{
+    std::array const params{
+            sut_t::parameter{.value = 0, .driven = true},
+            sut_t::parameter{.value = 0.f, .driven = true}};
+    sut_t sut(params);
+
+    auto process = [&sut]<class V>(std::size_t const port, V const value) {
+        audio::engine::processor_test_environment test_env(sut, 16);
+        test_env.insert_input_event<V>(port, 0, V{value});
+        sut.process(test_env.ctx);
+    };
+
+    std::optional<int> consumed_int;
+    std::optional<float> consumed_float;
+    auto consume = [&]() {
+        sut.consume<int>(0, [&](int const value) { consumed_int = value; });
+        sut.consume<float>(1, [&](float const value) {
+            consumed_float = value;
+        });
+    };
+
+    process(0, 5);
+
+    // not visible until fetched
+    consume();
+    EXPECT_FALSE(consumed_int.has_value());
+
+    sut.fetch_updates();
+    consume();
+    EXPECT_EQ(5, consumed_int);
+    EXPECT_FALSE(consumed_float.has_value());
+
+    // changes of consecutive periods are fetched at once
+    consumed_int.reset();
+    process(1, 2.f);
+    process(0, 6);
+
+    sut.fetch_updates();
+    consume();
+    EXPECT_EQ(6, consumed_int);
+    EXPECT_EQ(2.f, consumed_float);
+}
+
+TEST(parameter_dispatch_processor, set_is_kept_back_while_queue_is_full)
+{
+    std::array const params{sut_t::parameter{.value = 0, .listened = true}};
+    sut_t sut(params, {}, 1);
+
+    sut.set(0, 1);
+    sut.set(0, 2);
+
+    audio::engine::processor_test_environment test_env(sut, 16);
+
+    sut.process(test_env.ctx);
+
+    auto const& ev_out = test_env.event_outputs.get<int>(0);
+    ASSERT_EQ(1u, ev_out.size());
+    EXPECT_EQ(1, ev_out.begin()->value());
+
+    // flushed on fetch
+    sut.fetch_updates();
+
+    test_env.event_outputs.clear_buffers();
+    sut.process(test_env.ctx);
+
+    ASSERT_EQ(1u, ev_out.size());
+    EXPECT_EQ(2, ev_out.begin()->value());
+}
+
+} // namespace piejam::runtime::processors::test
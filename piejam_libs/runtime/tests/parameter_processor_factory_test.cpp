@@ -4,6 +4,9 @@
 
 #include <piejam/runtime/processors/parameter_processor_factory.h>
 
+#include <piejam/audio/engine/event_identity_processor.h>
+#include <piejam/audio/engine/graph.h>
+#include <piejam/audio/engine/graph_algorithms.h>
 #include <piejam/audio/engine/processor_test_environment.h>
 
 #include <gtest/gtest.h>
@@ -55,36 +58,75 @@ TEST(parameter_processor_factory, make_and_find_expired)
     EXPECT_EQ(nullptr, found_proc.get());
 }
 
-TEST(parameter_processor_factory, make_and_replace)
+TEST(parameter_processor_factory, make_twice_returns_the_same_processor)
 {
     factory_t sut;
     auto id = parameter::id_t<int_param_fake>::generate();
     auto proc1 = sut.make_processor(id);
     auto proc2 = sut.make_processor(id);
-    auto found_proc = sut.find_processor(id);
 
-    EXPECT_EQ(proc2.get(), found_proc.get());
+    EXPECT_EQ(proc1.get(), proc2.get());
+}
+
+TEST(parameter_processor_factory,
+     make_dispatch_replaces_parameter_processors_in_graph)
+{
+    factory_t sut;
+    auto listened_id = parameter::id_t<int_param_fake>::generate();
+    auto driven_id = parameter::id_t<float_param_fake>::generate();
+    auto listened = sut.make_processor(listened_id);
+    auto driven = sut.make_processor(driven_id);
+
+    audio::engine::event_identity_processor listener(std::in_place_type<int>);
+    audio::engine::event_identity_processor driver(std::in_place_type<float>);
+
+    audio::engine::graph g;
+    g.event.insert({*listened, 0}, {listener, 0});
+    g.event.insert({driver, 0}, {*driven, 0});
+
+    auto dispatch = sut.make_dispatch(g, [](auto) -> int const* {
+        return nullptr;
+    });
+
+    ASSERT_EQ(2u, g.event.size());
+    EXPECT_TRUE(audio::engine::has_event_wire(
+            g,
+            {*dispatch.listened, 0},
+            {listener, 0}));
+    EXPECT_TRUE(audio::engine::has_event_wire(
+            g,
+            {driver, 0},
+            {*dispatch.driven, 0}));
 }
 
 TEST(parameter_processor_factory,
-     initialize_will_send_an_event_to_out_on_process)
+     make_dispatch_will_send_initial_value_on_process)
 {
     factory_t sut;
     auto id = parameter::id_t<int_param_fake>::generate();
     auto proc = sut.make_processor(id);
 
-    int value{5};
-    sut.initialize(boost::hof::match(
-            [&](parameter::id_t<int_param_fake> param_id) -> int const* {
-                return param_id == id ? &value : nullptr;
-            },
-            [](parameter::id_t<float_param_fake>) -> float const* {
-                return nullptr;
-            }));
-
-    audio::engine::processor_test_environment test_env(*proc, 16);
+    audio::engine::event_identity_processor listener(std::in_place_type<int>);
+    audio::engine::graph g;
+    g.event.insert({*proc, 0}, {listener, 0});
 
-    proc->process(test_env.ctx);
+    int value{5};
+    auto dispatch = sut.make_dispatch(
+            g,
+            boost::hof::match(
+                    [&](parameter::id_t<int_param_fake> param_id)
+                            -> int const* {
+                        return param_id == id ? &value : nullptr;
+                    },
+                    [](parameter::id_t<float_param_fake>) -> float const* {
+                        return nullptr;
+                    }));
+
+    audio::engine::processor_test_environment test_env(
+            *dispatch.listened,
+            16);
+
+    dispatch.listened->process(test_env.ctx);
 
     auto const& ev_out = test_env.event_outputs.get<int>(0);
     ASSERT_EQ(1u, ev_out.size());
@@ -93,19 +135,26 @@ TEST(parameter_processor_factory,
 }
 
 TEST(parameter_processor_factory,
-     initialize_without_a_value_will_not_send_anything)
+     make_dispatch_without_a_value_will_not_send_anything)
 {
     factory_t sut;
     auto id = parameter::id_t<int_param_fake>::generate();
     auto proc = sut.make_processor(id);
 
-    sut.initialize(
+    audio::engine::event_identity_processor listener(std::in_place_type<int>);
+    audio::engine::graph g;
+    g.event.insert({*proc, 0}, {listener, 0});
+
+    auto dispatch = sut.make_dispatch(
+            g,
             []<class P>(parameter::id_t<P>)
                     -> parameter::value_type_t<P> const* { return nullptr; });
 
-    audio::engine::processor_test_environment test_env(*proc, 16);
+    audio::engine::processor_test_environment test_env(
+            *dispatch.listened,
+            16);
 
-    proc->process(test_env.ctx);
+    dispatch.listened->process(test_env.ctx);
 
     auto const& ev_out = test_env.event_outputs.get<int>(0);
     EXPECT_TRUE(ev_out.empty());
@@ -117,11 +166,21 @@ TEST(parameter_processor_factory, set_will_send_an_event_to_out_on_process)
     auto id = parameter::id_t<int_param_fake>::generate();
     auto proc = sut.make_processor(id);
 
+    audio::engine::event_identity_processor listener(std::in_place_type<int>);
+    audio::engine::graph g;
+    g.event.insert({*proc, 0}, {listener, 0});
+
+    auto dispatch = sut.make_dispatch(g, [](auto) -> int const* {
+        return nullptr;
+    });
+    auto& dispatch_proc = *dispatch.listened;
+    sut.replace_dispatch(std::move(dispatch));
+
     sut.set(id, 5);
 
-    audio::engine::processor_test_environment test_env(*proc, 16);
+    audio::engine::processor_test_environment test_env(dispatch_proc, 16);
 
-    proc->process(test_env.ctx);
+    dispatch_proc.process(test_env.ctx);
 
     auto const& ev_out = test_env.event_outputs.get<int>(0);
     ASSERT_EQ(1u, ev_out.size());
@@ -129,17 +188,27 @@ TEST(parameter_processor_factory, set_will_send_an_event_to_out_on_process)
     EXPECT_EQ(5, ev_out.begin()->value());
 }
 
-TEST(parameter_processor_factory, set_to_non_existent_processor)
+TEST(parameter_processor_factory, set_to_non_existent_parameter)
 {
     factory_t sut;
     auto id = parameter::id_t<int_param_fake>::generate();
     auto proc = sut.make_processor(id);
 
+    audio::engine::event_identity_processor listener(std::in_place_type<int>);
+    audio::engine::graph g;
+    g.event.insert({*proc, 0}, {listener, 0});
+
+    auto dispatch = sut.make_dispatch(g, [](auto) -> int const* {
+        return nullptr;
+    });
+    auto& dispatch_proc = *dispatch.listened;
+    sut.replace_dispatch(std::move(dispatch));
+
     sut.set(parameter::id_t<int_param_fake>::generate(), 5);
 
-    audio::engine::processor_test_environment test_env(*proc, 16);
+    audio::engine::processor_test_environment test_env(dispatch_proc, 16);
 
-    proc->process(test_env.ctx);
+    dispatch_proc.process(test_env.ctx);
 
     // verify that the processor is not sending anything
     auto const& ev_out = test_env.event_outputs.get<int>(0);
@@ -152,10 +221,21 @@ TEST(parameter_processor_factory, consume_incoming_event)
     auto id = parameter::id_t<int_param_fake>::generate();
     auto proc = sut.make_processor(id);
 
-    audio::engine::processor_test_environment test_env(*proc, 16);
+    audio::engine::event_identity_processor driver(std::in_place_type<int>);
+    audio::engine::graph g;
+    g.event.insert({driver, 0}, {*proc, 0});
+
+    auto dispatch = sut.make_dispatch(g, [](auto) -> int const* {
+        return nullptr;
+    });
+    auto& dispatch_proc = *dispatch.driven;
+    sut.replace_dispatch(std::move(dispatch));
+
+    audio::engine::processor_test_environment test_env(dispatch_proc, 16);
     test_env.insert_input_event<int>(0, 3, 9);
 
-    proc->process(test_env.ctx);
+    dispatch_proc.process(test_env.ctx);
+    sut.fetch_updates();
 
     bool consume_called{};
     sut.consume(id, [&](int v) {
@@ -166,10 +246,11 @@ TEST(parameter_processor_factory, consume_incoming_event)
 }
 
 TEST(parameter_processor_factory,
-     consume_functor_is_not_called_for_non_existing_processor)
+     consume_functor_is_not_called_for_non_existing_parameter)
 {
     factory_t sut;
 
+    sut.fetch_updates();
     sut.consume(parameter::id_t<int_param_fake>::generate(), [](int) {
         FAIL();
     });
@@ -6,6 +6,7 @@
 
 #include <boost/outcome/std_result.hpp>
 
+#include <chrono>
 #include <filesystem>
 #include <span>
 #include <system_error>
@@ -15,11 +16,18 @@ namespace outcome = boost::outcome_v2;
 namespace piejam::system
 {
 
+enum class open_mode : bool
+{
+    read_only,
+    read_write,
+};
+
 class device
 {
 public:
     device() noexcept = default;
-    device(std::filesystem::path const& pathname);
+    device(std::filesystem::path const& pathname,
+           open_mode = open_mode::read_only);
     device(device const&) = delete;
     device(device&& other) noexcept;
 
@@ -47,7 +55,14 @@ public:
 
     [[nodiscard]] auto set_nonblock(bool set = true) -> std::error_code;
 
+    //! Waits until one of the poll events occurs. Returns
+    //! std::errc::timed_out, if none occurred within the timeout.
+    [[nodiscard]] auto poll(short events, std::chrono::milliseconds timeout)
+            -> std::error_code;
+
 private:
+    friend class memory_map;
+
     [[nodiscard]] auto
     ioctl(unsigned long request, void* p, std::size_t size) noexcept
             -> std::error_code;
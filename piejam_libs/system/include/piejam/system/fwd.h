@@ -9,5 +9,6 @@ namespace piejam::system
 
 class dll;
 class device;
+class memory_map;
 
 } // namespace piejam::system
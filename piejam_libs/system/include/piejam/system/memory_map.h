@@ -0,0 +1,50 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/system/fwd.h>
+
+#include <cstddef>
+#include <span>
+
+namespace piejam::system
+{
+
+//! Maps memory of a device into the address space.
+class memory_map
+{
+public:
+    memory_map() noexcept = default;
+    memory_map(
+            device&,
+            std::size_t size,
+            std::size_t offset,
+            bool writable = false);
+    memory_map(memory_map const&) = delete;
+    memory_map(memory_map&& other) noexcept;
+
+    ~memory_map();
+
+    auto operator=(memory_map const&) -> memory_map& = delete;
+    auto operator=(memory_map&& other) noexcept -> memory_map&;
+
+    explicit operator bool() const noexcept
+    {
+        return m_data != nullptr;
+    }
+
+    [[nodiscard]] auto data() const noexcept -> std::span<std::byte>
+    {
+        return {m_data, m_size};
+    }
+
+private:
+    void unmap() noexcept;
+
+    std::byte* m_data{};
+    std::size_t m_size{};
+};
+
+} // namespace piejam::system
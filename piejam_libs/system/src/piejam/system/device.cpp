@@ -8,6 +8,7 @@
 #include <boost/core/ignore_unused.hpp>
 
 #include <fcntl.h>
+#include <poll.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 
@@ -17,8 +18,10 @@
 namespace piejam::system
 {
 
-device::device(std::filesystem::path const& pathname)
-    : m_fd(::open(pathname.c_str(), O_RDONLY))
+device::device(std::filesystem::path const& pathname, open_mode const mode)
+    : m_fd(::open(
+              pathname.c_str(),
+              mode == open_mode::read_write ? O_RDWR : O_RDONLY))
 {
     if (m_fd < 0)
     {
@@ -131,4 +134,25 @@ device::set_nonblock(bool const set) -> std::error_code
     return {};
 }
 
+auto
+device::poll(short const events, std::chrono::milliseconds const timeout)
+        -> std::error_code
+{
+    BOOST_ASSERT(m_fd != invalid);
+
+    pollfd pfd{.fd = m_fd, .events = events, .revents = 0};
+    int const res = ::poll(&pfd, 1, static_cast<int>(timeout.count()));
+    if (res < 0)
+    {
+        return std::error_code(errno, std::generic_category());
+    }
+
+    if (res == 0)
+    {
+        return std::make_error_code(std::errc::timed_out);
+    }
+
+    return {};
+}
+
 } // namespace piejam::system
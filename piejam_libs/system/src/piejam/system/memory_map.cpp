@@ -0,0 +1,73 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/system/memory_map.h>
+
+#include <piejam/system/device.h>
+
+#include <boost/assert.hpp>
+
+#include <sys/mman.h>
+
+#include <system_error>
+#include <utility>
+
+namespace piejam::system
+{
+
+memory_map::memory_map(
+        device& dev,
+        std::size_t const size,
+        std::size_t const offset,
+        bool const writable)
+    : m_size(size)
+{
+    BOOST_ASSERT(dev);
+
+    void* const data = ::mmap(
+            nullptr,
+            size,
+            writable ? PROT_READ | PROT_WRITE : PROT_READ,
+            MAP_SHARED,
+            dev.m_fd,
+            static_cast<off_t>(offset));
+    if (data == MAP_FAILED)
+    {
+        throw std::system_error(errno, std::generic_category());
+    }
+
+    m_data = static_cast<std::byte*>(data);
+}
+
+memory_map::memory_map(memory_map&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+{
+}
+
+memory_map::~memory_map()
+{
+    unmap();
+}
+
+auto
+memory_map::operator=(memory_map&& other) noexcept -> memory_map&
+{
+    unmap();
+
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+    return *this;
+}
+
+void
+memory_map::unmap() noexcept
+{
+    if (m_data)
+    {
+        BOOST_VERIFY(!::munmap(m_data, m_size));
+    }
+}
+
+} // namespace piejam::system
@@ -0,0 +1,79 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/thread/wait_policy.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace piejam::thread
+{
+
+//! Binary semaphore, which spins according to its wait_policy before it
+//! parks the waiting thread on a futex.
+class binary_semaphore
+{
+public:
+    explicit binary_semaphore(bool available, wait_policy const& policy = {})
+        : m_state(available ? state_available : state_unavailable)
+        , m_policy(policy)
+    {
+    }
+
+    binary_semaphore(binary_semaphore const&) = delete;
+
+    auto operator=(binary_semaphore const&) -> binary_semaphore& = delete;
+
+    [[nodiscard]] auto try_acquire() noexcept -> bool
+    {
+        std::uint32_t expected = state_available;
+        return m_state.compare_exchange_strong(
+                expected,
+                state_unavailable,
+                std::memory_order_acquire,
+                std::memory_order_relaxed);
+    }
+
+    void acquire() noexcept
+    {
+        backoff idle(m_policy);
+        while (!idle.exhausted())
+        {
+            if (try_acquire())
+            {
+                return;
+            }
+
+            idle();
+        }
+
+        park();
+    }
+
+    void release() noexcept
+    {
+        if (m_state.exchange(state_available, std::memory_order_release) ==
+            state_parked)
+        {
+            wake();
+        }
+    }
+
+private:
+    static constexpr std::uint32_t state_unavailable{0};
+    static constexpr std::uint32_t state_available{1};
+    static constexpr std::uint32_t state_parked{2};
+
+    void park() noexcept;
+    void wake() noexcept;
+
+    std::atomic_uint32_t m_state;
+    wait_policy m_policy;
+
+    static_assert(std::atomic_uint32_t::is_always_lock_free);
+};
+
+} // namespace piejam::thread
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <piejam/thread/wait_policy.h>
+
 #include <optional>
 #include <string>
 
@@ -15,6 +17,7 @@ struct configuration
     std::optional<int> affinity;
     std::optional<int> realtime_priority;
     std::optional<std::string> name;
+    thread::wait_policy wait_policy;
 
     void apply() const;
 };
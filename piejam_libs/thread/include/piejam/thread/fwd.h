@@ -8,6 +8,7 @@ namespace piejam::thread
 {
 
 struct configuration;
+struct wait_policy;
 class worker;
 
 } // namespace piejam::thread
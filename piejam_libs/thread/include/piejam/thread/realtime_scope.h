@@ -0,0 +1,55 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+
+namespace piejam::thread
+{
+
+#ifdef PIEJAM_RT_AUDIT
+
+//! Audit of the real-time safety, built with PIEJAM_RT_AUDIT. While a thread
+//! is marked as real-time, memory allocations and blocking calls are
+//! reported with a stack trace to stderr. If the environment variable
+//! PIEJAM_RT_AUDIT_ABORT is set, the process is aborted on the first
+//! violation.
+namespace rt_audit
+{
+
+void enter() noexcept;
+void leave() noexcept;
+
+//! Number of violations, since the start of the process.
+[[nodiscard]] auto violations() noexcept -> std::size_t;
+
+} // namespace rt_audit
+
+#endif
+
+//! Marks the calling thread as real-time, while in scope. Scopes can be
+//! nested. Without PIEJAM_RT_AUDIT, this does nothing.
+class realtime_scope
+{
+public:
+    realtime_scope() noexcept
+    {
+#ifdef PIEJAM_RT_AUDIT
+        rt_audit::enter();
+#endif
+    }
+
+    realtime_scope(realtime_scope const&) = delete;
+    auto operator=(realtime_scope const&) -> realtime_scope& = delete;
+
+    ~realtime_scope()
+    {
+#ifdef PIEJAM_RT_AUDIT
+        rt_audit::leave();
+#endif
+    }
+};
+
+} // namespace piejam::thread
@@ -0,0 +1,145 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/thread/cache_line_size.h>
+
+#include <boost/assert.hpp>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace piejam::thread
+{
+
+//! Dense table of values, published from a single producer to a single
+//! consumer. The table is double-buffered, each buffer with a bitset of the
+//! changed entries. The producer writes into the front buffer, the consumer
+//! swaps the buffers and copies out only the changed entries.
+template <class T>
+class spsc_snapshot
+{
+    static_assert(std::is_nothrow_copy_assignable_v<T>);
+    static_assert(std::atomic_size_t::is_always_lock_free);
+
+    using word_t = std::uint64_t;
+    static constexpr std::size_t word_bits{sizeof(word_t) * 8};
+
+    struct buffer
+    {
+        std::vector<T> values;
+        std::vector<word_t> dirty;
+    };
+
+public:
+    class writer
+    {
+    public:
+        void set(std::size_t const index, T const& value) noexcept
+        {
+            BOOST_ASSERT(index < m_buffer.values.size());
+
+            m_buffer.values[index] = value;
+            m_buffer.dirty[index / word_bits] |= word_t{1}
+                                                 << (index % word_bits);
+        }
+
+    private:
+        friend class spsc_snapshot;
+
+        explicit writer(buffer& b) noexcept
+            : m_buffer(b)
+        {
+        }
+
+        buffer& m_buffer;
+    };
+
+    explicit spsc_snapshot(std::size_t const size)
+        : m_buffers{make_buffer(size), make_buffer(size)}
+    {
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return m_buffers[0].values.size();
+    }
+
+    //! Called by the producer. The entries set by f are published together,
+    //! once f returns.
+    template <std::invocable<writer&> F>
+    void update(F&& f) noexcept(std::is_nothrow_invocable_v<F, writer&>)
+    {
+        std::size_t const front =
+                m_state.fetch_or(writing, std::memory_order_acquire) &
+                front_mask;
+
+        writer w(m_buffers[front]);
+        std::invoke(std::forward<F>(f), w);
+
+        m_state.fetch_and(~writing, std::memory_order_release);
+    }
+
+    //! Called by the consumer, with the index and the value of each entry
+    //! changed since the previous call. If the producer is just updating,
+    //! nothing is consumed and false is returned. The changes are then
+    //! consumed with the next call.
+    template <std::invocable<std::size_t, T const&> F>
+    auto consume(F&& f) -> bool
+    {
+        std::size_t state = m_state.load(std::memory_order_relaxed);
+        if ((state & writing) ||
+            !m_state.compare_exchange_strong(
+                    state,
+                    state ^ front_mask,
+                    std::memory_order_acq_rel,
+                    std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        buffer& back = m_buffers[state & front_mask];
+        for (std::size_t word_index = 0; word_index < back.dirty.size();
+             ++word_index)
+        {
+            word_t word = std::exchange(back.dirty[word_index], 0);
+            while (word)
+            {
+                std::size_t const index =
+                        word_index * word_bits +
+                        static_cast<std::size_t>(std::countr_zero(word));
+                word &= word - 1;
+
+                std::invoke(f, index, std::as_const(back.values[index]));
+            }
+        }
+
+        return true;
+    }
+
+private:
+    static constexpr std::size_t front_mask{0b01};
+    static constexpr std::size_t writing{0b10};
+
+    static auto make_buffer(std::size_t const size) -> buffer
+    {
+        return buffer{
+                .values = std::vector<T>(size),
+                .dirty = std::vector<word_t>(
+                        (size + word_bits - 1) / word_bits)};
+    }
+
+    alignas(cache_line_size) std::atomic_size_t m_state{};
+    alignas(cache_line_size) std::array<buffer, 2> m_buffers;
+};
+
+} // namespace piejam::thread
@@ -0,0 +1,86 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <thread>
+
+namespace piejam::thread
+{
+
+//! How a thread waits for work or for other threads. It first spins with a
+//! cpu pause hint, then yields its time slice, and at last it is parked.
+struct wait_policy
+{
+    //! Busy-wait iterations with a pause hint.
+    std::size_t spin_count{1000};
+
+    //! Iterations yielding the time slice, before parking.
+    std::size_t yield_count{10};
+
+    //! For small periods, trades cpu time for wakeup latency.
+    static constexpr auto low_latency() noexcept -> wait_policy
+    {
+        return {.spin_count = 20000, .yield_count = 100};
+    }
+
+    //! For power or thermally limited systems, parks almost immediately.
+    static constexpr auto power_saving() noexcept -> wait_policy
+    {
+        return {.spin_count = 100, .yield_count = 0};
+    }
+};
+
+//! Hints the cpu that we are in a spin loop.
+inline void
+pause() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+//! Idle step of a wait loop, according to a wait_policy. Parking is up to
+//! the caller, once the backoff is exhausted.
+class backoff
+{
+public:
+    explicit backoff(wait_policy const& policy) noexcept
+        : m_policy(policy)
+    {
+    }
+
+    void operator()() noexcept
+    {
+        if (m_count < m_policy.spin_count)
+        {
+            pause();
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+
+        ++m_count;
+    }
+
+    [[nodiscard]] auto exhausted() const noexcept -> bool
+    {
+        return m_count >= m_policy.spin_count + m_policy.yield_count;
+    }
+
+    void reset() noexcept
+    {
+        m_count = 0;
+    }
+
+private:
+    wait_policy m_policy;
+    std::size_t m_count{};
+};
+
+} // namespace piejam::thread
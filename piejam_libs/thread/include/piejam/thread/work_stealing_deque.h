@@ -0,0 +1,132 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <piejam/thread/cache_line_size.h>
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace piejam::thread
+{
+
+//! Chase-Lev work-stealing deque. The owner thread pushes and pops at the
+//! bottom, any other thread may steal from the top. The capacity is fixed at
+//! construction, no allocation happens on push.
+template <class T>
+class work_stealing_deque
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    static_assert(std::atomic<T>::is_always_lock_free);
+    static_assert(std::atomic<std::int64_t>::is_always_lock_free);
+
+public:
+    explicit work_stealing_deque(std::size_t const capacity)
+        : m_mask(std::bit_ceil(std::max(capacity, std::size_t{1})) - 1)
+        , m_buffer(std::make_unique<std::atomic<T>[]>(m_mask + 1))
+    {
+    }
+
+    work_stealing_deque(work_stealing_deque const&) = delete;
+    work_stealing_deque(work_stealing_deque&&) = delete;
+
+    auto operator=(work_stealing_deque const&)
+            -> work_stealing_deque& = delete;
+    auto operator=(work_stealing_deque&&) -> work_stealing_deque& = delete;
+
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t
+    {
+        return m_mask + 1;
+    }
+
+    //! Owner only.
+    void push(T const& v) noexcept
+    {
+        std::int64_t const b = m_bottom.load(std::memory_order_relaxed);
+        BOOST_ASSERT(
+                b - m_top.load(std::memory_order_acquire) <
+                static_cast<std::int64_t>(capacity()));
+
+        m_buffer[b & m_mask].store(v, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    //! Owner only.
+    auto pop() noexcept -> std::optional<T>
+    {
+        std::int64_t const b = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = m_top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        std::optional<T> result{
+                m_buffer[b & m_mask].load(std::memory_order_relaxed)};
+
+        if (t == b)
+        {
+            // last element, race against thieves
+            if (!m_top.compare_exchange_strong(
+                        t,
+                        t + 1,
+                        std::memory_order_seq_cst,
+                        std::memory_order_relaxed))
+            {
+                result.reset();
+            }
+
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        return result;
+    }
+
+    //! Any thread.
+    auto steal() noexcept -> std::optional<T>
+    {
+        std::int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t const b = m_bottom.load(std::memory_order_acquire);
+
+        if (t >= b)
+        {
+            return std::nullopt;
+        }
+
+        T const v = m_buffer[t & m_mask].load(std::memory_order_relaxed);
+
+        if (!m_top.compare_exchange_strong(
+                    t,
+                    t + 1,
+                    std::memory_order_seq_cst,
+                    std::memory_order_relaxed))
+        {
+            return std::nullopt;
+        }
+
+        return v;
+    }
+
+private:
+    alignas(cache_line_size) std::atomic<std::int64_t> m_top{};
+    alignas(cache_line_size) std::atomic<std::int64_t> m_bottom{};
+    alignas(cache_line_size) std::size_t const m_mask;
+    std::unique_ptr<std::atomic<T>[]> const m_buffer;
+};
+
+} // namespace piejam::thread
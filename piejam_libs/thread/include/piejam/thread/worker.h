@@ -4,12 +4,13 @@
 
 #pragma once
 
+#include <piejam/thread/binary_semaphore.h>
 #include <piejam/thread/configuration.h>
+#include <piejam/thread/realtime_scope.h>
 
 #include <atomic>
 #include <concepts>
 #include <functional>
-#include <semaphore>
 #include <thread>
 
 namespace piejam::thread
@@ -22,7 +23,10 @@ public:
     using task_t = std::function<void()>;
 
     worker(thread::configuration conf = {})
-        : m_thread([this, conf = std::move(conf)](std::stop_token stoken) {
+        : m_wait_policy(conf.wait_policy)
+        , m_sem_work(false, conf.wait_policy)
+        , m_sem_finished(true, conf.wait_policy)
+        , m_thread([this, conf = std::move(conf)](std::stop_token stoken) {
             conf.apply();
 
             while (true)
@@ -34,7 +38,10 @@ public:
                     break;
                 }
 
-                m_task();
+                {
+                    realtime_scope const realtime;
+                    m_task();
+                }
 
                 m_sem_finished.release();
             }
@@ -63,9 +70,16 @@ public:
         m_sem_work.release();
     }
 
+    [[nodiscard]] auto wait_policy() const noexcept
+            -> thread::wait_policy const&
+    {
+        return m_wait_policy;
+    }
+
 private:
-    std::binary_semaphore m_sem_work{0};
-    std::binary_semaphore m_sem_finished{1};
+    thread::wait_policy m_wait_policy;
+    binary_semaphore m_sem_work;
+    binary_semaphore m_sem_finished;
 
     task_t m_task{[]() {}};
     std::jthread m_thread;
@@ -0,0 +1,67 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/thread/binary_semaphore.h>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <climits>
+
+namespace piejam::thread
+{
+
+namespace
+{
+
+void
+futex_wait(std::atomic_uint32_t& addr, std::uint32_t const expected) noexcept
+{
+    static_assert(sizeof(std::atomic_uint32_t) == sizeof(std::uint32_t));
+    ::syscall(
+            SYS_futex,
+            reinterpret_cast<std::uint32_t*>(&addr),
+            FUTEX_WAIT_PRIVATE,
+            expected,
+            nullptr,
+            nullptr,
+            0);
+}
+
+void
+futex_wake_one(std::atomic_uint32_t& addr) noexcept
+{
+    ::syscall(
+            SYS_futex,
+            reinterpret_cast<std::uint32_t*>(&addr),
+            FUTEX_WAKE_PRIVATE,
+            1,
+            nullptr,
+            nullptr,
+            0);
+}
+
+} // namespace
+
+void
+binary_semaphore::park() noexcept
+{
+    // Marking the state as parked, makes the releasing thread wake us up.
+    // If we grab the semaphore this way, it stays marked and the next release
+    // will just do a superfluous wake.
+    while (m_state.exchange(state_parked, std::memory_order_acquire) !=
+           state_available)
+    {
+        futex_wait(m_state, state_parked);
+    }
+}
+
+void
+binary_semaphore::wake() noexcept
+{
+    futex_wake_one(m_state);
+}
+
+} // namespace piejam::thread
@@ -0,0 +1,265 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Only built with PIEJAM_RT_AUDIT. The allocation functions are interposed
+// and forwarded to the ones of glibc, the blocking calls to the next
+// definition found by the dynamic linker.
+
+#include <piejam/thread/realtime_scope.h>
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+extern "C"
+{
+void* __libc_malloc(std::size_t) noexcept;
+void* __libc_calloc(std::size_t, std::size_t) noexcept;
+void* __libc_realloc(void*, std::size_t) noexcept;
+void* __libc_memalign(std::size_t, std::size_t) noexcept;
+void __libc_free(void*) noexcept;
+}
+
+namespace piejam::thread::rt_audit
+{
+
+namespace
+{
+
+constinit thread_local std::size_t t_depth{};
+constinit thread_local bool t_reporting{};
+
+std::atomic_size_t s_violations{};
+bool s_abort_on_violation{};
+
+void
+write_stderr(char const* const str) noexcept
+{
+    [[maybe_unused]] auto const written =
+            ::write(STDERR_FILENO, str, std::strlen(str));
+}
+
+void
+report(char const* const call) noexcept
+{
+    t_reporting = true;
+
+    s_violations.fetch_add(1, std::memory_order_relaxed);
+
+    write_stderr("piejam rt audit: ");
+    write_stderr(call);
+    write_stderr(" called from a real-time thread\n");
+
+    void* frames[32];
+    ::backtrace_symbols_fd(frames, ::backtrace(frames, 32), STDERR_FILENO);
+
+    if (s_abort_on_violation)
+    {
+        std::abort();
+    }
+
+    t_reporting = false;
+}
+
+//! backtrace loads libgcc on its first call, which allocates. So it is
+//! called once before any thread is marked real-time.
+struct init
+{
+    init() noexcept
+    {
+        s_abort_on_violation = std::getenv("PIEJAM_RT_AUDIT_ABORT");
+
+        void* frame{};
+        ::backtrace(&frame, 1);
+    }
+} const s_init;
+
+template <class F>
+auto
+next_function(std::atomic<F>& f, char const* const name) noexcept -> F
+{
+    F result = f.load(std::memory_order_relaxed);
+
+    if (!result)
+    {
+        result = reinterpret_cast<F>(::dlsym(RTLD_NEXT, name));
+        f.store(result, std::memory_order_relaxed);
+    }
+
+    return result;
+}
+
+void
+check(char const* const call) noexcept
+{
+    if (t_depth && !t_reporting)
+    {
+        report(call);
+    }
+}
+
+} // namespace
+
+void
+enter() noexcept
+{
+    ++t_depth;
+}
+
+void
+leave() noexcept
+{
+    --t_depth;
+}
+
+auto
+violations() noexcept -> std::size_t
+{
+    return s_violations.load(std::memory_order_relaxed);
+}
+
+namespace
+{
+
+using pthread_mutex_lock_t = int (*)(pthread_mutex_t*);
+using nanosleep_t = int (*)(timespec const*, timespec*);
+using clock_nanosleep_t = int (*)(clockid_t, int, timespec const*, timespec*);
+using usleep_t = int (*)(useconds_t);
+
+std::atomic<pthread_mutex_lock_t> s_pthread_mutex_lock{};
+std::atomic<nanosleep_t> s_nanosleep{};
+std::atomic<clock_nanosleep_t> s_clock_nanosleep{};
+std::atomic<usleep_t> s_usleep{};
+
+} // namespace
+
+} // namespace piejam::thread::rt_audit
+
+using piejam::thread::rt_audit::check;
+
+extern "C"
+{
+
+void*
+malloc(std::size_t const size) noexcept
+{
+    check("malloc");
+    return __libc_malloc(size);
+}
+
+void*
+calloc(std::size_t const num, std::size_t const size) noexcept
+{
+    check("calloc");
+    return __libc_calloc(num, size);
+}
+
+void*
+realloc(void* const ptr, std::size_t const size) noexcept
+{
+    check("realloc");
+    return __libc_realloc(ptr, size);
+}
+
+void
+free(void* const ptr) noexcept
+{
+    if (ptr)
+    {
+        check("free");
+    }
+
+    __libc_free(ptr);
+}
+
+void*
+memalign(std::size_t const alignment, std::size_t const size) noexcept
+{
+    check("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+void*
+aligned_alloc(std::size_t const alignment, std::size_t const size) noexcept
+{
+    check("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int
+posix_memalign(
+        void** const ptr,
+        std::size_t const alignment,
+        std::size_t const size) noexcept
+{
+    check("posix_memalign");
+
+    if (alignment % sizeof(void*) != 0 || !std::has_single_bit(alignment))
+    {
+        return EINVAL;
+    }
+
+    void* const result = __libc_memalign(alignment, size);
+    if (!result)
+    {
+        return ENOMEM;
+    }
+
+    *ptr = result;
+    return 0;
+}
+
+int
+pthread_mutex_lock(pthread_mutex_t* const mutex) noexcept
+{
+    using namespace piejam::thread::rt_audit;
+
+    check("pthread_mutex_lock");
+    return next_function(s_pthread_mutex_lock, "pthread_mutex_lock")(mutex);
+}
+
+int
+nanosleep(timespec const* const duration, timespec* const rem)
+{
+    using namespace piejam::thread::rt_audit;
+
+    check("nanosleep");
+    return next_function(s_nanosleep, "nanosleep")(duration, rem);
+}
+
+int
+clock_nanosleep(
+        clockid_t const clock,
+        int const flags,
+        timespec const* const time,
+        timespec* const rem)
+{
+    using namespace piejam::thread::rt_audit;
+
+    check("clock_nanosleep");
+    return next_function(s_clock_nanosleep, "clock_nanosleep")(
+            clock,
+            flags,
+            time,
+            rem);
+}
+
+int
+usleep(useconds_t const duration)
+{
+    using namespace piejam::thread::rt_audit;
+
+    check("usleep");
+    return next_function(s_usleep, "usleep")(duration);
+}
+
+} // extern "C"
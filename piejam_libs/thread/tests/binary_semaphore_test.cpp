@@ -0,0 +1,73 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/thread/binary_semaphore.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace piejam::thread::test
+{
+
+TEST(binary_semaphore, try_acquire_only_once_if_available)
+{
+    binary_semaphore sut(true);
+
+    EXPECT_TRUE(sut.try_acquire());
+    EXPECT_FALSE(sut.try_acquire());
+}
+
+TEST(binary_semaphore, try_acquire_after_release)
+{
+    binary_semaphore sut(false);
+
+    EXPECT_FALSE(sut.try_acquire());
+    sut.release();
+    EXPECT_TRUE(sut.try_acquire());
+}
+
+TEST(binary_semaphore, parked_thread_is_woken_up_by_release)
+{
+    binary_semaphore sut(false, {.spin_count = 0, .yield_count = 0});
+    binary_semaphore done(false, {.spin_count = 0, .yield_count = 0});
+    std::size_t counter{};
+
+    std::jthread t([&]() {
+        for (std::size_t i = 0; i < 100; ++i)
+        {
+            sut.acquire();
+            ++counter;
+            done.release();
+        }
+    });
+
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+        sut.release();
+        done.acquire();
+    }
+
+    t.join();
+
+    EXPECT_EQ(100u, counter);
+}
+
+TEST(backoff, is_exhausted_after_spin_and_yield_count)
+{
+    backoff sut({.spin_count = 2, .yield_count = 1});
+
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        EXPECT_FALSE(sut.exhausted());
+        sut();
+    }
+
+    EXPECT_TRUE(sut.exhausted());
+
+    sut.reset();
+    EXPECT_FALSE(sut.exhausted());
+}
+
+} // namespace piejam::thread::test
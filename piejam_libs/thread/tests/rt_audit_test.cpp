@@ -0,0 +1,80 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/thread/realtime_scope.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <mutex>
+
+namespace piejam::thread::test
+{
+
+namespace
+{
+
+void* volatile g_sink{};
+
+void
+allocate()
+{
+    auto p = std::make_unique<int>(1);
+    g_sink = p.get();
+}
+
+} // namespace
+
+TEST(rt_audit, allocation_outside_of_realtime_scope_is_no_violation)
+{
+    auto const violations = rt_audit::violations();
+
+    allocate();
+
+    EXPECT_EQ(violations, rt_audit::violations());
+}
+
+TEST(rt_audit, allocation_in_realtime_scope_is_a_violation)
+{
+    auto const violations = rt_audit::violations();
+
+    {
+        realtime_scope const realtime;
+        allocate();
+    }
+
+    // allocation and deallocation
+    EXPECT_EQ(violations + 2, rt_audit::violations());
+}
+
+TEST(rt_audit, locking_a_mutex_in_realtime_scope_is_a_violation)
+{
+    std::mutex m;
+    auto const violations = rt_audit::violations();
+
+    {
+        realtime_scope const realtime;
+        std::lock_guard const lock(m);
+    }
+
+    EXPECT_EQ(violations + 1, rt_audit::violations());
+}
+
+TEST(rt_audit, scopes_can_be_nested)
+{
+    auto const violations = rt_audit::violations();
+
+    {
+        realtime_scope const outer;
+        {
+            realtime_scope const inner;
+        }
+
+        allocate();
+    }
+
+    EXPECT_EQ(violations + 2, rt_audit::violations());
+}
+
+} // namespace piejam::thread::test
@@ -0,0 +1,117 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/thread/spsc_snapshot.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace piejam::thread::test
+{
+
+namespace
+{
+
+auto
+consume_all(spsc_snapshot<int>& sut) -> std::vector<std::pair<std::size_t, int>>
+{
+    std::vector<std::pair<std::size_t, int>> result;
+    EXPECT_TRUE(sut.consume([&result](std::size_t index, int value) {
+        result.emplace_back(index, value);
+    }));
+    return result;
+}
+
+} // namespace
+
+TEST(spsc_snapshot, nothing_to_consume_initially)
+{
+    spsc_snapshot<int> sut(3);
+
+    EXPECT_TRUE(consume_all(sut).empty());
+}
+
+TEST(spsc_snapshot, only_changed_entries_are_consumed)
+{
+    spsc_snapshot<int> sut(100);
+
+    sut.update([](auto& writer) {
+        writer.set(2, 5);
+        writer.set(70, 8);
+    });
+
+    EXPECT_EQ(
+            (std::vector<std::pair<std::size_t, int>>{{2, 5}, {70, 8}}),
+            consume_all(sut));
+    EXPECT_TRUE(consume_all(sut).empty());
+}
+
+TEST(spsc_snapshot, last_value_of_consecutive_updates_is_consumed)
+{
+    spsc_snapshot<int> sut(3);
+
+    sut.update([](auto& writer) { writer.set(1, 5); });
+    sut.update([](auto& writer) {
+        writer.set(1, 6);
+        writer.set(0, 7);
+    });
+
+    EXPECT_EQ(
+            (std::vector<std::pair<std::size_t, int>>{{0, 7}, {1, 6}}),
+            consume_all(sut));
+}
+
+TEST(spsc_snapshot, updates_after_consume_are_written_to_other_buffer)
+{
+    spsc_snapshot<int> sut(3);
+
+    sut.update([](auto& writer) { writer.set(0, 1); });
+    EXPECT_EQ(
+            (std::vector<std::pair<std::size_t, int>>{{0, 1}}),
+            consume_all(sut));
+
+    sut.update([](auto& writer) { writer.set(2, 3); });
+    EXPECT_EQ(
+            (std::vector<std::pair<std::size_t, int>>{{2, 3}}),
+            consume_all(sut));
+
+    sut.update([](auto& writer) { writer.set(0, 4); });
+    EXPECT_EQ(
+            (std::vector<std::pair<std::size_t, int>>{{0, 4}}),
+            consume_all(sut));
+}
+
+TEST(spsc_snapshot, consumed_values_are_monotonic_while_producing)
+{
+    spsc_snapshot<int> sut(2);
+
+    constexpr int last_value{100000};
+
+    std::thread producer([&sut]() {
+        for (int value = 1; value <= last_value; ++value)
+        {
+            sut.update([value](auto& writer) {
+                writer.set(0, value);
+                writer.set(1, value);
+            });
+        }
+    });
+
+    int last_consumed{};
+    while (last_consumed != last_value)
+    {
+        sut.consume([&last_consumed](std::size_t, int const value) {
+            EXPECT_LE(last_consumed, value);
+            last_consumed = value;
+        });
+    }
+
+    producer.join();
+}
+
+} // namespace piejam::thread::test
@@ -0,0 +1,117 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/thread/work_stealing_deque.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace piejam::thread::test
+{
+
+TEST(work_stealing_deque, capacity_is_rounded_up_to_power_of_two)
+{
+    work_stealing_deque<int> sut(5);
+    EXPECT_EQ(8u, sut.capacity());
+}
+
+TEST(work_stealing_deque, pop_and_steal_from_empty)
+{
+    work_stealing_deque<int> sut(4);
+    EXPECT_FALSE(sut.pop());
+    EXPECT_FALSE(sut.steal());
+}
+
+TEST(work_stealing_deque, pop_is_lifo)
+{
+    work_stealing_deque<int> sut(4);
+    sut.push(1);
+    sut.push(2);
+
+    EXPECT_EQ(2, sut.pop());
+    EXPECT_EQ(1, sut.pop());
+    EXPECT_FALSE(sut.pop());
+}
+
+TEST(work_stealing_deque, steal_is_fifo)
+{
+    work_stealing_deque<int> sut(4);
+    sut.push(1);
+    sut.push(2);
+
+    EXPECT_EQ(1, sut.steal());
+    EXPECT_EQ(2, sut.steal());
+    EXPECT_FALSE(sut.steal());
+}
+
+TEST(work_stealing_deque, wraps_around)
+{
+    work_stealing_deque<int> sut(2);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        sut.push(i);
+        sut.push(i + 1);
+        EXPECT_EQ(i, sut.steal());
+        EXPECT_EQ(i + 1, sut.pop());
+    }
+}
+
+TEST(work_stealing_deque, every_item_is_taken_exactly_once)
+{
+    constexpr int num_items = 100000;
+    work_stealing_deque<int> sut(num_items);
+    std::vector<std::atomic_int> taken(num_items);
+    std::atomic_int num_taken{};
+
+    auto take = [&](int const v) {
+        taken[v].fetch_add(1, std::memory_order_relaxed);
+        num_taken.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    std::vector<std::jthread> thieves;
+    for (int t = 0; t < 3; ++t)
+    {
+        thieves.emplace_back([&]() {
+            while (num_taken.load(std::memory_order_relaxed) < num_items)
+            {
+                if (auto v = sut.steal())
+                {
+                    take(*v);
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < num_items; ++i)
+    {
+        sut.push(i);
+
+        if (i % 3 == 0)
+        {
+            if (auto v = sut.pop())
+            {
+                take(*v);
+            }
+        }
+    }
+
+    while (auto v = sut.pop())
+    {
+        take(*v);
+    }
+
+    thieves.clear();
+
+    EXPECT_EQ(num_items, num_taken.load());
+    for (auto const& t : taken)
+    {
+        EXPECT_EQ(1, t.load());
+    }
+}
+
+} // namespace piejam::thread::test
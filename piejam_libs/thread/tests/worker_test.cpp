@@ -48,4 +48,23 @@ TEST(worker, on_multiple_wakeups_block_until_previous_task_is_finished)
     EXPECT_EQ(50u, counter2);
 }
 
+TEST(worker, parks_with_power_saving_wait_policy)
+{
+    std::size_t counter{};
+
+    {
+        worker wt(
+                {.affinity = {},
+                 .realtime_priority = {},
+                 .name = {},
+                 .wait_policy = wait_policy::power_saving()});
+        for (std::size_t i = 0; i < 10; ++i)
+        {
+            wt.wakeup([&]() { ++counter; });
+        }
+    }
+
+    EXPECT_EQ(10u, counter);
+}
+
 } // namespace piejam::thread::test
@@ -62,7 +62,9 @@ main(int argc, char* argv[]) -> int
                         }),
                 piejam::thread::configuration{
                         .affinity = boost::lexical_cast<int>(argv[5]),
-                        .realtime_priority = 96},
+                        .realtime_priority = 96,
+                        .name = {},
+                        .wait_policy = {}},
                 {},
                 *audio_device_manager,
                 ladspa_manager,
@@ -0,0 +1,347 @@
+// PieJam - An audio mixer for Raspberry Pi.
+// SPDX-FileCopyrightText: 2023  Dimitrij Kotrev
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <piejam/audio/offline_device_manager.h>
+#include <piejam/ladspa/instance_manager_processor_factory.h>
+#include <piejam/redux/store.h>
+#include <piejam/redux/thunk_middleware.h>
+#include <piejam/runtime/actions/export_graph.h>
+#include <piejam/runtime/actions/initiate_device_selection.h>
+#include <piejam/runtime/actions/load_session.h>
+#include <piejam/runtime/actions/refresh_devices.h>
+#include <piejam/runtime/actions/tracing.h>
+#include <piejam/runtime/audio_engine_middleware.h>
+#include <piejam/runtime/ladspa_fx_middleware.h>
+#include <piejam/runtime/persistence_middleware.h>
+#include <piejam/runtime/state.h>
+#include <piejam/runtime/store.h>
+#include <piejam/runtime/ui/action.h>
+#include <piejam/runtime/ui/thunk_action.h>
+#include <piejam/thread/configuration.h>
+
+#include <fmt/format.h>
+
+#include <spdlog/spdlog.h>
+
+#include <sndfile.hh>
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace piejam::runtime::ui
+{
+
+auto
+as_thunk_action(action const& a) -> thunk_action<runtime::state> const*
+{
+    return dynamic_cast<thunk_action<runtime::state> const*>(&a);
+}
+
+} // namespace piejam::runtime::ui
+
+namespace
+{
+
+//! Reads the input channels from a file, silence after its end.
+auto
+make_file_source(SndfileHandle& file) -> piejam::audio::offline_source
+{
+    return [&file, frames = std::vector<float>{}](
+                   std::span<std::span<float> const> const channels) mutable {
+        if (channels.empty())
+        {
+            return;
+        }
+
+        std::size_t const num_channels = channels.size();
+        std::size_t const num_frames = channels.front().size();
+        std::size_t const file_channels =
+                static_cast<std::size_t>(file.channels());
+
+        frames.resize(num_frames * file_channels);
+        auto const read = static_cast<std::size_t>(
+                file.readf(frames.data(), static_cast<sf_count_t>(num_frames)));
+        std::fill(
+                frames.begin() +
+                        static_cast<std::ptrdiff_t>(read * file_channels),
+                frames.end(),
+                0.f);
+
+        for (std::size_t ch = 0; ch < num_channels; ++ch)
+        {
+            for (std::size_t frame = 0; frame < num_frames; ++frame)
+            {
+                channels[ch][frame] = ch < file_channels
+                                              ? frames[frame * file_channels +
+                                                       ch]
+                                              : 0.f;
+            }
+        }
+    };
+}
+
+auto
+make_file_sink(SndfileHandle& file) -> piejam::audio::offline_sink
+{
+    return [&file, frames = std::vector<float>{}](
+                   std::span<std::span<float const> const> const
+                           channels) mutable {
+        if (channels.empty())
+        {
+            return;
+        }
+
+        std::size_t const num_channels = channels.size();
+        std::size_t const num_frames = channels.front().size();
+
+        frames.resize(num_frames * num_channels);
+        for (std::size_t ch = 0; ch < num_channels; ++ch)
+        {
+            for (std::size_t frame = 0; frame < num_frames; ++frame)
+            {
+                frames[frame * num_channels + ch] = channels[ch][frame];
+            }
+        }
+
+        file.writef(frames.data(), static_cast<sf_count_t>(num_frames));
+    };
+}
+
+} // namespace
+
+auto
+main(int argc, char* argv[]) -> int
+{
+    using namespace piejam;
+    namespace po = boost::program_options;
+
+    static auto const s_help_str = "help";
+    static auto const s_session_str = "session";
+    static auto const s_input_str = "input";
+    static auto const s_output_str = "output";
+    static auto const s_outputs_str = "outputs";
+    static auto const s_sample_rate_str = "sample_rate";
+    static auto const s_period_size_str = "period_size";
+    static auto const s_seconds_str = "seconds";
+    static auto const s_workers_str = "workers";
+    static auto const s_trace_str = "trace";
+    static auto const s_graph_str = "graph";
+
+    po::options_description desc("Options");
+    desc.add_options()(s_help_str, "produce help message")(
+            s_session_str,
+            po::value<std::string>(),
+            "session file to render")(
+            s_input_str,
+            po::value<std::string>(),
+            "audio file with the input channels, silence if omitted")(
+            s_output_str,
+            po::value<std::string>(),
+            "wav file to write the output channels to")(
+            s_outputs_str,
+            po::value<unsigned>()->default_value(2),
+            "number of output channels")(
+            s_sample_rate_str,
+            po::value<unsigned>(),
+            "sample rate, defaults to the one of the input file or 48000")(
+            s_period_size_str,
+            po::value<unsigned>()->default_value(256),
+            "period size, e.g. 64, 128, 256")(
+            s_seconds_str,
+            po::value<double>(),
+            "length to render, defaults to the length of the input file")(
+            s_workers_str,
+            po::value<unsigned>()->default_value(0),
+            "number of engine worker threads")(
+            s_trace_str,
+            po::value<std::string>(),
+            "json file to write a trace of the processor execution to")(
+            s_graph_str,
+            po::value<std::string>(),
+            "dot file to write the audio engine graph to");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count(s_help_str))
+    {
+        std::cout << desc << std::endl;
+        return 1;
+    }
+
+    if (!vm.count(s_output_str))
+    {
+        std::cerr << "Output file not set!" << std::endl;
+        return -1;
+    }
+
+    SndfileHandle input_file;
+    if (vm.count(s_input_str))
+    {
+        input_file = SndfileHandle(vm[s_input_str].as<std::string>());
+        if (!input_file)
+        {
+            std::cerr << "Could not open input file!" << std::endl;
+            return -1;
+        }
+    }
+
+    audio::sample_rate const sample_rate(
+            vm.count(s_sample_rate_str)
+                    ? vm[s_sample_rate_str].as<unsigned>()
+                    : (input_file ? static_cast<unsigned>(
+                                            input_file.samplerate())
+                                  : 48000u));
+
+    std::optional<std::size_t> num_frames;
+    if (vm.count(s_seconds_str))
+    {
+        num_frames = static_cast<std::size_t>(
+                vm[s_seconds_str].as<double>() * sample_rate.get());
+    }
+    else if (input_file)
+    {
+        num_frames = static_cast<std::size_t>(input_file.frames());
+    }
+    else
+    {
+        std::cerr << "Neither input file nor length set!" << std::endl;
+        return -1;
+    }
+
+    unsigned const num_outputs = vm[s_outputs_str].as<unsigned>();
+
+    SndfileHandle output_file(
+            vm[s_output_str].as<std::string>(),
+            SFM_WRITE,
+            SF_FORMAT_WAV | SF_FORMAT_FLOAT,
+            static_cast<int>(num_outputs),
+            static_cast<int>(sample_rate.get()));
+    if (!output_file)
+    {
+        std::cerr << "Could not open output file!" << std::endl;
+        return -1;
+    }
+
+    try
+    {
+        audio::offline_device_manager audio_device_manager(
+                input_file ? static_cast<unsigned>(input_file.channels()) : 0u,
+                num_outputs,
+                sample_rate,
+                audio::period_size(vm[s_period_size_str].as<unsigned>()),
+                input_file ? make_file_source(input_file)
+                           : audio::offline_source(
+                                     [](std::span<std::span<float> const>) {}),
+                make_file_sink(output_file));
+
+        ladspa::instance_manager_processor_factory ladspa_manager;
+
+        std::vector<thread::configuration> worker_configs(
+                vm[s_workers_str].as<unsigned>());
+
+        using middleware_factory =
+                redux::middleware_factory<runtime::state, runtime::action>;
+
+        runtime::store store(
+                [](runtime::state& st, runtime::action const& a) -> void {
+                    if (auto const* const ra = dynamic_cast<
+                                runtime::reducible_action const*>(&a);
+                        ra)
+                    {
+                        ra->reduce(st);
+                    }
+                },
+                runtime::make_initial_state());
+
+        store.apply_middleware(
+                middleware_factory::make<runtime::persistence_middleware>());
+
+        store.apply_middleware(
+                middleware_factory::make<runtime::audio_engine_middleware>(
+                        thread::configuration{
+                                .affinity = {},
+                                .realtime_priority = {},
+                                .name = "audio_main",
+                                .wait_policy = {}},
+                        worker_configs,
+                        audio_device_manager,
+                        ladspa_manager,
+                        nullptr));
+
+        store.apply_middleware(
+                middleware_factory::make<runtime::ladspa_fx_middleware>(
+                        ladspa_manager));
+
+        store.apply_middleware(
+                middleware_factory::make<redux::thunk_middleware>());
+
+        store.dispatch(runtime::actions::refresh_devices{});
+
+        {
+            runtime::actions::initiate_device_selection select_input;
+            select_input.input = true;
+            select_input.index = 0;
+            store.dispatch(select_input);
+        }
+
+        {
+            runtime::actions::initiate_device_selection select_output;
+            select_output.input = false;
+            select_output.index = 0;
+            store.dispatch(select_output);
+        }
+
+        if (vm.count(s_session_str))
+        {
+            store.dispatch(runtime::actions::load_session(
+                    vm[s_session_str].as<std::string>()));
+        }
+
+        audio::offline_device* const device =
+                audio_device_manager.last_device();
+        if (!device || !device->is_running())
+        {
+            std::cerr << "Could not start the audio engine!" << std::endl;
+            return -1;
+        }
+
+        if (vm.count(s_graph_str))
+        {
+            store.dispatch(runtime::actions::export_graph(
+                    vm[s_graph_str].as<std::string>()));
+        }
+
+        if (vm.count(s_trace_str))
+        {
+            store.dispatch(runtime::actions::start_tracing{});
+        }
+
+        device->render(*num_frames);
+
+        if (vm.count(s_trace_str))
+        {
+            store.dispatch(runtime::actions::stop_tracing(
+                    vm[s_trace_str].as<std::string>()));
+        }
+
+        std::cout << fmt::format(
+                             "Rendered {} frames, {:.2f}x real time",
+                             device->rendered_frames(),
+                             1.f / device->cpu_load())
+                  << std::endl;
+    }
+    catch (std::exception const& e)
+    {
+        spdlog::error(e.what());
+        return -1;
+    }
+
+    return 0;
+}